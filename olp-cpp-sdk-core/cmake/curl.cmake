@@ -51,6 +51,13 @@ if(CURL_FOUND AND NOT NETWORK_NO_CURL)
         add_definitions(-DOLP_SDK_NETWORK_HAS_PIPE2=1)
     endif()
 
+    check_symbol_exists(epoll_create1 "sys/epoll.h" OLP_SDK_HAS_EPOLL)
+    check_symbol_exists(eventfd "sys/eventfd.h" OLP_SDK_HAS_EVENTFD)
+    option(OLP_SDK_ENABLE_CURL_EPOLL "Use epoll instead of select() in the curl network backend when available" ON)
+    if(OLP_SDK_ENABLE_CURL_EPOLL AND OLP_SDK_HAS_EPOLL AND OLP_SDK_HAS_EVENTFD)
+        add_definitions(-DOLP_SDK_NETWORK_HAS_EPOLL=1)
+    endif()
+
 else()
     set(OLP_SDK_HTTP_CURL_SOURCES)
     set(OLP_SDK_NETWORK_CURL_LIBRARIES)
@@ -19,12 +19,18 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 
 #include <olp/core/porting/deprecated.h>
 #include <boost/optional.hpp>
 
 namespace olp {
+namespace thread {
+class TaskScheduler;
+}  // namespace thread
+
 namespace cache {
 
 /**
@@ -36,6 +42,105 @@ enum OpenOptions : unsigned char {
   CheckCrc = 0x02  /*!< Verifies the checksum of all data that is read. */
 };
 
+/**
+ * @brief The codecs that compress the values in the disk cache.
+ */
+enum class CompressionCodec : std::uint8_t {
+  None = 0, /*!< The values are stored as they are. */
+  Zlib = 1  /*!< The values are compressed with zlib (deflate). */
+};
+
+/**
+ * @brief The tuning of the LevelDB databases that back the disk caches.
+ *
+ * The default values favor the point lookups of the cache without using much
+ * memory. Use `ReadOptimized` or `WriteOptimized` as a starting point for
+ * the read-heavy or the write-heavy workloads.
+ */
+struct LevelDbProfile {
+  /**
+   * @brief Sets the number of the bloom filter bits per key.
+   *
+   * The filters let the lookups of the missing keys skip the table files
+   * without reading them. 10 bits give about 1% of false positives. The filters
+   * are added to the table files written after the change, so the existing
+   * files get them with the compactions. Set it to `0` to disable the filters.
+   *
+   * The default value is 10.
+   */
+  int bloom_filter_bits_per_key = 10;
+
+  /**
+   * @brief Sets the capacity (in bytes) of the LRU cache of the uncompressed
+   * table blocks.
+   *
+   * The default value is 0, which uses the 8 MB cache created by LevelDB.
+   */
+  size_t block_cache_size = 0u;
+
+  /**
+   * @brief Sets the approximate size (in bytes) of the table blocks.
+   *
+   * The smaller blocks make the point lookups read less, the larger blocks
+   * compress better and need a smaller index. The default value is 4 KB.
+   */
+  size_t block_size = 4u * 1024u;
+
+  /**
+   * @brief Sets the maximum number of the table files kept open.
+   *
+   * The default value is 1000.
+   */
+  int max_open_files = 1000;
+
+  /**
+   * @brief Enables the aggressive checks of the stored data.
+   *
+   * The database stops on the first detected corruption, instead of skipping
+   * the corrupted data. The default value is `false`.
+   */
+  bool paranoid_checks = false;
+
+  /**
+   * @brief Enables the reuse of the existing log and manifest files when
+   * the database is opened.
+   *
+   * Makes opening the database faster, as the log is not compacted into
+   * a table file right away. The default value is `false`.
+   */
+  bool reuse_logs = false;
+
+  /**
+   * @brief Gets the profile for the read-heavy workloads.
+   *
+   * Uses a 32 MB block cache, small blocks, and more bloom filter bits.
+   *
+   * @return The read-optimized profile.
+   */
+  static LevelDbProfile ReadOptimized() {
+    LevelDbProfile profile;
+    profile.bloom_filter_bits_per_key = 16;
+    profile.block_cache_size = 32u * 1024u * 1024u;
+    profile.block_size = 4u * 1024u;
+    return profile;
+  }
+
+  /**
+   * @brief Gets the profile for the write-heavy workloads.
+   *
+   * Uses large blocks and reuses the logs, so the writes and the compactions
+   * produce fewer and better compressed blocks.
+   *
+   * @return The write-optimized profile.
+   */
+  static LevelDbProfile WriteOptimized() {
+    LevelDbProfile profile;
+    profile.block_size = 64u * 1024u;
+    profile.reuse_logs = true;
+    return profile;
+  }
+};
+
 /**
  * @brief Settings for in-memory and on-disk caching.
  */
@@ -71,6 +176,46 @@ struct CacheSettings {
    */
   std::uint64_t max_disk_storage = 1024ull * 1024ull * 32ull;
 
+  /**
+   * @brief Sets the disk usage (in percent of `#max_disk_storage`) that
+   * the disk cache maintenance evicts the least recently used data down to.
+   *
+   * The default value is 80.
+   */
+  std::uint8_t disk_storage_low_water_mark = 80u;
+
+  /**
+   * @brief Sets the disk usage (in percent of `#max_disk_storage`) that
+   * schedules the disk cache maintenance, so the data is evicted before
+   * the writes start to fail.
+   *
+   * The default value is 90.
+   */
+  std::uint8_t disk_storage_high_water_mark = 90u;
+
+  /**
+   * @brief Sets the interval (in seconds) of the disk cache maintenance that
+   * removes the expired data while the disk is not full.
+   *
+   * The maintenance is scheduled by the first write after the interval.
+   * To disable the periodic maintenance, set it to 0. The default value is one
+   * hour.
+   */
+  std::uint32_t disk_maintenance_interval = 3600u;
+
+  /**
+   * @brief The task scheduler that runs the disk cache maintenance in
+   * the background.
+   *
+   * When the mutable disk cache reaches `#disk_storage_high_water_mark`, or
+   * `#disk_maintenance_interval` passes, the maintenance task is scheduled. It
+   * removes the expired data, evicts the least recently used data, and
+   * compacts the storage. If this parameter is not set, the maintenance runs
+   * only when a write fails because the disk is full, or when
+   * `DefaultCache::RunMaintenance` is called.
+   */
+  std::shared_ptr<thread::TaskScheduler> task_scheduler = nullptr;
+
   /**
    * @brief Sets the upper limit of the runtime memory (in bytes) before it is
    * written to the disk.
@@ -85,6 +230,61 @@ struct CacheSettings {
    */
   bool enforce_immediate_flush = true;
 
+  /**
+   * @brief Sets the size (in bytes) from which the values are stored outside
+   * of the mutable disk cache database.
+   *
+   * Such values are appended to separate segment files, and the database
+   * keeps only small pointers to them, so the database compactions do not
+   * rewrite the large values again and again. The segments that are mostly
+   * taken by the removed values are rewritten by the cache maintenance.
+   * The size is compared to the stored, possibly compressed, value.
+   *
+   * The default value is 0, which stores all the values in the database.
+   */
+  size_t blob_threshold = 0u;
+
+  /**
+   * @brief Sets the maximum size (in bytes) of one segment file used for
+   * the values above `blob_threshold`.
+   *
+   * The default value is 64 MB.
+   */
+  std::uint64_t max_blob_segment_size = 64u * 1024u * 1024u;
+
+  /**
+   * @brief Enables the collection of the cache statistics.
+   *
+   * The hits, misses, evictions, and the latencies are counted without locks;
+   * see `DefaultCache::GetStatistics`. The counters and the clock are read on
+   * every cache operation, so the statistics are opt-in.
+   *
+   * The default value is `false`.
+   */
+  bool enable_statistics = false;
+
+  /**
+   * @brief Enables the write-behind mode of the mutable disk cache.
+   *
+   * `DefaultCache::Put` stores the value in the in-memory cache and queues
+   * the disk write to a dedicated thread, which writes the queued values in
+   * batches and coalesces the writes of the same key. The lookups see
+   * the queued values. Use `DefaultCache::Flush` to wait until the queued
+   * values are written; they are also written when the cache is closed.
+   *
+   * The default value is `false`.
+   */
+  bool write_behind = false;
+
+  /**
+   * @brief Sets the maximum size (in bytes) of the values queued in
+   * the write-behind mode.
+   *
+   * `DefaultCache::Put` blocks while the queue is full. The default value is
+   * 8 MB.
+   */
+  size_t max_write_behind_queue_size = 1024u * 1024u * 8u;
+
   /**
    * @brief Sets the maximum permissible size of one file in the storage (in
    * bytes).
@@ -93,6 +293,12 @@ struct CacheSettings {
    */
   size_t max_file_size = 1024u * 1024u * 2u;
 
+  /**
+   * @brief Sets the tuning of the LevelDB databases of the mutable and
+   * the protected disk caches.
+   */
+  LevelDbProfile leveldb_profile;
+
   /**
    * @brief Sets the upper limit of the in-memory data cache size (in bytes).
    *
@@ -100,6 +306,53 @@ struct CacheSettings {
    */
   size_t max_memory_cache_size = 1024u * 1024u;
 
+  /**
+   * @brief Sets the codec that compresses the values written to the mutable
+   * disk cache.
+   *
+   * Only the values of at least `#compression_threshold` bytes are compressed,
+   * and only if they get smaller. The codec is stored with every value, so
+   * the values written with any codec can be read regardless of this setting.
+   * If the SDK is built without the codec, the values are stored as they are.
+   *
+   * The default value is `CompressionCodec::None`.
+   */
+  CompressionCodec compression_codec = CompressionCodec::None;
+
+  /**
+   * @brief Sets the minimum size (in bytes) of the values that are
+   * compressed.
+   *
+   * The default value is 1 KB.
+   */
+  size_t compression_threshold = 1024u;
+
+  /**
+   * @brief Sets the number of shards that the cache is split into.
+   *
+   * Keys are distributed across the shards by their hash. Every shard has its
+   * own lock and its own in-memory cache (`#max_memory_cache_size` is divided
+   * evenly between the shards), so the operations on keys that belong to
+   * different shards, including disk lookups, run in parallel.
+   *
+   * The default value is 1, which means that all cache operations are
+   * serialized.
+   */
+  size_t shard_count = 1u;
+
+  /**
+   * @brief Enables the concurrent lookups in the in-memory cache.
+   *
+   * The lookups that hit the in-memory cache take a shared lock instead of the
+   * exclusive lock of the shard, so they run in parallel with each other. The
+   * LRU order of the in-memory cache is updated in batches, and a hit does not
+   * refresh the key in the LRU order of the mutable disk cache. Use it for the
+   * read-heavy workloads with a high hit rate.
+   *
+   * The default value is `false`.
+   */
+  bool concurrent_memory_reads = false;
+
   /**
    * @brief Sets the disk cache open options.
    */
@@ -113,6 +366,9 @@ struct CacheSettings {
    * `disk_path_mutable` is empty. Use this cash if you want to have a stable
    * fallback state or offline data that you can always access regardless of
    * the network state.
+   *
+   * If the path points to a file created by `MappedCacheBuilder`, the file is
+   * memory-mapped instead, which makes the lookups considerably faster.
    */
   boost::optional<std::string> disk_path_protected = boost::none;
 };
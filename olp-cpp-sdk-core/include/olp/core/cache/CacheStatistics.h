@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <olp/core/CoreApi.h>
+
+namespace olp {
+namespace cache {
+
+/**
+ * @brief The kinds of the cached values, derived from the cache keys.
+ */
+enum class CacheKeyNamespace : std::uint8_t {
+  Api = 0,       /*!< The API lookup results. */
+  Catalog = 1,   /*!< The catalog configurations and versions. */
+  Partition = 2, /*!< The partition metadata. */
+  Data = 3,      /*!< The partition data. */
+  Other = 4      /*!< The keys that do not belong to any namespace above. */
+};
+
+/**
+ * @brief The counters of the cache operations.
+ */
+struct CORE_API CacheCounters {
+  /// The lookups served by the in-memory cache.
+  std::uint64_t memory_hits = 0u;
+  /// The lookups served by the protected or the mutable disk cache.
+  std::uint64_t disk_hits = 0u;
+  /// The lookups that found no value.
+  std::uint64_t misses = 0u;
+  /// The values removed from the in-memory or the disk cache as expired.
+  std::uint64_t expirations = 0u;
+  /// The values evicted from the in-memory or the disk cache by the size
+  /// limit.
+  std::uint64_t evictions = 0u;
+  /// The disk writes that failed because the disk cache is full.
+  std::uint64_t put_failures = 0u;
+  /// The bytes read from the disk caches.
+  std::uint64_t bytes_read = 0u;
+  /// The bytes written to the mutable disk cache.
+  std::uint64_t bytes_written = 0u;
+
+  /**
+   * @brief Adds the other counters to these ones.
+   *
+   * @param other The counters to add.
+   *
+   * @return The reference to these counters.
+   */
+  CacheCounters& operator+=(const CacheCounters& other);
+};
+
+/**
+ * @brief The histogram of the operation latencies with exponential buckets.
+ *
+ * The bucket `0` counts the operations that took less than 1 microsecond,
+ * and the bucket `i` counts the operations that took from 2^(i-1) to 2^i
+ * microseconds. The last bucket also counts all the longer operations.
+ */
+struct CORE_API LatencyHistogram {
+  /// The number of the buckets; the last one starts at about 4 seconds.
+  static constexpr size_t kBucketCount = 24u;
+
+  /**
+   * @brief Gets the bucket that counts the given latency.
+   *
+   * @param latency The operation latency.
+   *
+   * @return The bucket index.
+   */
+  static size_t GetBucket(std::chrono::nanoseconds latency);
+
+  /**
+   * @brief Gets the number of the recorded operations.
+   *
+   * @return The sum of all the buckets.
+   */
+  std::uint64_t Count() const;
+
+  /**
+   * @brief Gets the upper bound of the latency of the given fraction of
+   * the operations.
+   *
+   * @param fraction The fraction of the operations, from 0 to 1; for example,
+   * 0.99 for the 99th percentile.
+   *
+   * @return The upper bound of the bucket that holds the percentile, or zero
+   * if no operations are recorded.
+   */
+  std::chrono::microseconds Percentile(double fraction) const;
+
+  /// The number of the operations in every bucket.
+  std::array<std::uint64_t, kBucketCount> buckets{};
+};
+
+/**
+ * @brief The snapshot of the `DefaultCache` statistics.
+ *
+ * The statistics are collected while `CacheSettings::enable_statistics` is
+ * set, see `DefaultCache::GetStatistics`.
+ */
+struct CORE_API CacheStatistics {
+  /// The number of the key namespaces.
+  static constexpr size_t kNamespaceCount = 5u;
+
+  /**
+   * @brief Gets the counters of the given key namespace.
+   *
+   * @param key_namespace The key namespace.
+   *
+   * @return The counters of the namespace.
+   */
+  const CacheCounters& Get(CacheKeyNamespace key_namespace) const;
+
+  /**
+   * @brief Gets the namespace of the given cache key.
+   *
+   * The namespace of the keys built by `KeyEncoder` is encoded in the key.
+   * For the other keys, it is derived from the key suffix, for example,
+   * `::api` or `::Data`.
+   *
+   * @param key The cache key.
+   *
+   * @return The key namespace.
+   */
+  static CacheKeyNamespace GetKeyNamespace(const std::string& key);
+
+  /// The counters of all the namespaces.
+  CacheCounters total;
+  /// The counters of every namespace, indexed by `CacheKeyNamespace`.
+  std::array<CacheCounters, kNamespaceCount> namespaces;
+
+  /// The latencies of the single value lookups served by the in-memory cache.
+  LatencyHistogram memory_hit_latency;
+  /// The latencies of the single value lookups that read the disk caches,
+  /// including the misses.
+  LatencyHistogram disk_lookup_latency;
+  /// The latencies of the mutable disk cache writes.
+  LatencyHistogram disk_write_latency;
+};
+
+}  // namespace cache
+}  // namespace olp
@@ -19,17 +19,27 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <set>
+#include <vector>
 
 #include "CacheSettings.h"
+#include "CacheStatistics.h"
 #include "KeyValueCache.h"
+#include "WarmupManifest.h"
 
 namespace olp {
 namespace cache {
 
 class InMemoryCache;
 class DiskCache;
+class MappedCache;
+class StatisticsRecorder;
+class WriteBehindQueue;
 
 /**
  * @brief A default cache that provides an in-memory LRU cache and persistence
@@ -50,9 +60,28 @@ class DiskCache;
  *
  * By default, the maximum size of the in-memory cache is 1MB. To change it,
  * set `olp::cache::CacheSettings::max_memory_cache_size` to the desired value.
+ *
+ * When the mutable disk cache reaches
+ * `olp::cache::CacheSettings::disk_storage_high_water_mark`, the expired and
+ * the least recently used data is evicted by the maintenance task that runs on
+ * `olp::cache::CacheSettings::task_scheduler`. If a write still fails because
+ * the disk is full, the maintenance runs right away, and the write is retried.
+ * The maintenance can also be triggered manually with `RunMaintenance`.
+ *
+ * By default, all cache operations are serialized by one lock. To let several
+ * threads access the cache in parallel, set
+ * `olp::cache::CacheSettings::shard_count` to a value greater than 1.
  */
 class CORE_API DefaultCache : public KeyValueCache {
  public:
+  /**
+   * @brief Called when the warm-up started by `Warmup` is finished.
+   *
+   * @param loaded_count The number of the values loaded into the in-memory
+   * cache.
+   */
+  using WarmupCallback = std::function<void(size_t loaded_count)>;
+
   /*! The storage open result type */
   enum StorageOpenResult {
     Success,            /*!< The operation succeeded. */
@@ -131,6 +160,32 @@ class CORE_API DefaultCache : public KeyValueCache {
    */
   KeyValueCache::ValueTypePtr Get(const std::string& key) override;
 
+  /**
+   * @brief Stores several key-value pairs in the cache at once.
+   *
+   * All the items are written to the disk cache in one write operation.
+   *
+   * @param items The key-value pairs that should be stored.
+   *
+   * @return True if the operation is successful; false otherwise.
+   */
+  bool PutBatch(const BatchItems& items) override;
+
+  /**
+   * @brief Gets several key-value pairs from the cache at once.
+   *
+   * The keys that are not found in the in-memory cache are read from the same
+   * snapshot of the disk cache.
+   *
+   * @param keys The keys that are used to look for the key-value pairs.
+   * @param decoder Decodes the values from a string.
+   *
+   * @return The values in the same order as the keys. The value is empty if
+   * the key is not found.
+   */
+  std::vector<boost::any> GetBatch(const std::vector<std::string>& keys,
+                                   const Decoder& decoder) override;
+
   /**
    * @brief Removes the key-value pair from the cache.
    *
@@ -150,18 +205,152 @@ class CORE_API DefaultCache : public KeyValueCache {
    */
   bool RemoveKeysWithPrefix(const std::string& prefix) override;
 
+  /**
+   * @brief Runs the maintenance of the mutable disk cache.
+   *
+   * Removes the expired values, evicts the least recently used values until
+   * the cache size drops below `CacheSettings::disk_storage_low_water_mark`,
+   * and compacts the storage.
+   *
+   * @return The number of bytes reclaimed by this run.
+   */
+  std::uint64_t RunMaintenance();
+
+  /**
+   * @brief Gets the total number of bytes reclaimed by the maintenance since
+   * the cache was created.
+   *
+   * @return The number of reclaimed bytes.
+   */
+  std::uint64_t GetReclaimedBytes() const;
+
+  /**
+   * @brief Waits until the values queued in the write-behind mode are written
+   * to the mutable disk cache.
+   *
+   * Returns immediately if `CacheSettings::write_behind` is not set.
+   *
+   * @return True if the queued values are written; false if the cache is
+   * closed or a queued write failed since the previous flush.
+   */
+  bool Flush();
+
+  /**
+   * @brief Gets the statistics collected since the cache was created or
+   * the statistics were reset.
+   *
+   * The statistics are collected without locks, so the snapshot taken while
+   * the cache is in use may be slightly inconsistent. Nothing is collected if
+   * `CacheSettings::enable_statistics` is not set.
+   *
+   * @return The statistics snapshot.
+   */
+  CacheStatistics GetStatistics() const;
+
+  /**
+   * @brief Resets all the statistics counters and histograms to zero.
+   */
+  void ResetStatistics();
+
+  /**
+   * @brief Writes the keys of the in-memory cache to the snapshot file, the
+   * most recently used first.
+   *
+   * After a restart, pass the snapshot to `Warmup` to load the same values
+   * back from the disk caches.
+   *
+   * @param path The path to the snapshot file, it is overwritten.
+   * @param max_count The maximum number of the keys to write.
+   *
+   * @return True if the snapshot is written; false otherwise.
+   */
+  bool DumpHotKeys(const std::string& path,
+                   size_t max_count = std::numeric_limits<size_t>::max());
+
+  /**
+   * @brief Loads the values described by the manifest from the disk caches
+   * into the in-memory cache.
+   *
+   * The keys are collected right away, and the values are read in parallel on
+   * `CacheSettings::task_scheduler` until `WarmupManifest::max_bytes` are
+   * read. Without the task scheduler, the values are read before this method
+   * returns. The values that are already in the in-memory cache are skipped.
+   *
+   * The loaded values are kept in the encoded form, and are decoded by
+   * the first `Get` call that finds them.
+   *
+   * @param manifest The keys to load.
+   * @param callback Called when all the values are loaded, may be empty.
+   *
+   * @return True if the warm-up is started; false if the cache is closed,
+   * the in-memory cache is disabled, or the hot keys snapshot can not be read.
+   */
+  bool Warmup(const WarmupManifest& manifest,
+              WarmupCallback callback = nullptr);
+
  private:
+  struct Shard;
+  struct MaintenanceState;
+  struct WarmupJob;
+  using ShardLocks = std::vector<std::unique_lock<std::mutex>>;
+
+  using DiscCacheItem = boost::optional<std::pair<std::string, time_t>>;
+
   StorageOpenResult SetupStorage();
-  boost::optional<std::pair<std::string, time_t>> GetFromDiscCache(
-      const std::string& key);
+  size_t GetShardIndex(const std::string& key) const;
+  Shard& GetShard(const std::string& key);
+  ShardLocks LockShards(const std::set<size_t>& shard_indexes);
+  ShardLocks LockAllShards();
+  boost::any GetFromMemoryCache(Shard& shard, const std::string& key);
+  size_t GetAccessSlot(const std::string& key) const;
+  void TouchKey(Shard& shard, const std::string& key);
+  void TouchSlot(Shard& shard, size_t slot);
+  void RecordTouch(Shard& shard, const std::string& key);
+  void ApplyTouches(Shard& shard);
+  void LoadAccessTicks();
+  void StoreAccessTicks();
+  void StopWriteQueue();
+  bool IsDiskFull() const;
+  bool NeedsMaintenance() const;
+  bool MakeRoomOnDisk(bool wait);
+  void ScheduleMaintenance();
+  std::uint64_t Maintain();
+  bool PutToDiscCache(const std::string& key, const std::string& record);
+  bool PutToDiscCache(
+      const std::vector<std::pair<std::string, std::string>>& items);
+  bool WriteToDiscCache(
+      const std::vector<std::pair<std::string, std::string>>& items);
+  DiscCacheItem DecodeProtectedRecord(const std::string& key,
+                                      std::string value, bool verify_checksum);
+  DiscCacheItem DecodeQueuedRecord(const std::string& key, std::string record,
+                                   time_t now);
+  DiscCacheItem DecodeMutableRecord(const std::string& key, std::string record,
+                                    time_t now, bool verify_checksum);
+  DiscCacheItem GetFromDiscCache(const std::string& key);
+  DiscCacheItem GetFromProtectedCache(const std::string& key,
+                                      const std::string& lookup_key,
+                                      bool verify_checksum);
+  DiscCacheItem GetFromLegacyKey(const std::string& key,
+                                 bool verify_checksum);
+  DiscCacheItem GetFromMutableDiscCache(const std::string& key);
+  std::vector<DiscCacheItem> GetFromDiscCache(
+      const std::vector<std::string>& keys);
+  void CollectKeysWithPrefix(DiskCache& disk_cache, bool records,
+                             const std::string& prefix,
+                             std::vector<std::string>& keys);
+  void LoadWarmupKeys(WarmupJob& job, size_t task);
 
  private:
   CacheSettings settings_;
   bool is_open_;
-  std::unique_ptr<InMemoryCache> memory_cache_;
+  std::vector<std::unique_ptr<Shard>> shards_;
   std::unique_ptr<DiskCache> mutable_cache_;
   std::unique_ptr<DiskCache> protected_cache_;
-  std::mutex cache_lock_;
+  std::unique_ptr<MappedCache> mapped_protected_cache_;
+  std::shared_ptr<WriteBehindQueue> write_queue_;
+  bool protected_cache_records_;
+  std::unique_ptr<StatisticsRecorder> statistics_;
+  std::shared_ptr<MaintenanceState> maintenance_;
 };
 
 }  // namespace cache
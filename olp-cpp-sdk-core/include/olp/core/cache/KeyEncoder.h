@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <olp/core/CoreApi.h>
+#include <olp/core/cache/CacheStatistics.h>
+#include <boost/optional.hpp>
+
+namespace olp {
+namespace cache {
+
+/**
+ * @brief Builds the compact binary cache keys of one catalog.
+ *
+ * The strings are prefixed by their length and the versions are stored as
+ * varints, so the keys can be decoded, and the keys of different catalogs,
+ * layers, and partitions never collide. Every key is built with a single
+ * allocation.
+ *
+ * The keys of one catalog start with `CatalogPrefix`, and the keys of one
+ * layer start with `LayerPrefix`, so they can be removed with
+ * `KeyValueCache::RemoveKeysWithPrefix`.
+ */
+class CORE_API KeyEncoder {
+ public:
+  /**
+   * @brief Creates the `KeyEncoder` instance.
+   *
+   * @param catalog_hrn The catalog HRN string.
+   */
+  explicit KeyEncoder(const std::string& catalog_hrn);
+
+  /**
+   * @brief Gets the prefix of all the keys of the catalog.
+   *
+   * @return The catalog prefix.
+   */
+  std::string CatalogPrefix() const;
+
+  /**
+   * @brief Gets the key of the catalog configuration.
+   *
+   * @return The cache key.
+   */
+  std::string Catalog() const;
+
+  /**
+   * @brief Gets the key of the latest catalog version.
+   *
+   * @return The cache key.
+   */
+  std::string LatestVersion() const;
+
+  /**
+   * @brief Gets the key of the validator of the catalog configuration,
+   * the `ETag` and `Last-Modified` headers of its response.
+   *
+   * @return The cache key.
+   */
+  std::string CatalogValidator() const;
+
+  /**
+   * @brief Gets the key of the API lookup result.
+   *
+   * @param service The service name.
+   * @param service_version The service version.
+   *
+   * @return The cache key.
+   */
+  std::string Api(const std::string& service,
+                  const std::string& service_version) const;
+
+  /**
+   * @brief Gets the key of the layer versions of the catalog version.
+   *
+   * @param catalog_version The catalog version.
+   *
+   * @return The cache key.
+   */
+  std::string LayerVersions(std::int64_t catalog_version) const;
+
+  /**
+   * @brief Gets the prefix of all the keys of the layer.
+   *
+   * @param layer_id The layer ID.
+   *
+   * @return The layer prefix.
+   */
+  std::string LayerPrefix(const std::string& layer_id) const;
+
+  /**
+   * @brief Gets the key of the partition IDs of the layer.
+   *
+   * @param layer_id The layer ID.
+   * @param version The layer version, if any.
+   *
+   * @return The cache key.
+   */
+  std::string Partitions(const std::string& layer_id,
+                         const boost::optional<std::int64_t>& version) const;
+
+  /**
+   * @brief Gets the key of the validator of the partitions of the layer,
+   * the `ETag` and `Last-Modified` headers of their response.
+   *
+   * @param layer_id The layer ID.
+   * @param version The layer version, if any.
+   *
+   * @return The cache key.
+   */
+  std::string PartitionsValidator(
+      const std::string& layer_id,
+      const boost::optional<std::int64_t>& version) const;
+
+  /**
+   * @brief Gets the key of the copy of the partitions of the layer that is
+   * kept after the partitions expire, so they can be revalidated.
+   *
+   * @param layer_id The layer ID.
+   * @param version The layer version, if any.
+   *
+   * @return The cache key.
+   */
+  std::string StalePartitions(
+      const std::string& layer_id,
+      const boost::optional<std::int64_t>& version) const;
+
+  /**
+   * @brief Gets the key of the partition metadata.
+   *
+   * @param layer_id The layer ID.
+   * @param partition_id The partition ID.
+   * @param version The layer version, if any.
+   *
+   * @return The cache key.
+   */
+  std::string Partition(const std::string& layer_id,
+                        const std::string& partition_id,
+                        const boost::optional<std::int64_t>& version) const;
+
+  /**
+   * @brief Gets the prefix of the partition metadata keys of all
+   * the versions.
+   *
+   * @param layer_id The layer ID.
+   * @param partition_id The partition ID.
+   *
+   * @return The partition prefix.
+   */
+  std::string PartitionPrefix(const std::string& layer_id,
+                              const std::string& partition_id) const;
+
+  /**
+   * @brief Gets the key of the partition data.
+   *
+   * @param layer_id The layer ID.
+   * @param data_handle The data handle.
+   *
+   * @return The cache key.
+   */
+  std::string Data(const std::string& layer_id,
+                   const std::string& data_handle) const;
+
+  /**
+   * @brief Gets the namespace of the key built by `KeyEncoder`.
+   *
+   * @param key The cache key.
+   *
+   * @return The key namespace, or `CacheKeyNamespace::Other` if the key is not
+   * built by `KeyEncoder`.
+   */
+  static CacheKeyNamespace GetKeyNamespace(const std::string& key);
+
+  /**
+   * @brief Gets the key of the same entry in the format of the older SDK
+   * versions, so the caches written by them can still be read.
+   *
+   * @param key The cache key built by `KeyEncoder`.
+   *
+   * @return The legacy cache key, or an empty string if the key is not built
+   * by `KeyEncoder` or the entry was not cached by the older SDK versions.
+   */
+  static std::string ToLegacyKey(const std::string& key);
+
+ private:
+  std::string catalog_prefix_;
+};
+
+}  // namespace cache
+}  // namespace olp
@@ -57,6 +57,25 @@ class CORE_API KeyValueCache {
    */
   using ValueTypePtr = std::shared_ptr<ValueType>;
 
+  /**
+   * @brief A single key-value pair of the batch put operation.
+   */
+  struct BatchItem {
+    /// The key for this value.
+    std::string key;
+    /// The value of any type.
+    boost::any value;
+    /// Encodes the value into a string.
+    Encoder encoder;
+    /// The expiry time (in seconds) of the key-value pair.
+    time_t expiry = kDefaultExpiry;
+  };
+
+  /**
+   * @brief The list of key-value pairs of the batch put operation.
+   */
+  using BatchItems = std::vector<BatchItem>;
+
   virtual ~KeyValueCache() = default;
 
   /**
@@ -103,6 +122,46 @@ class CORE_API KeyValueCache {
    */
   virtual ValueTypePtr Get(const std::string& key) = 0;
 
+  /**
+   * @brief Stores several key-value pairs in the cache at once.
+   *
+   * The default implementation stores the items one by one. Implementations
+   * that are backed by a persistent storage should override it to write all
+   * the items in one operation.
+   *
+   * @param items The key-value pairs that should be stored.
+   *
+   * @return True if all the items are stored; false otherwise.
+   */
+  virtual bool PutBatch(const BatchItems& items) {
+    bool result = true;
+    for (const auto& item : items) {
+      result &= Put(item.key, item.value, item.encoder, item.expiry);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Gets several key-value pairs from the cache at once.
+   *
+   * The default implementation looks up the keys one by one.
+   *
+   * @param keys The keys that are used to look for the key-value pairs.
+   * @param decoder Decodes the values from a string.
+   *
+   * @return The values in the same order as the keys. The value is empty if
+   * the key is not found.
+   */
+  virtual std::vector<boost::any> GetBatch(const std::vector<std::string>& keys,
+                                           const Decoder& decoder) {
+    std::vector<boost::any> values;
+    values.reserve(keys.size());
+    for (const auto& key : keys) {
+      values.emplace_back(Get(key, decoder));
+    }
+    return values;
+  }
+
   /**
    * @brief Removes the key-value pair from the cache.
    *
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <olp/core/CoreApi.h>
+#include "KeyValueCache.h"
+
+namespace olp {
+namespace cache {
+
+/**
+ * @brief Builds the memory-mapped protected cache file.
+ *
+ * The mapped cache is an immutable file that contains the sorted key index
+ * and the values. `DefaultCache` memory-maps the file if
+ * `CacheSettings::disk_path_protected` points to it, so the lookups do not
+ * decode any LevelDB blocks. Use it for large offline bundles that never
+ * change.
+ *
+ * The file is written to a temporary file next to `path` and moved to `path`
+ * by `Finish`, so a partially written file is never used.
+ */
+class CORE_API MappedCacheBuilder {
+ public:
+  /**
+   * @brief Creates the `MappedCacheBuilder` instance.
+   *
+   * @param path The path to the mapped cache file.
+   */
+  explicit MappedCacheBuilder(const std::string& path);
+  ~MappedCacheBuilder();
+
+  /**
+   * @brief Adds the key-value pair to the file.
+   *
+   * The pairs can be added in any order, but the keys must be unique.
+   *
+   * @param key The key for this value.
+   * @param value The binary data that should be stored.
+   *
+   * @return True if the operation is successful; false otherwise.
+   */
+  bool Add(const std::string& key, const KeyValueCache::ValueType& value);
+
+  /**
+   * @brief Adds the key-value pair to the file.
+   *
+   * @param key The key for this value.
+   * @param value The data that should be stored.
+   *
+   * @return True if the operation is successful; false otherwise.
+   */
+  bool Add(const std::string& key, const std::string& value);
+
+  /**
+   * @brief Writes the index and completes the file.
+   *
+   * @return True if the operation is successful; false otherwise, for
+   * example, if the same key was added twice.
+   */
+  bool Finish();
+
+  /**
+   * @brief Converts the disk cache to the mapped cache file.
+   *
+   * The internal keys and the expiry times are not converted, as the data of
+   * the protected cache never expires.
+   *
+   * @param disk_cache_path The path to the existing disk cache, for example,
+   * the mutable cache of the `DefaultCache` instance that is closed.
+   * @param path The path to the mapped cache file.
+   *
+   * @return True if the operation is successful; false otherwise.
+   */
+  static bool ConvertDiskCache(const std::string& disk_cache_path,
+                               const std::string& path);
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace cache
+}  // namespace olp
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace olp {
+namespace cache {
+
+/**
+ * @brief Describes the values that `DefaultCache::Warmup` loads from the disk
+ * caches into the in-memory cache.
+ */
+struct WarmupManifest {
+  /**
+   * @brief The path to the hot keys snapshot written by
+   * `DefaultCache::DumpHotKeys`.
+   *
+   * The keys of the snapshot are loaded first, in the snapshot order. Leave it
+   * empty to load only the keys that match `key_prefixes`.
+   */
+  std::string hot_keys_path;
+
+  /**
+   * @brief The prefixes of the keys to load.
+   *
+   * The prefixes are looked up in the mutable and in the protected disk
+   * caches, the memory-mapped protected cache can not be searched by prefix.
+   */
+  std::vector<std::string> key_prefixes;
+
+  /**
+   * @brief The maximum number of bytes to read from the disk caches.
+   *
+   * The warm-up stops once the budget is spent. The default value of zero
+   * uses `CacheSettings::max_memory_cache_size`, as the values read above it
+   * would only evict the ones loaded before.
+   */
+  std::uint64_t max_bytes = 0u;
+
+  /**
+   * @brief The number of the tasks that load the values in parallel on
+   * `CacheSettings::task_scheduler`.
+   */
+  size_t max_parallel_tasks = 4u;
+};
+
+}  // namespace cache
+}  // namespace olp
@@ -19,7 +19,9 @@
 
 #pragma once
 
+#include <memory>
 #include <sstream>
+#include <vector>
 
 #include <olp/core/CoreApi.h>
 #include <olp/core/http/NetworkTypes.h>
@@ -49,6 +51,14 @@ class CORE_API HttpResponse {
    */
   HttpResponse(int status, std::stringstream&& response)
       : status(status), response(std::move(response)) {}
+  /**
+   * @brief Creates the `HttpResponse` instance.
+   *
+   * @param status The HTTP status.
+   * @param body The response body in a shared buffer.
+   */
+  HttpResponse(int status, std::shared_ptr<std::vector<unsigned char>> body)
+      : status(status), body(std::move(body)) {}
 
   /**
    * @brief The HTTP status.
@@ -63,6 +73,19 @@ class CORE_API HttpResponse {
    * @brief The HTTP response.
    */
   std::stringstream response;
+  /**
+   * @brief The HTTP response body in a shared buffer.
+   *
+   * Set only for the successful responses of the requests that are executed
+   * with `OlpClient::CallApiToBuffer`. In this case, `response` is empty.
+   */
+  std::shared_ptr<std::vector<unsigned char>> body;
+  /**
+   * @brief The HTTP response headers.
+   *
+   * Empty if the request failed before the headers are received.
+   */
+  http::Headers headers;
 };
 
 }  // namespace client
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
@@ -29,6 +30,7 @@
 #include "OlpClientSettings.h"
 
 #include <olp/core/CoreApi.h>
+#include <olp/core/thread/Priority.h>
 
 namespace olp {
 namespace network {
@@ -36,6 +38,10 @@ class NetworkRequest;
 class NetworkConfig;
 }  // namespace network
 
+namespace thread {
+class DelayedTaskQueue;
+}  // namespace thread
+
 namespace client {
 /**
  * @brief Executes HTTP requests.
@@ -73,6 +79,22 @@ class CORE_API OlpClient {
    */
   void SetSettings(const OlpClientSettings& settings);
 
+  /**
+   * @brief Sets the priority of the network requests sent by this client.
+   *
+   * The default priority is `olp::thread::NORMAL`.
+   *
+   * @param priority The request priority, see `olp::thread::Priority`.
+   */
+  void SetPriority(std::uint32_t priority);
+
+  /**
+   * @brief Gets the priority of the network requests sent by this client.
+   *
+   * @return The request priority.
+   */
+  std::uint32_t GetPriority() const;
+
   /**
    * @brief Executes the HTTP request through the network stack.
    *
@@ -129,7 +151,89 @@ class CORE_API OlpClient {
                        std::string content_type,
                        CancellationContext context) const;
 
+  /**
+   * @brief Executes the HTTP request through the network stack in a blocking
+   * way and stores the response body in a shared buffer.
+   *
+   * The network writes the body of a successful response directly into
+   * `HttpResponse::body`, so large responses (for example, blobs) are not
+   * copied on the way to the caller. Error responses are returned in
+   * `HttpResponse::response` as with `CallApi`.
+   *
+   * @param path The path that is appended to the base URL.
+   * @param method Select one of the following methods: `GET`, `POST`, `DELETE`,
+   * or `PUT`.
+   * @param query_params The parameters that are appended to the URL path.
+   * @param header_params The headers used to customize the request.
+   * @param form_params For the `POST` request, populate `form_params` or
+   * `post_body`, but not both.
+   * @param post_body For the `POST` request, populate `form_params` or
+   * `post_body`, but not both. This data must not be modified until
+   * the request is completed.
+   * @param content_type The content type for the `post_body` or `form_params`.
+   * @param context The `CancellationContext` instance that is used to cancel
+   * the request.
+   *
+   * @return The `HttpResponse` instance.
+   */
+  HttpResponse CallApiToBuffer(
+      std::string path, std::string method,
+      std::multimap<std::string, std::string> query_params,
+      std::multimap<std::string, std::string> header_params,
+      std::multimap<std::string, std::string> form_params,
+      std::shared_ptr<std::vector<unsigned char>> post_body,
+      std::string content_type, CancellationContext context) const;
+
+  /**
+   * @brief Executes the HTTP request through the network stack in a blocking
+   * way and passes the response body to the data callback chunk by chunk, as
+   * it is received.
+   *
+   * The body is not collected in memory, so responses of any size are
+   * received with bounded memory. Every chunk is passed with its offset in
+   * the body, and a retried request starts again at the offset zero. Only
+   * the body of a successful (2xx) response is passed to the data callback,
+   * the body of an error response is returned in `HttpResponse::response`.
+   *
+   * The data callback is called on the network thread and is not called
+   * after this method returns.
+   *
+   * @param path The path that is appended to the base URL.
+   * @param method Select one of the following methods: `GET`, `POST`, `DELETE`,
+   * or `PUT`.
+   * @param query_params The parameters that are appended to the URL path.
+   * @param header_params The headers used to customize the request.
+   * @param form_params For the `POST` request, populate `form_params` or
+   * `post_body`, but not both.
+   * @param post_body For the `POST` request, populate `form_params` or
+   * `post_body`, but not both. This data must not be modified until
+   * the request is completed.
+   * @param content_type The content type for the `post_body` or `form_params`.
+   * @param data_callback Receives the chunks of the response body.
+   * @param context The `CancellationContext` instance that is used to cancel
+   * the request.
+   *
+   * @return The `HttpResponse` instance.
+   */
+  HttpResponse CallApiStream(
+      std::string path, std::string method,
+      std::multimap<std::string, std::string> query_params,
+      std::multimap<std::string, std::string> header_params,
+      std::multimap<std::string, std::string> form_params,
+      std::shared_ptr<std::vector<unsigned char>> post_body,
+      std::string content_type, http::Network::DataCallback data_callback,
+      CancellationContext context) const;
+
  private:
+  HttpResponse CallApiBlocking(
+      const std::string& path, const std::string& method,
+      const std::multimap<std::string, std::string>& query_params,
+      const std::multimap<std::string, std::string>& header_params,
+      const std::shared_ptr<std::vector<unsigned char>>& post_body,
+      const std::string& content_type, CancellationContext context,
+      bool to_buffer,
+      const http::Network::DataCallback& data_callback = nullptr) const;
+
   std::shared_ptr<http::NetworkRequest> CreateRequest(
       const std::string& path, const std::string& method,
       const std::multimap<std::string, std::string>& query_params,
@@ -141,6 +245,10 @@ class CORE_API OlpClient {
   std::string base_url_;
   std::multimap<std::string, std::string> default_headers_;
   OlpClientSettings settings_;
+  std::uint32_t priority_{thread::NORMAL};
+  /// The timer of the retries when the settings have no task scheduler. The
+  /// retries that still wait are cancelled when the client is destroyed.
+  std::shared_ptr<thread::DelayedTaskQueue> delayed_tasks_;
 };
 
 }  // namespace client
@@ -32,6 +32,7 @@ struct CacheSettings;
 
 namespace http {
 class Network;
+struct NetworkInitializationSettings;
 }  // namespace http
 
 namespace client {
@@ -63,6 +64,17 @@ class CORE_API OlpClientSettingsFactory final {
   static std::shared_ptr<http::Network> CreateDefaultNetworkRequestHandler(
       size_t max_requests_count = 30u);
 
+  /**
+   * @brief Creates the `Network` instance with the given handles pool and
+   * pending requests queue limits.
+   *
+   * @param settings The network settings.
+   *
+   * @return The `Network` instance.
+   */
+  static std::shared_ptr<http::Network> CreateDefaultNetworkRequestHandler(
+      const http::NetworkInitializationSettings& settings);
+
   /**
    * @brief Creates the `KeyValueCache` instance that includes both a small
    * in-memory LRU cache and a larger persistent database cache.
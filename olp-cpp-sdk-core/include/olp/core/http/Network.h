@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -26,6 +27,7 @@
 #include <olp/core/CoreApi.h>
 #include <olp/core/http/NetworkRequest.h>
 #include <olp/core/http/NetworkResponse.h>
+#include <olp/core/http/NetworkStatistics.h>
 #include <olp/core/http/NetworkTypes.h>
 
 namespace olp {
@@ -64,7 +66,9 @@ class CORE_API Network {
    * been received. Each HTTP header entry will result in a callback.
    * @param[in] data_callback Callback to be called when a chunk of data is
    * received. This callback can be triggered multiple times all prior to the
-   * final Callback call.
+   * final Callback call. Only the body of a response with a successful (2xx)
+   * status is passed to it, and such a body is not written to the payload.
+   * The body of other responses is written to the payload only.
    * @return SendOutcome which represent either a valid \c RequestId as the
    * unique request identifier or a \c ErrorCode in case of failure. In case of
    * failure no callbacks will be triggered.
@@ -81,12 +85,61 @@ class CORE_API Network {
    * @param[in] id The unique RequestId of the request to be cancelled.
    */
   virtual void Cancel(RequestId id) = 0;
+
+  /**
+   * @brief Get the statistics collected since the network was created.
+   * Implementations that do not collect statistics return zero counters.
+   * @return The statistics snapshot.
+   */
+  virtual NetworkStatistics GetStatistics() const { return {}; }
+};
+
+/**
+ * @brief The settings of the default Network implementation.
+ */
+struct CORE_API NetworkInitializationSettings {
+  /// The maximum number of the requests sent in parallel.
+  size_t max_requests_count = 30u;
+  /// The number of the request handles that are kept open while idle. The
+  /// handles pool grows up to `max_requests_count` under load, and the extra
+  /// handles are closed after `handle_idle_timeout`.
+  size_t min_requests_count = 8u;
+  /// The maximum number of the requests that wait for a free handle when
+  /// `max_requests_count` requests are in flight. The waiting requests with
+  /// a higher `NetworkRequest::GetPriority` are sent first. When the queue is
+  /// full, `Network::Send` fails with `ErrorCode::NETWORK_OVERLOAD_ERROR`.
+  /// Zero disables the queue.
+  size_t max_pending_requests_count = 1024u;
+  /// The time after which the idle handles above `min_requests_count` are
+  /// closed.
+  std::chrono::seconds handle_idle_timeout{120};
+  /// The maximum number of the connections opened to one host, 0 means no
+  /// limit. The requests over the limit wait for a free connection.
+  size_t max_connections_per_host = 0u;
+  /// The maximum number of the concurrent HTTP/2 streams multiplexed over one
+  /// connection.
+  size_t max_streams_per_connection = 100u;
 };
 
 /**
  * @brief Create default Network implementation.
+ *
+ * The pool keeps a quarter of `max_requests_count` handles open while idle,
+ * and the other settings are defaulted, see `NetworkInitializationSettings`.
  */
 CORE_API std::shared_ptr<Network> CreateDefaultNetwork(size_t max_requests_count);
 
+/**
+ * @brief Create default Network implementation.
+ *
+ * @note Only the cURL based implementation supports the pending requests
+ * queue, the handles pool limits and the connection limits, the other
+ * implementations use only `NetworkInitializationSettings::max_requests_count`.
+ *
+ * @param[in] settings The network settings.
+ */
+CORE_API std::shared_ptr<Network> CreateDefaultNetwork(
+    NetworkInitializationSettings settings);
+
 }  // namespace http
 }  // namespace olp
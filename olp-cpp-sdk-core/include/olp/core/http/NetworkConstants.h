@@ -30,7 +30,13 @@ namespace http {
  */
 static constexpr auto kAuthorizationHeader = "Authorization";
 static constexpr auto kContentTypeHeader = "Content-Type";
+static constexpr auto kContentLengthHeader = "Content-Length";
+static constexpr auto kContentRangeHeader = "Content-Range";
 static constexpr auto kUserAgentHeader = "User-Agent";
+static constexpr auto kETagHeader = "ETag";
+static constexpr auto kIfNoneMatchHeader = "If-None-Match";
+static constexpr auto kLastModifiedHeader = "Last-Modified";
+static constexpr auto kIfModifiedSinceHeader = "If-Modified-Since";
 
 /**
  * Custom constants
@@ -26,6 +26,7 @@
 
 #include <olp/core/CoreApi.h>
 #include <olp/core/http/NetworkSettings.h>
+#include <olp/core/thread/Priority.h>
 
 namespace olp {
 namespace http {
@@ -122,6 +123,24 @@ class CORE_API NetworkRequest final {
    */
   NetworkRequest& WithSettings(NetworkSettings settings);
 
+  /**
+   * @brief Get the priority of this request.
+   * @return The request priority.
+   */
+  std::uint32_t GetPriority() const;
+
+  /**
+   * @brief Set the priority of this request.
+   *
+   * When all the network connections are busy, the waiting requests with
+   * a higher priority are sent first. The default priority is
+   * `olp::thread::NORMAL`.
+   *
+   * @param[in] priority The request priority, see `olp::thread::Priority`.
+   * @return reference to *this.
+   */
+  NetworkRequest& WithPriority(std::uint32_t priority);
+
  private:
   /// HTTP request method.
   HttpVerb verb_{HttpVerb::GET};
@@ -133,6 +152,8 @@ class CORE_API NetworkRequest final {
   RequestBodyType body_;
   /// Network settings for this request.
   NetworkSettings settings_;
+  /// Priority of the request in the queue of the waiting requests.
+  std::uint32_t priority_{thread::NORMAL};
 };
 
 }  // namespace http
@@ -86,6 +86,24 @@ class CORE_API NetworkSettings final {
    */
   NetworkSettings& WithProxySettings(NetworkProxySettings settings);
 
+  /**
+   * @brief Check whether HTTP/2 multiplexing is enabled.
+   * @return @c true if HTTP/2 multiplexing is enabled, @c false otherwise.
+   */
+  bool GetHttp2Multiplexing() const;
+
+  /**
+   * @brief Enable or disable HTTP/2 multiplexing.
+   *
+   * When enabled, HTTP/2 is negotiated for the HTTPS requests, and the request
+   * waits for a stream on an already open connection to the same host instead
+   * of opening a new connection. When disabled, HTTP/1.1 is used.
+   *
+   * @param[in] enable @c true to enable HTTP/2 multiplexing.
+   * @return reference to *this.
+   */
+  NetworkSettings& WithHttp2Multiplexing(bool enable);
+
  private:
   /// Maximum number of retries for HTTP request.
   std::size_t retries_{3};
@@ -95,6 +113,8 @@ class CORE_API NetworkSettings final {
   int transfer_timeout_{30};
   /// Network proxy settings.
   NetworkProxySettings proxy_settings_;
+  /// Enables HTTP/2 multiplexing.
+  bool http2_multiplexing_{true};
 };
 
 }  // namespace http
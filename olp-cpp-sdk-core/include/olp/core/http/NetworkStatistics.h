@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include <olp/core/CoreApi.h>
+
+namespace olp {
+namespace http {
+
+/**
+ * @brief The counters of the network requests and connections.
+ */
+struct CORE_API NetworkStatistics {
+  /// The requests that are completed, including the failed ones.
+  std::uint64_t requests_completed = 0u;
+  /// The new connections opened by the completed requests.
+  std::uint64_t connections_opened = 0u;
+  /// The completed requests that reused an already open connection.
+  std::uint64_t connections_reused = 0u;
+  /// The completed requests that were served over HTTP/2.
+  std::uint64_t http2_requests = 0u;
+
+  /// The requests that waited in the pending queue for a free handle.
+  std::uint64_t requests_queued = 0u;
+  /// The requests rejected because the pending queue was full.
+  std::uint64_t requests_rejected = 0u;
+  /// The requests that are waiting in the pending queue.
+  std::uint64_t pending_requests = 0u;
+  /// The largest number of the requests that waited in the pending queue at
+  /// once.
+  std::uint64_t peak_pending_requests = 0u;
+  /// The total time that the dequeued requests waited for a free handle.
+  std::chrono::microseconds total_queue_wait_time{0};
+  /// The longest time that a request waited for a free handle.
+  std::chrono::microseconds max_queue_wait_time{0};
+  /// The request handles that are currently open in the handles pool.
+  std::uint64_t open_handles = 0u;
+};
+
+}  // namespace http
+}  // namespace olp
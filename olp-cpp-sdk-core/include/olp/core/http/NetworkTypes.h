@@ -22,6 +22,8 @@
 #include <cstdint>
 #include <limits>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <olp/core/CoreApi.h>
 
@@ -37,6 +39,16 @@ namespace http {
  */
 using RequestId = std::uint64_t;
 
+/**
+ * @brief The HTTP header: the name and the value.
+ */
+using Header = std::pair<std::string, std::string>;
+
+/**
+ * @brief The list of the HTTP headers.
+ */
+using Headers = std::vector<Header>;
+
 /**
  * @brief List of special values for NetworkRequestId.
  */
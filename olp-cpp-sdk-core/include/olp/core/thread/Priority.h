@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace olp {
+namespace thread {
+
+/**
+ * @brief The predefined priorities of the work items, for example, network
+ * requests.
+ *
+ * Any other value can be used as well; the work with a higher priority is
+ * served first.
+ */
+enum Priority : std::uint32_t {
+  LOW = 100,    /*!< The background work, for example, prefetching. */
+  NORMAL = 500, /*!< The default priority. */
+  HIGH = 1000   /*!< The work that the user is waiting for. */
+};
+
+/**
+ * @brief The waiting time that raises the priority of the queued work by one.
+ *
+ * The queued work is aged, so the low priority work is not starved by
+ * the high priority work. For example, a `HIGH` task is served before
+ * the `LOW` tasks queued up to 9 seconds earlier, while a `NORMAL` task that
+ * waits for more than 5 seconds is served before a new `HIGH` task.
+ */
+constexpr std::chrono::milliseconds kPriorityAgingInterval{10};
+
+/**
+ * @brief Gets the time that orders the queued work; the work with
+ * the earlier time is served first.
+ *
+ * @param enqueue_time The time when the work is queued.
+ * @param priority The priority of the work.
+ *
+ * @return The enqueue time moved back by the priority, see
+ * `kPriorityAgingInterval`.
+ */
+inline std::chrono::steady_clock::time_point AgedEnqueueTime(
+    std::chrono::steady_clock::time_point enqueue_time,
+    std::uint32_t priority) {
+  return enqueue_time - priority * kPriorityAgingInterval;
+}
+
+}  // namespace thread
+}  // namespace olp
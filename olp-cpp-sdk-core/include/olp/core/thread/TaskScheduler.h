@@ -19,12 +19,20 @@
 
 #pragma once
 
+#include <chrono>
+#include <memory>
+#include <mutex>
+
 #include <olp/core/client/ApiResponse.h>
 #include <olp/core/client/CancellationContext.h>
+#include <olp/core/thread/Priority.h>
+#include <olp/core/utils/WarningWorkarounds.h>
 
 namespace olp {
 namespace thread {
 
+class DelayedTaskQueue;
+
 /**
  * @brief The TaskScheduler class is an abstract interface to be used as base
  * for a custom thread scheduling strategy.
@@ -39,13 +47,22 @@ class CORE_API TaskScheduler {
   /// Alias for abstract interface input.
   using CallFuncType = std::function<void()>;
 
-  virtual ~TaskScheduler() = default;
+  TaskScheduler();
+
+  /**
+   * @brief Destroys the delayed tasks that still wait on the timer of
+   * the default `EnqueueDelayedTask` implementation without running them.
+   */
+  virtual ~TaskScheduler();
 
   /**
    * @brief Use this method to schedule a asynchronous task.
    * @param[in] func The callable target to be added to the scheduling pipeline.
+   * @param[in] priority The priority of the task, see `olp::thread::Priority`.
    */
-  void ScheduleTask(CallFuncType&& func) { EnqueueTask(std::move(func)); }
+  void ScheduleTask(CallFuncType&& func, std::uint32_t priority = NORMAL) {
+    EnqueueTask(std::move(func), priority);
+  }
 
   /**
    * @brief Use this methods to schedule a asynchronous cancellable task.
@@ -55,6 +72,7 @@ class CORE_API TaskScheduler {
    * @code
    *     void func(CancellationContext& context);
    * @encode
+   * @param[in] priority The priority of the task, see `olp::thread::Priority`.
    * @return Returns a \c CancellationContext copy to the caller which can be
    * used to cancel the enqueued tasks. Tasks can only be cancelled before
    * execution or during execution if the task itself is designed to support
@@ -64,17 +82,37 @@ class CORE_API TaskScheduler {
   template <class Function, typename std::enable_if<!std::is_convertible<
                                 decltype(std::declval<Function>()),
                                 CallFuncType>::value>::type* = nullptr>
-  client::CancellationContext ScheduleTask(Function&& func) {
+  client::CancellationContext ScheduleTask(Function&& func,
+                                           std::uint32_t priority = NORMAL) {
     client::CancellationContext context;
     auto task = [func, context]() {
       if (!context.IsCancelled()) {
         func(context);
       };
     };
-    EnqueueTask(std::move(task));
+    EnqueueTask(std::move(task), priority);
     return context;
   }
 
+  /**
+   * @brief Use this method to schedule a asynchronous task that is executed
+   * after the delay.
+   *
+   * Waiting for the delay does not block any thread, so use it instead of
+   * sleeping in a task, for example, to back off before a retry.
+   *
+   * @note The tasks that are still waiting when the scheduler is destroyed
+   * are destroyed without being run.
+   *
+   * @param[in] func The callable target to be added to the scheduling pipeline.
+   * @param[in] delay The time after which the task is executed.
+   * @param[in] priority The priority of the task, see `olp::thread::Priority`.
+   */
+  void ScheduleDelayedTask(CallFuncType&& func, std::chrono::milliseconds delay,
+                           std::uint32_t priority = NORMAL) {
+    EnqueueDelayedTask(std::move(func), delay, priority);
+  }
+
  protected:
   /**
    * @brief Abstract enqueue task interface to be implemented by
@@ -89,6 +127,43 @@ class CORE_API TaskScheduler {
    * kept, once called you own the task.
    */
   virtual void EnqueueTask(CallFuncType&&) = 0;
+
+  /**
+   * @brief Enqueue task interface that takes the task priority into account.
+   *
+   * Override this method to serve the tasks with a higher priority first.
+   * The default implementation ignores the priority.
+   *
+   * @param[in] func Rvalue reference of the task to be enqueued.
+   * @param[in] priority The priority of the task, see
+   * `olp::thread::Priority`.
+   */
+  virtual void EnqueueTask(CallFuncType&& func, std::uint32_t priority) {
+    CORE_UNUSED(priority);
+    EnqueueTask(std::move(func));
+  }
+
+  /**
+   * @brief Enqueue delayed task interface.
+   *
+   * Override this method to execute the delayed tasks on the scheduler
+   * threads. The default implementation waits for the delay on a timer thread
+   * owned by this scheduler and executes the task on that thread, so the task
+   * should not block.
+   *
+   * @param[in] func Rvalue reference of the task to be enqueued.
+   * @param[in] delay The time after which the task is executed.
+   * @param[in] priority The priority of the task, see
+   * `olp::thread::Priority`.
+   */
+  virtual void EnqueueDelayedTask(CallFuncType&& func,
+                                  std::chrono::milliseconds delay,
+                                  std::uint32_t priority);
+
+ private:
+  /// The timer of the default `EnqueueDelayedTask`, created on first use.
+  std::unique_ptr<DelayedTaskQueue> delayed_tasks_;
+  std::mutex delayed_tasks_mutex_;
 };
 
 }  // namespace thread
@@ -19,6 +19,9 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -28,6 +31,19 @@
 namespace olp {
 namespace thread {
 
+class DelayedTaskQueue;
+
+/**
+ * @brief The task scheduler that executes the tasks on a pool of threads.
+ *
+ * The tasks with a higher priority are executed first. The priority of
+ * the waiting tasks is aged, see `olp::thread::kPriorityAgingInterval`, and
+ * the tasks with the same priority are executed in the order they were
+ * scheduled in.
+ *
+ * The delayed tasks wait on one timer thread, that is started when the first
+ * delayed task is scheduled, and are executed on the pool threads.
+ */
 class CORE_API ThreadPoolTaskScheduler final : public TaskScheduler {
  public:
   /**
@@ -53,11 +69,52 @@ class CORE_API ThreadPoolTaskScheduler final : public TaskScheduler {
   /// the next free thread from the thread pool.
   void EnqueueTask(TaskScheduler::CallFuncType&& func) override;
 
+  /// Override base class method to enqueue tasks and execute them in
+  /// the order of the aged priority.
+  void EnqueueTask(TaskScheduler::CallFuncType&& func,
+                   std::uint32_t priority) override;
+
+  /// Override base class method to enqueue the tasks to the thread pool
+  /// after the delay.
+  void EnqueueDelayedTask(TaskScheduler::CallFuncType&& func,
+                          std::chrono::milliseconds delay,
+                          std::uint32_t priority) override;
+
  private:
+  /// The task waiting in the queue.
+  struct PrioritizedTask {
+    /// The task to execute.
+    TaskScheduler::CallFuncType function;
+    /// The time that orders the tasks, see `AgedEnqueueTime`.
+    std::chrono::steady_clock::time_point order;
+    /// Orders the tasks with the same time in the queue order.
+    std::uint64_t sequence;
+  };
+
+  /// The heap of the tasks that mimics the API of std::queue used by
+  /// SyncQueue, the task with the earliest order is at the front.
+  class PriorityQueue {
+   public:
+    bool empty() const;
+    void push(PrioritizedTask&& task);
+    void push(const PrioritizedTask& task);
+    PrioritizedTask& front();
+    void pop();
+
+   private:
+    static bool IsLater(const PrioritizedTask& lhs,
+                        const PrioritizedTask& rhs);
+
+    std::vector<PrioritizedTask> heap_;
+    std::uint64_t sequence_{0};
+  };
+
   /// Thread pool created in constructor.
   std::vector<std::thread> thread_pool_;
   /// SyncQueue used to manage tasks.
-  SyncQueueFifo<TaskScheduler::CallFuncType> sync_queue_;
+  SyncQueue<PrioritizedTask, PriorityQueue> sync_queue_;
+  /// The timer that enqueues the delayed tasks.
+  std::unique_ptr<DelayedTaskQueue> delayed_tasks_;
 };
 
 }  // namespace thread
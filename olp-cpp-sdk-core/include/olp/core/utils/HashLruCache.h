@@ -0,0 +1,613 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <olp/core/utils/LruCache.h>
+
+namespace olp {
+namespace utils {
+/**
+ * @brief Generic key-value LRU cache based on a hash table.
+ *
+ * Provides the same interface as `LruCache`, but the lookups, insertions and
+ * removals take constant time. The items are stored in one contiguous array
+ * and are linked into the LRU list by their indexes, and the keys are looked
+ * up in an open-addressing hash table with linear probing.
+ *
+ * The keys are not ordered. If the items need to be removed by a key range
+ * (for example, by a key prefix), set `OrderedIndex` to true. The cache then
+ * maintains a sorted index of the keys and provides `EraseWhile`.
+ *
+ * `Key` and `Value` must be default constructible and move assignable.
+ */
+template <typename Key, typename Value,
+          typename CacheCostFunc = CacheCost<Value>,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>, bool OrderedIndex = false>
+class HashLruCache {
+  static constexpr std::size_t kNone = std::numeric_limits<std::size_t>::max();
+  // Marks the released nodes in `Node::previous`.
+  static constexpr std::size_t kFree = kNone - 1u;
+  // The number of hash table slots, must be a power of two.
+  static constexpr std::size_t kInitialCapacity = 16u;
+
+  // Node contains the key, the value and the indexes of the previous and next
+  // nodes in the LRU chain. Free nodes are chained by `next`.
+  struct Node {
+    Key key;
+    Value value;
+    std::size_t hash;
+    std::size_t cost;
+    std::size_t previous;
+    std::size_t next;
+  };
+
+ public:
+  /// typedef for eviction function
+  using EvictionFunction = std::function<void(const Key&, Value&&)>;
+
+  class ValueType {
+   public:
+    const Key& key() const { return cache_->nodes_[index_].key; }
+    const Value& value() const { return cache_->nodes_[index_].value; }
+
+    /// The handle of the item, valid until the item is removed from the cache.
+    std::size_t handle() const { return index_; }
+
+   protected:
+    const HashLruCache* cache_ = nullptr;
+    std::size_t index_ = kNone;
+  };
+
+  class const_iterator : public ValueType {
+   public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef std::ptrdiff_t difference_type;
+    typedef ValueType value_type;
+    typedef const value_type& reference;
+    typedef const value_type* pointer;
+
+    const_iterator() = default;
+    const_iterator(const const_iterator&) = default;
+    const_iterator& operator=(const const_iterator&) = default;
+
+    bool operator==(const const_iterator& other) const {
+      return this->index_ == other.index_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return !operator==(other);
+    }
+
+    const_iterator& operator++() {
+      this->index_ = this->cache_->nodes_[this->index_].next;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      auto old_value = *this;
+      operator++();
+      return old_value;
+    }
+
+    const_iterator& operator--() {
+      this->index_ = this->index_ == kNone
+                         ? this->cache_->last_
+                         : this->cache_->nodes_[this->index_].previous;
+      return *this;
+    }
+    const_iterator operator--(int) {
+      auto old_value = *this;
+      operator--();
+      return old_value;
+    }
+
+    reference operator*() const { return *this; }
+    pointer operator->() const { return this; }
+
+   private:
+    friend class HashLruCache;
+
+    const_iterator(const HashLruCache* cache, std::size_t index) {
+      this->cache_ = cache;
+      this->index_ = index;
+    }
+  };
+
+  /**
+   * @brief HashLruCache constructor
+   * @param maxSize the maximum size of values this cache will keep
+   * @param cacheCostFunc the function this cache uses to compute the
+   *        caching cost of each cached value
+   * @param hash Function object for hashing keys
+   * @param equal Function object for comparing keys
+   */
+  explicit HashLruCache(std::size_t maxSize = 0,
+                        CacheCostFunc cacheCostFunc = CacheCostFunc(),
+                        Hash hash = Hash(), KeyEqual equal = KeyEqual())
+      : cache_cost_func_(std::move(cacheCostFunc)),
+        hash_(std::move(hash)),
+        equal_(std::move(equal)),
+        max_size_(maxSize) {}
+
+  /// deleted copy constructor
+  HashLruCache(const HashLruCache&) = delete;
+  /// default move constructor
+  HashLruCache(HashLruCache&&) = default;
+
+  /// deleted assignment operator
+  HashLruCache& operator=(const HashLruCache&) = delete;
+  /// default move assignment operator
+  HashLruCache& operator=(HashLruCache&&) = default;
+
+  /**
+   * @brief insert a key/value to the cache
+   *
+   * Note - if the key already exists in the cache, it will be promoted in the
+   * LRU, but its value and cost will not be updated. Use insertOrAssign instead
+   * to update/insert existing values.
+   *
+   * @param key the key to add
+   * @param value the value to add
+   * @return a pair of bool and iterator, see `LruCache::Insert`.
+   */
+  template <typename _Key, typename _Value>
+  std::pair<const_iterator, bool> Insert(_Key&& key, _Value&& value) {
+    Value new_value(std::forward<_Value>(value));
+    const auto cost = cache_cost_func_(new_value);
+    if (cost > max_size_) {
+      return std::make_pair(end(), false);
+    }
+
+    Key new_key(std::forward<_Key>(key));
+    Reserve();
+    const auto hash = hash_(new_key);
+    const auto slot = FindSlot(new_key, hash);
+    if (slots_[slot] != kNone) {
+      Promote(slots_[slot]);
+      return std::make_pair(const_iterator{this, slots_[slot]}, false);
+    }
+
+    return std::make_pair(
+        AddNode(slot, std::move(new_key), std::move(new_value), hash, cost),
+        true);
+  }
+
+  /**
+   * @brief insert a key/value to the cache or update an existing key/value pair
+   *
+   * Note - if the key already exists in the cache, its value and cost will be
+   * updated, use insert() instead to not update existing key/value pairs.
+   *
+   * @param key the key to add
+   * @param value the value to add
+   * @return a pair of bool and iterator, see `LruCache::InsertOrAssign`.
+   */
+  template <typename _Value>
+  std::pair<const_iterator, bool> InsertOrAssign(Key key, _Value&& value) {
+    Value new_value(std::forward<_Value>(value));
+    const auto cost = cache_cost_func_(new_value);
+    Reserve();
+    const auto hash = hash_(key);
+    const auto slot = FindSlot(key, hash);
+    if (cost > max_size_) {
+      if (slots_[slot] != kNone) {
+        EraseSlot(slot, false);
+      }
+      return std::make_pair(end(), false);
+    }
+
+    if (slots_[slot] != kNone) {
+      // element already exists, update it
+      const auto index = slots_[slot];
+      auto& node = nodes_[index];
+      node.value = std::move(new_value);
+      size_ = size_ - node.cost + cost;
+      node.cost = cost;
+      Promote(index);
+      Evict();
+      return std::make_pair(const_iterator{this, index}, false);
+    }
+
+    return std::make_pair(
+        AddNode(slot, std::move(key), std::move(new_value), hash, cost), true);
+  }
+
+  /**
+   * @brief erase - removes an item from the cache
+   * @param key the key to erase
+   * @return true if the key existed and was removed from the cache, false
+   * otherwise.
+   */
+  bool Erase(const Key& key) {
+    if (count_ == 0) {
+      return false;
+    }
+
+    const auto slot = FindSlot(key, hash_(key));
+    if (slots_[slot] == kNone) {
+      return false;
+    }
+
+    EraseSlot(slot, false);
+    return true;
+  }
+
+  const_iterator Erase(const_iterator& it) {
+    auto prev = it++;
+
+    Erase(prev->key());
+
+    return it;
+  }
+
+  /**
+   * @brief Erases the items in the key order, starting from the first key that
+   * is not less than `first`, while `predicate` returns true for the key.
+   *
+   * Available only with the ordered index. For example, erases all the keys
+   * that start with a prefix, when `first` is the prefix.
+   *
+   * @param first the key to start from
+   * @param predicate the function that is called with every key
+   * @return the number of erased items
+   */
+  template <typename Predicate>
+  std::size_t EraseWhile(const Key& first, Predicate predicate) {
+    static_assert(OrderedIndex, "EraseWhile requires the ordered index");
+
+    std::size_t erased = 0;
+    auto it = ordered_keys_.lower_bound(first);
+    while (it != ordered_keys_.end() && predicate(*it)) {
+      const Key key = *it++;
+      Erase(key);
+      ++erased;
+    }
+    return erased;
+  }
+
+  /**
+   * @brief size the current size of the cache
+   * @return the size
+   */
+  std::size_t Size() const { return size_; }
+
+  /**
+   * @brief size the maximum size of the cache
+   * @return the maximum size
+   */
+  std::size_t GetMaxSize() const { return max_size_; }
+
+  /**
+   * @brief resize sets a new maximum size of the cache.
+   *
+   * If the new maximum size is smaller than the current size, items are evicted
+   * until the cache shrinks to less than or equal the new maximum size.
+   *
+   * @param maxSize the new maximum size of the cache
+   */
+  void Resize(std::size_t maxSize) {
+    max_size_ = maxSize;
+    Evict();
+  }
+
+  /**
+   * @brief find an value in the cache
+   *
+   * Note - this function will promote the item pointed to by key if found
+   *
+   * @param key the key to find
+   * @return an iterator to the value if found, otherwise, an iterator pointing
+   * to end()
+   */
+  const_iterator Find(const Key& key) {
+    auto it = FindNoPromote(key);
+    if (it != end()) {
+      Promote(it.index_);
+    }
+    return it;
+  }
+
+  /**
+   * @brief find an value in the cache
+   *
+   * Note - this function will NOT promote the item pointed to by key if found
+   *
+   * @param key the key to find
+   * @return an iterator to the value if found, otherwise, an iterator pointing
+   * to end()
+   */
+  const_iterator FindNoPromote(const Key& key) const {
+    if (count_ == 0) {
+      return end();
+    }
+
+    return const_iterator{this, slots_[FindSlot(key, hash_(key))]};
+  }
+
+  /**
+   * @brief find an value in the cache
+   *
+   * Note - this function will promote the item pointed to by key if found
+   *
+   * @param key the key to find
+   * @param nullValue the value to return if the key/value pair is not in the
+   * cache
+   * @return a const reference to the value, or nullValue if not found
+   */
+  const Value& Find(const Key& key, const Value& nullValue) {
+    auto it = Find(key);
+    return it == end() ? nullValue : it.value();
+  }
+
+  /**
+   * @brief returns the iterator to the item with the given handle
+   *
+   * Note - the handle must belong to an item that is still in the cache.
+   *
+   * @param handle the handle returned by `ValueType::handle`
+   * @return an iterator to the item
+   */
+  const_iterator FromHandle(std::size_t handle) const {
+    return const_iterator{this, handle};
+  }
+
+  /**
+   * @brief promotes the item with the given handle in the LRU
+   *
+   * Unlike `FromHandle`, accepts the handles of the removed items and does
+   * nothing for them. If the handle was reused for another item, that item is
+   * promoted.
+   *
+   * @param handle the handle returned by `ValueType::handle`
+   * @return true if the handle belongs to an item in the cache
+   */
+  bool PromoteHandle(std::size_t handle) {
+    if (handle >= nodes_.size() || nodes_[handle].previous == kFree) {
+      return false;
+    }
+
+    Promote(handle);
+    return true;
+  }
+
+  /// returns the begin iterator, the most recently used item.
+  const_iterator begin() const { return const_iterator{this, first_}; }
+
+  /// returns the end iterator
+  const_iterator end() const { return const_iterator{this, kNone}; }
+
+  /**
+   * @brief clear removes all items from cache
+   * Removes all content, but does not reset the eviction callback or maximum
+   * size
+   */
+  void Clear() {
+    nodes_.clear();
+    slots_.clear();
+    ordered_keys_.clear();
+    first_ = last_ = free_ = kNone;
+    count_ = 0u;
+    size_ = 0u;
+  }
+
+  /**
+   * @brief setEvictionCallback set a function that is invoked when a value is
+   * evicted from the cache Note - the function must not modify the cache in the
+   * callback. The value can be safely moved, if not, it will be destroyed when
+   * the function returns.
+   *
+   * To reset the eviction callback, pass a nullptr
+   *
+   * @param func the function to be called on eviction
+   */
+  void SetEvictionCallback(EvictionFunction func) {
+    eviction_callback_ = std::move(func);
+  }
+
+ private:
+  // Allocates the table on the first insertion.
+  void Reserve() {
+    if (slots_.empty()) {
+      slots_.assign(kInitialCapacity, kNone);
+    }
+  }
+
+  // Returns the slot that holds the key, or the empty slot where the key
+  // should be inserted. The table always has at least one empty slot.
+  std::size_t FindSlot(const Key& key, std::size_t hash) const {
+    const auto mask = slots_.size() - 1u;
+    auto slot = hash & mask;
+    while (slots_[slot] != kNone) {
+      const auto& node = nodes_[slots_[slot]];
+      if (node.hash == hash && equal_(node.key, key)) {
+        break;
+      }
+      slot = (slot + 1u) & mask;
+    }
+    return slot;
+  }
+
+  const_iterator AddNode(std::size_t slot, Key key, Value value,
+                         std::size_t hash, std::size_t cost) {
+    // Keep the load factor at or below 3/4.
+    if ((count_ + 1u) * 4u > slots_.size() * 3u) {
+      Rehash(slots_.size() * 2u);
+      slot = FindSlot(key, hash);
+    }
+
+    if (OrderedIndex) {
+      ordered_keys_.insert(key);
+    }
+
+    std::size_t index = free_;
+    if (index != kNone) {
+      free_ = nodes_[index].next;
+      auto& node = nodes_[index];
+      node.key = std::move(key);
+      node.value = std::move(value);
+      node.hash = hash;
+      node.cost = cost;
+    } else {
+      index = nodes_.size();
+      nodes_.push_back(
+          Node{std::move(key), std::move(value), hash, cost, kNone, kNone});
+    }
+
+    slots_[slot] = index;
+    LinkFront(index);
+    ++count_;
+    size_ += cost;
+    Evict();
+    return const_iterator{this, index};
+  }
+
+  void EraseSlot(std::size_t slot, bool doEvictionCallback) {
+    const auto index = slots_[slot];
+    auto& node = nodes_[index];
+
+    Unlink(index);
+    ReleaseSlot(slot);
+    if (OrderedIndex) {
+      ordered_keys_.erase(node.key);
+    }
+    --count_;
+    size_ -= node.cost;
+
+    if (doEvictionCallback && eviction_callback_) {
+      eviction_callback_(node.key, std::move(node.value));
+    }
+
+    node.key = Key();
+    node.value = Value();
+    node.previous = kFree;
+    node.next = free_;
+    free_ = index;
+  }
+
+  // Backward shift deletion, so no tombstones are left in the table.
+  void ReleaseSlot(std::size_t slot) {
+    const auto mask = slots_.size() - 1u;
+    auto hole = slot;
+    auto next = (slot + 1u) & mask;
+    while (slots_[next] != kNone) {
+      const auto ideal = nodes_[slots_[next]].hash & mask;
+      if (((next - ideal) & mask) >= ((next - hole) & mask)) {
+        slots_[hole] = slots_[next];
+        hole = next;
+      }
+      next = (next + 1u) & mask;
+    }
+    slots_[hole] = kNone;
+  }
+
+  void Rehash(std::size_t capacity) {
+    slots_.assign(capacity, kNone);
+    const auto mask = capacity - 1u;
+    for (auto index = first_; index != kNone; index = nodes_[index].next) {
+      auto slot = nodes_[index].hash & mask;
+      while (slots_[slot] != kNone) {
+        slot = (slot + 1u) & mask;
+      }
+      slots_[slot] = index;
+    }
+  }
+
+  void LinkFront(std::size_t index) {
+    auto& node = nodes_[index];
+    node.previous = kNone;
+    node.next = first_;
+    if (first_ != kNone) {
+      nodes_[first_].previous = index;
+    } else {
+      last_ = index;
+    }
+    first_ = index;
+  }
+
+  void Unlink(std::size_t index) {
+    auto& node = nodes_[index];
+    if (node.previous != kNone) {
+      nodes_[node.previous].next = node.next;
+    } else {
+      first_ = node.next;
+    }
+
+    if (node.next != kNone) {
+      nodes_[node.next].previous = node.previous;
+    } else {
+      last_ = node.previous;
+    }
+  }
+
+  void Promote(std::size_t index) {
+    if (index == first_) return;  // nothing to do
+
+    Unlink(index);
+    LinkFront(index);
+  }
+
+  void Evict() {
+    while (size_ > max_size_) {
+      assert(last_ != kNone);
+      const auto& node = nodes_[last_];
+      EraseSlot(FindSlot(node.key, node.hash), true);
+    }
+  }
+
+  EvictionFunction eviction_callback_;
+  CacheCostFunc cache_cost_func_;
+  Hash hash_;
+  KeyEqual equal_;
+  std::vector<Node> nodes_;
+  std::vector<std::size_t> slots_;
+  std::set<Key> ordered_keys_;
+  std::size_t first_ = kNone;
+  std::size_t last_ = kNone;
+  std::size_t free_ = kNone;
+  std::size_t count_ = 0u;
+  std::size_t max_size_;
+  std::size_t size_ = 0u;
+};
+
+template <typename Key, typename Value, typename CacheCostFunc, typename Hash,
+          typename KeyEqual, bool OrderedIndex>
+constexpr std::size_t HashLruCache<Key, Value, CacheCostFunc, Hash, KeyEqual,
+                                   OrderedIndex>::kNone;
+
+template <typename Key, typename Value, typename CacheCostFunc, typename Hash,
+          typename KeyEqual, bool OrderedIndex>
+constexpr std::size_t HashLruCache<Key, Value, CacheCostFunc, Hash, KeyEqual,
+                                   OrderedIndex>::kFree;
+
+template <typename Key, typename Value, typename CacheCostFunc, typename Hash,
+          typename KeyEqual, bool OrderedIndex>
+constexpr std::size_t HashLruCache<Key, Value, CacheCostFunc, Hash, KeyEqual,
+                                   OrderedIndex>::kInitialCapacity;
+
+}  // namespace utils
+}  // namespace olp
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "BlobStore.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include <leveldb/env.h>
+#include "LittleEndian.h"
+#include "olp/core/logging/Log.h"
+#include "olp/core/utils/Dir.h"
+
+namespace olp {
+namespace cache {
+
+namespace {
+constexpr auto kLogTag = "BlobStore";
+constexpr char kSegmentSuffix[] = ".seg";
+constexpr size_t kValueSizeOffset = 4u;
+
+bool ParseSegmentName(const std::string& name, std::uint64_t& segment) {
+  const auto suffix_size = sizeof(kSegmentSuffix) - 1;
+  if (name.size() <= suffix_size ||
+      name.compare(name.size() - suffix_size, suffix_size, kSegmentSuffix) !=
+          0) {
+    return false;
+  }
+
+  char* end = nullptr;
+  segment = std::strtoull(name.c_str(), &end, 10);
+  return end == name.c_str() + name.size() - suffix_size;
+}
+}  // namespace
+
+constexpr size_t BlobStore::kEntryHeaderSize;
+
+bool BlobStore::Open(const std::string& path, std::uint64_t max_segment_size,
+                     bool read_only) {
+  Close();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  path_ = path;
+  max_segment_size_ = max_segment_size;
+  read_only_ = read_only;
+  segments_.clear();
+  next_segment_ = 0u;
+
+  std::uint64_t size = 0u;
+  std::vector<std::string> names;
+  auto env = leveldb::Env::Default();
+  if (env->GetChildren(path_, &names).ok()) {
+    for (const auto& name : names) {
+      std::uint64_t segment = 0u;
+      std::uint64_t segment_size = 0u;
+      if (ParseSegmentName(name, segment) &&
+          env->GetFileSize(path_ + "/" + name, &segment_size).ok()) {
+        segments_[segment] = segment_size;
+        size += segment_size;
+        next_segment_ = std::max(next_segment_, segment + 1u);
+      }
+    }
+  }
+
+  size_.store(size, std::memory_order_relaxed);
+  return true;
+}
+
+void BlobStore::Close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CloseActiveSegment();
+  segments_.clear();
+  size_.store(0u, std::memory_order_relaxed);
+}
+
+bool BlobStore::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CloseActiveSegment();
+  segments_.clear();
+  size_.store(0u, std::memory_order_relaxed);
+  return path_.empty() || !utils::Dir::exists(path_) ||
+         utils::Dir::remove(path_);
+}
+
+bool BlobStore::Append(const std::string& key, const std::string& value,
+                       BlobPointer& pointer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (read_only_) {
+    return false;
+  }
+
+  const auto entry_size = kEntryHeaderSize + key.size() + value.size();
+  if (has_active_segment_ && segments_[active_segment_] > 0u &&
+      segments_[active_segment_] + entry_size > max_segment_size_) {
+    CloseActiveSegment();
+  }
+
+  if (!has_active_segment_ && !OpenNewSegment()) {
+    return false;
+  }
+
+  char header[kEntryHeaderSize];
+  WriteLittleEndian<std::uint32_t>(header,
+                                   static_cast<std::uint32_t>(key.size()));
+  WriteLittleEndian<std::uint64_t>(header + kValueSizeOffset, value.size());
+  active_file_.write(header, sizeof(header));
+  active_file_.write(key.data(), key.size());
+  active_file_.write(value.data(), value.size());
+  active_file_.flush();
+  if (!active_file_) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to write %s",
+                        GetSegmentPath(active_segment_).c_str());
+    // The entry may be partially written, the next one goes to a new segment.
+    CloseActiveSegment();
+    return false;
+  }
+
+  auto& segment_size = segments_[active_segment_];
+  pointer.segment = active_segment_;
+  pointer.offset = segment_size + kEntryHeaderSize + key.size();
+  pointer.size = value.size();
+  segment_size += entry_size;
+  size_.fetch_add(entry_size, std::memory_order_relaxed);
+  return true;
+}
+
+bool BlobStore::Read(const BlobPointer& pointer, std::string& value) const {
+  std::ifstream file(GetSegmentPath(pointer.segment), std::ios::binary);
+  if (!file || pointer.size > value.max_size()) {
+    return false;
+  }
+
+  value.resize(static_cast<size_t>(pointer.size));
+  file.seekg(static_cast<std::streamoff>(pointer.offset));
+  file.read(&value[0], static_cast<std::streamsize>(value.size()));
+  return static_cast<bool>(file);
+}
+
+std::map<std::uint64_t, std::uint64_t> BlobStore::GetSealedSegments() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto segments = segments_;
+  if (has_active_segment_) {
+    segments.erase(active_segment_);
+  }
+  return segments;
+}
+
+bool BlobStore::ScanSegment(std::uint64_t segment,
+                            const EntryCallback& callback) const {
+  std::ifstream file(GetSegmentPath(segment), std::ios::binary);
+  if (!file || !file.seekg(0, std::ios::end)) {
+    return false;
+  }
+
+  const auto file_size = static_cast<std::uint64_t>(file.tellg());
+  std::uint64_t offset = 0u;
+  char header[kEntryHeaderSize];
+  std::string key;
+  while (offset + kEntryHeaderSize <= file_size) {
+    file.seekg(static_cast<std::streamoff>(offset));
+    if (!file.read(header, sizeof(header))) {
+      return false;
+    }
+
+    const auto key_size = ReadLittleEndian<std::uint32_t>(header);
+    BlobPointer pointer;
+    pointer.segment = segment;
+    pointer.offset = offset + kEntryHeaderSize + key_size;
+    pointer.size = ReadLittleEndian<std::uint64_t>(header + kValueSizeOffset);
+    if (pointer.offset > file_size ||
+        pointer.size > file_size - pointer.offset) {
+      break;
+    }
+
+    key.resize(key_size);
+    if (!file.read(&key[0], key_size)) {
+      return false;
+    }
+
+    callback(key, pointer);
+    offset = pointer.offset + pointer.size;
+  }
+  return true;
+}
+
+bool BlobStore::RemoveSegment(std::uint64_t segment) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = segments_.find(segment);
+  if (it == segments_.end() ||
+      (has_active_segment_ && segment == active_segment_)) {
+    return false;
+  }
+
+  if (std::remove(GetSegmentPath(segment).c_str()) != 0) {
+    OLP_SDK_LOG_WARNING_F(kLogTag, "Failed to remove %s",
+                          GetSegmentPath(segment).c_str());
+    return false;
+  }
+
+  size_.fetch_sub(it->second, std::memory_order_relaxed);
+  segments_.erase(it);
+  return true;
+}
+
+std::string BlobStore::GetSegmentPath(std::uint64_t segment) const {
+  return path_ + "/" + std::to_string(segment) + kSegmentSuffix;
+}
+
+bool BlobStore::OpenNewSegment() {
+  if (!utils::Dir::exists(path_) && !utils::Dir::create(path_)) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to create %s", path_.c_str());
+    return false;
+  }
+
+  const auto segment = next_segment_++;
+  active_file_.open(GetSegmentPath(segment),
+                    std::ios::binary | std::ios::trunc);
+  if (!active_file_) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to create %s",
+                        GetSegmentPath(segment).c_str());
+    active_file_.clear();
+    return false;
+  }
+
+  active_segment_ = segment;
+  has_active_segment_ = true;
+  segments_[segment] = 0u;
+  return true;
+}
+
+void BlobStore::CloseActiveSegment() {
+  if (has_active_segment_) {
+    active_file_.close();
+    active_file_.clear();
+    has_active_segment_ = false;
+  }
+}
+
+}  // namespace cache
+}  // namespace olp
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace olp {
+namespace cache {
+
+/// The location of a value in the segment files.
+struct BlobPointer {
+  std::uint64_t segment = 0u;
+  std::uint64_t offset = 0u;
+  std::uint64_t size = 0u;
+};
+
+/**
+ * @brief Stores the large values in append-only segment files.
+ *
+ * Every entry holds the key size (4 bytes, little endian), the value size
+ * (8 bytes, little endian), the key, and the value. The keys let the garbage
+ * collection find out which entries are still referenced by the disk cache.
+ * The values are only appended to the newest segment; the older segments are
+ * sealed and are only read or removed.
+ */
+class BlobStore {
+ public:
+  /// The size of the entry header.
+  static constexpr size_t kEntryHeaderSize = 12u;
+
+  using EntryCallback =
+      std::function<void(const std::string& key, const BlobPointer& pointer)>;
+
+  /// Finds the existing segments in the directory. The directory is created
+  /// by the first append.
+  bool Open(const std::string& path, std::uint64_t max_segment_size,
+            bool read_only);
+  void Close();
+  /// Removes all the segments.
+  bool Clear();
+
+  /// Appends the value to the newest segment and flushes it, so the value can
+  /// be read as soon as the pointer is stored.
+  bool Append(const std::string& key, const std::string& value,
+              BlobPointer& pointer);
+  bool Read(const BlobPointer& pointer, std::string& value) const;
+
+  /// The total size of the segment files.
+  std::uint64_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+  /// Returns the sizes of the segments that are not appended to anymore.
+  std::map<std::uint64_t, std::uint64_t> GetSealedSegments() const;
+  /// Calls `callback` for every entry of the segment. A truncated entry at
+  /// the end of the segment, left by an interrupted write, is skipped.
+  bool ScanSegment(std::uint64_t segment, const EntryCallback& callback) const;
+  bool RemoveSegment(std::uint64_t segment);
+
+ private:
+  std::string GetSegmentPath(std::uint64_t segment) const;
+  bool OpenNewSegment();
+  void CloseActiveSegment();
+
+  std::string path_;
+  std::uint64_t max_segment_size_{0u};
+  bool read_only_{true};
+
+  /// Guards the segments and the active segment file.
+  mutable std::mutex mutex_;
+  std::map<std::uint64_t, std::uint64_t> segments_;
+  std::ofstream active_file_;
+  std::uint64_t active_segment_{0u};
+  bool has_active_segment_{false};
+  std::uint64_t next_segment_{0u};
+  std::atomic<std::uint64_t> size_{0u};
+};
+
+}  // namespace cache
+}  // namespace olp
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "olp/core/cache/CacheStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "olp/core/cache/KeyEncoder.h"
+
+namespace olp {
+namespace cache {
+
+namespace {
+struct NamespaceSuffix {
+  const char* suffix;
+  CacheKeyNamespace key_namespace;
+};
+
+// The suffixes of the keys created by the older SDK versions.
+constexpr NamespaceSuffix kNamespaceSuffixes[] = {
+    {"::Data", CacheKeyNamespace::Data},
+    {"::partition", CacheKeyNamespace::Partition},
+    {"::partitions", CacheKeyNamespace::Partition},
+    {"::api", CacheKeyNamespace::Api},
+    {"::catalog", CacheKeyNamespace::Catalog},
+    {"::latestVersion", CacheKeyNamespace::Catalog},
+    {"::layerVersions", CacheKeyNamespace::Catalog}};
+
+bool EndsWith(const std::string& value, const char* suffix) {
+  const auto suffix_size = std::char_traits<char>::length(suffix);
+  return value.size() >= suffix_size &&
+         value.compare(value.size() - suffix_size, suffix_size, suffix) == 0;
+}
+}  // namespace
+
+constexpr size_t LatencyHistogram::kBucketCount;
+constexpr size_t CacheStatistics::kNamespaceCount;
+
+CacheCounters& CacheCounters::operator+=(const CacheCounters& other) {
+  memory_hits += other.memory_hits;
+  disk_hits += other.disk_hits;
+  misses += other.misses;
+  expirations += other.expirations;
+  evictions += other.evictions;
+  put_failures += other.put_failures;
+  bytes_read += other.bytes_read;
+  bytes_written += other.bytes_written;
+  return *this;
+}
+
+size_t LatencyHistogram::GetBucket(std::chrono::nanoseconds latency) {
+  auto microseconds =
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  size_t bucket = 0u;
+  while (microseconds > 0 && bucket + 1u < kBucketCount) {
+    microseconds >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+std::uint64_t LatencyHistogram::Count() const {
+  std::uint64_t count = 0u;
+  for (auto bucket : buckets) {
+    count += bucket;
+  }
+  return count;
+}
+
+std::chrono::microseconds LatencyHistogram::Percentile(double fraction) const {
+  const auto count = Count();
+  if (count == 0u) {
+    return std::chrono::microseconds(0);
+  }
+
+  // The rank of the operation, from 1 to count.
+  const auto rank = std::max<std::uint64_t>(
+      static_cast<std::uint64_t>(std::ceil(fraction * count)), 1u);
+  std::uint64_t seen = 0u;
+  size_t bucket = 0u;
+  for (; bucket + 1u < kBucketCount; ++bucket) {
+    seen += buckets[bucket];
+    if (seen >= rank) {
+      break;
+    }
+  }
+  return std::chrono::microseconds(std::int64_t(1) << bucket);
+}
+
+const CacheCounters& CacheStatistics::Get(
+    CacheKeyNamespace key_namespace) const {
+  return namespaces[static_cast<size_t>(key_namespace)];
+}
+
+CacheKeyNamespace CacheStatistics::GetKeyNamespace(const std::string& key) {
+  const auto key_namespace = KeyEncoder::GetKeyNamespace(key);
+  if (key_namespace != CacheKeyNamespace::Other) {
+    return key_namespace;
+  }
+
+  for (const auto& suffix : kNamespaceSuffixes) {
+    if (EndsWith(key, suffix.suffix)) {
+      return suffix.key_namespace;
+    }
+  }
+  return CacheKeyNamespace::Other;
+}
+
+}  // namespace cache
+}  // namespace olp
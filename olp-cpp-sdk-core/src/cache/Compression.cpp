@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "Compression.h"
+
+#include <limits>
+
+#ifdef OLP_SDK_CACHE_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace olp {
+namespace cache {
+
+namespace {
+#ifdef OLP_SDK_CACHE_HAS_ZLIB
+// zlib takes the sizes as uLong, which is 32 bits on some platforms.
+bool FitsZlib(size_t size) {
+  return size <= std::numeric_limits<uLong>::max();
+}
+
+bool ZlibCompress(const char* data, size_t size, std::string& out) {
+  if (!FitsZlib(size)) {
+    return false;
+  }
+
+  const auto offset = out.size();
+  auto compressed_size = compressBound(static_cast<uLong>(size));
+  out.resize(offset + compressed_size);
+  // The fastest level, the cache is written on the request path.
+  const auto result = compress2(reinterpret_cast<Bytef*>(&out[offset]),
+                                &compressed_size,
+                                reinterpret_cast<const Bytef*>(data),
+                                static_cast<uLong>(size), Z_BEST_SPEED);
+  if (result != Z_OK) {
+    out.resize(offset);
+    return false;
+  }
+
+  out.resize(offset + compressed_size);
+  return true;
+}
+
+bool ZlibDecompress(const char* data, size_t data_size, size_t size,
+                    std::string& out) {
+  if (!FitsZlib(data_size) || !FitsZlib(size)) {
+    return false;
+  }
+
+  const auto offset = out.size();
+  out.resize(offset + size);
+  auto decompressed_size = static_cast<uLongf>(size);
+  const auto result =
+      uncompress(reinterpret_cast<Bytef*>(&out[offset]), &decompressed_size,
+                 reinterpret_cast<const Bytef*>(data),
+                 static_cast<uLong>(data_size));
+  if (result != Z_OK || decompressed_size != size) {
+    out.resize(offset);
+    return false;
+  }
+
+  return true;
+}
+#endif
+}  // namespace
+
+bool IsCompressionSupported(CompressionCodec codec) {
+  switch (codec) {
+    case CompressionCodec::None:
+      return true;
+    case CompressionCodec::Zlib:
+#ifdef OLP_SDK_CACHE_HAS_ZLIB
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+bool Compress(CompressionCodec codec, const char* data, size_t size,
+              std::string& out) {
+  switch (codec) {
+    case CompressionCodec::None:
+      out.append(data, size);
+      return true;
+    case CompressionCodec::Zlib:
+#ifdef OLP_SDK_CACHE_HAS_ZLIB
+      return ZlibCompress(data, size, out);
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+bool Decompress(CompressionCodec codec, const char* data, size_t data_size,
+                size_t size, std::string& out) {
+  switch (codec) {
+    case CompressionCodec::None:
+      if (data_size != size) {
+        return false;
+      }
+      out.append(data, size);
+      return true;
+    case CompressionCodec::Zlib:
+#ifdef OLP_SDK_CACHE_HAS_ZLIB
+      return ZlibDecompress(data, data_size, size, out);
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+}  // namespace cache
+}  // namespace olp
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <olp/core/cache/CacheSettings.h>
+
+namespace olp {
+namespace cache {
+
+/// Checks if the SDK is built with the codec.
+bool IsCompressionSupported(CompressionCodec codec);
+
+/// Appends the compressed data to `out`. Returns false if the codec is not
+/// supported or fails; `out` is restored then.
+bool Compress(CompressionCodec codec, const char* data, size_t size,
+              std::string& out);
+
+/// Appends the decompressed data to `out`. `size` is the size of the original
+/// data. Returns false if the codec is not supported or the data is malformed;
+/// `out` is restored then.
+bool Decompress(CompressionCodec codec, const char* data, size_t data_size,
+                size_t size, std::string& out);
+
+}  // namespace cache
+}  // namespace olp
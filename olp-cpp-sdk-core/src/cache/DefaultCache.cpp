@@ -25,43 +25,309 @@ PORTING_CLANG_GCC_DISABLE_WARNING("-Wdeprecated-declarations")
 #include "olp/core/cache/DefaultCache.h"
 PORTING_POP_WARNINGS()
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <typeinfo>
+#include <unordered_set>
+#include <vector>
+
+#include <leveldb/iterator.h>
+#include <leveldb/write_batch.h>
+#include "BlobStore.h"
+#include "Compression.h"
 #include "DiskCache.h"
+#include "DiskCacheRecord.h"
 #include "InMemoryCache.h"
+#include "LittleEndian.h"
+#include "MappedCache.h"
+#include "StatisticsRecorder.h"
+#include "WriteBehindQueue.h"
+#include "olp/core/cache/KeyEncoder.h"
 #include "olp/core/logging/Log.h"
 #include "olp/core/porting/make_unique.h"
+#include "olp/core/thread/TaskScheduler.h"
 
 namespace {
 
 constexpr auto kLogTag = "DefaultCache";
 
-std::string CreateExpiryKey(const std::string& key) { return key + "::expiry"; }
+// The number of items written in one batch during the migration.
+constexpr size_t kMigrationBatchSize = 1000u;
 
-time_t GetRemainingExpiryTime(const std::string& key,
-                              olp::cache::DiskCache& disk_cache) {
-  auto expiry_key = CreateExpiryKey(key);
-  auto expiry = olp::cache::KeyValueCache::kDefaultExpiry;
-  auto expiry_value = disk_cache.Get(expiry_key);
-  if (expiry_value) {
-    expiry = std::stol(*expiry_value);
-    expiry -= olp::cache::InMemoryCache::DefaultTimeProvider()();
+// The number of keys a warm-up task reads from the disk at once.
+constexpr size_t kWarmupBatchSize = 64u;
+
+// The number of access tick slots of a shard. The keys share the slots by
+// hash, so the memory used for the eviction order does not grow with
+// the number of keys on the disk.
+constexpr size_t kAccessSlots = 4096u;
+
+// The number of the disk cache accesses a shard buffers for the concurrent
+// memory reads, which do not take the shard lock.
+constexpr size_t kTouchBufferSize = 16u;
+
+// The number of keys the maintenance removes in one batch.
+constexpr size_t kMaintenanceBatchSize = 1000u;
+
+// The warm-up does not know the decoder of the values, so it stores them in
+// the memory cache as read from the disk. The first read replaces the value
+// with the decoded one.
+struct WarmedValue {
+  std::string value;
+  // The absolute expiry time, or DiskCacheRecord::kNoExpiry.
+  time_t expiry;
+};
+
+using WarmedValuePtr = std::shared_ptr<const WarmedValue>;
+
+time_t GetRemainingExpiryTime(time_t expiry, time_t now) {
+  if (expiry == olp::cache::DiskCacheRecord::kNoExpiry) {
+    return olp::cache::KeyValueCache::kDefaultExpiry;
+  }
+
+  return expiry - now;
+}
+
+time_t GetAbsoluteExpiryTime(time_t expiry) {
+  if (expiry < olp::cache::KeyValueCache::kDefaultExpiry) {
+    return expiry + olp::cache::InMemoryCache::DefaultTimeProvider()();
+  }
+
+  return olp::cache::DiskCacheRecord::kNoExpiry;
+}
+
+using ShardLocks = std::vector<std::unique_lock<std::mutex>>;
+
+void Unlock(std::unique_lock<std::mutex>& lock) { lock.unlock(); }
+
+void Lock(std::unique_lock<std::mutex>& lock) { lock.lock(); }
+
+void Unlock(ShardLocks& locks) {
+  for (auto& lock : locks) {
+    lock.unlock();
+  }
+}
+
+void Lock(ShardLocks& locks) {
+  // The locks are taken again in the order they were taken in.
+  for (auto& lock : locks) {
+    lock.lock();
+  }
+}
+
+// Waits on the write-behind queue with the shard locks released, so a slow
+// disk does not stall the other users of the shards. The copy keeps the queue
+// alive if the cache is closed meanwhile; the caller checks is_open_ again.
+template <typename Locks, typename Wait>
+void WaitUnlocked(Locks& locks,
+                  std::shared_ptr<olp::cache::WriteBehindQueue> queue,
+                  Wait wait) {
+  Unlock(locks);
+  wait(*queue);
+  Lock(locks);
+}
+
+const auto kWaitForSpace = [](olp::cache::WriteBehindQueue& queue) {
+  queue.WaitForSpace();
+};
+
+const auto kWaitForWrite = [](olp::cache::WriteBehindQueue& queue) {
+  queue.WaitForWrite();
+};
+
+// Writes to the disk; if the write fails, retries it once after the disk
+// maintenance made room. The maintenance takes the shard locks, so they are
+// released meanwhile, and the write checks is_open_ again.
+template <typename Locks, typename Write, typename MakeRoom>
+bool WriteOrMakeRoom(Locks& locks, Write write, MakeRoom make_room) {
+  if (write()) {
+    return true;
+  }
+
+  Unlock(locks);
+  const auto has_room = make_room();
+  Lock(locks);
+  return has_room && write();
+}
+
+// Returns the disk usage in bytes that is the given percent of the limit.
+std::uint64_t GetStorageMark(const olp::cache::CacheSettings& settings,
+                             std::uint8_t percent) {
+  return settings.max_disk_storage == std::uint64_t(-1)
+             ? settings.max_disk_storage
+             : settings.max_disk_storage / 100u * percent;
+}
+
+bool IsWarmedValue(const boost::any& value) {
+  return value.type() == typeid(WarmedValuePtr);
+}
+
+boost::any DecodeWarmedValue(olp::cache::InMemoryCache& memory_cache,
+                             const std::string& key, boost::any value,
+                             const olp::cache::Decoder& decoder) {
+  if (!IsWarmedValue(value)) {
+    return value;
   }
 
-  return expiry;
+  const auto warmed = boost::any_cast<WarmedValuePtr>(value);
+  const auto now = olp::cache::InMemoryCache::DefaultTimeProvider()();
+  auto decoded = decoder(warmed->value);
+  memory_cache.Put(key, decoded, GetRemainingExpiryTime(warmed->expiry, now),
+                   warmed->value.size());
+  return decoded;
 }
 
-void PurgeDiskItem(const std::string& key, olp::cache::DiskCache& disk_cache) {
-  auto expiry_key = CreateExpiryKey(key);
-  disk_cache.Remove(key);
-  disk_cache.Remove(expiry_key);
+boost::any DecodeBinary(const std::string& value) {
+  return olp::cache::KeyValueCache::ValueTypePtr(
+      std::make_shared<olp::cache::KeyValueCache::ValueType>(value.begin(),
+                                                             value.end()));
 }
 
-bool StoreExpiry(const std::string& key, olp::cache::DiskCache& disk_cache,
-                 time_t expiry) {
-  auto expiry_key = CreateExpiryKey(key);
-  return disk_cache.Put(
-      expiry_key,
-      std::to_string(expiry +
-                     olp::cache::InMemoryCache::DefaultTimeProvider()()));
+// The hot keys snapshot is a sequence of keys, each preceded by its size.
+bool WriteHotKeys(const std::string& path,
+                  const std::vector<std::string>& keys) {
+  const auto temporary_path = path + ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+    for (const auto& key : keys) {
+      char size[sizeof(std::uint32_t)];
+      olp::cache::WriteLittleEndian<std::uint32_t>(
+          size, static_cast<std::uint32_t>(key.size()));
+      file.write(size, sizeof(size));
+      file.write(key.data(), key.size());
+    }
+    file.close();
+    if (!file) {
+      std::remove(temporary_path.c_str());
+      return false;
+    }
+  }
+
+  std::remove(path.c_str());
+  return std::rename(temporary_path.c_str(), path.c_str()) == 0;
+}
+
+bool ReadHotKeys(const std::string& path, std::vector<std::string>& keys) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+
+  char size[sizeof(std::uint32_t)];
+  while (file.read(size, sizeof(size))) {
+    std::string key(olp::cache::ReadLittleEndian<std::uint32_t>(size), '\0');
+    if (!file.read(&key[0], key.size())) {
+      return false;
+    }
+    keys.emplace_back(std::move(key));
+  }
+
+  // Only a clean end of the file is accepted, not a truncated size.
+  return file.gcount() == 0;
+}
+
+olp::cache::CompressionCodec GetCompressionCodec(
+    size_t size, const olp::cache::CacheSettings& settings) {
+  return size >= settings.compression_threshold
+             ? settings.compression_codec
+             : olp::cache::CompressionCodec::None;
+}
+
+std::string EncodeRecord(const std::string& value, time_t expiry,
+                         const olp::cache::CacheSettings& settings) {
+  return olp::cache::DiskCacheRecord::Encode(
+      value, GetAbsoluteExpiryTime(expiry),
+      GetCompressionCodec(value.size(), settings));
+}
+
+std::string EncodeRecord(const olp::cache::KeyValueCache::ValueType& value,
+                         time_t expiry,
+                         const olp::cache::CacheSettings& settings) {
+  return olp::cache::DiskCacheRecord::Encode(
+      value.data(), value.size(), GetAbsoluteExpiryTime(expiry),
+      GetCompressionCodec(value.size(), settings));
+}
+
+bool StoreFormatVersion(olp::cache::DiskCache& disk_cache) {
+  auto batch = std::make_unique<leveldb::WriteBatch>();
+  batch->Put(olp::cache::DiskCacheRecord::FormatVersionKey(),
+             std::to_string(olp::cache::DiskCacheRecord::kVersion));
+  return disk_cache.ApplyBatch(std::move(batch));
+}
+
+// Checks whether the value is already a record, written by a migration that
+// was interrupted before it stored the format version.
+bool IsMigratedRecord(const std::string& value) {
+  std::string record = value;
+  time_t expiry = olp::cache::DiskCacheRecord::kNoExpiry;
+  return olp::cache::DiskCacheRecord::Decode(record, expiry, true);
+}
+
+// Converts the values and their "::expiry" keys stored by the older SDK
+// versions into the records, and drops the expired values on the way.
+// The format version is stored last, so the interrupted migration runs again
+// on the next open and skips the values that are already converted.
+bool MigrateLegacyRecords(olp::cache::DiskCache& disk_cache) {
+  auto iterator = disk_cache.NewIterator();
+  if (!iterator) {
+    return false;
+  }
+
+  const auto now = olp::cache::InMemoryCache::DefaultTimeProvider()();
+  auto batch = std::make_unique<leveldb::WriteBatch>();
+  size_t batch_size = 0u;
+  size_t migrated = 0u;
+
+  // The iterator reads from an implicit snapshot, so the batches written in
+  // the loop do not affect it. A value is always visited before its expiry
+  // key, because the key is a prefix of the expiry key.
+  for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+    auto key = iterator->key().ToString();
+    if (olp::cache::DiskCacheRecord::IsLegacyExpiryKey(key)) {
+      batch->Delete(key);
+    } else if (IsMigratedRecord(iterator->value().ToString())) {
+      continue;
+    } else {
+      auto expiry = olp::cache::DiskCacheRecord::kNoExpiry;
+      auto expiry_value = disk_cache.Get(
+          olp::cache::DiskCacheRecord::LegacyExpiryKey(key));
+      if (expiry_value) {
+        expiry = std::strtoll(expiry_value->c_str(), nullptr, 10);
+      }
+
+      if (expiry <= now) {
+        batch->Delete(key);
+      } else {
+        batch->Put(key, olp::cache::DiskCacheRecord::Encode(
+                            iterator->value().ToString(), expiry));
+        ++migrated;
+      }
+    }
+
+    if (++batch_size == kMigrationBatchSize) {
+      if (!disk_cache.ApplyBatch(std::move(batch))) {
+        return false;
+      }
+      batch = std::make_unique<leveldb::WriteBatch>();
+      batch_size = 0u;
+    }
+  }
+
+  if (!iterator->status().ok() || !disk_cache.ApplyBatch(std::move(batch))) {
+    return false;
+  }
+
+  OLP_SDK_LOG_INFO_F(kLogTag, "Migrated %d values to the record format",
+                     static_cast<int>(migrated));
+  return StoreFormatVersion(disk_cache);
 }
 
 void ValidateDiskPath(olp::cache::CacheSettings& settings) {
@@ -79,43 +345,150 @@ void ValidateDiskPath(olp::cache::CacheSettings& settings) {
 namespace olp {
 namespace cache {
 
+struct DefaultCache::Shard {
+  Shard() : touch_writes(0u) {
+    for (auto& touch : touches) {
+      touch.store(kAccessSlots, std::memory_order_relaxed);
+    }
+  }
+
+  std::mutex lock;
+  /// Created with the cache and only cleared afterwards, so the concurrent
+  /// lookups can use it without the lock.
+  std::unique_ptr<InMemoryCache> memory_cache;
+  /// Advanced by every access of the mutable disk cache keys of the shard.
+  std::uint32_t access_clock{0u};
+  /// The last access tick of the mutable disk cache keys, `kAccessSlots` slots
+  /// indexed by the key hash. The colliding keys share the tick. Empty while
+  /// there is no mutable disk cache.
+  std::vector<std::uint32_t> access_ticks;
+  /// The access slots of the concurrent memory reads, applied to the ticks
+  /// under the lock. When the buffer is full, the oldest accesses are
+  /// overwritten.
+  std::atomic<size_t> touch_writes;
+  std::array<std::atomic<size_t>, kTouchBufferSize> touches;
+};
+
+/// Shared with the background maintenance task, so the task does nothing if it
+/// runs after the cache is destroyed.
+struct DefaultCache::MaintenanceState {
+  explicit MaintenanceState(DefaultCache* cache) : cache(cache) {}
+
+  /// Serializes the maintenance with opening, closing and clearing the cache.
+  std::mutex lock;
+  DefaultCache* cache;
+  std::atomic<bool> scheduled{false};
+  std::atomic<std::uint64_t> reclaimed_bytes{0u};
+  /// The time the periodic maintenance is due at.
+  std::atomic<time_t> due_time{0};
+  /// The warm-up tasks that use the cache; the destructor waits for them.
+  size_t running_tasks{0u};
+  std::condition_variable tasks_finished;
+};
+
+/// Shared by the tasks of one warm-up.
+struct DefaultCache::WarmupJob {
+  std::vector<std::string> keys;
+  std::uint64_t max_bytes{0u};
+  size_t task_count{1u};
+  std::atomic<std::uint64_t> bytes_read{0u};
+  std::atomic<size_t> loaded_count{0u};
+  std::atomic<size_t> pending_tasks{0u};
+  WarmupCallback callback;
+};
+
 DefaultCache::DefaultCache(const CacheSettings& settings)
     : settings_(settings),
       is_open_(false),
-      memory_cache_(nullptr),
       mutable_cache_(nullptr),
-      protected_cache_(nullptr) {}
+      protected_cache_(nullptr),
+      mapped_protected_cache_(nullptr),
+      protected_cache_records_(false),
+      statistics_(
+          std::make_unique<StatisticsRecorder>(settings.enable_statistics)),
+      maintenance_(std::make_shared<MaintenanceState>(this)) {
+  maintenance_->due_time = InMemoryCache::DefaultTimeProvider()() +
+                           settings_.disk_maintenance_interval;
+  const auto shard_count = std::max<size_t>(settings_.shard_count, 1u);
+  shards_.reserve(shard_count);
+  // The memory budget is split evenly between the shards.
+  const auto shard_memory_size =
+      std::max<size_t>(settings_.max_memory_cache_size / shard_count, 1u);
+  for (size_t i = 0; i < shard_count; ++i) {
+    shards_.emplace_back(std::make_unique<Shard>());
+    if (settings_.max_memory_cache_size > 0) {
+      shards_.back()->memory_cache = std::make_unique<InMemoryCache>(
+          shard_memory_size, InMemoryCache::DefaultCacheCost(),
+          InMemoryCache::DefaultTimeProvider(),
+          settings_.concurrent_memory_reads);
+      if (statistics_->IsEnabled()) {
+        auto statistics = statistics_.get();
+        shards_.back()->memory_cache->SetRemovalCallback(
+            [statistics](const std::string& key, bool expired) {
+              statistics->Add(expired ? StatisticsRecorder::kExpirations
+                                      : StatisticsRecorder::kEvictions,
+                              key);
+            });
+      }
+    }
+  }
+}
 
-DefaultCache::~DefaultCache() = default;
+DefaultCache::~DefaultCache() {
+  std::unique_lock<std::mutex> lock(maintenance_->lock);
+  // The queued writes are applied before the disk cache is closed.
+  StopWriteQueue();
+  StoreAccessTicks();
+  maintenance_->cache = nullptr;
+  maintenance_->tasks_finished.wait(
+      lock, [&]() { return maintenance_->running_tasks == 0u; });
+}
 
 DefaultCache::StorageOpenResult DefaultCache::Open() {
-  std::lock_guard<std::mutex> lock(cache_lock_);
+  std::lock_guard<std::mutex> maintenance_lock(maintenance_->lock);
+  auto locks = LockAllShards();
   is_open_ = true;
   return SetupStorage();
 }
 
 void DefaultCache::Close() {
-  std::lock_guard<std::mutex> lock(cache_lock_);
+  std::lock_guard<std::mutex> maintenance_lock(maintenance_->lock);
+  auto locks = LockAllShards();
   if (!is_open_) {
     return;
   }
 
-  memory_cache_.reset();
+  StopWriteQueue();
+  StoreAccessTicks();
+  for (auto& shard : shards_) {
+    if (shard->memory_cache) {
+      shard->memory_cache->Clear();
+    }
+    shard->access_clock = 0u;
+    shard->access_ticks.clear();
+  }
   mutable_cache_.reset();
   protected_cache_.reset();
+  mapped_protected_cache_.reset();
   is_open_ = false;
 }
 
 bool DefaultCache::Clear() {
-  std::lock_guard<std::mutex> lock(cache_lock_);
+  std::lock_guard<std::mutex> maintenance_lock(maintenance_->lock);
+  auto locks = LockAllShards();
   if (!is_open_) {
     return false;
   }
 
-  if (memory_cache_) {
-    memory_cache_->Clear();
+  for (auto& shard : shards_) {
+    if (shard->memory_cache) {
+      shard->memory_cache->Clear();
+    }
+    shard->access_clock = 0u;
+    shard->access_ticks.clear();
   }
 
+  StopWriteQueue();
   if (mutable_cache_) {
     if (!mutable_cache_->Clear()) {
       return false;
@@ -127,30 +500,44 @@ bool DefaultCache::Clear() {
 
 bool DefaultCache::Put(const std::string& key, const boost::any& value,
                        const Encoder& encoder, time_t expiry) {
-  std::lock_guard<std::mutex> lock(cache_lock_);
+  auto& shard = GetShard(key);
+  std::unique_lock<std::mutex> lock(shard.lock);
+  while (is_open_ && write_queue_ && !write_queue_->HasSpace()) {
+    WaitUnlocked(lock, write_queue_, kWaitForSpace);
+  }
   if (!is_open_) {
     return false;
   }
 
   auto encodedItem = encoder();
-  if (memory_cache_) {
-    if (!memory_cache_->Put(key, value, expiry, encodedItem.size())) {
+  if (shard.memory_cache) {
+    if (!shard.memory_cache->Put(key, value, expiry, encodedItem.size())) {
       OLP_SDK_LOG_WARNING_F(kLogTag,
                             "Failed to store value in memory cache %s, size %d",
                             key.c_str(), static_cast<int>(encodedItem.size()));
     }
   }
 
-  if (mutable_cache_) {
-    if (expiry < KeyValueCache::kDefaultExpiry) {
-      if (!StoreExpiry(key, *mutable_cache_, expiry)) {
-        return false;
+  if (write_queue_) {
+    write_queue_->Push(key, EncodeRecord(encodedItem, expiry, settings_));
+    TouchKey(shard, key);
+  } else if (mutable_cache_) {
+    const auto record = EncodeRecord(encodedItem, expiry, settings_);
+    const auto write = [&]() {
+      return is_open_ && mutable_cache_ && PutToDiscCache(key, record);
+    };
+    if (!WriteOrMakeRoom(lock, write, [&]() { return MakeRoomOnDisk(true); })) {
+      if (is_open_ && IsDiskFull()) {
+        statistics_->Add(StatisticsRecorder::kPutFailures, key);
       }
-    }
-
-    if (!mutable_cache_->Put(key, encodedItem)) {
       return false;
     }
+    TouchKey(shard, key);
+    const auto needs_maintenance = NeedsMaintenance();
+    lock.unlock();
+    if (needs_maintenance) {
+      ScheduleMaintenance();
+    }
   }
 
   return true;
@@ -158,56 +545,90 @@ bool DefaultCache::Put(const std::string& key, const boost::any& value,
 
 bool DefaultCache::Put(const std::string& key,
                        const KeyValueCache::ValueTypePtr value, time_t expiry) {
-  std::lock_guard<std::mutex> lock(cache_lock_);
+  auto& shard = GetShard(key);
+  std::unique_lock<std::mutex> lock(shard.lock);
+  while (is_open_ && write_queue_ && !write_queue_->HasSpace()) {
+    WaitUnlocked(lock, write_queue_, kWaitForSpace);
+  }
   if (!is_open_) {
     return false;
   }
 
-  if (memory_cache_) {
-    if (!memory_cache_->Put(key, value, expiry, value->size())) {
+  if (shard.memory_cache) {
+    if (!shard.memory_cache->Put(key, value, expiry, value->size())) {
       OLP_SDK_LOG_WARNING_F(kLogTag,
                             "Failed to store value in memory cache %s, size %d",
                             key.c_str(), static_cast<int>(value->size()));
     }
   }
 
-  if (mutable_cache_) {
-    if (expiry < KeyValueCache::kDefaultExpiry) {
-      if (!StoreExpiry(key, *mutable_cache_, expiry)) {
-        return false;
+  if (write_queue_) {
+    write_queue_->Push(key, EncodeRecord(*value, expiry, settings_));
+    TouchKey(shard, key);
+  } else if (mutable_cache_) {
+    // The record is encoded straight from the shared buffer, so the value is
+    // copied only once on its way to the disk.
+    const auto record = EncodeRecord(*value, expiry, settings_);
+    const auto write = [&]() {
+      return is_open_ && mutable_cache_ && PutToDiscCache(key, record);
+    };
+    if (!WriteOrMakeRoom(lock, write, [&]() { return MakeRoomOnDisk(true); })) {
+      if (is_open_ && IsDiskFull()) {
+        statistics_->Add(StatisticsRecorder::kPutFailures, key);
       }
-    }
-
-    std::string val(value->begin(), value->end());
-    if (!mutable_cache_->Put(key, val)) {
       return false;
     }
+    TouchKey(shard, key);
+    const auto needs_maintenance = NeedsMaintenance();
+    lock.unlock();
+    if (needs_maintenance) {
+      ScheduleMaintenance();
+    }
   }
 
   return true;
 }
 
 boost::any DefaultCache::Get(const std::string& key, const Decoder& decoder) {
-  std::lock_guard<std::mutex> lock(cache_lock_);
+  const auto start = statistics_->Start();
+  auto& shard = GetShard(key);
+  if (settings_.concurrent_memory_reads) {
+    auto value = GetFromMemoryCache(shard, key);
+    // The warmed values are decoded under the shard lock.
+    if (!value.empty() && !IsWarmedValue(value)) {
+      RecordTouch(shard, key);
+      statistics_->Add(StatisticsRecorder::kMemoryHits, key);
+      statistics_->Finish(StatisticsRecorder::kMemoryHit, start);
+      return value;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(shard.lock);
   if (!is_open_) {
     return boost::any();
   }
 
-  if (memory_cache_) {
-    auto value = memory_cache_->Get(key);
+  if (shard.memory_cache) {
+    auto value = DecodeWarmedValue(*shard.memory_cache, key,
+                                   shard.memory_cache->Get(key), decoder);
     if (!value.empty()) {
+      TouchKey(shard, key);
+      statistics_->Add(StatisticsRecorder::kMemoryHits, key);
+      statistics_->Finish(StatisticsRecorder::kMemoryHit, start);
       return value;
     }
   }
 
   auto disc_cache = GetFromDiscCache(key);
+  statistics_->Finish(StatisticsRecorder::kDiskLookup, start);
 
   if (disc_cache) {
     auto decoded_item = decoder(disc_cache->first);
-    if (memory_cache_) {
-      memory_cache_->Put(key, decoded_item, disc_cache->second,
-                         disc_cache->first.size());
+    if (shard.memory_cache) {
+      shard.memory_cache->Put(key, decoded_item, disc_cache->second,
+                              disc_cache->first.size());
     }
+    TouchKey(shard, key);
     return decoded_item;
   }
 
@@ -215,41 +636,219 @@ boost::any DefaultCache::Get(const std::string& key, const Decoder& decoder) {
 }
 
 KeyValueCache::ValueTypePtr DefaultCache::Get(const std::string& key) {
-  std::lock_guard<std::mutex> lock(cache_lock_);
+  const auto start = statistics_->Start();
+  auto& shard = GetShard(key);
+  if (settings_.concurrent_memory_reads) {
+    auto value = GetFromMemoryCache(shard, key);
+    if (!value.empty() && !IsWarmedValue(value)) {
+      RecordTouch(shard, key);
+      statistics_->Add(StatisticsRecorder::kMemoryHits, key);
+      statistics_->Finish(StatisticsRecorder::kMemoryHit, start);
+      return boost::any_cast<KeyValueCache::ValueTypePtr>(value);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(shard.lock);
   if (!is_open_) {
     return nullptr;
   }
 
-  if (memory_cache_) {
-    auto value = memory_cache_->Get(key);
+  if (shard.memory_cache) {
+    auto value = DecodeWarmedValue(*shard.memory_cache, key,
+                                   shard.memory_cache->Get(key), DecodeBinary);
 
     if (!value.empty()) {
+      TouchKey(shard, key);
+      statistics_->Add(StatisticsRecorder::kMemoryHits, key);
+      statistics_->Finish(StatisticsRecorder::kMemoryHit, start);
       return boost::any_cast<KeyValueCache::ValueTypePtr>(value);
     }
   }
 
-  auto disc_cache = GetFromDiscCache(key);
-  if (disc_cache) {
-    auto data = std::make_shared<KeyValueCache::ValueType>(
-        disc_cache->first.begin(), disc_cache->first.end());
+  KeyValueCache::ValueTypePtr data;
+  auto expiry = KeyValueCache::kDefaultExpiry;
+  const bool verify_checksum =
+      (settings_.openOptions & CheckCrc) == CheckCrc;
+  MappedCache::Value mapped_value;
+  if (mapped_protected_cache_ &&
+      mapped_protected_cache_->Get(key, mapped_value, verify_checksum)) {
+    // The value is copied straight from the mapping. It can not be shared
+    // with the caller instead, as ValueTypePtr owns a vector.
+    data = std::make_shared<KeyValueCache::ValueType>(
+        mapped_value.data, mapped_value.data + mapped_value.size);
+    statistics_->Add(StatisticsRecorder::kDiskHits, key);
+    statistics_->Add(StatisticsRecorder::kBytesRead, key, mapped_value.size);
+  } else {
+    // The key was already looked up in the mapped cache above.
+    auto disc_cache = mapped_protected_cache_
+                          ? GetFromLegacyKey(key, verify_checksum)
+                          : GetFromDiscCache(key);
+    if (!disc_cache && mapped_protected_cache_) {
+      disc_cache = GetFromMutableDiscCache(key);
+    }
+    if (disc_cache) {
+      data = std::make_shared<KeyValueCache::ValueType>(
+          disc_cache->first.begin(), disc_cache->first.end());
+      expiry = disc_cache->second;
+    }
+  }
+  statistics_->Finish(StatisticsRecorder::kDiskLookup, start);
 
-    if (memory_cache_) {
-      memory_cache_->Put(key, data, disc_cache->second, data->size());
+  if (data) {
+    if (shard.memory_cache) {
+      shard.memory_cache->Put(key, data, expiry, data->size());
     }
-    return data;
+    TouchKey(shard, key);
   }
 
-  return nullptr;
+  return data;
+}
+
+bool DefaultCache::PutBatch(const BatchItems& items) {
+  std::set<size_t> shard_indexes;
+  for (const auto& item : items) {
+    shard_indexes.insert(GetShardIndex(item.key));
+  }
+
+  auto locks = LockShards(shard_indexes);
+  while (is_open_ && write_queue_ && !write_queue_->HasSpace()) {
+    WaitUnlocked(locks, write_queue_, kWaitForSpace);
+  }
+  if (!is_open_) {
+    return false;
+  }
+
+  std::vector<InMemoryCache::ItemTuples> memory_items(shards_.size());
+  std::vector<std::pair<std::string, std::string>> disk_items;
+  for (const auto& item : items) {
+    auto encoded_item = item.encoder();
+    memory_items[GetShardIndex(item.key)].emplace_back(
+        item.key, item.expiry, item.value, encoded_item.size());
+
+    if (mutable_cache_) {
+      disk_items.emplace_back(
+          item.key, EncodeRecord(encoded_item, item.expiry, settings_));
+    }
+  }
+
+  for (auto index : shard_indexes) {
+    auto& memory_cache = shards_[index]->memory_cache;
+    if (memory_cache && !memory_cache->PutBatch(memory_items[index])) {
+      OLP_SDK_LOG_WARNING_F(kLogTag,
+                            "Failed to store some of %d values in memory cache",
+                            static_cast<int>(memory_items[index].size()));
+    }
+  }
+
+  if (write_queue_) {
+    for (auto& item : disk_items) {
+      write_queue_->Push(item.first, std::move(item.second));
+    }
+  } else if (mutable_cache_ && !disk_items.empty()) {
+    const auto write = [&]() {
+      return is_open_ && mutable_cache_ && PutToDiscCache(disk_items);
+    };
+    if (!WriteOrMakeRoom(locks, write,
+                         [&]() { return MakeRoomOnDisk(true); })) {
+      if (is_open_ && IsDiskFull()) {
+        for (const auto& item : disk_items) {
+          statistics_->Add(StatisticsRecorder::kPutFailures, item.first);
+        }
+      }
+      return false;
+    }
+  }
+
+  auto needs_maintenance = false;
+  if (mutable_cache_) {
+    for (const auto& item : items) {
+      TouchKey(GetShard(item.key), item.key);
+    }
+    needs_maintenance = !write_queue_ && NeedsMaintenance();
+  }
+  locks.clear();
+  if (needs_maintenance) {
+    ScheduleMaintenance();
+  }
+
+  return true;
+}
+
+std::vector<boost::any> DefaultCache::GetBatch(
+    const std::vector<std::string>& keys, const Decoder& decoder) {
+  std::set<size_t> shard_indexes;
+  for (const auto& key : keys) {
+    shard_indexes.insert(GetShardIndex(key));
+  }
+
+  auto locks = LockShards(shard_indexes);
+  std::vector<boost::any> values(keys.size());
+  if (!is_open_) {
+    return values;
+  }
+
+  std::vector<size_t> missed_indexes;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto& memory_cache = GetShard(keys[i]).memory_cache;
+    if (memory_cache) {
+      values[i] = DecodeWarmedValue(*memory_cache, keys[i],
+                                    memory_cache->Get(keys[i]), decoder);
+    }
+
+    if (values[i].empty()) {
+      missed_indexes.push_back(i);
+    } else {
+      TouchKey(GetShard(keys[i]), keys[i]);
+      statistics_->Add(StatisticsRecorder::kMemoryHits, keys[i]);
+    }
+  }
+
+  if (missed_indexes.empty()) {
+    return values;
+  }
+
+  std::vector<std::string> missed_keys;
+  missed_keys.reserve(missed_indexes.size());
+  for (auto index : missed_indexes) {
+    missed_keys.push_back(keys[index]);
+  }
+
+  auto disc_items = GetFromDiscCache(missed_keys);
+  for (size_t i = 0; i < disc_items.size(); ++i) {
+    const auto& disc_item = disc_items[i];
+    if (!disc_item) {
+      continue;
+    }
+
+    const auto& key = missed_keys[i];
+    auto decoded_item = decoder(disc_item->first);
+    auto& shard = GetShard(key);
+    if (shard.memory_cache) {
+      shard.memory_cache->Put(key, decoded_item, disc_item->second,
+                              disc_item->first.size());
+    }
+    TouchKey(shard, key);
+    values[missed_indexes[i]] = std::move(decoded_item);
+  }
+
+  return values;
 }
 
 bool DefaultCache::Remove(const std::string& key) {
-  std::lock_guard<std::mutex> lock(cache_lock_);
+  auto& shard = GetShard(key);
+  std::unique_lock<std::mutex> lock(shard.lock);
+  // The queued writes of the key are dropped, and the write in progress is
+  // waited for with the shard unlocked.
+  const auto matches = [&](const std::string& queued) { return queued == key; };
+  while (is_open_ && write_queue_ && !write_queue_->Discard(matches)) {
+    WaitUnlocked(lock, write_queue_, kWaitForWrite);
+  }
   if (!is_open_) {
     return false;
   }
 
-  if (memory_cache_) {
-    memory_cache_->Remove(key);
+  if (shard.memory_cache) {
+    shard.memory_cache->Remove(key);
   }
 
   if (mutable_cache_) {
@@ -262,30 +861,745 @@ bool DefaultCache::Remove(const std::string& key) {
 }
 
 bool DefaultCache::RemoveKeysWithPrefix(const std::string& key) {
-  std::lock_guard<std::mutex> lock(cache_lock_);
+  auto locks = LockAllShards();
+  const auto matches = [&](const std::string& queued) {
+    return queued.compare(0, key.size(), key) == 0;
+  };
+  while (is_open_ && write_queue_ && !write_queue_->Discard(matches)) {
+    WaitUnlocked(locks, write_queue_, kWaitForWrite);
+  }
   if (!is_open_) {
     return false;
   }
 
-  if (memory_cache_) {
-    memory_cache_->RemoveKeysWithPrefix(key);
+  for (auto& shard : shards_) {
+    if (shard->memory_cache) {
+      shard->memory_cache->RemoveKeysWithPrefix(key);
+    }
+    // The access ticks are indexed by the key hash and can not be looked up
+    // by prefix, the stale ones are overwritten by the next accesses.
+    if (key.empty()) {
+      shard->access_clock = 0u;
+      std::fill(shard->access_ticks.begin(), shard->access_ticks.end(), 0u);
+    }
   }
 
   if (mutable_cache_) {
-    return mutable_cache_->RemoveKeysWithPrefix(key);
+    if (!mutable_cache_->RemoveKeysWithPrefix(key)) {
+      return false;
+    }
+
+    // The empty prefix removes the format version as well.
+    if (key.empty()) {
+      return StoreFormatVersion(*mutable_cache_);
+    }
   }
   return true;
 }
 
+std::uint64_t DefaultCache::RunMaintenance() {
+  std::lock_guard<std::mutex> lock(maintenance_->lock);
+  return Maintain();
+}
+
+std::uint64_t DefaultCache::GetReclaimedBytes() const {
+  return maintenance_->reclaimed_bytes.load();
+}
+
+CacheStatistics DefaultCache::GetStatistics() const {
+  return statistics_->Get();
+}
+
+void DefaultCache::ResetStatistics() { statistics_->Reset(); }
+
+bool DefaultCache::DumpHotKeys(const std::string& path, size_t max_count) {
+  // The memory caches have their own locks, and are empty while the cache is
+  // closed.
+  std::vector<std::vector<std::string>> shard_keys;
+  shard_keys.reserve(shards_.size());
+  for (auto& shard : shards_) {
+    if (shard->memory_cache) {
+      shard_keys.emplace_back(shard->memory_cache->GetKeys(max_count));
+    }
+  }
+
+  // The shards are merged in turns, so the hottest keys of every shard come
+  // first.
+  std::vector<std::string> keys;
+  for (size_t position = 0; keys.size() < max_count; ++position) {
+    bool found = false;
+    for (auto& shard : shard_keys) {
+      if (position < shard.size() && keys.size() < max_count) {
+        keys.emplace_back(std::move(shard[position]));
+        found = true;
+      }
+    }
+    if (!found) {
+      break;
+    }
+  }
+
+  if (!WriteHotKeys(path, keys)) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to write the hot keys to %s",
+                        path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool DefaultCache::Warmup(const WarmupManifest& manifest,
+                          WarmupCallback callback) {
+  auto job = std::make_shared<WarmupJob>();
+  if (!manifest.hot_keys_path.empty() &&
+      !ReadHotKeys(manifest.hot_keys_path, job->keys)) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to read the hot keys from %s",
+                        manifest.hot_keys_path.c_str());
+    return false;
+  }
+
+  {
+    // The maintenance lock keeps the disk caches open during the scan.
+    std::lock_guard<std::mutex> lock(maintenance_->lock);
+    if (!is_open_ || settings_.max_memory_cache_size == 0u) {
+      return false;
+    }
+
+    for (const auto& prefix : manifest.key_prefixes) {
+      if (mutable_cache_) {
+        CollectKeysWithPrefix(*mutable_cache_, true, prefix, job->keys);
+      }
+      if (protected_cache_) {
+        CollectKeysWithPrefix(*protected_cache_, protected_cache_records_,
+                              prefix, job->keys);
+      }
+    }
+  }
+
+  // The keys listed several times are loaded at the first position.
+  std::unordered_set<std::string> unique_keys;
+  job->keys.erase(std::remove_if(job->keys.begin(), job->keys.end(),
+                                 [&](const std::string& key) {
+                                   return !unique_keys.insert(key).second;
+                                 }),
+                  job->keys.end());
+
+  job->max_bytes = manifest.max_bytes > 0u ? manifest.max_bytes
+                                           : settings_.max_memory_cache_size;
+  job->callback = std::move(callback);
+
+  if (!settings_.task_scheduler || job->keys.empty()) {
+    LoadWarmupKeys(*job, 0u);
+    if (job->callback) {
+      job->callback(job->loaded_count.load());
+    }
+    return true;
+  }
+
+  job->task_count = std::max<size_t>(
+      std::min(manifest.max_parallel_tasks, job->keys.size()), 1u);
+
+  OLP_SDK_LOG_INFO_F(kLogTag, "Warming up %d keys in %d tasks",
+                     static_cast<int>(job->keys.size()),
+                     static_cast<int>(job->task_count));
+
+  job->pending_tasks = job->task_count;
+  std::weak_ptr<MaintenanceState> weak_state = maintenance_;
+  for (size_t task = 0; task < job->task_count; ++task) {
+    settings_.task_scheduler->ScheduleTask([weak_state, job, task]() {
+      if (auto state = weak_state.lock()) {
+        std::unique_lock<std::mutex> lock(state->lock);
+        if (state->cache) {
+          // The destructor waits for the running tasks, so the cache can be
+          // used without the lock.
+          ++state->running_tasks;
+          lock.unlock();
+          state->cache->LoadWarmupKeys(*job, task);
+          lock.lock();
+          --state->running_tasks;
+          state->tasks_finished.notify_all();
+        }
+      }
+
+      if (--job->pending_tasks == 0u && job->callback) {
+        job->callback(job->loaded_count.load());
+      }
+    });
+  }
+
+  return true;
+}
+
+void DefaultCache::StopWriteQueue() {
+  // The waiting calls may still hold the queue, so the writer thread is
+  // stopped before the disk cache is closed.
+  if (write_queue_) {
+    write_queue_->Stop();
+    write_queue_.reset();
+  }
+}
+
+bool DefaultCache::Flush() {
+  std::lock_guard<std::mutex> lock(maintenance_->lock);
+  if (!is_open_) {
+    return false;
+  }
+
+  return write_queue_ ? write_queue_->Flush() : true;
+}
+
+size_t DefaultCache::GetShardIndex(const std::string& key) const {
+  return std::hash<std::string>{}(key) % shards_.size();
+}
+
+DefaultCache::Shard& DefaultCache::GetShard(const std::string& key) {
+  return *shards_[GetShardIndex(key)];
+}
+
+DefaultCache::ShardLocks DefaultCache::LockShards(
+    const std::set<size_t>& shard_indexes) {
+  // std::set is sorted, so the shards are locked in the same order as in
+  // LockAllShards.
+  ShardLocks locks;
+  locks.reserve(shard_indexes.size());
+  for (auto index : shard_indexes) {
+    locks.emplace_back(shards_[index]->lock);
+  }
+  return locks;
+}
+
+DefaultCache::ShardLocks DefaultCache::LockAllShards() {
+  // Shards are always locked in the same order to avoid deadlocks.
+  ShardLocks locks;
+  locks.reserve(shards_.size());
+  for (auto& shard : shards_) {
+    locks.emplace_back(shard->lock);
+  }
+  return locks;
+}
+
+boost::any DefaultCache::GetFromMemoryCache(Shard& shard,
+                                            const std::string& key) {
+  // The memory cache is empty while the cache is closed.
+  return shard.memory_cache ? shard.memory_cache->Get(key) : boost::any();
+}
+
+size_t DefaultCache::GetAccessSlot(const std::string& key) const {
+  // The shard index uses the low part of the hash.
+  return std::hash<std::string>{}(key) / shards_.size() % kAccessSlots;
+}
+
+void DefaultCache::TouchKey(Shard& shard, const std::string& key) {
+  // Only the mutable disk cache is evicted by the maintenance.
+  if (!shard.access_ticks.empty()) {
+    TouchSlot(shard, GetAccessSlot(key));
+  }
+}
+
+void DefaultCache::TouchSlot(Shard& shard, size_t slot) {
+  // The clock is halved with the ticks before it overflows, which keeps
+  // the order of the ticks.
+  if (shard.access_clock == std::numeric_limits<std::uint32_t>::max()) {
+    for (auto& tick : shard.access_ticks) {
+      tick /= 2u;
+    }
+    shard.access_clock /= 2u;
+  }
+  shard.access_ticks[slot] = ++shard.access_clock;
+}
+
+void DefaultCache::RecordTouch(Shard& shard, const std::string& key) {
+  const auto index =
+      shard.touch_writes.fetch_add(1u, std::memory_order_relaxed);
+  shard.touches[index % kTouchBufferSize].store(GetAccessSlot(key),
+                                                std::memory_order_relaxed);
+
+  // The reader that fills the buffer applies the accesses, unless the shard
+  // is busy; then they are applied by the maintenance or overwritten.
+  if ((index + 1u) % kTouchBufferSize == 0u && shard.lock.try_lock()) {
+    ApplyTouches(shard);
+    shard.lock.unlock();
+  }
+}
+
+void DefaultCache::ApplyTouches(Shard& shard) {
+  for (auto& touch : shard.touches) {
+    const auto slot = touch.exchange(kAccessSlots, std::memory_order_relaxed);
+    if (slot < shard.access_ticks.size()) {
+      TouchSlot(shard, slot);
+    }
+  }
+}
+
+void DefaultCache::LoadAccessTicks() {
+  // The stored ticks are used only if the shard layout did not change.
+  const auto shard_size = sizeof(std::uint32_t) * (1u + kAccessSlots);
+  auto value = mutable_cache_->Get(DiskCacheRecord::AccessTicksKey());
+  const bool stored =
+      value && value->size() == 8u + shards_.size() * shard_size &&
+      ReadLittleEndian<std::uint32_t>(value->data()) == shards_.size() &&
+      ReadLittleEndian<std::uint32_t>(value->data() + 4u) == kAccessSlots;
+
+  for (size_t index = 0; index < shards_.size(); ++index) {
+    auto& shard = *shards_[index];
+    shard.access_clock = 0u;
+    shard.access_ticks.assign(kAccessSlots, 0u);
+    if (!stored) {
+      continue;
+    }
+
+    const char* data = value->data() + 8u + index * shard_size;
+    shard.access_clock = ReadLittleEndian<std::uint32_t>(data);
+    for (auto& tick : shard.access_ticks) {
+      data += sizeof(std::uint32_t);
+      tick = ReadLittleEndian<std::uint32_t>(data);
+    }
+  }
+}
+
+void DefaultCache::StoreAccessTicks() {
+  if (!is_open_ || !mutable_cache_) {
+    return;
+  }
+
+  // The shard count and the slot count, then the clock and the ticks of
+  // every shard.
+  const auto shard_size = sizeof(std::uint32_t) * (1u + kAccessSlots);
+  std::string value(8u + shards_.size() * shard_size, '\0');
+  WriteLittleEndian<std::uint32_t>(&value[0],
+                                   static_cast<std::uint32_t>(shards_.size()));
+  WriteLittleEndian<std::uint32_t>(&value[4],
+                                   static_cast<std::uint32_t>(kAccessSlots));
+  for (size_t index = 0; index < shards_.size(); ++index) {
+    auto& shard = *shards_[index];
+    if (shard.access_ticks.size() != kAccessSlots) {
+      return;
+    }
+
+    ApplyTouches(shard);
+
+    char* data = &value[8u + index * shard_size];
+    WriteLittleEndian<std::uint32_t>(data, shard.access_clock);
+    for (auto tick : shard.access_ticks) {
+      data += sizeof(std::uint32_t);
+      WriteLittleEndian<std::uint32_t>(data, tick);
+    }
+  }
+
+  auto batch = std::make_unique<leveldb::WriteBatch>();
+  batch->Put(DiskCacheRecord::AccessTicksKey(), value);
+  if (!mutable_cache_->ApplyBatch(std::move(batch))) {
+    OLP_SDK_LOG_WARNING(kLogTag, "Failed to store the access ticks");
+  }
+}
+
+void DefaultCache::CollectKeysWithPrefix(DiskCache& disk_cache, bool records,
+                                         const std::string& prefix,
+                                         std::vector<std::string>& keys) {
+  auto iterator = disk_cache.NewIterator();
+  if (!iterator) {
+    return;
+  }
+
+  for (iterator->Seek(prefix);
+       iterator->Valid() && iterator->key().starts_with(prefix);
+       iterator->Next()) {
+    auto key = iterator->key().ToString();
+    if (DiskCacheRecord::IsInternalKey(key.data(), key.size()) ||
+        (!records && DiskCacheRecord::IsLegacyExpiryKey(key))) {
+      continue;
+    }
+    keys.emplace_back(std::move(key));
+  }
+}
+
+void DefaultCache::LoadWarmupKeys(WarmupJob& job, size_t task) {
+  // Every task takes every task_count-th key, so the tasks move through
+  // the keys together, and the budget is spent on the first keys.
+  std::vector<std::vector<std::string>> shard_keys(shards_.size());
+  for (size_t first = task * kWarmupBatchSize; first < job.keys.size();
+       first += job.task_count * kWarmupBatchSize) {
+    const auto last = std::min(first + kWarmupBatchSize, job.keys.size());
+    for (size_t i = first; i < last; ++i) {
+      shard_keys[GetShardIndex(job.keys[i])].push_back(job.keys[i]);
+    }
+
+    for (size_t index = 0; index < shards_.size(); ++index) {
+      auto& keys = shard_keys[index];
+      if (keys.empty()) {
+        continue;
+      }
+
+      if (job.bytes_read.load() >= job.max_bytes) {
+        return;
+      }
+
+      auto& shard = *shards_[index];
+      std::lock_guard<std::mutex> lock(shard.lock);
+      if (!is_open_) {
+        return;
+      }
+
+      // The values that are already in memory may be newer than on the disk.
+      keys.erase(std::remove_if(keys.begin(), keys.end(),
+                                [&](const std::string& key) {
+                                  return !shard.memory_cache->Get(key).empty();
+                                }),
+                 keys.end());
+
+      auto items = GetFromDiscCache(keys);
+      for (size_t i = 0; i < items.size(); ++i) {
+        auto& item = items[i];
+        if (!item) {
+          continue;
+        }
+
+        const auto size = item->first.size();
+        if (job.bytes_read.fetch_add(size) + size > job.max_bytes) {
+          return;
+        }
+
+        auto value = std::make_shared<const WarmedValue>(WarmedValue{
+            std::move(item->first), GetAbsoluteExpiryTime(item->second)});
+        if (shard.memory_cache->Put(keys[i], WarmedValuePtr(std::move(value)),
+                                    item->second, size)) {
+          ++job.loaded_count;
+        }
+      }
+      keys.clear();
+    }
+  }
+}
+
+bool DefaultCache::PutToDiscCache(const std::string& key,
+                                  const std::string& record) {
+  const auto start = statistics_->Start();
+  if (!mutable_cache_->Put(key, record)) {
+    return false;
+  }
+
+  statistics_->Finish(StatisticsRecorder::kDiskWrite, start);
+  statistics_->Add(StatisticsRecorder::kBytesWritten, key, record.size());
+  return true;
+}
+
+bool DefaultCache::PutToDiscCache(
+    const std::vector<std::pair<std::string, std::string>>& items) {
+  const auto start = statistics_->Start();
+  if (!mutable_cache_->PutBatch(items)) {
+    return false;
+  }
+
+  statistics_->Finish(StatisticsRecorder::kDiskWrite, start);
+  for (const auto& item : items) {
+    statistics_->Add(StatisticsRecorder::kBytesWritten, item.first,
+                     item.second.size());
+  }
+  return true;
+}
+
+bool DefaultCache::WriteToDiscCache(
+    const std::vector<std::pair<std::string, std::string>>& items) {
+  // Called by the write-behind thread, which holds no shard locks. Closing
+  // and flushing the cache wait for this thread under the maintenance lock, so
+  // the maintenance runs here only if the lock is free.
+  if (PutToDiscCache(items) ||
+      (MakeRoomOnDisk(false) && PutToDiscCache(items))) {
+    if (NeedsMaintenance()) {
+      ScheduleMaintenance();
+    }
+    return true;
+  }
+
+  if (IsDiskFull()) {
+    for (const auto& item : items) {
+      statistics_->Add(StatisticsRecorder::kPutFailures, item.first);
+    }
+    ScheduleMaintenance();
+  }
+  return false;
+}
+
+bool DefaultCache::IsDiskFull() const {
+  return mutable_cache_ &&
+         mutable_cache_->Size() >= settings_.max_disk_storage;
+}
+
+bool DefaultCache::NeedsMaintenance() const {
+  // The maintenance starts before the disk is full, so the writes do not
+  // fail, and runs periodically to remove the expired values.
+  if (mutable_cache_->Size() >=
+      GetStorageMark(settings_, settings_.disk_storage_high_water_mark)) {
+    return true;
+  }
+
+  return settings_.disk_maintenance_interval > 0u &&
+         InMemoryCache::DefaultTimeProvider()() >= maintenance_->due_time;
+}
+
+bool DefaultCache::MakeRoomOnDisk(bool wait) {
+  std::unique_lock<std::mutex> lock(maintenance_->lock, std::defer_lock);
+  if (wait) {
+    lock.lock();
+  } else if (!lock.try_lock()) {
+    return false;
+  }
+
+  // The disk may have been trimmed while waiting for the lock.
+  if (!is_open_ || !IsDiskFull()) {
+    return is_open_ && mutable_cache_;
+  }
+
+  OLP_SDK_LOG_INFO(kLogTag, "Disk cache is full, running the maintenance");
+  Maintain();
+  return !IsDiskFull();
+}
+
+void DefaultCache::ScheduleMaintenance() {
+  if (!settings_.task_scheduler || maintenance_->scheduled.exchange(true)) {
+    return;
+  }
+
+  OLP_SDK_LOG_INFO(kLogTag, "Scheduling the disk cache maintenance");
+
+  std::weak_ptr<MaintenanceState> weak_state = maintenance_;
+  settings_.task_scheduler->ScheduleTask([weak_state]() {
+    auto state = weak_state.lock();
+    if (!state) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(state->lock);
+    state->scheduled = false;
+    if (state->cache) {
+      state->cache->Maintain();
+    }
+  });
+}
+
+std::uint64_t DefaultCache::Maintain() {
+  maintenance_->due_time = InMemoryCache::DefaultTimeProvider()() +
+                           settings_.disk_maintenance_interval;
+  if (!is_open_ || !mutable_cache_) {
+    return 0u;
+  }
+
+  struct Candidate {
+    std::string key;
+    std::uint64_t size;
+    size_t shard;
+    size_t slot;
+    bool expired;
+  };
+
+  // The keys are removed only if their ticks did not change since the copy,
+  // so the values that are accessed during the maintenance are kept.
+  std::vector<std::vector<std::uint32_t>> ticks(shards_.size());
+  for (size_t index = 0; index < shards_.size(); ++index) {
+    auto& shard = *shards_[index];
+    std::lock_guard<std::mutex> lock(shard.lock);
+    ApplyTouches(shard);
+    ticks[index] = shard.access_ticks;
+  }
+
+  const auto read_candidate = [&](const leveldb::Iterator& iterator,
+                                  time_t now, Candidate& candidate) {
+    const auto key = iterator.key();
+    const auto value = iterator.value();
+    if (DiskCacheRecord::IsInternalKey(key.data(), key.size())) {
+      return false;
+    }
+
+    time_t expiry = DiskCacheRecord::kNoExpiry;
+    candidate.expired =
+        !DiskCacheRecord::DecodeExpiry(value.data(), value.size(), expiry) ||
+        expiry <= now;
+    // The values in the segment files are reclaimed along with the pointers.
+    BlobPointer pointer;
+    const auto blob_size = DiskCacheRecord::DecodeBlobPointer(
+                               value.data(), value.size(), pointer)
+                               ? pointer.size
+                               : 0u;
+    candidate.key = key.ToString();
+    candidate.size = key.size() + value.size() + blob_size;
+    candidate.shard = GetShardIndex(candidate.key);
+    candidate.slot = GetAccessSlot(candidate.key);
+    return !ticks[candidate.shard].empty();
+  };
+
+  // The disk is scanned without holding the keys, the candidates are removed
+  // in batches under the lock of their shard.
+  std::vector<std::vector<Candidate>> batches(shards_.size());
+  size_t batched_count = 0u;
+  const auto remove_batches = [&]() {
+    std::uint64_t removed = 0u;
+    for (size_t index = 0; index < shards_.size(); ++index) {
+      auto& candidates = batches[index];
+      if (candidates.empty()) {
+        continue;
+      }
+
+      auto& shard = *shards_[index];
+      std::lock_guard<std::mutex> lock(shard.lock);
+      candidates.erase(
+          std::remove_if(candidates.begin(), candidates.end(),
+                         [&](const Candidate& candidate) {
+                           return shard.access_ticks[candidate.slot] !=
+                                  ticks[index][candidate.slot];
+                         }),
+          candidates.end());
+
+      auto batch = std::make_unique<leveldb::WriteBatch>();
+      std::uint64_t batch_size = 0u;
+      for (const auto& candidate : candidates) {
+        batch->Delete(candidate.key);
+        batch_size += candidate.size;
+      }
+
+      if (batch_size > 0u && mutable_cache_->ApplyBatch(std::move(batch))) {
+        removed += batch_size;
+        for (const auto& candidate : candidates) {
+          statistics_->Add(candidate.expired
+                               ? StatisticsRecorder::kExpirations
+                               : StatisticsRecorder::kEvictions,
+                           candidate.key);
+        }
+      }
+      candidates.clear();
+    }
+    batched_count = 0u;
+    return removed;
+  };
+
+  const auto add_candidate = [&](Candidate& candidate, std::uint64_t& removed) {
+    batches[candidate.shard].emplace_back(std::move(candidate));
+    if (++batched_count >= kMaintenanceBatchSize) {
+      removed += remove_batches();
+    }
+  };
+
+  const auto low_water_mark =
+      GetStorageMark(settings_, settings_.disk_storage_low_water_mark);
+
+  // The expired values are removed first. The bytes of the other values are
+  // counted by shard and by tick, which is bounded by the number of slots.
+  // The size limit applies to the files on the disk, so the storage is
+  // compacted before deciding whether the least recently used values have to
+  // be evicted as well.
+  std::uint64_t reclaimed = 0u;
+  std::vector<std::map<std::uint32_t, std::uint64_t>> tick_sizes(
+      shards_.size());
+  std::vector<std::uint64_t> shard_sizes(shards_.size(), 0u);
+  {
+    auto iterator = mutable_cache_->NewIterator();
+    if (!iterator) {
+      return 0u;
+    }
+
+    const auto now = InMemoryCache::DefaultTimeProvider()();
+    Candidate candidate;
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+      if (!read_candidate(*iterator, now, candidate)) {
+        continue;
+      }
+
+      if (candidate.expired) {
+        add_candidate(candidate, reclaimed);
+      } else {
+        tick_sizes[candidate.shard][ticks[candidate.shard][candidate.slot]] +=
+            candidate.size;
+        shard_sizes[candidate.shard] += candidate.size;
+      }
+    }
+    reclaimed += remove_batches();
+  }
+
+  // The segments also hold the values removed since the last maintenance.
+  mutable_cache_->CollectGarbage();
+  if (reclaimed > 0u || mutable_cache_->Size() > low_water_mark) {
+    mutable_cache_->Compact();
+  }
+
+  const auto size = mutable_cache_->Size();
+  std::uint64_t total_size = 0u;
+  for (auto shard_size : shard_sizes) {
+    total_size += shard_size;
+  }
+
+  if (size > low_water_mark && total_size > 0u) {
+    // The ticks of the shards are not comparable, so every shard evicts its
+    // least recently used values in proportion to its share of the cache:
+    // the values with ticks below the threshold, and the values with
+    // the threshold tick until the budget is spent.
+    std::vector<std::uint32_t> thresholds(shards_.size(), 0u);
+    std::vector<std::uint64_t> budgets(shards_.size(), 0u);
+    for (size_t index = 0; index < shards_.size(); ++index) {
+      auto target = static_cast<std::uint64_t>(
+          static_cast<double>(size - low_water_mark) * shard_sizes[index] /
+          total_size);
+      for (const auto& tick_size : tick_sizes[index]) {
+        if (target == 0u) {
+          break;
+        }
+        thresholds[index] = tick_size.first;
+        budgets[index] = target;
+        target -= std::min(target, tick_size.second);
+      }
+    }
+
+    auto iterator = mutable_cache_->NewIterator();
+    if (!iterator) {
+      return reclaimed;
+    }
+
+    std::uint64_t evicted = 0u;
+    const auto now = InMemoryCache::DefaultTimeProvider()();
+    Candidate candidate;
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+      if (!read_candidate(*iterator, now, candidate)) {
+        continue;
+      }
+
+      const auto tick = ticks[candidate.shard][candidate.slot];
+      auto& budget = budgets[candidate.shard];
+      if (tick > thresholds[candidate.shard] ||
+          (tick == thresholds[candidate.shard] && budget == 0u)) {
+        continue;
+      }
+      if (tick == thresholds[candidate.shard]) {
+        budget -= std::min(budget, candidate.size);
+      }
+      add_candidate(candidate, evicted);
+    }
+    evicted += remove_batches();
+
+    if (evicted > 0u) {
+      mutable_cache_->CollectGarbage();
+      mutable_cache_->Compact();
+    }
+    reclaimed += evicted;
+  }
+
+  maintenance_->reclaimed_bytes += reclaimed;
+  OLP_SDK_LOG_INFO_F(kLogTag,
+                     "Maintenance finished, size %llu, reclaimed %llu bytes",
+                     static_cast<unsigned long long>(mutable_cache_->Size()),
+                     static_cast<unsigned long long>(reclaimed));
+  return reclaimed;
+}
+
 DefaultCache::StorageOpenResult DefaultCache::SetupStorage() {
   auto result = Success;
 
-  memory_cache_.reset();
+  StopWriteQueue();
   mutable_cache_.reset();
   protected_cache_.reset();
+  mapped_protected_cache_.reset();
 
-  if (settings_.max_memory_cache_size > 0) {
-    memory_cache_.reset(new InMemoryCache(settings_.max_memory_cache_size));
+  for (auto& shard : shards_) {
+    if (shard->memory_cache) {
+      shard->memory_cache->Clear();
+    }
   }
 
   // Temporary code for backwards compatibility.
@@ -298,27 +1612,80 @@ DefaultCache::StorageOpenResult DefaultCache::SetupStorage() {
     storage_settings.enforce_immediate_flush =
         settings_.enforce_immediate_flush;
     storage_settings.max_file_size = settings_.max_file_size;
+    storage_settings.blob_threshold = settings_.blob_threshold;
+    storage_settings.max_blob_segment_size = settings_.max_blob_segment_size;
+    storage_settings.leveldb_profile = settings_.leveldb_profile;
+
+    if (!IsCompressionSupported(settings_.compression_codec)) {
+      OLP_SDK_LOG_WARNING(kLogTag,
+                          "The compression codec is not supported by this "
+                          "build, the values are stored uncompressed");
+    }
 
+    const auto path = settings_.disk_path_mutable.get();
     mutable_cache_ = std::make_unique<DiskCache>();
-    auto status = mutable_cache_->Open(settings_.disk_path_mutable.get(),
-                                       settings_.disk_path_mutable.get(),
-                                       storage_settings, OpenOptions::Default);
+    auto status = mutable_cache_->Open(path, path, storage_settings,
+                                       OpenOptions::Default);
+    if (status != OpenResult::Fail &&
+        !mutable_cache_->Get(DiskCacheRecord::FormatVersionKey()) &&
+        !MigrateLegacyRecords(*mutable_cache_)) {
+      // The values that are not migrated can not be read, so the cache is
+      // started from scratch instead.
+      OLP_SDK_LOG_ERROR_F(kLogTag,
+                          "Failed to migrate the mutable cache %s, clearing it",
+                          path.c_str());
+      status = OpenResult::Fail;
+      if (mutable_cache_->Clear()) {
+        status = mutable_cache_->Open(path, path, storage_settings,
+                                      OpenOptions::Default);
+      }
+      if (status != OpenResult::Fail && !StoreFormatVersion(*mutable_cache_)) {
+        status = OpenResult::Fail;
+      }
+    }
+
     if (status == OpenResult::Fail) {
       OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to open the mutable cache %s",
-                          settings_.disk_path_mutable.get().c_str());
+                          path.c_str());
 
       mutable_cache_.reset();
       settings_.disk_path_mutable = boost::none;
       result = OpenDiskPathFailure;
     }
+
+    if (mutable_cache_) {
+      LoadAccessTicks();
+    }
+
+    if (mutable_cache_ && settings_.write_behind) {
+      write_queue_ = std::make_shared<WriteBehindQueue>(
+          [this](const WriteBehindQueue::Items& items) {
+            return WriteToDiscCache(items);
+          },
+          settings_.max_write_behind_queue_size);
+    }
   }
 
-  if (settings_.disk_path_protected) {
+  if (settings_.disk_path_protected &&
+      MappedCache::IsMappedCacheFile(settings_.disk_path_protected.get())) {
+    mapped_protected_cache_ = std::make_unique<MappedCache>();
+    if (!mapped_protected_cache_->Open(settings_.disk_path_protected.get())) {
+      OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to map protected cache %s",
+                          settings_.disk_path_protected.get().c_str());
+
+      mapped_protected_cache_.reset();
+      settings_.disk_path_protected = boost::none;
+      result = OpenDiskPathFailure;
+    }
+  } else if (settings_.disk_path_protected) {
+    StorageSettings storage_settings;
+    storage_settings.leveldb_profile = settings_.leveldb_profile;
+
     protected_cache_ = std::make_unique<DiskCache>();
     auto status =
         protected_cache_->Open(settings_.disk_path_protected.get(),
                                settings_.disk_path_protected.get(),
-                               StorageSettings{}, OpenOptions::ReadOnly);
+                               storage_settings, OpenOptions::ReadOnly);
     if (status == OpenResult::Fail) {
       OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to reopen protected cache %s",
                           settings_.disk_path_protected.get().c_str());
@@ -326,35 +1693,240 @@ DefaultCache::StorageOpenResult DefaultCache::SetupStorage() {
       protected_cache_.reset();
       settings_.disk_path_protected = boost::none;
       result = OpenDiskPathFailure;
+    } else {
+      // The protected cache is read-only and can not be migrated, so the
+      // caches created by the older SDK versions are read as is.
+      protected_cache_records_ = static_cast<bool>(
+          protected_cache_->Get(DiskCacheRecord::FormatVersionKey()));
     }
   }
 
   return result;
 }
 
-boost::optional<std::pair<std::string, time_t>> DefaultCache::GetFromDiscCache(
+DefaultCache::DiscCacheItem DefaultCache::DecodeProtectedRecord(
+    const std::string& key, std::string value, bool verify_checksum) {
+  time_t expiry = DiskCacheRecord::kNoExpiry;
+  if (protected_cache_records_ &&
+      !DiskCacheRecord::Decode(value, expiry, verify_checksum)) {
+    return boost::none;
+  }
+
+  // The data in the protected cache never expires.
+  auto default_expiry = KeyValueCache::kDefaultExpiry;
+  statistics_->Add(StatisticsRecorder::kDiskHits, key);
+  statistics_->Add(StatisticsRecorder::kBytesRead, key, value.size());
+  return std::make_pair(std::move(value), default_expiry);
+}
+
+DefaultCache::DiscCacheItem DefaultCache::DecodeQueuedRecord(
+    const std::string& key, std::string record, time_t now) {
+  time_t expiry = DiskCacheRecord::kNoExpiry;
+  if (!DiskCacheRecord::Decode(record, expiry, false)) {
+    return boost::none;
+  }
+
+  expiry = GetRemainingExpiryTime(expiry, now);
+  if (expiry <= 0) {
+    return boost::none;
+  }
+
+  statistics_->Add(StatisticsRecorder::kDiskHits, key);
+  return std::make_pair(std::move(record), expiry);
+}
+
+DefaultCache::DiscCacheItem DefaultCache::DecodeMutableRecord(
+    const std::string& key, std::string record, time_t now,
+    bool verify_checksum) {
+  time_t expiry = DiskCacheRecord::kNoExpiry;
+  if (!DiskCacheRecord::Decode(record, expiry, verify_checksum)) {
+    OLP_SDK_LOG_WARNING_F(kLogTag, "Corrupted record %s, removing",
+                          key.c_str());
+    mutable_cache_->Remove(key);
+    return boost::none;
+  }
+
+  expiry = GetRemainingExpiryTime(expiry, now);
+  if (expiry <= 0) {
+    mutable_cache_->Remove(key);
+    statistics_->Add(StatisticsRecorder::kExpirations, key);
+    return boost::none;
+  }
+
+  statistics_->Add(StatisticsRecorder::kDiskHits, key);
+  statistics_->Add(StatisticsRecorder::kBytesRead, key, record.size());
+  return std::make_pair(std::move(record), expiry);
+}
+
+DefaultCache::DiscCacheItem DefaultCache::GetFromDiscCache(
     const std::string& key) {
+  // The single key lookups skip the snapshot and the vectors of the batch
+  // lookup below.
+  const bool verify_checksum =
+      (settings_.openOptions & CheckCrc) == CheckCrc;
+
+  if (auto item = GetFromProtectedCache(key, key, verify_checksum)) {
+    return item;
+  }
+  if (auto item = GetFromLegacyKey(key, verify_checksum)) {
+    return item;
+  }
+
+  return GetFromMutableDiscCache(key);
+}
+
+DefaultCache::DiscCacheItem DefaultCache::GetFromProtectedCache(
+    const std::string& key, const std::string& lookup_key,
+    bool verify_checksum) {
   if (protected_cache_) {
-    auto result = protected_cache_->Get(key);
-    if (result) {
+    if (auto value = protected_cache_->Get(lookup_key)) {
+      return DecodeProtectedRecord(key, std::move(value.value()),
+                                   verify_checksum);
+    }
+  } else if (mapped_protected_cache_) {
+    MappedCache::Value value;
+    if (mapped_protected_cache_->Get(lookup_key, value, verify_checksum)) {
+      auto data = reinterpret_cast<const char*>(value.data);
       auto default_expiry = KeyValueCache::kDefaultExpiry;
-      return std::make_pair(std::move(result.value()), default_expiry);
+      statistics_->Add(StatisticsRecorder::kDiskHits, key);
+      statistics_->Add(StatisticsRecorder::kBytesRead, key, value.size);
+      return std::make_pair(std::string(data, value.size), default_expiry);
     }
   }
+  return boost::none;
+}
 
-  if (mutable_cache_) {
-    auto expiry = GetRemainingExpiryTime(key, *mutable_cache_);
-    if (expiry <= 0) {
-      PurgeDiskItem(key, *mutable_cache_);
-    } else {
-      auto result = mutable_cache_->Get(key);
+DefaultCache::DiscCacheItem DefaultCache::GetFromLegacyKey(
+    const std::string& key, bool verify_checksum) {
+  // The protected caches are read-only, and the ones built by the older SDK
+  // versions keep the keys of their format.
+  if (!protected_cache_ && !mapped_protected_cache_) {
+    return boost::none;
+  }
+
+  const auto legacy_key = KeyEncoder::ToLegacyKey(key);
+  if (legacy_key.empty()) {
+    return boost::none;
+  }
+  return GetFromProtectedCache(key, legacy_key, verify_checksum);
+}
+
+DefaultCache::DiscCacheItem DefaultCache::GetFromMutableDiscCache(
+    const std::string& key) {
+  const bool verify_checksum =
+      (settings_.openOptions & CheckCrc) == CheckCrc;
+  const auto now = InMemoryCache::DefaultTimeProvider()();
+  DiscCacheItem item;
+  std::string record;
+  if (write_queue_ && write_queue_->Get(key, record)) {
+    // The queued record is newer than the one on the disk, so the disk is not
+    // looked up, even if the queued record expired.
+    item = DecodeQueuedRecord(key, std::move(record), now);
+  } else if (mutable_cache_) {
+    if (auto value = mutable_cache_->Get(key)) {
+      item = DecodeMutableRecord(key, std::move(value.value()), now,
+                                 verify_checksum);
+    }
+  }
+
+  if (!item) {
+    statistics_->Add(StatisticsRecorder::kMisses, key);
+  }
 
-      if (result) {
-        return std::make_pair(std::move(result.value()), expiry);
+  return item;
+}
+
+std::vector<DefaultCache::DiscCacheItem> DefaultCache::GetFromDiscCache(
+    const std::vector<std::string>& keys) {
+  std::vector<DiscCacheItem> items(keys.size());
+  std::vector<size_t> missed_indexes;
+  const bool verify_checksum =
+      (settings_.openOptions & CheckCrc) == CheckCrc;
+
+  if (protected_cache_) {
+    auto values = protected_cache_->GetBatch(keys);
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (values[i]) {
+        items[i] = DecodeProtectedRecord(keys[i], std::move(values[i].value()),
+                                         verify_checksum);
+      }
+      if (!items[i]) {
+        missed_indexes.push_back(i);
+      }
+    }
+  } else if (mapped_protected_cache_) {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      MappedCache::Value value;
+      if (mapped_protected_cache_->Get(keys[i], value, verify_checksum)) {
+        auto data = reinterpret_cast<const char*>(value.data);
+        auto default_expiry = KeyValueCache::kDefaultExpiry;
+        statistics_->Add(StatisticsRecorder::kDiskHits, keys[i]);
+        statistics_->Add(StatisticsRecorder::kBytesRead, keys[i], value.size);
+        items[i] =
+            std::make_pair(std::string(data, value.size), default_expiry);
+      } else {
+        missed_indexes.push_back(i);
       }
     }
+  } else {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      missed_indexes.push_back(i);
+    }
   }
-  return boost::none;
+
+  if (protected_cache_ || mapped_protected_cache_) {
+    std::vector<size_t> legacy_missed_indexes;
+    for (auto index : missed_indexes) {
+      items[index] = GetFromLegacyKey(keys[index], verify_checksum);
+      if (!items[index]) {
+        legacy_missed_indexes.push_back(index);
+      }
+    }
+    missed_indexes.swap(legacy_missed_indexes);
+  }
+
+  const auto now = InMemoryCache::DefaultTimeProvider()();
+  if (write_queue_ && !missed_indexes.empty()) {
+    // The queued records are newer than the ones on the disk, so the keys
+    // found in the queue are not looked up on the disk, even if expired.
+    std::vector<size_t> disk_indexes;
+    for (auto index : missed_indexes) {
+      std::string record;
+      if (write_queue_->Get(keys[index], record)) {
+        items[index] = DecodeQueuedRecord(keys[index], std::move(record), now);
+      } else {
+        disk_indexes.push_back(index);
+      }
+    }
+    missed_indexes.swap(disk_indexes);
+  }
+
+  if (mutable_cache_ && !missed_indexes.empty()) {
+    std::vector<std::string> lookup_keys;
+    lookup_keys.reserve(missed_indexes.size());
+    for (auto index : missed_indexes) {
+      lookup_keys.push_back(keys[index]);
+    }
+
+    auto values = mutable_cache_->GetBatch(lookup_keys);
+    for (size_t i = 0; i < missed_indexes.size(); ++i) {
+      if (values[i]) {
+        const auto index = missed_indexes[i];
+        items[index] = DecodeMutableRecord(
+            keys[index], std::move(values[i].value()), now, verify_checksum);
+      }
+    }
+  }
+
+  if (statistics_->IsEnabled()) {
+    for (size_t i = 0; i < items.size(); ++i) {
+      if (!items[i]) {
+        statistics_->Add(StatisticsRecorder::kMisses, keys[i]);
+      }
+    }
+  }
+
+  return items;
 }
 
 }  // namespace cache
@@ -26,11 +26,13 @@
 #include <string>
 #include <vector>
 
+#include <leveldb/cache.h>
 #include <leveldb/db.h>
 #include <leveldb/filter_policy.h>
 #include <leveldb/iterator.h>
 #include <leveldb/options.h>
 #include <leveldb/write_batch.h>
+#include "DiskCacheRecord.h"
 #include "DiskCacheSizeLimitEnv.h"
 #include "olp/core/logging/Log.h"
 #include "olp/core/porting/make_unique.h"
@@ -42,6 +44,17 @@ namespace cache {
 namespace {
 constexpr auto kLogTag = "Storage.LevelDB";
 
+// The directory of the segment files, inside the DB directory.
+constexpr auto kBlobDirectory = "/blobs";
+
+// The segments with less than this percentage of the referenced bytes are
+// rewritten by the garbage collection.
+constexpr std::uint64_t kBlobSegmentMinLivePercent = 50u;
+
+// The number of the pointers the garbage collection replaces under one
+// exclusive lock.
+constexpr size_t kBlobPointerBatchSize = 64u;
+
 leveldb::Slice ToLeveldbSlice(const std::string& slice) {
   return leveldb::Slice(slice);
 }
@@ -141,9 +154,14 @@ void DiskCache::LevelDBLogger::Logv(const char* format, va_list ap) {
   OLP_SDK_LOG_DEBUG_F("Storage.LevelDB.leveldb", format, ap);
 }
 
-void DiskCache::Close() { database_.reset(); }
+void DiskCache::Close() {
+  database_.reset();
+  blob_store_.Close();
+}
+
 bool DiskCache::Clear() {
   database_.reset();
+  blob_store_.Close();
   if (!disk_cache_path_.empty()) {
     return olp::utils::Dir::remove(disk_cache_path_);
   }
@@ -162,6 +180,11 @@ OpenResult DiskCache::Open(const std::string& data_path,
 
   bool is_read_only = (options & ReadOnly) == ReadOnly;
   max_size_ = settings.max_disk_storage;
+  read_only_ = is_read_only;
+  blob_threshold_ = settings.blob_threshold;
+  // The read-only caches may still have the values in the segment files.
+  blob_store_.Open(versioned_data_path + kBlobDirectory,
+                   settings.max_blob_segment_size, is_read_only);
 
   leveldb::Options open_options;
   open_options.info_log = leveldb_logger_.get();
@@ -170,6 +193,24 @@ OpenResult DiskCache::Open(const std::string& data_path,
     open_options.max_file_size = settings.max_file_size;
   }
 
+  // The previous database uses the block cache and the filter policy until it
+  // is closed.
+  database_.reset();
+  const auto& profile = settings.leveldb_profile;
+  block_cache_.reset(profile.block_cache_size > 0u
+                         ? leveldb::NewLRUCache(profile.block_cache_size)
+                         : nullptr);
+  filter_policy_.reset(
+      profile.bloom_filter_bits_per_key > 0
+          ? leveldb::NewBloomFilterPolicy(profile.bloom_filter_bits_per_key)
+          : nullptr);
+  open_options.block_cache = block_cache_.get();
+  open_options.filter_policy = filter_policy_.get();
+  open_options.block_size = profile.block_size;
+  open_options.max_open_files = profile.max_open_files;
+  open_options.paranoid_checks = profile.paranoid_checks;
+  open_options.reuse_logs = profile.reuse_logs;
+
   if (!is_read_only) {
     open_options.create_if_missing = true;
 
@@ -242,13 +283,19 @@ bool DiskCache::Put(const std::string& key, const std::string& value) {
     return false;
   }
 
-  if (environment_ && (max_size_ != kSizeMax) &&
-      (environment_->Size() >= max_size_)) {
+  if (environment_ && (max_size_ != kSizeMax) && (Size() >= max_size_)) {
+    return false;
+  }
+
+  std::string pointer_record;
+  if (!StoreBlob(key, value, pointer_record)) {
     return false;
   }
 
+  BlockingSharedLock lock(write_mutex_);
   const auto status = database_->Put(
-      leveldb::WriteOptions(), ToLeveldbSlice(key), ToLeveldbSlice(value));
+      leveldb::WriteOptions(), ToLeveldbSlice(key),
+      ToLeveldbSlice(pointer_record.empty() ? value : pointer_record));
   if (!status.ok()) {
     OLP_SDK_LOG_ERROR(kLogTag, "Put: failed, status=" << status.ToString());
     return false;
@@ -258,13 +305,74 @@ bool DiskCache::Put(const std::string& key, const std::string& value) {
 
 boost::optional<std::string> DiskCache::Get(const std::string& key) {
   std::string res;
-  return database_ && database_->Get({}, ToLeveldbSlice(key), &res).ok()
+  return database_ && database_->Get({}, ToLeveldbSlice(key), &res).ok() &&
+                 ResolveValue(key, res)
              ? boost::optional<std::string>(std::move(res))
              : boost::none;
 }
 
+bool DiskCache::PutBatch(
+    const std::vector<std::pair<std::string, std::string>>& items) {
+  if (!database_) {
+    return false;
+  }
+
+  if (environment_ && (max_size_ != kSizeMax) && (Size() >= max_size_)) {
+    return false;
+  }
+
+  auto batch = std::make_unique<leveldb::WriteBatch>();
+  std::string pointer_record;
+  for (const auto& item : items) {
+    if (!StoreBlob(item.first, item.second, pointer_record)) {
+      return false;
+    }
+    batch->Put(ToLeveldbSlice(item.first),
+               ToLeveldbSlice(pointer_record.empty() ? item.second
+                                                     : pointer_record));
+  }
+
+  return ApplyBatch(std::move(batch));
+}
+
+std::vector<boost::optional<std::string>> DiskCache::GetBatch(
+    const std::vector<std::string>& keys) {
+  std::vector<boost::optional<std::string>> values(keys.size());
+  if (!database_) {
+    return values;
+  }
+
+  // Read from one snapshot, so that concurrent writes do not interleave with
+  // the batch.
+  leveldb::ReadOptions opts;
+  opts.verify_checksums = check_crc_;
+  opts.snapshot = database_->GetSnapshot();
+
+  std::string res;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (database_->Get(opts, ToLeveldbSlice(keys[i]), &res).ok() &&
+        ResolveValue(keys[i], res)) {
+      values[i] = std::move(res);
+    }
+    res.clear();
+  }
+
+  database_->ReleaseSnapshot(opts.snapshot);
+  return values;
+}
+
+uint64_t DiskCache::Size() const {
+  return environment_ ? environment_->Size() + blob_store_.Size() : 0u;
+}
+
 bool DiskCache::Remove(const std::string& key) {
-  if (!database_ || !database_->Delete(leveldb::WriteOptions(), key).ok())
+  if (!database_) {
+    return false;
+  }
+
+  // The value in the segment files is reclaimed by the garbage collection.
+  BlockingSharedLock lock(write_mutex_);
+  if (!database_->Delete(leveldb::WriteOptions(), key).ok())
     return false;
   return true;
 }
@@ -294,6 +402,7 @@ bool DiskCache::RemoveKeysWithPrefix(const std::string& prefix) {
     }
   }
 
+  BlockingSharedLock lock(write_mutex_);
   const auto status = database_->Write(leveldb::WriteOptions(), batch.get());
   if (!status.ok()) {
     OLP_SDK_LOG_ERROR(
@@ -303,5 +412,171 @@ bool DiskCache::RemoveKeysWithPrefix(const std::string& prefix) {
   return true;
 }
 
+std::unique_ptr<leveldb::Iterator> DiskCache::NewIterator() {
+  if (!database_) {
+    return nullptr;
+  }
+
+  leveldb::ReadOptions opts;
+  opts.verify_checksums = check_crc_;
+  opts.fill_cache = false;
+  return std::unique_ptr<leveldb::Iterator>(database_->NewIterator(opts));
+}
+
+bool DiskCache::ApplyBatch(std::unique_ptr<leveldb::WriteBatch> batch) {
+  if (!database_) {
+    return false;
+  }
+
+  BlockingSharedLock lock(write_mutex_);
+  const auto status = database_->Write(leveldb::WriteOptions(), batch.get());
+  if (!status.ok()) {
+    OLP_SDK_LOG_ERROR(kLogTag,
+                      "ApplyBatch: failed, status=" << status.ToString());
+    return false;
+  }
+  return true;
+}
+
+void DiskCache::Compact() {
+  if (database_) {
+    database_->CompactRange(nullptr, nullptr);
+  }
+}
+
+bool DiskCache::ResolveValue(const std::string& key, std::string& value) {
+  BlobPointer pointer;
+  if (!DiskCacheRecord::DecodeBlobPointer(value.data(), value.size(),
+                                          pointer)) {
+    return true;
+  }
+
+  if (blob_store_.Read(pointer, value)) {
+    return true;
+  }
+
+  // The garbage collection replaces the pointer before it removes the old
+  // segment, so the current pointer is tried once more.
+  std::string current;
+  if (database_ && database_->Get({}, ToLeveldbSlice(key), &current).ok() &&
+      DiskCacheRecord::DecodeBlobPointer(current.data(), current.size(),
+                                         pointer) &&
+      blob_store_.Read(pointer, value)) {
+    return true;
+  }
+
+  OLP_SDK_LOG_WARNING(kLogTag, "ResolveValue: failed to read the value of "
+                                   << key << " from the segment files");
+  return false;
+}
+
+uint64_t DiskCache::CollectGarbage() {
+  if (!database_ || read_only_) {
+    return 0u;
+  }
+
+  uint64_t reclaimed = 0u;
+  for (const auto& segment : blob_store_.GetSealedSegments()) {
+    std::vector<std::pair<std::string, BlobPointer>> referenced;
+    uint64_t referenced_size = 0u;
+    blob_store_.ScanSegment(
+        segment.first, [&](const std::string& key, const BlobPointer& pointer) {
+          if (IsReferenced(key, pointer)) {
+            referenced.emplace_back(key, pointer);
+            referenced_size +=
+                BlobStore::kEntryHeaderSize + key.size() + pointer.size;
+          }
+        });
+
+    if (referenced_size * 100u >=
+        segment.second * kBlobSegmentMinLivePercent) {
+      continue;
+    }
+
+    // Copy the referenced values to the newest segment; the pointers are
+    // replaced only if they were not changed in the meantime.
+    std::vector<std::pair<std::string, std::string>> moved;
+    bool copied = true;
+    for (const auto& item : referenced) {
+      std::string record;
+      BlobPointer pointer;
+      if (!blob_store_.Read(item.second, record) ||
+          !blob_store_.Append(item.first, record, pointer)) {
+        copied = false;
+        break;
+      }
+      moved.emplace_back(item.first,
+                         DiskCacheRecord::EncodeBlobPointer(record, pointer));
+    }
+
+    if (!copied) {
+      continue;
+    }
+
+    // The exclusive lock is taken for a limited number of pointers at a time,
+    // so the writes are not blocked for the whole segment.
+    bool replaced = true;
+    for (size_t first = 0; first < moved.size() && replaced;
+         first += kBlobPointerBatchSize) {
+      const auto last = std::min(first + kBlobPointerBatchSize, moved.size());
+      std::lock_guard<BlockingSharedMutex> lock(write_mutex_);
+      leveldb::WriteBatch batch;
+      for (size_t i = first; i < last; ++i) {
+        if (IsReferenced(referenced[i].first, referenced[i].second)) {
+          batch.Put(ToLeveldbSlice(moved[i].first),
+                    ToLeveldbSlice(moved[i].second));
+        }
+      }
+
+      const auto status = database_->Write(leveldb::WriteOptions(), &batch);
+      if (!status.ok()) {
+        OLP_SDK_LOG_ERROR(kLogTag, "CollectGarbage: failed, status="
+                                       << status.ToString());
+        replaced = false;
+      }
+    }
+
+    if (replaced && blob_store_.RemoveSegment(segment.first)) {
+      reclaimed += segment.second - referenced_size;
+    }
+  }
+
+  return reclaimed;
+}
+
+bool DiskCache::StoreBlob(const std::string& key, const std::string& value,
+                          std::string& pointer_record) {
+  pointer_record.clear();
+  time_t expiry = DiskCacheRecord::kNoExpiry;
+  if (blob_threshold_ == 0u || value.size() < blob_threshold_ ||
+      !DiskCacheRecord::DecodeExpiry(value.data(), value.size(), expiry)) {
+    return true;
+  }
+
+  if (environment_ && max_size_ != kSizeMax &&
+      Size() + value.size() > max_size_) {
+    return false;
+  }
+
+  BlobPointer pointer;
+  if (!blob_store_.Append(key, value, pointer)) {
+    return false;
+  }
+
+  pointer_record = DiskCacheRecord::EncodeBlobPointer(value, pointer);
+  return true;
+}
+
+bool DiskCache::IsReferenced(const std::string& key,
+                             const BlobPointer& pointer) {
+  std::string value;
+  BlobPointer current;
+  return database_->Get({}, ToLeveldbSlice(key), &value).ok() &&
+         DiskCacheRecord::DecodeBlobPointer(value.data(), value.size(),
+                                            current) &&
+         current.segment == pointer.segment &&
+         current.offset == pointer.offset;
+}
+
 }  // namespace cache
 }  // namespace olp
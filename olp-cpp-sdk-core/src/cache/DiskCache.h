@@ -32,9 +32,14 @@
 #include <leveldb/write_batch.h>
 #include <olp/core/cache/CacheSettings.h>
 #include <olp/core/client/ApiError.h>
+#include "BlobStore.h"
+#include "SharedMutex.h"
 
 namespace leveldb {
+class Cache;
 class DB;
+class FilterPolicy;
+class Iterator;
 }  // namespace leveldb
 
 namespace olp {
@@ -67,6 +72,13 @@ struct StorageSettings {
   bool enforce_immediate_flush = true;
   /// Maximum size of one file in storage, default 2MBytes.
   size_t max_file_size = 2 * 1024u * 1024u;
+  /// The records of at least this size (in bytes) are stored in the segment
+  /// files next to DB, and DB keeps only the pointers to them. 0 disables it.
+  size_t blob_threshold = 0u;
+  /// The maximum size of one segment file, default 64 MBytes.
+  uint64_t max_blob_segment_size = 64 * 1024u * 1024u;
+  /// The bloom filters, the block cache and the other LevelDB tuning.
+  LevelDbProfile leveldb_profile;
 };
 
 /**
@@ -94,24 +106,62 @@ class DiskCache {
   bool Put(const std::string& key, const std::string& value);
   boost::optional<std::string> Get(const std::string& key);
 
-  size_t Size() const;
+  /// Writes all the key/value pairs to DB in one write batch.
+  bool PutBatch(const std::vector<std::pair<std::string, std::string>>& items);
+  /// Reads the values of all the keys from the same DB snapshot.
+  std::vector<boost::optional<std::string>> GetBatch(
+      const std::vector<std::string>& keys);
+
+  /// The size of the DB and the segment files, 0 if the size is not limited.
+  uint64_t Size() const;
 
   /// Remove single key/value from DB.
   bool Remove(const std::string& key);
   /// Empty prefix deleted everything from DB.
   bool RemoveKeysWithPrefix(const std::string& prefix);
 
+  /// Creates an iterator over the whole DB, nullptr if DB is not open.
+  std::unique_ptr<leveldb::Iterator> NewIterator();
+  /// Writes the batch to DB, ignoring the size limit.
+  bool ApplyBatch(std::unique_ptr<leveldb::WriteBatch> batch);
+  /// Compacts the whole DB, so the space of the removed values is reclaimed.
+  void Compact();
+
+  /// Replaces the blob pointer record read from DB, e.g. by an iterator, with
+  /// the record it points to. Other values are left as they are. Returns
+  /// false if the pointed record can not be read.
+  bool ResolveValue(const std::string& key, std::string& value);
+
+  /// Moves the values that are still referenced out of the segments that are
+  /// mostly garbage, and removes these segments and the unreferenced ones.
+  /// Returns the number of the reclaimed bytes.
+  uint64_t CollectGarbage();
+
  private:
   void SetOpenError(const leveldb::Status& status);
-  bool ApplyBatch(std::unique_ptr<leveldb::WriteBatch> batch);
+  /// Moves the record to the segment files if it is large enough, and
+  /// replaces it with the blob pointer. Returns false if the append failed.
+  bool StoreBlob(const std::string& key, const std::string& value,
+                 std::string& pointer_record);
+  bool IsReferenced(const std::string& key, const BlobPointer& pointer);
 
  private:
   std::string disk_cache_path_;
+  /// Used by the database, so declared before it.
+  std::unique_ptr<leveldb::Cache> block_cache_;
+  std::unique_ptr<const leveldb::FilterPolicy> filter_policy_;
   std::unique_ptr<leveldb::DB> database_;
   std::unique_ptr<DiskCacheSizeLimitEnv> environment_;
   std::unique_ptr<LevelDBLogger> leveldb_logger_;
   uint64_t max_size_{kSizeMax};
   bool check_crc_{false};
+  bool read_only_{false};
+  size_t blob_threshold_{0u};
+  BlobStore blob_store_;
+  /// The writes take the shared lock; the garbage collection takes
+  /// the exclusive lock to replace the pointers only if they are unchanged.
+  /// Held across the database writes, so the waiting threads block.
+  BlockingSharedMutex write_mutex_;
   client::ApiError error_;
 };
 
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "DiskCacheRecord.h"
+
+#include <cstring>
+
+#include <boost/crc.hpp>
+#include "BlobStore.h"
+#include "Compression.h"
+#include "LittleEndian.h"
+
+namespace olp {
+namespace cache {
+
+namespace {
+constexpr size_t kFlagsOffset = 1u;
+constexpr size_t kCodecOffset = 2u;
+constexpr size_t kChecksumOffset = 4u;
+constexpr size_t kExpiryOffset = 8u;
+
+// The internal keys start with a zero byte, so they are never matched by
+// the key prefix of the cached data.
+constexpr char kInternalKeyPrefix[] = "\0internal::";
+constexpr char kFormatVersionKey[] = "\0internal::format_version";
+constexpr char kAccessTicksKey[] = "\0internal::access_ticks";
+
+// The legacy format stored the expiry time as a separate key.
+constexpr char kLegacyExpirySuffix[] = "::expiry";
+
+// The compressed value is prefixed with the original size.
+constexpr size_t kOriginalSizeSize = 8u;
+
+// The blob pointer holds the segment, the offset, and the size.
+constexpr size_t kBlobPointerSize = 24u;
+}  // namespace
+
+constexpr std::uint8_t DiskCacheRecord::kVersion;
+constexpr size_t DiskCacheRecord::kHeaderSize;
+constexpr time_t DiskCacheRecord::kNoExpiry;
+
+std::uint32_t DiskCacheRecord::Checksum(const char* data, size_t size) {
+  boost::crc_32_type crc;
+  crc.process_bytes(data, size);
+  return crc.checksum();
+}
+
+std::string DiskCacheRecord::FormatVersionKey() {
+  return std::string(kFormatVersionKey, sizeof(kFormatVersionKey) - 1);
+}
+
+std::string DiskCacheRecord::AccessTicksKey() {
+  return std::string(kAccessTicksKey, sizeof(kAccessTicksKey) - 1);
+}
+
+bool DiskCacheRecord::IsInternalKey(const char* data, size_t size) {
+  const auto prefix_size = sizeof(kInternalKeyPrefix) - 1;
+  return size >= prefix_size &&
+         std::memcmp(data, kInternalKeyPrefix, prefix_size) == 0;
+}
+
+std::string DiskCacheRecord::LegacyExpiryKey(const std::string& key) {
+  return key + kLegacyExpirySuffix;
+}
+
+bool DiskCacheRecord::IsLegacyExpiryKey(const std::string& key) {
+  const auto suffix_size = sizeof(kLegacyExpirySuffix) - 1;
+  return key.size() >= suffix_size &&
+         key.compare(key.size() - suffix_size, suffix_size,
+                     kLegacyExpirySuffix) == 0;
+}
+
+std::string DiskCacheRecord::Encode(const std::string& value, time_t expiry,
+                                    CompressionCodec codec) {
+  return Encode(reinterpret_cast<const unsigned char*>(value.data()),
+                value.size(), expiry, codec);
+}
+
+std::string DiskCacheRecord::Encode(const unsigned char* data, size_t size,
+                                    time_t expiry, CompressionCodec codec) {
+  const auto value = reinterpret_cast<const char*>(data);
+  std::string record(kHeaderSize, '\0');
+
+  if (codec != CompressionCodec::None) {
+    record.resize(kHeaderSize + kOriginalSizeSize);
+    WriteLittleEndian<std::uint64_t>(&record[kHeaderSize], size);
+    // Keep the value as it is, if it does not get smaller.
+    if (!Compress(codec, value, size, record) || record.size() >= size) {
+      record.resize(kHeaderSize);
+      codec = CompressionCodec::None;
+    }
+  }
+
+  if (codec == CompressionCodec::None) {
+    record.reserve(kHeaderSize + size);
+    record.append(value, size);
+  }
+
+  std::uint8_t flags = 0u;
+  if (expiry != kNoExpiry) {
+    flags |= kHasExpiry;
+    WriteLittleEndian<std::int64_t>(&record[kExpiryOffset], expiry);
+  }
+
+  record[0] = static_cast<char>(kVersion);
+  record[kFlagsOffset] = static_cast<char>(flags);
+  record[kCodecOffset] = static_cast<char>(codec);
+  WriteLittleEndian<std::uint32_t>(
+      &record[kChecksumOffset],
+      Checksum(record.data() + kHeaderSize, record.size() - kHeaderSize));
+  return record;
+}
+
+std::string DiskCacheRecord::EncodeBlobPointer(const std::string& record,
+                                               const BlobPointer& pointer) {
+  std::string result(record, 0, kHeaderSize);
+  result.resize(kHeaderSize + kBlobPointerSize);
+  result[kFlagsOffset] = static_cast<char>(
+      static_cast<std::uint8_t>(result[kFlagsOffset]) | kBlobPointer);
+  WriteLittleEndian<std::uint64_t>(&result[kHeaderSize], pointer.segment);
+  WriteLittleEndian<std::uint64_t>(&result[kHeaderSize + 8u], pointer.offset);
+  WriteLittleEndian<std::uint64_t>(&result[kHeaderSize + 16u], pointer.size);
+  WriteLittleEndian<std::uint32_t>(
+      &result[kChecksumOffset],
+      Checksum(result.data() + kHeaderSize, kBlobPointerSize));
+  return result;
+}
+
+bool DiskCacheRecord::DecodeBlobPointer(const char* data, size_t size,
+                                        BlobPointer& pointer) {
+  time_t expiry = kNoExpiry;
+  if (size != kHeaderSize + kBlobPointerSize ||
+      !DecodeExpiry(data, size, expiry) ||
+      !(static_cast<std::uint8_t>(data[kFlagsOffset]) & kBlobPointer) ||
+      ReadLittleEndian<std::uint32_t>(data + kChecksumOffset) !=
+          Checksum(data + kHeaderSize, kBlobPointerSize)) {
+    return false;
+  }
+
+  pointer.segment = ReadLittleEndian<std::uint64_t>(data + kHeaderSize);
+  pointer.offset = ReadLittleEndian<std::uint64_t>(data + kHeaderSize + 8u);
+  pointer.size = ReadLittleEndian<std::uint64_t>(data + kHeaderSize + 16u);
+  return true;
+}
+
+bool DiskCacheRecord::Decode(std::string& record, time_t& expiry,
+                             bool verify_checksum) {
+  // The blob pointers are resolved by the disk cache.
+  if (!DecodeExpiry(record.data(), record.size(), expiry) ||
+      (static_cast<std::uint8_t>(record[kFlagsOffset]) & kBlobPointer)) {
+    return false;
+  }
+
+  if (verify_checksum) {
+    const auto checksum =
+        ReadLittleEndian<std::uint32_t>(&record[kChecksumOffset]);
+    if (checksum != Checksum(record.data() + kHeaderSize,
+                             record.size() - kHeaderSize)) {
+      return false;
+    }
+  }
+
+  const auto codec =
+      static_cast<CompressionCodec>(static_cast<std::uint8_t>(
+          record[kCodecOffset]));
+  if (codec == CompressionCodec::None) {
+    record.erase(0, kHeaderSize);
+    return true;
+  }
+
+  if (record.size() < kHeaderSize + kOriginalSizeSize) {
+    return false;
+  }
+
+  const auto size = ReadLittleEndian<std::uint64_t>(&record[kHeaderSize]);
+  const auto compressed_offset = kHeaderSize + kOriginalSizeSize;
+  std::string value;
+  if (size > value.max_size() ||
+      !Decompress(codec, record.data() + compressed_offset,
+                  record.size() - compressed_offset,
+                  static_cast<size_t>(size), value)) {
+    return false;
+  }
+
+  record.swap(value);
+  return true;
+}
+
+bool DiskCacheRecord::DecodeExpiry(const char* data, size_t size,
+                                   time_t& expiry) {
+  if (size < kHeaderSize || static_cast<std::uint8_t>(data[0]) != kVersion) {
+    return false;
+  }
+
+  const auto flags = static_cast<std::uint8_t>(data[kFlagsOffset]);
+  expiry = (flags & kHasExpiry)
+               ? static_cast<time_t>(
+                     ReadLittleEndian<std::int64_t>(data + kExpiryOffset))
+               : kNoExpiry;
+  return true;
+}
+
+}  // namespace cache
+}  // namespace olp
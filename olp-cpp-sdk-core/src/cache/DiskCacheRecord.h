@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <time.h>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <olp/core/cache/CacheSettings.h>
+
+namespace olp {
+namespace cache {
+
+struct BlobPointer;
+
+/**
+ * @brief The format of the values that are stored in the disk cache.
+ *
+ * Every value is prefixed with a fixed size binary header:
+ *
+ * | Offset | Size | Field                                            |
+ * |--------|------|--------------------------------------------------|
+ * | 0      | 1    | The format version, `kVersion`.                  |
+ * | 1      | 1    | Flags, see `Flags`.                              |
+ * | 2      | 1    | The compression codec, see `CompressionCodec`.   |
+ * | 3      | 1    | Reserved, always zero.                           |
+ * | 4      | 4    | CRC-32 of the stored value, little endian.       |
+ * | 8      | 8    | Absolute expiry time (seconds), little endian.   |
+ *
+ * Keeping the expiry time in the same record as the value lets the cache
+ * read and write an item with one disk access.
+ *
+ * The compressed value is prefixed with its original size, 8 bytes, little
+ * endian. The checksum covers the stored bytes, so it is verified before
+ * the value is decompressed.
+ *
+ * The large records can be moved to the segment files of `BlobStore`. Then
+ * the disk cache keeps the blob pointer record instead: the header of
+ * the moved record with the `kBlobPointer` flag, followed by the segment,
+ * the offset, and the size of the moved record, 8 bytes each, little endian.
+ * The checksum of the pointer covers these 24 bytes.
+ */
+class DiskCacheRecord {
+ public:
+  /// The current format version.
+  static constexpr std::uint8_t kVersion = 1u;
+  /// The size of the header in bytes.
+  static constexpr size_t kHeaderSize = 16u;
+  /// The expiry time of the values that never expire.
+  static constexpr time_t kNoExpiry = std::numeric_limits<time_t>::max();
+
+  /// The record flags.
+  enum Flags : std::uint8_t {
+    /// The expiry field is set.
+    kHasExpiry = 0x01,
+    /// The record points to the value stored in the segment files.
+    kBlobPointer = 0x02
+  };
+
+  /// Creates the record from the value and its absolute expiry time. Pass
+  /// `kNoExpiry` for values that never expire. The value is compressed with
+  /// `codec` if it is supported and makes the value smaller.
+  static std::string Encode(const std::string& value, time_t expiry,
+                            CompressionCodec codec = CompressionCodec::None);
+  static std::string Encode(const unsigned char* data, size_t size,
+                            time_t expiry,
+                            CompressionCodec codec = CompressionCodec::None);
+
+  /// Strips the header from the record in place, decompresses the value,
+  /// and returns the absolute expiry time in `expiry`. Returns false if the
+  /// record is malformed, has an unknown version or codec, or (with
+  /// `verify_checksum`) the checksum does not match.
+  static bool Decode(std::string& record, time_t& expiry,
+                     bool verify_checksum);
+
+  /// Reads only the absolute expiry time from the record header. Returns
+  /// false if the record is malformed or has an unknown version.
+  static bool DecodeExpiry(const char* data, size_t size, time_t& expiry);
+
+  /// Creates the blob pointer record for the record stored at `pointer`.
+  /// The pointer keeps the expiry of the record.
+  static std::string EncodeBlobPointer(const std::string& record,
+                                       const BlobPointer& pointer);
+
+  /// Reads the blob pointer record. Returns false if the data is not a valid
+  /// blob pointer record.
+  static bool DecodeBlobPointer(const char* data, size_t size,
+                                BlobPointer& pointer);
+
+  /// Calculates the CRC-32 checksum of the data.
+  static std::uint32_t Checksum(const char* data, size_t size);
+
+  /// The key that stores the format version in the disk cache. The caches
+  /// without it were created by the older SDK versions.
+  static std::string FormatVersionKey();
+
+  /// The key that stores the access ticks of the cached keys, so the least
+  /// recently used values are evicted first after a restart as well.
+  static std::string AccessTicksKey();
+
+  /// Checks if the key is one of the internal keys above, which are not
+  /// the cached data.
+  static bool IsInternalKey(const char* data, size_t size);
+
+  /// The key that stores the expiry time of `key` in the legacy format.
+  static std::string LegacyExpiryKey(const std::string& key);
+  /// Checks if the key stores the expiry time in the legacy format.
+  static bool IsLegacyExpiryKey(const std::string& key);
+};
+
+}  // namespace cache
+}  // namespace olp
@@ -50,6 +50,11 @@ DiskCacheSizeLimitEnv::DiskCacheSizeLimitEnv(leveldb::Env* env,
   std::vector<std::string> children;
   if (target()->GetChildren(base_path, &children).ok()) {
     for (const std::string& child : children) {
+      // GetChildren() also lists the directory itself and its parent.
+      if (child == "." || child == "..") {
+        continue;
+      }
+
       uint64_t size;
       std::string full_path(base_path + PathSeparator() + child);
       if (target()->GetFileSize(full_path, &size).ok()) {
@@ -19,6 +19,9 @@
 
 #include "InMemoryCache.h"
 
+#include <algorithm>
+#include <thread>
+
 namespace olp {
 namespace cache {
 namespace {
@@ -27,22 +30,120 @@ inline bool HasExpiry(time_t expiry_seconds) {
 }
 }  // namespace
 
+constexpr size_t InMemoryCache::ReadBuffer::kSize;
+constexpr size_t InMemoryCache::kReadBufferCount;
+
+InMemoryCache::ReadBuffer::ReadBuffer() : writes(0u) {
+  for (auto& handle : handles) {
+    handle.store(kNoHandle, std::memory_order_relaxed);
+  }
+}
+
 InMemoryCache::InMemoryCache(size_t max_size, ModelCacheCostFunc cache_cost,
-                             TimeProvider time_provider)
-    : item_tuples_(max_size, std::move(cache_cost)),
+                             TimeProvider time_provider, bool concurrent_reads)
+    : item_tuples_(max_size, ItemCacheCost{std::move(cache_cost)}),
       time_provider_(std::move(time_provider)) {
   item_tuples_.SetEvictionCallback(
-      [this](const std::string& key, ItemTuple&& value) {
-        OnEviction(key, std::move(value));
-      });
+      [this](const std::string&, Item&& item) { OnEviction(item); });
+  if (concurrent_reads) {
+    read_buffers_.reset(new ReadBuffer[kReadBufferCount]);
+  }
 }
 
 bool InMemoryCache::Put(const std::string& key, const boost::any& item,
                         time_t expire_seconds, size_t size) {
-  std::lock_guard<std::mutex> lock{mutex_};
+  std::lock_guard<SharedMutex> lock{mutex_};
 
   PurgeExpired();
 
+  return PutItem(key, item, expire_seconds, size);
+}
+
+bool InMemoryCache::PutBatch(const ItemTuples& items) {
+  std::lock_guard<SharedMutex> lock{mutex_};
+
+  PurgeExpired();
+
+  bool ret = true;
+  for (const auto& item : items) {
+    ret &= PutItem(std::get<0>(item), std::get<2>(item), std::get<1>(item),
+                   std::get<3>(item));
+  }
+  return ret;
+}
+
+boost::any InMemoryCache::Get(const std::string& key) {
+  if (read_buffers_) {
+    return GetShared(key);
+  }
+
+  std::lock_guard<SharedMutex> lock{mutex_};
+  return GetItem(key);
+}
+
+std::vector<boost::any> InMemoryCache::GetBatch(
+    const std::vector<std::string>& keys) {
+  std::lock_guard<SharedMutex> lock{mutex_};
+  std::vector<boost::any> items;
+  items.reserve(keys.size());
+  for (const auto& key : keys) {
+    items.emplace_back(GetItem(key));
+  }
+  return items;
+}
+
+size_t InMemoryCache::Size() const {
+  std::lock_guard<SharedMutex> lock{mutex_};
+  return item_tuples_.Size();
+}
+
+std::vector<std::string> InMemoryCache::GetKeys(size_t max_count) const {
+  std::lock_guard<SharedMutex> lock{mutex_};
+  std::vector<std::string> keys;
+  keys.reserve(std::min(max_count, item_tuples_.Size()));
+  for (auto it = item_tuples_.begin();
+       it != item_tuples_.end() && keys.size() < max_count; ++it) {
+    keys.push_back(it->key());
+  }
+  return keys;
+}
+
+void InMemoryCache::Clear() {
+  std::lock_guard<SharedMutex> lock{mutex_};
+  expiries_.clear();
+  item_tuples_.Clear();
+}
+
+bool InMemoryCache::Remove(const std::string& key) {
+  std::lock_guard<SharedMutex> lock{mutex_};
+  auto it = item_tuples_.FindNoPromote(key);
+  if (it == item_tuples_.end()) {
+    return false;
+  }
+
+  RemoveExpiry(it->value());
+  return item_tuples_.Erase(key);
+}
+
+void InMemoryCache::RemoveKeysWithPrefix(const std::string& key_prefix) {
+  std::lock_guard<SharedMutex> lock{mutex_};
+  item_tuples_.EraseWhile(key_prefix, [&](const std::string& key) {
+    if (key.compare(0, key_prefix.length(), key_prefix) != 0) {
+      return false;
+    }
+
+    RemoveExpiry(item_tuples_.FindNoPromote(key)->value());
+    return true;
+  });
+}
+
+void InMemoryCache::SetRemovalCallback(RemovalCallback callback) {
+  std::lock_guard<SharedMutex> lock{mutex_};
+  removal_callback_ = std::move(callback);
+}
+
+bool InMemoryCache::PutItem(const std::string& key, const boost::any& item,
+                            time_t expire_seconds, size_t size) {
   bool expires = HasExpiry(expire_seconds);
   if (expires) {
     // can't expire in the past.
@@ -52,105 +153,176 @@ bool InMemoryCache::Put(const std::string& key, const boost::any& item,
     expire_seconds += time_provider_();
   }
 
-  auto item_tuple = std::make_tuple(key, expire_seconds, item, size);
-  auto ret = item_tuples_.InsertOrAssign(key, item_tuple);
-  if (ret.second && expires) {
-    item_expiries_[expire_seconds].push_back(item_tuple);
+  // The updated item gets the new expiry time.
+  auto it = item_tuples_.FindNoPromote(key);
+  if (it != item_tuples_.end()) {
+    RemoveExpiry(it->value());
+  }
+
+  auto ret = item_tuples_.InsertOrAssign(
+      key, Item{std::make_tuple(key, expire_seconds, item, size)});
+  if (ret.first != item_tuples_.end() && expires) {
+    AddExpiry(expire_seconds, ret.first->handle());
   }
 
   return ret.second;
 }
 
-boost::any InMemoryCache::Get(const std::string& key) {
-  std::lock_guard<std::mutex> lock{mutex_};
+boost::any InMemoryCache::GetItem(const std::string& key) {
   auto it = item_tuples_.Find(key);
   if (it != item_tuples_.end()) {
-    auto expiry_time = std::get<1>(it.value());
-    if (expiry_time < time_provider_()) {
-      PurgeExpired(expiry_time);
+    const auto& tuple = it->value().tuple;
+    if (std::get<1>(tuple) < time_provider_()) {
+      PurgeExpired();
       return {};
     }
 
-    return std::get<2>(it.value());
+    return std::get<2>(tuple);
   }
 
   return {};
 }
 
-size_t InMemoryCache::Size() const {
-  std::lock_guard<std::mutex> lock{mutex_};
-  return item_tuples_.Size();
+bool InMemoryCache::PurgeExpired() {
+  bool ret = true;
+  const auto time_now = time_provider_();
+
+  while (!expiries_.empty() && expiries_.front().time < time_now) {
+    auto it = item_tuples_.FromHandle(expiries_.front().handle);
+    RemoveExpiry(it->value());
+    if (removal_callback_) {
+      removal_callback_(it->key(), true);
+    }
+    ret &= item_tuples_.Erase(it->key());
+  }
+
+  return ret;
 }
 
-void InMemoryCache::Clear() {
-  std::lock_guard<std::mutex> lock{mutex_};
-  item_expiries_.clear();
-  item_tuples_.Clear();
+boost::any InMemoryCache::GetShared(const std::string& key) {
+  boost::any value;
+  size_t handle = kNoHandle;
+  {
+    SharedLock lock{mutex_};
+    auto it = item_tuples_.FindNoPromote(key);
+    if (it == item_tuples_.end()) {
+      return {};
+    }
+
+    // The expired item is left for the next write to purge.
+    const auto& tuple = it->value().tuple;
+    if (std::get<1>(tuple) < time_provider_()) {
+      return {};
+    }
+
+    value = std::get<2>(tuple);
+    handle = it->handle();
+  }
+
+  RecordRead(handle);
+  return value;
 }
 
-bool InMemoryCache::Remove(const std::string& key) {
-  std::lock_guard<std::mutex> lock{mutex_};
-  return item_tuples_.Erase(key);
+void InMemoryCache::RecordRead(size_t handle) {
+  const auto thread_hash = std::hash<std::thread::id>{}(
+      std::this_thread::get_id());
+  auto& buffer = read_buffers_[thread_hash % kReadBufferCount];
+  const auto index = buffer.writes.fetch_add(1u, std::memory_order_relaxed);
+  buffer.handles[index % ReadBuffer::kSize].store(handle,
+                                                  std::memory_order_relaxed);
+
+  // The reader that fills the buffer applies the promotions, unless a writer
+  // holds the lock; then the promotions are overwritten by the next reads.
+  if ((index + 1u) % ReadBuffer::kSize == 0u && mutex_.try_lock()) {
+    DrainReadBuffer(buffer);
+    mutex_.unlock();
+  }
 }
 
-void InMemoryCache::RemoveKeysWithPrefix(const std::string& key_prefix) {
-  std::lock_guard<std::mutex> lock{mutex_};
-  for (auto it = item_tuples_.begin(); it != item_tuples_.end();) {
-    if (it->key().substr(0, key_prefix.length()) == key_prefix) {
-      // we allow concurrent modifications.
-      it = item_tuples_.Erase(it);
-    } else {
-      ++it;
+void InMemoryCache::DrainReadBuffer(ReadBuffer& buffer) {
+  // The handles of the removed items are skipped by PromoteHandle.
+  for (auto& handle : buffer.handles) {
+    const auto value = handle.exchange(kNoHandle, std::memory_order_relaxed);
+    if (value != kNoHandle) {
+      item_tuples_.PromoteHandle(value);
     }
   }
 }
 
-bool InMemoryCache::PurgeExpired() {
-  bool ret = true;
-  std::vector<time_t> expired_keys;
-  const auto time_now = time_provider_();
+void InMemoryCache::OnEviction(const Item& item) {
+  RemoveExpiry(item);
+  if (removal_callback_) {
+    removal_callback_(std::get<0>(item.tuple), false);
+  }
+}
 
-  for (const auto& item : item_expiries_) {
-    if (item.first < time_now) {
-      expired_keys.push_back(item.first);
-    } else {
-      // std::map is sorted, so any further expiry times will be larger.
-      break;
-    }
+void InMemoryCache::AddExpiry(time_t time, size_t handle) {
+  expiries_.push_back(Expiry{time, handle});
+  SiftUp(expiries_.size() - 1);
+}
+
+void InMemoryCache::RemoveExpiry(const Item& item) {
+  const auto index = item.expiry_index;
+  if (index == kNoExpiryIndex) {
+    return;
   }
 
-  for (auto& key : expired_keys) {
-    ret &= PurgeExpired(key);
+  item.expiry_index = kNoExpiryIndex;
+  const auto last = expiries_.size() - 1;
+  if (index != last) {
+    MoveExpiry(last, index);
+    expiries_.pop_back();
+    SiftUp(index);
+    SiftDown(index);
+  } else {
+    expiries_.pop_back();
   }
+}
 
-  return ret;
+void InMemoryCache::MoveExpiry(size_t from, size_t to) {
+  expiries_[to] = expiries_[from];
+  item_tuples_.FromHandle(expiries_[to].handle)->value().expiry_index = to;
 }
 
-bool InMemoryCache::PurgeExpired(time_t expire_time) {
-  bool ret = true;
-  for (auto& item : item_expiries_[expire_time]) {
-    ret &= item_tuples_.Erase(std::get<0>(item));
+void InMemoryCache::SiftUp(size_t index) {
+  const auto expiry = expiries_[index];
+  while (index > 0) {
+    const auto parent = (index - 1) / 2;
+    if (expiries_[parent].time <= expiry.time) {
+      break;
+    }
+
+    MoveExpiry(parent, index);
+    index = parent;
   }
 
-  item_expiries_.erase(expire_time);
-  return ret;
+  expiries_[index] = expiry;
+  item_tuples_.FromHandle(expiry.handle)->value().expiry_index = index;
 }
 
-void InMemoryCache::OnEviction(const std::string& key, ItemTuple&& value) {
-  time_t expiry = std::get<1>(value);
-  if (HasExpiry(expiry)) {
-    auto item = item_expiries_[expiry];
-    for (auto it = item.begin(); it != item.end(); it++) {
-      if (std::get<0>(*it) == key) {
-        item.erase(it);
-        break;
-      }
+void InMemoryCache::SiftDown(size_t index) {
+  const auto expiry = expiries_[index];
+  const auto size = expiries_.size();
+  while (true) {
+    auto child = 2 * index + 1;
+    if (child >= size) {
+      break;
+    }
+
+    if (child + 1 < size && expiries_[child + 1].time < expiries_[child].time) {
+      ++child;
     }
 
-    if (item_expiries_[expiry].size() == 0) {
-      item_expiries_.erase(expiry);
+    if (expiry.time <= expiries_[child].time) {
+      break;
     }
+
+    MoveExpiry(child, index);
+    index = child;
   }
+
+  expiries_[index] = expiry;
+  item_tuples_.FromHandle(expiry.handle)->value().expiry_index = index;
 }
 
 }  // namespace cache
@@ -19,16 +19,19 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <functional>
-#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <tuple>
 #include <vector>
 
-#include <olp/core/utils/LruCache.h>
+#include <olp/core/utils/HashLruCache.h>
 #include <boost/any.hpp>
+#include "SharedMutex.h"
 
 namespace olp {
 namespace cache {
@@ -46,6 +49,10 @@ class InMemoryCache {
   using ItemTuples = std::vector<ItemTuple>;
   using TimeProvider = std::function<time_t()>;
   using ModelCacheCostFunc = std::function<std::size_t(const ItemTuple&)>;
+  /// Called under the cache lock for every item evicted by the size limit or
+  /// purged as expired.
+  using RemovalCallback =
+      std::function<void(const std::string& key, bool expired)>;
 
   /// Default cache cost based on size.
   struct DefaultCacheCost {
@@ -63,30 +70,111 @@ class InMemoryCache {
     }
   };
 
+  /// In the concurrent mode, `Get` takes the shared lock and does not promote
+  /// the item in the LRU right away. The promotions are buffered and applied
+  /// in batches, and the expired items are purged by the next write.
   InMemoryCache(size_t max_size = kSizeMax,
                 ModelCacheCostFunc cache_cost = DefaultCacheCost(),
-                TimeProvider time_provider = DefaultTimeProvider());
+                TimeProvider time_provider = DefaultTimeProvider(),
+                bool concurrent_reads = false);
 
   bool Put(const std::string& key, const boost::any& item,
            time_t expire_seconds = kExpiryMax, size_t = 1u);
 
+  /// Stores all the items under one lock. Every tuple holds the key, the
+  /// expiry time in seconds from now, the value, and the size of the value.
+  bool PutBatch(const ItemTuples& items);
+
   boost::any Get(const std::string& key);
+
+  /// Looks up all the keys under one lock. Returns the values in the same
+  /// order as the keys; the value is empty if the key is not found.
+  std::vector<boost::any> GetBatch(const std::vector<std::string>& keys);
+
   size_t Size() const;
   void Clear();
 
+  /// Gets up to the given number of keys, the most recently used first.
+  std::vector<std::string> GetKeys(size_t max_count) const;
+
   bool Remove(const std::string& key);
   void RemoveKeysWithPrefix(const std::string& key_prefix);
 
+  /// Must be set before the cache is used by several threads.
+  void SetRemovalCallback(RemovalCallback callback);
+
  protected:
+  bool PutItem(const std::string& key, const boost::any& item,
+               time_t expire_seconds, size_t size);
+  boost::any GetItem(const std::string& key);
   bool PurgeExpired();
-  bool PurgeExpired(time_t expire_time);
-  void OnEviction(const std::string& key, ItemTuple&& value);
 
  private:
-  mutable std::mutex mutex_;
-  utils::LruCache<std::string, ItemTuple, ModelCacheCostFunc> item_tuples_;
-  std::map<time_t, ItemTuples> item_expiries_;
+  static constexpr size_t kNoExpiryIndex = kSizeMax;
+  static constexpr size_t kNoHandle = kSizeMax;
+
+  /// The stored item. The expiry index is the position of the item in the
+  /// expiry heap, it is updated in place when the heap is reordered.
+  struct Item {
+    Item() = default;
+    explicit Item(ItemTuple tuple) : tuple(std::move(tuple)) {}
+
+    ItemTuple tuple;
+    mutable size_t expiry_index = kNoExpiryIndex;
+  };
+
+  /// Applies the model cost function to the stored items.
+  struct ItemCacheCost {
+    std::size_t operator()(const Item& item) const { return cost(item.tuple); }
+    ModelCacheCostFunc cost;
+  };
+
+  /// The entry of the expiry heap, refers to the item by its cache handle.
+  struct Expiry {
+    time_t time;
+    size_t handle;
+  };
+
+  /// The keys are also kept sorted, so RemoveKeysWithPrefix does not scan all
+  /// the items.
+  using ItemCache =
+      utils::HashLruCache<std::string, Item, ItemCacheCost,
+                          std::hash<std::string>, std::equal_to<std::string>,
+                          true>;
+
+  /// The buffer of the LRU promotions made by the concurrent reads. When the
+  /// buffer is full, the oldest promotions are overwritten.
+  struct ReadBuffer {
+    static constexpr size_t kSize = 16u;
+
+    ReadBuffer();
+
+    std::atomic<size_t> writes;
+    std::array<std::atomic<size_t>, kSize> handles;
+  };
+
+  /// The number of the read buffers, the threads are spread between them.
+  static constexpr size_t kReadBufferCount = 16u;
+
+  boost::any GetShared(const std::string& key);
+  void RecordRead(size_t handle);
+  void DrainReadBuffer(ReadBuffer& buffer);
+
+  void OnEviction(const Item& item);
+
+  /// The expiry heap is a binary min-heap ordered by the expiry time.
+  void AddExpiry(time_t time, size_t handle);
+  void RemoveExpiry(const Item& item);
+  void MoveExpiry(size_t from, size_t to);
+  void SiftUp(size_t index);
+  void SiftDown(size_t index);
+
+  mutable SharedMutex mutex_;
+  ItemCache item_tuples_;
+  std::vector<Expiry> expiries_;
   TimeProvider time_provider_;
+  RemovalCallback removal_callback_;
+  std::unique_ptr<ReadBuffer[]> read_buffers_;
 };
 }  // namespace cache
 }  // namespace olp
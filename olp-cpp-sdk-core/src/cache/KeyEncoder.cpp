@@ -0,0 +1,386 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "olp/core/cache/KeyEncoder.h"
+
+#include <initializer_list>
+
+namespace olp {
+namespace cache {
+
+namespace {
+// Starts every encoded key. The keys built by the older SDK versions start
+// with the HRN, and the format version key starts with zero.
+constexpr char kMarker = '\x01';
+
+// The kind of the key follows the catalog or the layer ID.
+constexpr char kCatalogTag = 'c';
+constexpr char kLatestVersionTag = 'v';
+constexpr char kCatalogValidatorTag = 'e';
+constexpr char kApiTag = 'a';
+constexpr char kLayerVersionsTag = 'l';
+constexpr char kLayerTag = 'L';
+constexpr char kPartitionsTag = 'P';
+constexpr char kPartitionsValidatorTag = 'E';
+constexpr char kStalePartitionsTag = 'S';
+constexpr char kPartitionTag = 'p';
+constexpr char kDataTag = 'd';
+
+constexpr size_t kMaxVarintSize = 10u;
+
+// The separator of the keys built by the older SDK versions.
+constexpr auto kLegacySeparator = "::";
+
+size_t VarintSize(std::uint64_t value) {
+  size_t size = 1u;
+  while (value >= 0x80u) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+size_t StringSize(const std::string& value) {
+  return VarintSize(value.size()) + value.size();
+}
+
+void AppendVarint(std::string& key, std::uint64_t value) {
+  while (value >= 0x80u) {
+    key.push_back(static_cast<char>((value & 0x7fu) | 0x80u));
+    value >>= 7;
+  }
+  key.push_back(static_cast<char>(value));
+}
+
+void AppendString(std::string& key, const std::string& value) {
+  AppendVarint(key, value.size());
+  key.append(value);
+}
+
+std::string CatalogKey(const std::string& catalog_prefix, size_t extra_size) {
+  std::string key;
+  key.reserve(catalog_prefix.size() + extra_size);
+  key.append(catalog_prefix);
+  return key;
+}
+
+std::string LayerKey(const std::string& catalog_prefix,
+                     const std::string& layer_id, size_t extra_size) {
+  auto key =
+      CatalogKey(catalog_prefix, 1u + StringSize(layer_id) + extra_size);
+  key.push_back(kLayerTag);
+  AppendString(key, layer_id);
+  return key;
+}
+
+// Reads the parts of an encoded key, and fails on the malformed ones.
+class KeyReader {
+ public:
+  explicit KeyReader(const std::string& key) : key_(key) {}
+
+  bool AtEnd() const { return position_ == key_.size(); }
+
+  bool ReadTag(char& tag) {
+    if (AtEnd()) {
+      return false;
+    }
+    tag = key_[position_++];
+    return true;
+  }
+
+  bool ReadVarint(std::uint64_t& value) {
+    value = 0u;
+    for (size_t i = 0; i < kMaxVarintSize && !AtEnd(); ++i) {
+      const auto byte = static_cast<unsigned char>(key_[position_++]);
+      value |= static_cast<std::uint64_t>(byte & 0x7fu) << (7u * i);
+      if ((byte & 0x80u) == 0u) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadString(std::string& value) {
+    std::uint64_t size = 0u;
+    if (!ReadVarint(size) || size > key_.size() - position_) {
+      return false;
+    }
+    value.assign(key_, position_, static_cast<size_t>(size));
+    position_ += static_cast<size_t>(size);
+    return true;
+  }
+
+  bool ReadVersion(std::string& value) {
+    std::uint64_t version = 0u;
+    if (!ReadVarint(version)) {
+      return false;
+    }
+    value = std::to_string(static_cast<std::int64_t>(version));
+    return true;
+  }
+
+ private:
+  const std::string& key_;
+  size_t position_{0u};
+};
+
+// Builds the key of the older SDK versions from the parts of an encoded key.
+std::string LegacyKey(std::initializer_list<std::string> parts) {
+  std::string key;
+  for (const auto& part : parts) {
+    if (!key.empty()) {
+      key.append(kLegacySeparator);
+    }
+    key.append(part);
+  }
+  return key;
+}
+
+std::string LegacyLayerKey(KeyReader& reader, const std::string& hrn) {
+  std::string layer_id;
+  char tag = 0;
+  if (!reader.ReadString(layer_id) || !reader.ReadTag(tag)) {
+    return std::string();
+  }
+
+  std::string id;
+  std::string version;
+  switch (tag) {
+    case kPartitionsTag:
+      // The partitions of the volatile layers have no version, and their key
+      // ends with the separator.
+      if (reader.AtEnd()) {
+        return LegacyKey({hrn, layer_id}) + kLegacySeparator;
+      }
+      if (reader.ReadVersion(version) && reader.AtEnd()) {
+        return LegacyKey({hrn, layer_id, version}) + "::partitions";
+      }
+      break;
+    case kPartitionTag:
+      if (!reader.ReadString(id)) {
+        break;
+      }
+      if (reader.AtEnd()) {
+        return LegacyKey({hrn, layer_id, id}) + kLegacySeparator;
+      }
+      if (reader.ReadVersion(version) && reader.AtEnd()) {
+        return LegacyKey({hrn, layer_id, id, version}) + "::partition";
+      }
+      break;
+    case kDataTag:
+      if (reader.ReadString(id) && reader.AtEnd()) {
+        return LegacyKey({hrn, layer_id, id}) + "::Data";
+      }
+      break;
+    default:
+      break;
+  }
+  return std::string();
+}
+}  // namespace
+
+KeyEncoder::KeyEncoder(const std::string& catalog_hrn) {
+  catalog_prefix_.reserve(1u + StringSize(catalog_hrn));
+  catalog_prefix_.push_back(kMarker);
+  AppendString(catalog_prefix_, catalog_hrn);
+}
+
+std::string KeyEncoder::CatalogPrefix() const { return catalog_prefix_; }
+
+std::string KeyEncoder::Catalog() const {
+  auto key = CatalogKey(catalog_prefix_, 1u);
+  key.push_back(kCatalogTag);
+  return key;
+}
+
+std::string KeyEncoder::LatestVersion() const {
+  auto key = CatalogKey(catalog_prefix_, 1u);
+  key.push_back(kLatestVersionTag);
+  return key;
+}
+
+std::string KeyEncoder::CatalogValidator() const {
+  auto key = CatalogKey(catalog_prefix_, 1u);
+  key.push_back(kCatalogValidatorTag);
+  return key;
+}
+
+std::string KeyEncoder::Api(const std::string& service,
+                            const std::string& service_version) const {
+  auto key = CatalogKey(catalog_prefix_, 1u + StringSize(service) +
+                                             StringSize(service_version));
+  key.push_back(kApiTag);
+  AppendString(key, service);
+  AppendString(key, service_version);
+  return key;
+}
+
+std::string KeyEncoder::LayerVersions(std::int64_t catalog_version) const {
+  auto key = CatalogKey(catalog_prefix_, 1u + kMaxVarintSize);
+  key.push_back(kLayerVersionsTag);
+  AppendVarint(key, static_cast<std::uint64_t>(catalog_version));
+  return key;
+}
+
+std::string KeyEncoder::LayerPrefix(const std::string& layer_id) const {
+  return LayerKey(catalog_prefix_, layer_id, 0u);
+}
+
+std::string KeyEncoder::Partitions(
+    const std::string& layer_id,
+    const boost::optional<std::int64_t>& version) const {
+  auto key = LayerKey(catalog_prefix_, layer_id, 1u + kMaxVarintSize);
+  key.push_back(kPartitionsTag);
+  if (version) {
+    AppendVarint(key, static_cast<std::uint64_t>(*version));
+  }
+  return key;
+}
+
+std::string KeyEncoder::PartitionsValidator(
+    const std::string& layer_id,
+    const boost::optional<std::int64_t>& version) const {
+  auto key = LayerKey(catalog_prefix_, layer_id, 1u + kMaxVarintSize);
+  key.push_back(kPartitionsValidatorTag);
+  if (version) {
+    AppendVarint(key, static_cast<std::uint64_t>(*version));
+  }
+  return key;
+}
+
+std::string KeyEncoder::StalePartitions(
+    const std::string& layer_id,
+    const boost::optional<std::int64_t>& version) const {
+  auto key = LayerKey(catalog_prefix_, layer_id, 1u + kMaxVarintSize);
+  key.push_back(kStalePartitionsTag);
+  if (version) {
+    AppendVarint(key, static_cast<std::uint64_t>(*version));
+  }
+  return key;
+}
+
+std::string KeyEncoder::Partition(
+    const std::string& layer_id, const std::string& partition_id,
+    const boost::optional<std::int64_t>& version) const {
+  auto key = LayerKey(catalog_prefix_, layer_id,
+                      1u + StringSize(partition_id) + kMaxVarintSize);
+  key.push_back(kPartitionTag);
+  AppendString(key, partition_id);
+  if (version) {
+    AppendVarint(key, static_cast<std::uint64_t>(*version));
+  }
+  return key;
+}
+
+std::string KeyEncoder::PartitionPrefix(
+    const std::string& layer_id, const std::string& partition_id) const {
+  auto key =
+      LayerKey(catalog_prefix_, layer_id, 1u + StringSize(partition_id));
+  key.push_back(kPartitionTag);
+  AppendString(key, partition_id);
+  return key;
+}
+
+std::string KeyEncoder::Data(const std::string& layer_id,
+                             const std::string& data_handle) const {
+  auto key =
+      LayerKey(catalog_prefix_, layer_id, 1u + StringSize(data_handle));
+  key.push_back(kDataTag);
+  AppendString(key, data_handle);
+  return key;
+}
+
+CacheKeyNamespace KeyEncoder::GetKeyNamespace(const std::string& key) {
+  KeyReader reader(key);
+  std::string value;
+  char tag = 0;
+  if (!reader.ReadTag(tag) || tag != kMarker || !reader.ReadString(value) ||
+      !reader.ReadTag(tag)) {
+    return CacheKeyNamespace::Other;
+  }
+
+  switch (tag) {
+    case kCatalogTag:
+    case kLatestVersionTag:
+    case kCatalogValidatorTag:
+    case kLayerVersionsTag:
+      return CacheKeyNamespace::Catalog;
+    case kApiTag:
+      return CacheKeyNamespace::Api;
+    case kLayerTag:
+      break;
+    default:
+      return CacheKeyNamespace::Other;
+  }
+
+  if (!reader.ReadString(value) || !reader.ReadTag(tag)) {
+    return CacheKeyNamespace::Other;
+  }
+
+  switch (tag) {
+    case kPartitionsTag:
+    case kPartitionsValidatorTag:
+    case kStalePartitionsTag:
+    case kPartitionTag:
+      return CacheKeyNamespace::Partition;
+    case kDataTag:
+      return CacheKeyNamespace::Data;
+    default:
+      return CacheKeyNamespace::Other;
+  }
+}
+
+std::string KeyEncoder::ToLegacyKey(const std::string& key) {
+  KeyReader reader(key);
+  std::string hrn;
+  char tag = 0;
+  if (!reader.ReadTag(tag) || tag != kMarker || !reader.ReadString(hrn) ||
+      !reader.ReadTag(tag)) {
+    return std::string();
+  }
+
+  std::string service;
+  std::string service_version;
+  std::string version;
+  switch (tag) {
+    case kCatalogTag:
+      return reader.AtEnd() ? hrn + "::catalog" : std::string();
+    case kLatestVersionTag:
+      return reader.AtEnd() ? hrn + "::latestVersion" : std::string();
+    case kApiTag:
+      if (reader.ReadString(service) && reader.ReadString(service_version) &&
+          reader.AtEnd()) {
+        return LegacyKey({hrn, service, service_version}) + "::api";
+      }
+      return std::string();
+    case kLayerVersionsTag:
+      if (reader.ReadVersion(version) && reader.AtEnd()) {
+        return LegacyKey({hrn, version}) + "::layerVersions";
+      }
+      return std::string();
+    case kLayerTag:
+      return LegacyLayerKey(reader, hrn);
+    default:
+      // The validators and the stale partitions were not cached before.
+      return std::string();
+  }
+}
+
+}  // namespace cache
+}  // namespace olp
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace olp {
+namespace cache {
+
+/// Writes the integer to `out` in the little endian byte order, so the disk
+/// formats do not depend on the platform.
+template <typename T>
+void WriteLittleEndian(char* out, T value) {
+  auto bits = static_cast<std::uint64_t>(value);
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    out[i] = static_cast<char>((bits >> (8u * i)) & 0xffu);
+  }
+}
+
+/// Reads the integer written by `WriteLittleEndian`.
+template <typename T>
+T ReadLittleEndian(const char* in) {
+  std::uint64_t bits = 0u;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    bits |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[i]))
+            << (8u * i);
+  }
+  return static_cast<T>(bits);
+}
+
+}  // namespace cache
+}  // namespace olp
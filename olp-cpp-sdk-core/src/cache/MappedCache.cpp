@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "MappedCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "DiskCacheRecord.h"
+#include "LittleEndian.h"
+#include "olp/core/logging/Log.h"
+
+namespace olp {
+namespace cache {
+
+namespace {
+constexpr auto kLogTag = "MappedCache";
+constexpr size_t kMagicSize = sizeof(MappedCache::kMagic) - 1;
+
+constexpr size_t kVersionOffset = 8u;
+constexpr size_t kCountOffset = 16u;
+constexpr size_t kIndexOffset = 24u;
+
+constexpr size_t kKeyOffset = 0u;
+constexpr size_t kKeySizeOffset = 8u;
+constexpr size_t kChecksumOffset = 12u;
+constexpr size_t kValueOffset = 16u;
+constexpr size_t kValueSizeOffset = 24u;
+}  // namespace
+
+constexpr char MappedCache::kMagic[];
+constexpr std::uint32_t MappedCache::kVersion;
+constexpr size_t MappedCache::kHeaderSize;
+constexpr size_t MappedCache::kIndexEntrySize;
+
+MappedCache::~MappedCache() { Close(); }
+
+bool MappedCache::Open(const std::string& path) {
+  Close();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to open %s", path.c_str());
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+    CloseHandle(file);
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to get the size of %s",
+                        path.c_str());
+    return false;
+  }
+
+  // The mapping keeps the file open, so the file handle is not needed.
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to map %s", path.c_str());
+    return false;
+  }
+
+  auto address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (address == nullptr) {
+    CloseHandle(mapping);
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to map %s", path.c_str());
+    return false;
+  }
+
+  mapping_ = mapping;
+  data_ = static_cast<const char*>(address);
+  size_ = static_cast<size_t>(file_size.QuadPart);
+#else
+  const int file = open(path.c_str(), O_RDONLY);
+  if (file < 0) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to open %s", path.c_str());
+    return false;
+  }
+
+  struct stat stat_info;
+  if (fstat(file, &stat_info) != 0 || stat_info.st_size == 0) {
+    close(file);
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to get the size of %s",
+                        path.c_str());
+    return false;
+  }
+
+  const auto size = static_cast<size_t>(stat_info.st_size);
+  // The mapping keeps the file open, so the descriptor is not needed.
+  auto address = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+  close(file);
+  if (address == MAP_FAILED) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to map %s", path.c_str());
+    return false;
+  }
+
+  data_ = static_cast<const char*>(address);
+  size_ = size;
+#endif
+
+  if (!Validate()) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Invalid mapped cache file %s",
+                        path.c_str());
+    Close();
+    return false;
+  }
+
+  return true;
+}
+
+void MappedCache::Close() {
+  if (data_ == nullptr) {
+    return;
+  }
+
+#ifdef _WIN32
+  UnmapViewOfFile(data_);
+  CloseHandle(mapping_);
+  mapping_ = nullptr;
+#else
+  munmap(const_cast<char*>(data_), size_);
+#endif
+
+  data_ = nullptr;
+  size_ = 0u;
+  count_ = 0u;
+  index_offset_ = 0u;
+}
+
+bool MappedCache::IsMappedCacheFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  char magic[kMagicSize];
+  return file.read(magic, kMagicSize) &&
+         std::memcmp(magic, kMagic, kMagicSize) == 0;
+}
+
+void MappedCache::EncodeHeader(std::uint64_t count,
+                               std::uint64_t index_offset, char* out) {
+  std::fill(out, out + kHeaderSize, '\0');
+  std::copy(kMagic, kMagic + kMagicSize, out);
+  WriteLittleEndian<std::uint32_t>(out + kVersionOffset, kVersion);
+  WriteLittleEndian<std::uint64_t>(out + kCountOffset, count);
+  WriteLittleEndian<std::uint64_t>(out + kIndexOffset, index_offset);
+}
+
+void MappedCache::EncodeIndexEntry(std::uint64_t key_offset,
+                                   std::uint32_t key_size,
+                                   std::uint32_t checksum,
+                                   std::uint64_t value_offset,
+                                   std::uint64_t value_size, char* out) {
+  WriteLittleEndian<std::uint64_t>(out + kKeyOffset, key_offset);
+  WriteLittleEndian<std::uint32_t>(out + kKeySizeOffset, key_size);
+  WriteLittleEndian<std::uint32_t>(out + kChecksumOffset, checksum);
+  WriteLittleEndian<std::uint64_t>(out + kValueOffset, value_offset);
+  WriteLittleEndian<std::uint64_t>(out + kValueSizeOffset, value_size);
+}
+
+bool MappedCache::Get(const std::string& key, Value& value,
+                      bool verify_checksum) const {
+  // The entries are sorted in the bytewise order of the keys, the same as
+  // the order of LevelDB, so the converted caches need no sorting.
+  std::uint64_t first = 0u;
+  std::uint64_t last = count_;
+  while (first < last) {
+    const auto middle = first + (last - first) / 2u;
+    const auto entry = IndexEntry(middle);
+    const auto key_offset = ReadLittleEndian<std::uint64_t>(entry + kKeyOffset);
+    const auto key_size =
+        ReadLittleEndian<std::uint32_t>(entry + kKeySizeOffset);
+    if (key_offset > size_ || key_size > size_ - key_offset) {
+      return false;
+    }
+
+    const auto common_size = std::min<size_t>(key_size, key.size());
+    auto result = std::memcmp(data_ + key_offset, key.data(), common_size);
+    if (result == 0) {
+      result = (key_size < key.size()) ? -1 : (key_size > key.size() ? 1 : 0);
+    }
+
+    if (result < 0) {
+      first = middle + 1u;
+    } else if (result > 0) {
+      last = middle;
+    } else {
+      const auto value_offset =
+          ReadLittleEndian<std::uint64_t>(entry + kValueOffset);
+      const auto value_size =
+          ReadLittleEndian<std::uint64_t>(entry + kValueSizeOffset);
+      if (value_offset > size_ || value_size > size_ - value_offset) {
+        return false;
+      }
+
+      if (verify_checksum &&
+          ReadLittleEndian<std::uint32_t>(entry + kChecksumOffset) !=
+              DiskCacheRecord::Checksum(data_ + value_offset,
+                                        static_cast<size_t>(value_size))) {
+        return false;
+      }
+
+      value.data = reinterpret_cast<const unsigned char*>(data_ + value_offset);
+      value.size = static_cast<size_t>(value_size);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool MappedCache::Validate() {
+  if (size_ < kHeaderSize || std::memcmp(data_, kMagic, kMagicSize) != 0 ||
+      ReadLittleEndian<std::uint32_t>(data_ + kVersionOffset) != kVersion) {
+    return false;
+  }
+
+  count_ = ReadLittleEndian<std::uint64_t>(data_ + kCountOffset);
+  index_offset_ = ReadLittleEndian<std::uint64_t>(data_ + kIndexOffset);
+  return index_offset_ >= kHeaderSize && index_offset_ <= size_ &&
+         count_ <= (size_ - index_offset_) / kIndexEntrySize;
+}
+
+const char* MappedCache::IndexEntry(std::uint64_t index) const {
+  return data_ + index_offset_ + index * kIndexEntrySize;
+}
+
+}  // namespace cache
+}  // namespace olp
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace olp {
+namespace cache {
+
+/**
+ * @brief The read-only protected cache file that is memory-mapped.
+ *
+ * The file is created by `MappedCacheBuilder` and has the following layout
+ * (all integers are little endian):
+ *
+ * | Offset         | Size   | Field                                       |
+ * |----------------|--------|---------------------------------------------|
+ * | 0              | 8      | The magic, `kMagic`.                        |
+ * | 8              | 4      | The format version, `kVersion`.             |
+ * | 12             | 4      | Reserved, always zero.                      |
+ * | 16             | 8      | The number of entries.                      |
+ * | 24             | 8      | The offset of the index.                    |
+ * | 32             | ...    | The keys and the values.                    |
+ * | index offset   | 32 * n | The index entries sorted by key.            |
+ *
+ * Every index entry consists of the key offset (8 bytes), the key size
+ * (4 bytes), the CRC-32 of the value (4 bytes), the value offset (8 bytes),
+ * and the value size (8 bytes).
+ *
+ * A lookup is a binary search over the index, and the value is returned as
+ * a view into the mapping, so neither the lookup nor the value decoding
+ * allocates.
+ */
+class MappedCache {
+ public:
+  /// The file magic.
+  static constexpr char kMagic[] = "OLPCMAPF";
+  /// The current format version.
+  static constexpr std::uint32_t kVersion = 1u;
+  /// The size of the file header in bytes.
+  static constexpr size_t kHeaderSize = 32u;
+  /// The size of one index entry in bytes.
+  static constexpr size_t kIndexEntrySize = 32u;
+
+  /// The view of a value. Valid until the cache is closed.
+  struct Value {
+    const unsigned char* data = nullptr;
+    size_t size = 0u;
+  };
+
+  MappedCache() = default;
+  ~MappedCache();
+
+  MappedCache(const MappedCache&) = delete;
+  MappedCache& operator=(const MappedCache&) = delete;
+
+  /// Maps the file. Returns false if the file can not be mapped or is not
+  /// a valid cache file.
+  bool Open(const std::string& path);
+  void Close();
+
+  /// Checks if the file starts with the magic of the mapped cache.
+  static bool IsMappedCacheFile(const std::string& path);
+
+  /// Writes the file header, `kHeaderSize` bytes, to `out`.
+  static void EncodeHeader(std::uint64_t count, std::uint64_t index_offset,
+                           char* out);
+  /// Writes the index entry, `kIndexEntrySize` bytes, to `out`.
+  static void EncodeIndexEntry(std::uint64_t key_offset,
+                               std::uint32_t key_size, std::uint32_t checksum,
+                               std::uint64_t value_offset,
+                               std::uint64_t value_size, char* out);
+
+  /// Finds the value of the key. Returns false if the key is not found or
+  /// (with `verify_checksum`) the checksum does not match.
+  bool Get(const std::string& key, Value& value, bool verify_checksum) const;
+
+  /// The number of entries in the file.
+  std::uint64_t Count() const { return count_; }
+
+ private:
+  bool Validate();
+  const char* IndexEntry(std::uint64_t index) const;
+
+  const char* data_{nullptr};
+  size_t size_{0u};
+  std::uint64_t count_{0u};
+  std::uint64_t index_offset_{0u};
+#ifdef _WIN32
+  void* mapping_{nullptr};
+#endif
+};
+
+}  // namespace cache
+}  // namespace olp
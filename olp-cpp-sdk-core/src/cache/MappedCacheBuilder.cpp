@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "olp/core/cache/MappedCacheBuilder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include <leveldb/iterator.h>
+#include "DiskCache.h"
+#include "DiskCacheRecord.h"
+#include "MappedCache.h"
+#include "olp/core/logging/Log.h"
+#include "olp/core/porting/make_unique.h"
+
+namespace olp {
+namespace cache {
+
+namespace {
+constexpr auto kLogTag = "MappedCacheBuilder";
+constexpr auto kTemporarySuffix = ".tmp";
+}  // namespace
+
+class MappedCacheBuilder::Impl {
+ public:
+  explicit Impl(const std::string& path)
+      : path_(path),
+        temporary_path_(path + kTemporarySuffix),
+        file_(temporary_path_, std::ios::binary | std::ios::trunc),
+        offset_(MappedCache::kHeaderSize) {
+    // The header is written by Finish, when the index offset is known.
+    const std::string header(MappedCache::kHeaderSize, '\0');
+    file_.write(header.data(), header.size());
+    if (!file_) {
+      OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to create %s",
+                          temporary_path_.c_str());
+    }
+  }
+
+  ~Impl() {
+    if (!finished_) {
+      file_.close();
+      std::remove(temporary_path_.c_str());
+    }
+  }
+
+  bool Add(const std::string& key, const char* data, size_t size) {
+    if (finished_ || !file_ ||
+        key.size() > std::numeric_limits<std::uint32_t>::max()) {
+      return false;
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.key_offset = offset_;
+    entry.value_offset = offset_ + key.size();
+    entry.value_size = size;
+    entry.checksum = DiskCacheRecord::Checksum(data, size);
+
+    file_.write(key.data(), key.size());
+    file_.write(data, size);
+    if (!file_) {
+      OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to write %s",
+                          temporary_path_.c_str());
+      return false;
+    }
+
+    offset_ = entry.value_offset + size;
+    entries_.emplace_back(std::move(entry));
+    return true;
+  }
+
+  bool Finish() {
+    if (finished_ || !file_) {
+      return false;
+    }
+
+    std::sort(entries_.begin(), entries_.end(),
+              [](const Entry& lhs, const Entry& rhs) {
+                return lhs.key < rhs.key;
+              });
+    auto duplicate = std::adjacent_find(
+        entries_.begin(), entries_.end(),
+        [](const Entry& lhs, const Entry& rhs) { return lhs.key == rhs.key; });
+    if (duplicate != entries_.end()) {
+      OLP_SDK_LOG_ERROR_F(kLogTag, "Duplicate key %s", duplicate->key.c_str());
+      return false;
+    }
+
+    char index_entry[MappedCache::kIndexEntrySize];
+    for (const auto& entry : entries_) {
+      MappedCache::EncodeIndexEntry(
+          entry.key_offset, static_cast<std::uint32_t>(entry.key.size()),
+          entry.checksum, entry.value_offset, entry.value_size, index_entry);
+      file_.write(index_entry, sizeof(index_entry));
+    }
+
+    char header[MappedCache::kHeaderSize];
+    MappedCache::EncodeHeader(entries_.size(), offset_, header);
+    file_.seekp(0);
+    file_.write(header, sizeof(header));
+    file_.close();
+    if (!file_) {
+      OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to write %s",
+                          temporary_path_.c_str());
+      return false;
+    }
+
+    std::remove(path_.c_str());
+    if (std::rename(temporary_path_.c_str(), path_.c_str()) != 0) {
+      OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to move %s to %s",
+                          temporary_path_.c_str(), path_.c_str());
+      return false;
+    }
+
+    finished_ = true;
+    return true;
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    std::uint64_t key_offset;
+    std::uint64_t value_offset;
+    std::uint64_t value_size;
+    std::uint32_t checksum;
+  };
+
+  std::string path_;
+  std::string temporary_path_;
+  std::ofstream file_;
+  std::uint64_t offset_;
+  std::vector<Entry> entries_;
+  bool finished_{false};
+};
+
+MappedCacheBuilder::MappedCacheBuilder(const std::string& path)
+    : impl_(std::make_unique<Impl>(path)) {}
+
+MappedCacheBuilder::~MappedCacheBuilder() = default;
+
+bool MappedCacheBuilder::Add(const std::string& key,
+                             const KeyValueCache::ValueType& value) {
+  return impl_->Add(key, reinterpret_cast<const char*>(value.data()),
+                    value.size());
+}
+
+bool MappedCacheBuilder::Add(const std::string& key,
+                             const std::string& value) {
+  return impl_->Add(key, value.data(), value.size());
+}
+
+bool MappedCacheBuilder::Finish() { return impl_->Finish(); }
+
+bool MappedCacheBuilder::ConvertDiskCache(const std::string& disk_cache_path,
+                                          const std::string& path) {
+  DiskCache disk_cache;
+  StorageSettings storage_settings;
+  storage_settings.max_disk_storage = DiskCache::kSizeMax;
+  if (disk_cache.Open(disk_cache_path, disk_cache_path, storage_settings,
+                      OpenOptions::ReadOnly) == OpenResult::Fail) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to open the disk cache %s",
+                        disk_cache_path.c_str());
+    return false;
+  }
+
+  auto iterator = disk_cache.NewIterator();
+  if (!iterator) {
+    return false;
+  }
+
+  // The caches created by the older SDK versions store the plain values and
+  // the expiry times as separate keys.
+  const auto format_version_key = DiskCacheRecord::FormatVersionKey();
+  const bool records = static_cast<bool>(disk_cache.Get(format_version_key));
+
+  MappedCacheBuilder builder(path);
+  for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+    auto key = iterator->key().ToString();
+    if (DiskCacheRecord::IsInternalKey(key.data(), key.size()) ||
+        (!records && DiskCacheRecord::IsLegacyExpiryKey(key))) {
+      continue;
+    }
+
+    auto value = iterator->value().ToString();
+    time_t expiry = DiskCacheRecord::kNoExpiry;
+    if (records && (!disk_cache.ResolveValue(key, value) ||
+                    !DiskCacheRecord::Decode(value, expiry, true))) {
+      OLP_SDK_LOG_WARNING_F(kLogTag, "Corrupted record %s, skipping",
+                            key.c_str());
+      continue;
+    }
+
+    if (!builder.Add(key, value)) {
+      return false;
+    }
+  }
+
+  if (!iterator->status().ok()) {
+    OLP_SDK_LOG_ERROR_F(kLogTag, "Failed to read the disk cache %s",
+                        disk_cache_path.c_str());
+    return false;
+  }
+
+  return builder.Finish();
+}
+
+}  // namespace cache
+}  // namespace olp
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace olp {
+namespace cache {
+
+/// A reader-writer lock for short critical sections, std::shared_mutex is not
+/// available in C++11. The writers are serialized by a mutex, so they block
+/// each other; the readers and the writer waiting for the readers to leave
+/// only yield. The writer is preferred, new readers wait while it is pending.
+class SharedMutex {
+ public:
+  void lock() {
+    writer_mutex_.lock();
+    state_.fetch_or(kWriter, std::memory_order_acquire);
+    while (state_.load(std::memory_order_acquire) != kWriter) {
+      std::this_thread::yield();
+    }
+  }
+
+  bool try_lock() {
+    if (!writer_mutex_.try_lock()) {
+      return false;
+    }
+
+    std::uint32_t expected = 0u;
+    if (!state_.compare_exchange_strong(expected, kWriter,
+                                        std::memory_order_acquire)) {
+      writer_mutex_.unlock();
+      return false;
+    }
+    return true;
+  }
+
+  void unlock() {
+    state_.fetch_and(~kWriter, std::memory_order_release);
+    writer_mutex_.unlock();
+  }
+
+  void lock_shared() {
+    while (state_.fetch_add(1u, std::memory_order_acquire) & kWriter) {
+      state_.fetch_sub(1u, std::memory_order_relaxed);
+      while (state_.load(std::memory_order_relaxed) & kWriter) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  void unlock_shared() { state_.fetch_sub(1u, std::memory_order_release); }
+
+ private:
+  static constexpr std::uint32_t kWriter = 1u << 31;
+
+  std::mutex writer_mutex_;
+  /// The writer flag and the number of the readers.
+  std::atomic<std::uint32_t> state_{0u};
+};
+
+/// A reader-writer lock for long critical sections, like the disk writes.
+/// The waiting threads block instead of yielding. The writer is preferred,
+/// new readers wait while it is pending.
+class BlockingSharedMutex {
+ public:
+  void lock() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++waiting_writers_;
+    released_.wait(lock, [&]() { return !writer_ && readers_ == 0u; });
+    --waiting_writers_;
+    writer_ = true;
+  }
+
+  void unlock() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      writer_ = false;
+    }
+    released_.notify_all();
+  }
+
+  void lock_shared() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    released_.wait(lock,
+                   [&]() { return !writer_ && waiting_writers_ == 0u; });
+    ++readers_;
+  }
+
+  void unlock_shared() {
+    bool last = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      last = --readers_ == 0u;
+    }
+    if (last) {
+      released_.notify_all();
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable released_;
+  std::uint32_t readers_{0u};
+  std::uint32_t waiting_writers_{0u};
+  bool writer_{false};
+};
+
+/// Holds the shared lock for the scope, like std::shared_lock.
+template <typename Mutex>
+class BasicSharedLock {
+ public:
+  explicit BasicSharedLock(Mutex& mutex) : mutex_(mutex) {
+    mutex_.lock_shared();
+  }
+  ~BasicSharedLock() { mutex_.unlock_shared(); }
+
+  BasicSharedLock(const BasicSharedLock&) = delete;
+  BasicSharedLock& operator=(const BasicSharedLock&) = delete;
+
+ private:
+  Mutex& mutex_;
+};
+
+using SharedLock = BasicSharedLock<SharedMutex>;
+using BlockingSharedLock = BasicSharedLock<BlockingSharedMutex>;
+
+}  // namespace cache
+}  // namespace olp
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "StatisticsRecorder.h"
+
+#include <functional>
+#include <thread>
+
+namespace olp {
+namespace cache {
+
+namespace {
+void AddTo(CacheCounters& counters, StatisticsRecorder::Counter counter,
+           std::uint64_t value) {
+  switch (counter) {
+    case StatisticsRecorder::kMemoryHits:
+      counters.memory_hits += value;
+      break;
+    case StatisticsRecorder::kDiskHits:
+      counters.disk_hits += value;
+      break;
+    case StatisticsRecorder::kMisses:
+      counters.misses += value;
+      break;
+    case StatisticsRecorder::kExpirations:
+      counters.expirations += value;
+      break;
+    case StatisticsRecorder::kEvictions:
+      counters.evictions += value;
+      break;
+    case StatisticsRecorder::kPutFailures:
+      counters.put_failures += value;
+      break;
+    case StatisticsRecorder::kBytesRead:
+      counters.bytes_read += value;
+      break;
+    case StatisticsRecorder::kBytesWritten:
+      counters.bytes_written += value;
+      break;
+    default:
+      break;
+  }
+}
+}  // namespace
+
+constexpr size_t StatisticsRecorder::kStripeCount;
+
+StatisticsRecorder::StatisticsRecorder(bool enabled) : enabled_(enabled) {
+  // The atomics are not initialized by their default constructors.
+  Reset();
+}
+
+void StatisticsRecorder::Add(Counter counter, CacheKeyNamespace key_namespace,
+                             std::uint64_t value) {
+  if (!enabled_) {
+    return;
+  }
+
+  GetStripe()
+      .counters[static_cast<size_t>(key_namespace)][counter]
+      .fetch_add(value, std::memory_order_relaxed);
+}
+
+void StatisticsRecorder::Finish(Latency latency, Clock::time_point start) {
+  if (!enabled_) {
+    return;
+  }
+
+  const auto bucket = LatencyHistogram::GetBucket(Clock::now() - start);
+  GetStripe().latencies[latency][bucket].fetch_add(1u,
+                                                   std::memory_order_relaxed);
+}
+
+CacheStatistics StatisticsRecorder::Get() const {
+  CacheStatistics statistics;
+  for (const auto& stripe : stripes_) {
+    for (size_t i = 0; i < CacheStatistics::kNamespaceCount; ++i) {
+      for (size_t counter = 0; counter < kCounterCount; ++counter) {
+        AddTo(statistics.namespaces[i], static_cast<Counter>(counter),
+              stripe.counters[i][counter].load(std::memory_order_relaxed));
+      }
+    }
+
+    LatencyHistogram* histograms[kLatencyCount] = {
+        &statistics.memory_hit_latency, &statistics.disk_lookup_latency,
+        &statistics.disk_write_latency};
+    for (size_t latency = 0; latency < kLatencyCount; ++latency) {
+      for (size_t bucket = 0; bucket < LatencyHistogram::kBucketCount;
+           ++bucket) {
+        histograms[latency]->buckets[bucket] +=
+            stripe.latencies[latency][bucket].load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  for (const auto& counters : statistics.namespaces) {
+    statistics.total += counters;
+  }
+  return statistics;
+}
+
+void StatisticsRecorder::Reset() {
+  for (auto& stripe : stripes_) {
+    for (auto& counters : stripe.counters) {
+      for (auto& counter : counters) {
+        counter.store(0u, std::memory_order_relaxed);
+      }
+    }
+    for (auto& histogram : stripe.latencies) {
+      for (auto& bucket : histogram) {
+        bucket.store(0u, std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+StatisticsRecorder::Stripe& StatisticsRecorder::GetStripe() {
+  const auto thread_hash =
+      std::hash<std::thread::id>{}(std::this_thread::get_id());
+  return stripes_[thread_hash % kStripeCount];
+}
+
+}  // namespace cache
+}  // namespace olp
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "olp/core/cache/CacheStatistics.h"
+
+namespace olp {
+namespace cache {
+
+/**
+ * @brief Collects the `CacheStatistics` without locks.
+ *
+ * The counters are relaxed atomics, spread between several stripes by
+ * the thread id, so the threads rarely write the same cache lines. The stripes
+ * are summed up by `Get`. When disabled, nothing is recorded and no clocks are
+ * read.
+ */
+class StatisticsRecorder {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  enum Counter {
+    kMemoryHits,
+    kDiskHits,
+    kMisses,
+    kExpirations,
+    kEvictions,
+    kPutFailures,
+    kBytesRead,
+    kBytesWritten,
+    kCounterCount
+  };
+
+  enum Latency { kMemoryHit, kDiskLookup, kDiskWrite, kLatencyCount };
+
+  explicit StatisticsRecorder(bool enabled);
+
+  bool IsEnabled() const { return enabled_; }
+
+  /// Adds the value to the counter of the key namespace.
+  void Add(Counter counter, const std::string& key, std::uint64_t value = 1u) {
+    if (enabled_) {
+      Add(counter, CacheStatistics::GetKeyNamespace(key), value);
+    }
+  }
+
+  void Add(Counter counter, CacheKeyNamespace key_namespace,
+           std::uint64_t value = 1u);
+
+  /// Returns the start time of the measured operation, or the default time
+  /// point when disabled.
+  Clock::time_point Start() const {
+    return enabled_ ? Clock::now() : Clock::time_point();
+  }
+
+  /// Records the time passed since `start`.
+  void Finish(Latency latency, Clock::time_point start);
+
+  CacheStatistics Get() const;
+  void Reset();
+
+ private:
+  static constexpr size_t kStripeCount = 8u;
+
+  struct Stripe {
+    std::array<std::array<std::atomic<std::uint64_t>, kCounterCount>,
+               CacheStatistics::kNamespaceCount>
+        counters;
+    std::array<std::array<std::atomic<std::uint64_t>,
+                          LatencyHistogram::kBucketCount>,
+               kLatencyCount>
+        latencies;
+  };
+
+  Stripe& GetStripe();
+
+  const bool enabled_;
+  std::array<Stripe, kStripeCount> stripes_;
+};
+
+}  // namespace cache
+}  // namespace olp
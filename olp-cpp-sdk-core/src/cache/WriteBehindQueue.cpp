@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "WriteBehindQueue.h"
+
+#include "olp/core/logging/Log.h"
+
+namespace olp {
+namespace cache {
+
+namespace {
+constexpr auto kLogTag = "WriteBehindQueue";
+}  // namespace
+
+WriteBehindQueue::WriteBehindQueue(Writer writer, size_t max_size)
+    : writer_(std::move(writer)),
+      max_size_(max_size),
+      thread_(&WriteBehindQueue::Run, this) {}
+
+WriteBehindQueue::~WriteBehindQueue() { Stop(); }
+
+void WriteBehindQueue::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  pending_condition_.notify_one();
+  written_condition_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void WriteBehindQueue::Push(const std::string& key, std::string record) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = pending_index_.find(key);
+  if (it != pending_index_.end()) {
+    auto& pending_record = pending_[it->second].second;
+    pending_size_ = pending_size_ - pending_record.size() + record.size();
+    pending_record = std::move(record);
+  } else {
+    pending_size_ += key.size() + record.size();
+    pending_index_.emplace(key, pending_.size());
+    pending_.emplace_back(key, std::move(record));
+  }
+
+  ++pushed_;
+  lock.unlock();
+  pending_condition_.notify_one();
+}
+
+bool WriteBehindQueue::HasSpace() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return HasSpaceLocked();
+}
+
+bool WriteBehindQueue::WaitForSpace() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  written_condition_.wait(lock, [&]() { return stop_ || HasSpaceLocked(); });
+  return !stop_;
+}
+
+bool WriteBehindQueue::Discard(
+    const std::function<bool(const std::string&)>& matches) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (const auto& item : writing_) {
+    if (matches(item.first)) {
+      return false;
+    }
+  }
+
+  Items kept;
+  kept.reserve(pending_.size());
+  pending_index_.clear();
+  pending_size_ = 0u;
+  for (auto& item : pending_) {
+    if (matches(item.first)) {
+      continue;
+    }
+    pending_size_ += item.first.size() + item.second.size();
+    pending_index_.emplace(item.first, kept.size());
+    kept.push_back(std::move(item));
+  }
+  pending_.swap(kept);
+
+  // Nothing is left to write, so the flushes are done.
+  if (pending_.empty() && writing_.empty()) {
+    written_ = pushed_;
+  }
+  lock.unlock();
+  written_condition_.notify_all();
+  return true;
+}
+
+bool WriteBehindQueue::WaitForWrite() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto written = written_;
+  written_condition_.wait(lock, [&]() {
+    return stop_ || writing_.empty() || written_ != written;
+  });
+  return !stop_;
+}
+
+bool WriteBehindQueue::Get(const std::string& key, std::string& record) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto* value = Find(pending_, pending_index_, key);
+  if (!value) {
+    value = Find(writing_, writing_index_, key);
+  }
+
+  if (!value) {
+    return false;
+  }
+
+  record = *value;
+  return true;
+}
+
+bool WriteBehindQueue::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto target = pushed_;
+  written_condition_.wait(lock, [&]() { return written_ >= target; });
+
+  const auto failed = failed_;
+  failed_ = false;
+  return !failed;
+}
+
+void WriteBehindQueue::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    pending_condition_.wait(lock,
+                            [&]() { return stop_ || !pending_.empty(); });
+    if (pending_.empty()) {
+      // Stopped, and all the records are written.
+      return;
+    }
+
+    writing_.swap(pending_);
+    writing_index_.swap(pending_index_);
+    pending_size_ = 0u;
+    const auto taken = pushed_;
+    lock.unlock();
+    written_condition_.notify_all();
+
+    const bool written = writer_(writing_);
+    if (!written) {
+      OLP_SDK_LOG_WARNING_F(kLogTag, "Failed to write %d records",
+                            static_cast<int>(writing_.size()));
+    }
+
+    lock.lock();
+    writing_.clear();
+    writing_index_.clear();
+    // The discarded records are never written, so all the pushes are done
+    // when nothing is pending.
+    written_ = pending_.empty() ? pushed_ : taken;
+    failed_ = failed_ || !written;
+    written_condition_.notify_all();
+  }
+}
+
+bool WriteBehindQueue::HasSpaceLocked() const {
+  // A record larger than the queue is still accepted when the queue is empty.
+  return pending_size_ < max_size_ || pending_.empty();
+}
+
+const std::string* WriteBehindQueue::Find(
+    const Items& items, const std::unordered_map<std::string, size_t>& index,
+    const std::string& key) {
+  auto it = index.find(key);
+  return it != index.end() ? &items[it->second].second : nullptr;
+}
+
+}  // namespace cache
+}  // namespace olp
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace olp {
+namespace cache {
+
+/**
+ * @brief Queues the disk cache writes and applies them on a dedicated thread.
+ *
+ * The writes of the same key are coalesced, and all the writes queued while
+ * the previous batch is written go to the disk in the next batch. The pending
+ * records can be looked up, so the reads see the queued writes.
+ */
+class WriteBehindQueue {
+ public:
+  using Items = std::vector<std::pair<std::string, std::string>>;
+  /// Writes the batch to the disk, returns false on failure.
+  using Writer = std::function<bool(const Items&)>;
+
+  /// Starts the writer thread. `max_size` limits the size of the queued keys
+  /// and records in bytes, see `WaitForSpace`.
+  WriteBehindQueue(Writer writer, size_t max_size);
+  /// Writes the queued records and stops the writer thread.
+  ~WriteBehindQueue();
+
+  WriteBehindQueue(const WriteBehindQueue&) = delete;
+  WriteBehindQueue& operator=(const WriteBehindQueue&) = delete;
+
+  /// Queues the record, replacing the queued record of the same key. Never
+  /// blocks, so it can be called under the cache locks.
+  void Push(const std::string& key, std::string record);
+
+  /// Checks whether the queue has room for more records.
+  bool HasSpace() const;
+
+  /// Blocks while the queue is full. Returns false if the queue is stopped.
+  bool WaitForSpace();
+
+  /// Drops the queued records of the matching keys. Returns false, dropping
+  /// nothing, if a matching record is being written; wait for it with
+  /// `WaitForWrite` and retry.
+  bool Discard(const std::function<bool(const std::string&)>& matches);
+
+  /// Waits until the records that are being written are written. Returns
+  /// false if the queue is stopped.
+  bool WaitForWrite();
+
+  /// Writes the queued records and stops the writer thread. The waiting
+  /// calls return, and the records pushed later are not written.
+  void Stop();
+
+  /// Finds the queued or the currently written record of the key.
+  bool Get(const std::string& key, std::string& record) const;
+
+  /// Waits until all the records queued before the call are written. Returns
+  /// false if any write failed since the previous flush.
+  bool Flush();
+
+ private:
+  void Run();
+  bool HasSpaceLocked() const;
+  static const std::string* Find(
+      const Items& items, const std::unordered_map<std::string, size_t>& index,
+      const std::string& key);
+
+  Writer writer_;
+  const size_t max_size_;
+
+  mutable std::mutex mutex_;
+  /// Wakes up the writer thread.
+  std::condition_variable pending_condition_;
+  /// Wakes up the producers and the flushes after a batch is taken or written.
+  std::condition_variable written_condition_;
+
+  /// The queued records and their positions by key.
+  Items pending_;
+  std::unordered_map<std::string, size_t> pending_index_;
+  size_t pending_size_{0u};
+
+  /// The records that are being written, read by the writer thread without
+  /// the lock, so they are only replaced by the writer thread.
+  Items writing_;
+  std::unordered_map<std::string, size_t> writing_index_;
+
+  /// The number of the pushes, and the number of the pushes written.
+  std::uint64_t pushed_{0u};
+  std::uint64_t written_{0u};
+  bool failed_{false};
+  bool stop_{false};
+
+  std::thread thread_;
+};
+
+}  // namespace cache
+}  // namespace olp
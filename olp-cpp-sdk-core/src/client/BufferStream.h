@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+namespace olp {
+namespace client {
+
+/// Stream buffer that writes directly into a shared byte vector, so the
+/// network payload ends up in the buffer that is handed over to the caller
+/// and to the cache without intermediate copies.
+class BufferStreamBuf : public std::streambuf {
+ public:
+  using Buffer = std::vector<unsigned char>;
+
+  /// The upper limit of the preallocated buffer size, so a wrong or hostile
+  /// size does not allocate the memory up front.
+  static constexpr std::uint64_t kMaxReservedSize = 64u * 1024u * 1024u;
+
+  explicit BufferStreamBuf(std::shared_ptr<Buffer> buffer)
+      : buffer_(std::move(buffer)) {}
+
+  /// Sets the expected body size, e.g. from the Content-Length header. The
+  /// buffer is preallocated on the first write, after all the headers of
+  /// the final response are received, so the sizes of the redirects and
+  /// the intermediate responses are replaced by then.
+  void SetExpectedSize(std::uint64_t size) { expected_size_ = size; }
+
+ protected:
+  std::streamsize xsputn(const char_type* data,
+                         std::streamsize count) override {
+    const auto bytes = reinterpret_cast<const unsigned char*>(data);
+    const auto size = static_cast<size_t>(count);
+    if (expected_size_ > 0u && buffer_->empty()) {
+      buffer_->reserve(static_cast<size_t>(
+          std::min(expected_size_, std::uint64_t{kMaxReservedSize})));
+      expected_size_ = 0u;
+    }
+
+    // Overwrite the data after a seek (e.g. a retried transfer), append the
+    // rest.
+    const auto overwrite = std::min(size, buffer_->size() - position_);
+    std::copy(bytes, bytes + overwrite, buffer_->begin() + position_);
+    buffer_->insert(buffer_->end(), bytes + overwrite, bytes + size);
+    position_ += size;
+    return count;
+  }
+
+  int_type overflow(int_type ch) override {
+    if (traits_type::eq_int_type(ch, traits_type::eof())) {
+      return traits_type::not_eof(ch);
+    }
+
+    const auto c = traits_type::to_char_type(ch);
+    xsputn(&c, 1);
+    return ch;
+  }
+
+  pos_type seekoff(off_type offset, std::ios_base::seekdir direction,
+                   std::ios_base::openmode mode) override {
+    off_type base = 0;
+    if (direction == std::ios_base::cur) {
+      base = static_cast<off_type>(position_);
+    } else if (direction == std::ios_base::end) {
+      base = static_cast<off_type>(buffer_->size());
+    }
+    return seekpos(pos_type(base + offset), mode);
+  }
+
+  pos_type seekpos(pos_type position, std::ios_base::openmode mode) override {
+    const auto offset = static_cast<off_type>(position);
+    if ((mode & std::ios_base::out) == 0 || offset < 0 ||
+        offset > static_cast<off_type>(buffer_->size())) {
+      return pos_type(off_type(-1));
+    }
+
+    position_ = static_cast<size_t>(offset);
+    return position;
+  }
+
+ private:
+  std::shared_ptr<Buffer> buffer_;
+  size_t position_{0};
+  std::uint64_t expected_size_{0};
+};
+
+/// Output stream over `BufferStreamBuf`.
+class BufferStream : public std::ostream {
+ public:
+  explicit BufferStream(std::shared_ptr<BufferStreamBuf::Buffer> buffer)
+      : std::ostream(nullptr), buffer_(std::move(buffer)) {
+    rdbuf(&buffer_);
+  }
+
+  /// See `BufferStreamBuf::SetExpectedSize`.
+  void SetExpectedSize(std::uint64_t size) { buffer_.SetExpectedSize(size); }
+
+ private:
+  BufferStreamBuf buffer_;
+};
+
+}  // namespace client
+}  // namespace olp
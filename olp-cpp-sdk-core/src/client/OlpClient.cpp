@@ -19,17 +19,23 @@
 
 #include "olp/core/client/OlpClient.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <chrono>
+#include <cstdlib>
 #include <future>
+#include <mutex>
 #include <sstream>
-#include <thread>
 
+#include "BufferStream.h"
 #include "olp/core/client/Condition.h"
 #include "olp/core/client/ErrorCode.h"
 #include "olp/core/http/NetworkConstants.h"
 #include "olp/core/logging/Log.h"
+#include "olp/core/thread/TaskScheduler.h"
 #include "olp/core/utils/Url.h"
+#include "thread/DelayedTaskQueue.h"
 
 namespace {
 constexpr auto kLogTag = "OlpClient";
@@ -75,8 +81,10 @@ CancellationToken ExecuteSingleRequest(
     return CancellationToken();
   }
 
+  auto headers = std::make_shared<http::Headers>();
   auto send_outcome = network->Send(
-      request, response_body, [=](const http::NetworkResponse& response) {
+      request, response_body,
+      [=](const http::NetworkResponse& response) {
         int status = response.GetStatus();
         if (status >= 400 || status < 0) {
           if (response.GetError().empty()) {
@@ -85,7 +93,12 @@ CancellationToken ExecuteSingleRequest(
             response_body->str(response.GetError());
           }
         }
-        callback(HttpResponse(status, std::move(*response_body)));
+        HttpResponse result(status, std::move(*response_body));
+        result.headers = std::move(*headers);
+        callback(std::move(result));
+      },
+      [headers](std::string key, std::string value) {
+        headers->emplace_back(std::move(key), std::move(value));
       });
 
   if (!send_outcome.IsSuccessful()) {
@@ -121,26 +134,116 @@ http::NetworkRequest::HttpVerb GetHttpVerb(const std::string& verb) {
   return http_verb;
 }
 
+bool StatusSuccess(int status) { return status >= 0 && status < 400; }
+
+bool StatusOk(int status) { return status >= 200 && status < 300; }
+
+// Passes the streamed body chunks to the caller while a request is sent,
+// so the caller's sink is not used after the request returns.
+// The network passes only the successful body to the data callback, the
+// error body is written to the payload and used for the error message.
+// The retries replay the body from the start, so the bytes that the caller
+// already has are skipped, and the caller gets each byte once.
+class DataForwarder {
+ public:
+  explicit DataForwarder(http::Network::DataCallback data_callback)
+      : data_callback_(std::move(data_callback)) {}
+
+  void Forward(const std::uint8_t* data, std::uint64_t offset,
+               std::size_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!forwarding_) {
+      return;
+    }
+
+    if (forwarded_ && offset < end_offset_) {
+      const auto skipped = static_cast<std::size_t>(
+          std::min<std::uint64_t>(end_offset_ - offset, length));
+      data += skipped;
+      offset += skipped;
+      length -= skipped;
+      if (length == 0) {
+        return;
+      }
+    }
+
+    data_callback_(data, offset, length);
+    forwarded_ = true;
+    end_offset_ = offset + length;
+  }
+
+  void Start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    forwarding_ = true;
+  }
+
+  void Stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    forwarding_ = false;
+  }
+
+ private:
+  std::mutex mutex_;
+  http::Network::DataCallback data_callback_;
+  bool forwarding_{false};
+  bool forwarded_{false};
+  std::uint64_t end_offset_{0};
+};
 HttpResponse SendRequest(const http::NetworkRequest& request,
                          const olp::client::OlpClientSettings& settings,
                          const olp::client::RetrySettings& retry_settings,
-                         client::CancellationContext context) {
+                         client::CancellationContext context, bool to_buffer,
+                         const std::shared_ptr<DataForwarder>& data_forwarder) {
   http::NetworkResponse network_response = kCancelledErrorResponse;
   auto interest_flag = std::make_shared<std::atomic_bool>(true);
   Condition condition{};
   auto response_body = std::make_shared<std::stringstream>();
   http::SendOutcome outcome{http::ErrorCode::CANCELLED_ERROR};
 
+  // The buffer is preallocated when the size of the body is known, so
+  // the payload is written only once.
+  std::shared_ptr<std::vector<unsigned char>> buffer;
+  std::shared_ptr<BufferStream> buffer_stream;
+  http::Network::Payload payload = response_body;
+  if (to_buffer) {
+    buffer = std::make_shared<std::vector<unsigned char>>();
+    buffer_stream = std::make_shared<BufferStream>(buffer);
+    payload = buffer_stream;
+  }
+
+  auto headers = std::make_shared<http::Headers>();
+  http::Network::HeaderCallback header_callback =
+      [buffer_stream, headers](std::string key, std::string value) {
+        if (buffer_stream &&
+            CaseInsensitiveCompare(key, http::kContentLengthHeader)) {
+          buffer_stream->SetExpectedSize(
+              std::strtoull(value.c_str(), nullptr, 10));
+        }
+        headers->emplace_back(std::move(key), std::move(value));
+      };
+
+  // Only the error body is written to the payload of the streamed request.
+  http::Network::DataCallback forward_callback;
+  if (data_forwarder) {
+    data_forwarder->Start();
+    forward_callback = [data_forwarder](const std::uint8_t* data,
+                                        std::uint64_t offset,
+                                        std::size_t length) {
+      data_forwarder->Forward(data, offset, length);
+    };
+  }
+
   context.ExecuteOrCancelled(
       [&]() {
         outcome = settings.network_request_handler->Send(
-            request, response_body,
+            request, payload,
             [&, interest_flag](http::NetworkResponse response) {
               if (interest_flag->exchange(false)) {
                 network_response = std::move(response);
                 condition.Notify();
               }
-            });
+            },
+            header_callback, forward_callback);
 
         return CancellationToken([&, interest_flag]() {
           if (interest_flag->exchange(false)) {
@@ -158,7 +261,13 @@ HttpResponse SendRequest(const http::NetworkRequest& request,
             ErrorCodeToString(outcome.GetErrorCode())};
   }
 
-  if (!condition.Wait(std::chrono::seconds(retry_settings.timeout))) {
+  const bool completed =
+      condition.Wait(std::chrono::seconds(retry_settings.timeout));
+  if (data_forwarder) {
+    data_forwarder->Stop();
+  }
+
+  if (!completed) {
     OLP_SDK_LOG_INFO_F(kLogTag, "Timeout");
     context.CancelOperation();
     return ToHttpResponse(kTimeoutErrorResponse);
@@ -172,10 +281,38 @@ HttpResponse SendRequest(const http::NetworkRequest& request,
     return ToHttpResponse(kCancelledErrorResponse);
   }
 
-  return {network_response.GetStatus(), std::move(*response_body)};
+  const auto status = network_response.GetStatus();
+  HttpResponse response;
+  if (data_forwarder && StatusOk(status)) {
+    response = HttpResponse(status);
+  } else if (buffer && StatusSuccess(status)) {
+    response = HttpResponse(status, std::move(buffer));
+  } else if (buffer) {
+    response =
+        HttpResponse(status, std::string(buffer->begin(), buffer->end()));
+  } else {
+    response = HttpResponse(status, std::move(*response_body));
+  }
+
+  response.headers = std::move(*headers);
+  return response;
 }
 
-bool StatusSuccess(int status) { return status >= 0 && status < 400; }
+// Waits for the backdown period, the cancellation interrupts the wait.
+// Returns false if the operation is cancelled.
+bool WaitForBackdown(client::CancellationContext& context,
+                     std::chrono::milliseconds period) {
+  auto condition = std::make_shared<Condition>();
+  const bool executed = context.ExecuteOrCancelled([&]() {
+    return CancellationToken([condition]() { condition->Notify(); });
+  });
+  if (!executed) {
+    return false;
+  }
+
+  condition->Wait(period);
+  return !context.IsCancelled();
+}
 
 std::chrono::milliseconds CalculateNextWaitTime(
     const RetrySettings& settings,
@@ -190,9 +327,28 @@ std::chrono::milliseconds CalculateNextWaitTime(
   }
   return std::chrono::milliseconds::zero();
 }
+
+/// Completes the request when the scheduled retry is destroyed without being
+/// run, for example, by a task scheduler destroyed during the backdown.
+struct PendingRetry {
+  explicit PendingRetry(NetworkAsyncCallback callback)
+      : callback(std::move(callback)) {}
+
+  ~PendingRetry() {
+    if (pending->exchange(false)) {
+      callback(HttpResponse(static_cast<int>(http::ErrorCode::CANCELLED_ERROR),
+                            "Operation Cancelled."));
+    }
+  }
+
+  NetworkAsyncCallback callback;
+  std::shared_ptr<std::atomic_bool> pending =
+      std::make_shared<std::atomic_bool>(true);
+};
 }  // anonymous namespace
 
-OlpClient::OlpClient() {}
+OlpClient::OlpClient()
+    : delayed_tasks_(std::make_shared<thread::DelayedTaskQueue>()) {}
 
 void OlpClient::SetBaseUrl(const std::string& base_url) {
   base_url_ = base_url;
@@ -208,6 +364,10 @@ void OlpClient::SetSettings(const OlpClientSettings& settings) {
   settings_ = settings;
 }
 
+void OlpClient::SetPriority(std::uint32_t priority) { priority_ = priority; }
+
+std::uint32_t OlpClient::GetPriority() const { return priority_; }
+
 std::shared_ptr<http::NetworkRequest> OlpClient::CreateRequest(
     const std::string& path, const std::string& method,
     const std::multimap<std::string, std::string>& query_params,
@@ -218,7 +378,7 @@ std::shared_ptr<http::NetworkRequest> OlpClient::CreateRequest(
       olp::utils::Url::Construct(base_url_, path, query_params));
 
   http::NetworkRequest::HttpVerb http_verb = GetHttpVerb(method);
-  network_request->WithVerb(http_verb);
+  network_request->WithVerb(http_verb).WithPriority(priority_);
 
   if (settings_.authentication_settings &&
       settings_.authentication_settings.get().provider) {
@@ -262,6 +422,8 @@ NetworkAsyncCallback GetRetryCallback(
     const RetrySettings& settings, const NetworkAsyncCallback& callback,
     const std::shared_ptr<http::NetworkRequest>& network_request,
     std::weak_ptr<http::Network> network,
+    const std::shared_ptr<thread::TaskScheduler>& task_scheduler,
+    const std::weak_ptr<thread::DelayedTaskQueue>& weak_delayed_tasks,
     const std::weak_ptr<CancellationContext>& weak_cancel_context) {
   ++current_try;
   return [=](HttpResponse response) {
@@ -272,39 +434,86 @@ NetworkAsyncCallback GetRetryCallback(
         !settings.retry_condition(response) ||
         accumulated_wait_time >= max_wait_time) {
       callback(std::move(response));
-    } else {
-      // TODO there must be a better way
-      const auto actual_wait_time = std::min(
-          current_backdown_period, max_wait_time - accumulated_wait_time);
-      std::this_thread::sleep_for(actual_wait_time);
-
-      const auto next_wait_time =
-          CalculateNextWaitTime(settings, current_backdown_period, current_try);
-
-      auto cancel_context = weak_cancel_context.lock();
-      if (cancel_context) {
-        cancel_context->ExecuteOrCancelled(
-            [&]() -> CancellationToken {
-              return ExecuteSingleRequest(
-                  network, *network_request,
-                  GetRetryCallback(current_try, next_wait_time,
-                                   accumulated_wait_time + actual_wait_time,
-                                   settings, callback, network_request, network,
-                                   weak_cancel_context));
-            },
-            [callback]() {
-              callback(HttpResponse(
-                  static_cast<int>(http::ErrorCode::CANCELLED_ERROR),
-                  "Operation Cancelled."));
-            });
-      } else {
-        // Last (and only) strong reference lives in cancellation
-        // token, which is reset on CancelOperation.
+      return;
+    }
+
+    auto cancel_context = weak_cancel_context.lock();
+    if (!cancel_context) {
+      // Last (and only) strong reference lives in cancellation
+      // token, which is reset on CancelOperation.
+      callback(HttpResponse(static_cast<int>(http::ErrorCode::CANCELLED_ERROR),
+                            "Operation Cancelled."));
+      return;
+    }
+
+    const auto actual_wait_time = std::min(
+        current_backdown_period, max_wait_time - accumulated_wait_time);
+    const auto next_wait_time =
+        CalculateNextWaitTime(settings, current_backdown_period, current_try);
+
+    // Either the retry, the cancellation during the backdown period or the
+    // destruction of the waiting retry completes the request.
+    auto pending_retry = std::make_shared<PendingRetry>(callback);
+    auto retry_pending = pending_retry->pending;
+    auto retry = [=]() {
+      if (!pending_retry->pending->exchange(false)) {
+        return;
+      }
+
+      auto context = weak_cancel_context.lock();
+      if (!context) {
         callback(
             HttpResponse(static_cast<int>(http::ErrorCode::CANCELLED_ERROR),
                          "Operation Cancelled."));
+        return;
       }
-    }
+
+      context->ExecuteOrCancelled(
+          [&]() -> CancellationToken {
+            return ExecuteSingleRequest(
+                network, *network_request,
+                GetRetryCallback(current_try, next_wait_time,
+                                 accumulated_wait_time + actual_wait_time,
+                                 settings, callback, network_request, network,
+                                 task_scheduler, weak_delayed_tasks,
+                                 weak_cancel_context));
+          },
+          [callback]() {
+            callback(HttpResponse(
+                static_cast<int>(http::ErrorCode::CANCELLED_ERROR),
+                "Operation Cancelled."));
+          });
+    };
+
+    // The backdown period is waited for on a timer, so it blocks neither
+    // the network thread that called this callback nor a task scheduler
+    // thread. Without the timer of the client, which is destroyed, the retry
+    // is dropped and completes the request.
+    cancel_context->ExecuteOrCancelled(
+        [&]() -> CancellationToken {
+          if (task_scheduler) {
+            task_scheduler->ScheduleDelayedTask(std::move(retry),
+                                                actual_wait_time,
+                                                network_request->GetPriority());
+          } else if (auto delayed_tasks = weak_delayed_tasks.lock()) {
+            delayed_tasks->Schedule(std::move(retry), actual_wait_time);
+          }
+
+          return CancellationToken([retry_pending, callback]() {
+            if (retry_pending->exchange(false)) {
+              callback(HttpResponse(
+                  static_cast<int>(http::ErrorCode::CANCELLED_ERROR),
+                  "Operation Cancelled."));
+            }
+          });
+        },
+        [retry_pending, callback]() {
+          if (retry_pending->exchange(false)) {
+            callback(HttpResponse(
+                static_cast<int>(http::ErrorCode::CANCELLED_ERROR),
+                "Operation Cancelled."));
+          }
+        });
   };
 }
 
@@ -351,7 +560,9 @@ CancellationToken OlpClient::CallApi(
                        std::chrono::milliseconds(
                            settings_.retry_settings.initial_backdown_period),
                        std::chrono::milliseconds::zero(), retry_settings,
-                       callback, network_request, network, cancel_context);
+                       callback, network_request, network,
+                       settings_.task_scheduler, delayed_tasks_,
+                       cancel_context);
 
   cancel_context->ExecuteOrCancelled(
       [=]() -> CancellationToken {
@@ -374,10 +585,45 @@ HttpResponse OlpClient::CallApi(
     std::multimap<std::string, std::string> forms_params,
     std::shared_ptr<std::vector<unsigned char>> post_body,
     std::string content_type, CancellationContext context) const {
+  return CallApiBlocking(path, method, query_params, header_params, post_body,
+                         content_type, std::move(context), false);
+}
+
+HttpResponse OlpClient::CallApiToBuffer(
+    std::string path, std::string method,
+    std::multimap<std::string, std::string> query_params,
+    std::multimap<std::string, std::string> header_params,
+    std::multimap<std::string, std::string> /*forms_params*/,
+    std::shared_ptr<std::vector<unsigned char>> post_body,
+    std::string content_type, CancellationContext context) const {
+  return CallApiBlocking(path, method, query_params, header_params, post_body,
+                         content_type, std::move(context), true);
+}
+
+HttpResponse OlpClient::CallApiStream(
+    std::string path, std::string method,
+    std::multimap<std::string, std::string> query_params,
+    std::multimap<std::string, std::string> header_params,
+    std::multimap<std::string, std::string> /*forms_params*/,
+    std::shared_ptr<std::vector<unsigned char>> post_body,
+    std::string content_type, http::Network::DataCallback data_callback,
+    CancellationContext context) const {
+  return CallApiBlocking(path, method, query_params, header_params, post_body,
+                         content_type, std::move(context), false,
+                         data_callback);
+}
+
+HttpResponse OlpClient::CallApiBlocking(
+    const std::string& path, const std::string& method,
+    const std::multimap<std::string, std::string>& query_params,
+    const std::multimap<std::string, std::string>& header_params,
+    const std::shared_ptr<std::vector<unsigned char>>& post_body,
+    const std::string& content_type, CancellationContext context,
+    bool to_buffer, const http::Network::DataCallback& data_callback) const {
   http::NetworkRequest network_request(
       olp::utils::Url::Construct(base_url_, path, query_params));
 
-  network_request.WithVerb(GetHttpVerb(method));
+  network_request.WithVerb(GetHttpVerb(method)).WithPriority(priority_);
 
   if (settings_.authentication_settings &&
       settings_.authentication_settings.get().provider) {
@@ -427,8 +673,13 @@ HttpResponse OlpClient::CallApi(
 
   network_request.WithSettings(std::move(network_settings));
 
-  auto response =
-      SendRequest(network_request, settings_, retry_settings, context);
+  std::shared_ptr<DataForwarder> data_forwarder;
+  if (data_callback) {
+    data_forwarder = std::make_shared<DataForwarder>(data_callback);
+  }
+
+  auto response = SendRequest(network_request, settings_, retry_settings,
+                              context, to_buffer, data_forwarder);
 
   // Make sure that we don't wait longer than `timeout` in retry settings
   auto accumulated_wait_time = backdown_period;
@@ -446,20 +697,16 @@ HttpResponse OlpClient::CallApi(
       return response;
     }
 
-    // do the periodical sleep and check for cancellation status in between.
-    auto duration_to_sleep =
+    auto duration_to_wait =
         std::min(backdown_period, max_wait_time - accumulated_wait_time);
-    accumulated_wait_time += duration_to_sleep;
-
-    while (duration_to_sleep.count() > 0 && !context.IsCancelled()) {
-      const auto sleep_ms =
-          std::min(std::chrono::milliseconds(1000), duration_to_sleep);
-      std::this_thread::sleep_for(sleep_ms);
-      duration_to_sleep -= sleep_ms;
+    accumulated_wait_time += duration_to_wait;
+    if (!WaitForBackdown(context, duration_to_wait)) {
+      return ToHttpResponse(kCancelledErrorResponse);
     }
 
     backdown_period = CalculateNextWaitTime(retry_settings, backdown_period, i);
-    response = SendRequest(network_request, settings_, retry_settings, context);
+    response = SendRequest(network_request, settings_, retry_settings, context,
+                           to_buffer, data_forwarder);
   }
 
   return response;
@@ -39,6 +39,12 @@ OlpClientSettingsFactory::CreateDefaultNetworkRequestHandler(
   return http::CreateDefaultNetwork(max_requests_count);
 }
 
+std::shared_ptr<http::Network>
+OlpClientSettingsFactory::CreateDefaultNetworkRequestHandler(
+    const http::NetworkInitializationSettings& settings) {
+  return http::CreateDefaultNetwork(settings);
+}
+
 std::unique_ptr<cache::KeyValueCache>
 OlpClientSettingsFactory::CreateDefaultCache(
     const cache::CacheSettings& settings) {
@@ -19,6 +19,8 @@
 
 #include "olp/core/http/Network.h"
 
+#include <algorithm>
+
 #include "olp/core/utils/WarningWorkarounds.h"
 
 #ifdef OLP_SDK_NETWORK_HAS_CURL
@@ -36,9 +38,19 @@ namespace http {
 
 CORE_API std::shared_ptr<Network> CreateDefaultNetwork(
     size_t max_requests_count) {
+  NetworkInitializationSettings settings;
+  settings.max_requests_count = max_requests_count;
+  settings.min_requests_count =
+      std::max(static_cast<size_t>(1u), max_requests_count / 4);
+  return CreateDefaultNetwork(std::move(settings));
+}
+
+CORE_API std::shared_ptr<Network> CreateDefaultNetwork(
+    NetworkInitializationSettings settings) {
+  const auto max_requests_count = settings.max_requests_count;
   CORE_UNUSED(max_requests_count);
 #ifdef OLP_SDK_NETWORK_HAS_CURL
-  return std::make_shared<NetworkCurl>(max_requests_count);
+  return std::make_shared<NetworkCurl>(std::move(settings));
 #elif OLP_SDK_NETWORK_HAS_ANDROID
   return std::make_shared<NetworkAndroid>(max_requests_count);
 #elif OLP_SDK_NETWORK_HAS_IOS
@@ -38,6 +38,8 @@ NetworkRequest::RequestBodyType NetworkRequest::GetBody() const {
 
 const NetworkSettings& NetworkRequest::GetSettings() const { return settings_; }
 
+std::uint32_t NetworkRequest::GetPriority() const { return priority_; }
+
 NetworkRequest& NetworkRequest::WithHeader(std::string name,
                                            std::string value) {
   headers_.emplace_back(std::move(name), std::move(value));
@@ -64,5 +66,10 @@ NetworkRequest& NetworkRequest::WithSettings(NetworkSettings settings) {
   return *this;
 }
 
+NetworkRequest& NetworkRequest::WithPriority(std::uint32_t priority) {
+  priority_ = priority;
+  return *this;
+}
+
 }  // namespace http
 }  // namespace olp
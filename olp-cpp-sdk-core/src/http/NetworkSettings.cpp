@@ -34,6 +34,10 @@ const NetworkProxySettings& NetworkSettings::GetProxySettings() const {
   return proxy_settings_;
 }
 
+bool NetworkSettings::GetHttp2Multiplexing() const {
+  return http2_multiplexing_;
+}
+
 NetworkSettings& NetworkSettings::WithRetries(std::size_t retries) {
   retries_ = retries;
   return *this;
@@ -55,5 +59,10 @@ NetworkSettings& NetworkSettings::WithProxySettings(
   return *this;
 }
 
+NetworkSettings& NetworkSettings::WithHttp2Multiplexing(bool enable) {
+  http2_multiplexing_ = enable;
+  return *this;
+}
+
 }  // namespace http
 }  // namespace olp
@@ -392,7 +392,7 @@ public class HttpClient {
             checkCancelled();
 
             headersCallback(request.requestId(), headersArray);
-            dateAndOffsetCallback(request.requestId(), 0l, offset);
+            dateAndOffsetCallback(request.requestId(), status, 0l, offset);
 
             // Do the input phase
             InputStream in = null;
@@ -588,8 +588,9 @@ public class HttpClient {
       long requestId, int status, String error, String contentType);
   // Callback for data received
   private synchronized native void dataCallback(long requestId, byte[] data, int len);
-  // Callback set date and offset
-  private synchronized native void dateAndOffsetCallback(long requestId, long date, long offset);
+  // Callback set status, date and offset
+  private synchronized native void dateAndOffsetCallback(
+      long requestId, int status, long date, long offset);
   // Callback set date and offset
   private synchronized native void headersCallback(long requestId, String[] headers);
   // Reset request for retry
@@ -93,11 +93,12 @@ Java_com_here_olp_network_HttpClient_headersCallback(JNIEnv* env, jobject obj,
 }
 
 /*
- * Callback to be called when a date header is received
+ * Callback to be called when the status and the date header are received
  */
 extern "C" OLP_SDK_NETWORK_ANDROID_EXPORT void JNICALL
 Java_com_here_olp_network_HttpClient_dateAndOffsetCallback(
-    JNIEnv* env, jobject obj, jlong request_id, jlong date, jlong offset) {
+    JNIEnv* env, jobject obj, jlong request_id, jint status, jlong date,
+    jlong offset) {
   auto network = olp::http::GetNetworkAndroidNativePtr(env, obj);
   if (!network) {
     OLP_SDK_LOG_WARNING(
@@ -106,7 +107,7 @@ Java_com_here_olp_network_HttpClient_dateAndOffsetCallback(
             << request_id);
     return;
   }
-  network->DateAndOffsetCallback(env, request_id, date, offset);
+  network->DateAndOffsetCallback(env, request_id, status, date, offset);
 }
 
 /*
@@ -383,7 +384,7 @@ bool NetworkAndroid::Initialize() {
     JNINativeMethod methods[] = {
         {"headersCallback", "(J[Ljava/lang/String;)V",
          (void*)&Java_com_here_olp_network_HttpClient_headersCallback},
-        {"dateAndOffsetCallback", "(JJJ)V",
+        {"dateAndOffsetCallback", "(JIJJ)V",
          (void*)&Java_com_here_olp_network_HttpClient_dateAndOffsetCallback},
         {"dataCallback", "(J[BI)V",
          (void*)&Java_com_here_olp_network_HttpClient_dataCallback},
@@ -599,7 +600,8 @@ void NetworkAndroid::HeadersCallback(JNIEnv* env, RequestId request_id,
 }
 
 void NetworkAndroid::DateAndOffsetCallback(JNIEnv* env, RequestId request_id,
-                                           jlong date, jlong offset) {
+                                           int status, jlong date,
+                                           jlong offset) {
   std::unique_lock<std::mutex> lock(requests_mutex_);
   if (!started_) return;
 
@@ -609,6 +611,7 @@ void NetworkAndroid::DateAndOffsetCallback(JNIEnv* env, RequestId request_id,
         kLogTag, "Date and offset to unknown request with id=" << request_id);
     return;
   }
+  request->second->status = status;
   request->second->offset = offset;
 }
 
@@ -632,8 +635,16 @@ void NetworkAndroid::DataReceived(JNIEnv* env, RequestId request_id,
   OLP_SDK_LOG_TRACE(
       kLogTag, "Received " << len << " bytes for request_id=" << request_id);
 
+  // The data callback receives only the successful body, the error body goes
+  // to the payload.
+  const bool to_data_callback = request->data_callback &&
+                                request->status >= 200 && request->status < 300;
+
   jbyte* jdata = env->GetByteArrayElements(data, NULL);
-  if (auto payload = request->payload) {
+  if (to_data_callback) {
+    request->data_callback(reinterpret_cast<uint8_t*>(jdata),
+                           request->offset + request->count, len);
+  } else if (auto payload = request->payload) {
     if (payload->tellp() != std::streampos(request->count)) {
       payload->seekp(request->count);
       if (payload->fail()) {
@@ -646,10 +657,6 @@ void NetworkAndroid::DataReceived(JNIEnv* env, RequestId request_id,
     payload->write(reinterpret_cast<const char*>(jdata), len);
   }
 
-  if (request->data_callback)
-    request->data_callback(reinterpret_cast<uint8_t*>(jdata),
-                           request->offset + request->count, len);
-
   env->ReleaseByteArrayElements(data, jdata, 0);
 
   request->count += len;
@@ -1048,7 +1055,8 @@ NetworkAndroid::RequestData::RequestData(
       data_callback(data_callback),
       url(url),
       payload(payload),
-      obj(nullptr) {}
+      obj(nullptr),
+      status(0) {}
 
 NetworkAndroid::ResponseData::ResponseData(
     RequestId id, Network::Callback callback, int status, const char* error,
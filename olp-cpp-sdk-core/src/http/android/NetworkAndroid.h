@@ -67,14 +67,15 @@ class NetworkAndroid : public Network {
   void HeadersCallback(JNIEnv* env, RequestId request_id, jobjectArray headers);
 
   /**
-   * @brief Date header received for the given message
+   * @brief Status and date header received for the given message
    * @param env - JNI environment for this thread
    * @param id - Unique Id of the message
+   * @param status - HTTP status code of the response
    * @param date - Date in milliseconds since January 1, 1970 GMT
    * @param offset - Offset of first byte from beginning of the whole content
    */
-  void DateAndOffsetCallback(JNIEnv* env, RequestId request_id, jlong date,
-                             jlong offset);
+  void DateAndOffsetCallback(JNIEnv* env, RequestId request_id, int status,
+                             jlong date, jlong offset);
 
   /**
    * @brief Data received to the given message
@@ -134,6 +135,7 @@ class NetworkAndroid : public Network {
       obj = nullptr;
       count = 0;
       offset = 0;
+      status = 0;
     }
     Network::Callback callback;
     Network::HeaderCallback header_callback;
@@ -143,6 +145,7 @@ class NetworkAndroid : public Network {
     jobject obj;
     jlong count;
     jlong offset;
+    int status;
     std::shared_ptr<RequestCompletion> completion;
   };
 
@@ -23,7 +23,12 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#ifdef OLP_SDK_NETWORK_HAS_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
 
+#include <algorithm>
 #include <cstring>
 #include <locale>
 #include <memory>
@@ -52,7 +57,9 @@
 #include "olp/core/logging/Log.h"
 #include "olp/core/porting/make_unique.h"
 #include "olp/core/porting/platform.h"
+#include "olp/core/thread/Priority.h"
 #include "olp/core/utils/Dir.h"
+#include "olp/core/utils/WarningWorkarounds.h"
 
 namespace olp {
 namespace http {
@@ -61,9 +68,11 @@ namespace {
 
 const char* kLogTag = "CURL";
 constexpr std::chrono::seconds kHandleLostTimeout(30);
-constexpr std::chrono::seconds kHandleReuseTimeout(120);
+#ifdef OLP_SDK_NETWORK_HAS_EPOLL
+constexpr int kMaxEpollEvents = 256;
+#endif
 
-std::vector<std::pair<std::string, std::string> > GetStatistics(
+std::vector<std::pair<std::string, std::string> > GetTransferStatistics(
     CURL* handle, std::size_t retryCount) {
   std::vector<std::pair<std::string, std::string> > statistics;
   double time;
@@ -220,13 +229,21 @@ static curl_code SslctxFunction(CURL* curl, void* sslctx, void*) {
 
 }  // anonymous namespace
 
-NetworkCurl::NetworkCurl(size_t max_requests_count)
-    : handles_(max_requests_count),
+NetworkCurl::NetworkCurl(NetworkInitializationSettings settings)
+    : handles_(std::max(static_cast<size_t>(1u), settings.max_requests_count)),
       static_handle_count_(
-          std::max(static_cast<size_t>(1u), max_requests_count / 4)) {
+          std::min(handles_.size(), std::max(static_cast<size_t>(1u),
+                                             settings.min_requests_count))),
+      max_pending_requests_(settings.max_pending_requests_count),
+      handle_idle_timeout_(settings.handle_idle_timeout),
+      max_host_connections_(settings.max_connections_per_host),
+      max_streams_(settings.max_streams_per_connection) {
   OLP_SDK_LOG_TRACE(kLogTag, "Created NetworkCurl with address="
-                                 << this
-                                 << ", handles_count=" << max_requests_count);
+                                 << this << ", handles_count="
+                                 << handles_.size() << ", static_handles_count="
+                                 << static_handle_count_
+                                 << ", max_pending_requests="
+                                 << max_pending_requests_);
 }
 
 NetworkCurl::~NetworkCurl() {
@@ -247,7 +264,26 @@ bool NetworkCurl::Initialize() {
     return true;
   }
 
-#ifdef OLP_SDK_NETWORK_HAS_PIPE2
+#if defined OLP_SDK_NETWORK_HAS_EPOLL
+  event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.fd = event_fd_;
+  if (event_fd_ < 0 || epoll_fd_ < 0 ||
+      epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, event_fd_, &event) != 0) {
+    OLP_SDK_LOG_ERROR(kLogTag, "epoll setup failed, err=" << errno
+                                                          << ", this=" << this);
+    if (event_fd_ >= 0) {
+      close(event_fd_);
+    }
+    if (epoll_fd_ >= 0) {
+      close(epoll_fd_);
+    }
+    event_fd_ = epoll_fd_ = -1;
+    return false;
+  }
+#elif defined OLP_SDK_NETWORK_HAS_PIPE2
   if (pipe2(pipe_, O_NONBLOCK)) {
     OLP_SDK_LOG_ERROR(kLogTag, "pipe2 failed, this=" << this);
     return false;
@@ -291,6 +327,33 @@ bool NetworkCurl::Initialize() {
     return false;
   }
 
+#if LIBCURL_VERSION_NUM >= 0x072B00
+  // Multiplex the HTTP/2 requests over one connection (since Curl 7.43.0)
+  curl_multi_setopt(curl_, CURLMOPT_PIPELINING, GetPipeliningMode());
+#endif
+
+#if LIBCURL_VERSION_NUM >= 0x071E00
+  // Since Curl 7.30.0
+  curl_multi_setopt(curl_, CURLMOPT_MAX_HOST_CONNECTIONS,
+                    static_cast<long>(max_host_connections_));
+#endif
+
+#if LIBCURL_VERSION_NUM >= 0x074300
+  // Since Curl 7.67.0
+  curl_multi_setopt(curl_, CURLMOPT_MAX_CONCURRENT_STREAMS,
+                    static_cast<long>(max_streams_));
+#endif
+
+#ifdef OLP_SDK_NETWORK_HAS_EPOLL
+  // Let CURL tell which sockets to watch, see WaitAndPerform()
+  curl_multi_setopt(curl_, CURLMOPT_SOCKETFUNCTION,
+                    &NetworkCurl::SocketFunction);
+  curl_multi_setopt(curl_, CURLMOPT_SOCKETDATA, this);
+  curl_multi_setopt(curl_, CURLMOPT_TIMERFUNCTION, &NetworkCurl::TimerFunction);
+  curl_multi_setopt(curl_, CURLMOPT_TIMERDATA, this);
+  timer_set_ = false;
+#endif
+
   // handles setup
   std::shared_ptr<NetworkCurl> that = shared_from_this();
   for (int i = 0; i < handles_.size(); ++i) {
@@ -304,6 +367,10 @@ bool NetworkCurl::Initialize() {
     handles_[i].in_use = false;
     handles_[i].self = that;
   }
+  {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    statistics_.open_handles = static_handle_count_;
+  }
 
   // start worker thread
   thread_ = std::thread(&NetworkCurl::Run, this);
@@ -327,6 +394,15 @@ void NetworkCurl::Deinitialize() {
     std::lock_guard<std::mutex> lock(event_mutex_);
     state_ = WorkerState::STOPPING;
     event_condition_.notify_one();
+#ifdef OLP_SDK_NETWORK_HAS_EPOLL
+    // Wake up epoll_wait(). The worker thread can not close event_fd_ before
+    // the lock is released.
+    const std::uint64_t value = 1;
+    if (write(event_fd_, &value, sizeof(value)) < 0) {
+      OLP_SDK_LOG_INFO(kLogTag, "Deinitialize, failed to write eventfd, err="
+                                    << errno << ", this=" << this);
+    }
+#endif
   }
 
   std::lock_guard<std::mutex> init_lock(init_mutex_);
@@ -338,7 +414,8 @@ void NetworkCurl::Deinitialize() {
 }
 
 void NetworkCurl::Teardown() {
-#if (defined OLP_SDK_NETWORK_HAS_PIPE) || (defined OLP_SDK_NETWORK_HAS_PIPE2)
+#if !(defined OLP_SDK_NETWORK_HAS_EPOLL) && \
+    ((defined OLP_SDK_NETWORK_HAS_PIPE) || (defined OLP_SDK_NETWORK_HAS_PIPE2))
   char tmp = 1;
   if (write(pipe_[1], &tmp, 1) < 0) {
     OLP_SDK_LOG_INFO(kLogTag, "Deinitialize, failed to write pipe, err="
@@ -348,10 +425,18 @@ void NetworkCurl::Teardown() {
 
   // handles teardown
   std::vector<std::pair<RequestId, Network::Callback> > completed_messages;
+  std::vector<PendingRequest> cancelled_requests;
   {
     std::lock_guard<std::mutex> lock(event_mutex_);
     events_.clear();
 
+    for (auto& pending : pending_requests_) {
+      completed_messages.emplace_back(pending.second.id,
+                                      std::move(pending.second.callback));
+    }
+    pending_requests_.clear();
+    cancelled_requests.swap(cancelled_requests_);
+
     for (auto& handle : handles_) {
       if (handle.handle) {
         if (handle.in_use) {
@@ -377,11 +462,29 @@ void NetworkCurl::Teardown() {
   ssl_mutexes_.reset();
 #endif
 
-#if (defined OLP_SDK_NETWORK_HAS_PIPE) || (defined OLP_SDK_NETWORK_HAS_PIPE2)
+#if defined OLP_SDK_NETWORK_HAS_EPOLL
+  close(epoll_fd_);
+  close(event_fd_);
+  epoll_fd_ = event_fd_ = -1;
+#elif (defined OLP_SDK_NETWORK_HAS_PIPE) || (defined OLP_SDK_NETWORK_HAS_PIPE2)
   close(pipe_[0]);
   close(pipe_[1]);
 #endif
 
+  {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    statistics_.pending_requests = 0u;
+    statistics_.open_handles = 0u;
+  }
+
+  for (auto& request : cancelled_requests) {
+    request.callback(
+        http::NetworkResponse()
+            .WithRequestId(request.id)
+            .WithStatus(static_cast<int>(ErrorCode::CANCELLED_ERROR))
+            .WithError("Cancelled"));
+  }
+
   // Handle completed messages
   if (!completed_messages.empty()) {
     for (auto& pair : completed_messages) {
@@ -464,13 +567,39 @@ ErrorCode NetworkCurl::SendImplementation(
     return ErrorCode::IO_ERROR;
   }
 
-  const auto& config = request.GetSettings();
+  RequestHandle* handle = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(event_mutex_);
+    // The queued requests are sent first, so the new request does not
+    // overtake them even if a handle has just been released.
+    if (pending_requests_.empty()) {
+      handle = GetHandle(id, callback, header_callback, data_callback, payload,
+                         request.GetBody());
+    }
+    if (!handle) {
+      if (!EnqueuePendingRequest(PendingRequest(
+              request, id, payload, std::move(callback),
+              std::move(header_callback), std::move(data_callback)))) {
+        return ErrorCode::NETWORK_OVERLOAD_ERROR;
+      }
+      OLP_SDK_LOG_DEBUG(kLogTag, "Queued request with url="
+                                     << request.GetUrl() << ", id=" << id
+                                     << ", priority=" << request.GetPriority());
+      return ErrorCode::SUCCESS;
+    }
+  }
 
-  RequestHandle* handle = GetHandle(id, callback, header_callback,
-                                    data_callback, payload, request.GetBody());
-  if (!handle) {
-    return ErrorCode::NETWORK_OVERLOAD_ERROR;
+  const auto error = SetupHandle(request, handle);
+  if (error != ErrorCode::SUCCESS) {
+    ReleaseHandle(handle);
   }
+  return error;
+}
+
+ErrorCode NetworkCurl::SetupHandle(const NetworkRequest& request,
+                                   RequestHandle* handle) {
+  const auto& config = request.GetSettings();
+  const auto id = handle->id;
 
   OLP_SDK_LOG_DEBUG(kLogTag, "Send request with url=" << request.GetUrl()
                                                       << ", id=" << id);
@@ -619,6 +748,16 @@ ErrorCode NetworkCurl::SendImplementation(
   curl_easy_setopt(handle->handle, CURLOPT_TCP_KEEPINTVL, 60L);
 #endif
 
+#if LIBCURL_VERSION_NUM >= 0x072F00
+  // Negotiate HTTP/2 for HTTPS only (since Curl 7.47.0), and wait for
+  // a stream on an open connection instead of opening a new one.
+  curl_easy_setopt(handle->handle, CURLOPT_HTTP_VERSION,
+                   GetHttpVersion(config));
+  if (config.GetHttp2Multiplexing()) {
+    curl_easy_setopt(handle->handle, CURLOPT_PIPEWAIT, 1L);
+  }
+#endif
+
   {
     std::lock_guard<std::mutex> lock(event_mutex_);
     AddEvent(EventInfo::Type::SEND_EVENT, handle);
@@ -641,24 +780,146 @@ void NetworkCurl::Cancel(RequestId id) {
       return;
     }
   }
+  for (auto it = pending_requests_.begin(); it != pending_requests_.end();
+       ++it) {
+    if (it->second.id == id) {
+      cancelled_requests_.push_back(std::move(it->second));
+      pending_requests_.erase(it);
+      {
+        std::lock_guard<std::mutex> statistics_lock(statistics_mutex_);
+        statistics_.pending_requests = pending_requests_.size();
+      }
+      NotifyWorker();
+
+      OLP_SDK_LOG_TRACE(kLogTag, "Cancel pending request with id=" << id);
+      return;
+    }
+  }
   OLP_SDK_LOG_WARNING(kLogTag, "Cancel non-existing request with id=" << id);
 }
 
+NetworkStatistics NetworkCurl::GetStatistics() const {
+  std::lock_guard<std::mutex> lock(statistics_mutex_);
+  return statistics_;
+}
+
+long NetworkCurl::GetPipeliningMode() {
+#if LIBCURL_VERSION_NUM >= 0x072B00
+  return CURLPIPE_MULTIPLEX;
+#else
+  return 0L;
+#endif
+}
+
+long NetworkCurl::GetHttpVersion(const NetworkSettings& settings) {
+#if LIBCURL_VERSION_NUM >= 0x072F00
+  if (settings.GetHttp2Multiplexing()) {
+    return CURL_HTTP_VERSION_2TLS;
+  }
+#else
+  CORE_UNUSED(settings);
+#endif
+  return CURL_HTTP_VERSION_1_1;
+}
+
 void NetworkCurl::AddEvent(EventInfo::Type type, RequestHandle* handle) {
   events_.emplace_back(type, handle);
+  NotifyWorker();
+}
+
+void NetworkCurl::NotifyWorker() {
   event_condition_.notify_all();
-#if (defined OLP_SDK_NETWORK_HAS_PIPE) || (defined OLP_SDK_NETWORK_HAS_PIPE2)
+#if defined OLP_SDK_NETWORK_HAS_EPOLL
+  const std::uint64_t value = 1;
+  if (write(event_fd_, &value, sizeof(value)) < 0) {
+    OLP_SDK_LOG_INFO(kLogTag, "NotifyWorker - failed, err=" << errno);
+  }
+#elif (defined OLP_SDK_NETWORK_HAS_PIPE) || (defined OLP_SDK_NETWORK_HAS_PIPE2)
   char tmp = 1;
   if (write(pipe_[1], &tmp, 1) < 0) {
-    OLP_SDK_LOG_INFO(kLogTag, "AddEvent - failed for id=" << handle->id
-                                                          << ", err=" << errno);
+    OLP_SDK_LOG_INFO(kLogTag, "NotifyWorker - failed, err=" << errno);
   }
 #else
-  OLP_SDK_LOG_WARNING(kLogTag, "AddEvent for id=" << handle->id
-                                                  << " - no pipe");
+  OLP_SDK_LOG_WARNING(kLogTag, "NotifyWorker - no pipe");
 #endif
 }
 
+bool NetworkCurl::EnqueuePendingRequest(PendingRequest request) {
+  std::lock_guard<std::mutex> lock(statistics_mutex_);
+  if (pending_requests_.size() >= max_pending_requests_) {
+    ++statistics_.requests_rejected;
+    OLP_SDK_LOG_DEBUG(kLogTag, "Send failed - all CURL handles are busy and "
+                               "the pending queue is full, id="
+                                   << request.id);
+    return false;
+  }
+
+  const auto order = thread::AgedEnqueueTime(request.enqueue_time,
+                                             request.request.GetPriority());
+  pending_requests_.emplace(order, std::move(request));
+  ++statistics_.requests_queued;
+  statistics_.pending_requests = pending_requests_.size();
+  statistics_.peak_pending_requests = std::max<std::uint64_t>(
+      statistics_.peak_pending_requests, pending_requests_.size());
+  return true;
+}
+
+void NetworkCurl::SendPendingRequests() {
+  std::vector<std::pair<RequestHandle*, NetworkRequest> > requests;
+  std::vector<PendingRequest> cancelled_requests;
+  {
+    std::lock_guard<std::mutex> lock(event_mutex_);
+    cancelled_requests.swap(cancelled_requests_);
+
+    const auto now = std::chrono::steady_clock::now();
+    while (!pending_requests_.empty()) {
+      auto& pending = pending_requests_.begin()->second;
+      RequestHandle* handle =
+          GetHandle(pending.id, pending.callback, pending.header_callback,
+                    pending.data_callback, pending.payload,
+                    pending.request.GetBody());
+      if (!handle) {
+        break;
+      }
+
+      const auto wait_time = std::chrono::duration_cast<
+          std::chrono::microseconds>(now - pending.enqueue_time);
+      requests.emplace_back(handle, std::move(pending.request));
+      pending_requests_.erase(pending_requests_.begin());
+
+      std::lock_guard<std::mutex> statistics_lock(statistics_mutex_);
+      statistics_.pending_requests = pending_requests_.size();
+      statistics_.total_queue_wait_time += wait_time;
+      statistics_.max_queue_wait_time =
+          std::max(statistics_.max_queue_wait_time, wait_time);
+    }
+  }
+
+  for (auto& request : cancelled_requests) {
+    request.callback(
+        NetworkResponse()
+            .WithRequestId(request.id)
+            .WithStatus(static_cast<int>(ErrorCode::CANCELLED_ERROR))
+            .WithError("Cancelled"));
+  }
+
+  for (auto& request : requests) {
+    RequestHandle* handle = request.first;
+    const auto error = SetupHandle(request.second, handle);
+    if (error == ErrorCode::SUCCESS) {
+      continue;
+    }
+
+    auto callback = handle->callback;
+    const auto id = handle->id;
+    ReleaseHandle(handle);
+    callback(NetworkResponse()
+                 .WithRequestId(id)
+                 .WithStatus(static_cast<int>(error))
+                 .WithError("Failed to send the pending request"));
+  }
+}
+
 NetworkCurl::RequestHandle* NetworkCurl::GetHandle(
     RequestId id, Network::Callback callback,
     Network::HeaderCallback header_callback,
@@ -669,7 +930,6 @@ NetworkCurl::RequestHandle* NetworkCurl::GetHandle(
                       "GetHandle failed - network is offline, id=" << id);
     return nullptr;
   }
-  std::lock_guard<std::mutex> lock(event_mutex_);
   for (auto& handle : handles_) {
     if (!handle.in_use) {
       if (!handle.handle) {
@@ -752,11 +1012,12 @@ size_t NetworkCurl::RxFunction(void* ptr, size_t size, size_t nmemb,
   }
 
   if (that->IsStarted() && !handle->range_out && !handle->cancelled) {
-    if (handle->data_callback) {
+    // The data callback receives only the successful body, the error body
+    // goes to the payload.
+    if (handle->data_callback && status >= 200 && status < 300) {
       handle->data_callback(reinterpret_cast<uint8_t*>(ptr),
                             handle->offset + handle->count, len);
-    }
-    if (handle->payload) {
+    } else if (handle->payload) {
       if (!handle->ignore_offset) {
         if (handle->payload->tellp() != std::streampos(handle->count)) {
           handle->payload->seekp(handle->count);
@@ -867,8 +1128,8 @@ void NetworkCurl::CompleteMessage(CURL* handle, CURLcode result) {
   std::vector<std::pair<std::string, std::string> > statistics;
   if (index < handles_.size()) {
     if (handles_[index].get_statistics) {
-      statistics =
-          GetStatistics(handles_[index].handle, handles_[index].retry_count);
+      statistics = GetTransferStatistics(handles_[index].handle,
+                                         handles_[index].retry_count);
     }
     if (handles_[index].cancelled) {
       auto callback = handles_[index].callback;
@@ -950,6 +1211,8 @@ void NetworkCurl::CompleteMessage(CURL* handle, CURLcode result) {
                                    << handles_[index].id << ", url=" << url
                                    << ", status=(" << status << ") " << error);
 
+    UpdateStatistics(handles_[index].handle, result);
+
     auto response = NetworkResponse()
                         .WithRequestId(handles_[index].id)
                         .WithStatus(status)
@@ -961,6 +1224,28 @@ void NetworkCurl::CompleteMessage(CURL* handle, CURLcode result) {
   }
 }
 
+void NetworkCurl::UpdateStatistics(CURL* handle, CURLcode result) {
+  long connects = 0;
+  curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+  long http_version = 0;
+#if LIBCURL_VERSION_NUM >= 0x073200
+  // Since Curl 7.50.0
+  curl_easy_getinfo(handle, CURLINFO_HTTP_VERSION, &http_version);
+#endif
+
+  std::lock_guard<std::mutex> lock(statistics_mutex_);
+  ++statistics_.requests_completed;
+  statistics_.connections_opened += static_cast<std::uint64_t>(connects);
+  if (result == CURLE_OK && connects == 0) {
+    ++statistics_.connections_reused;
+  }
+#if LIBCURL_VERSION_NUM >= 0x073200
+  if (http_version == CURL_HTTP_VERSION_2_0) {
+    ++statistics_.http2_requests;
+  }
+#endif
+}
+
 int NetworkCurl::GetHandleIndex(CURL* handle) {
   for (int index = 0; index < handles_.size(); index++) {
     if (handles_[index].in_use && (handles_[index].handle == handle)) {
@@ -970,6 +1255,141 @@ int NetworkCurl::GetHandleIndex(CURL* handle) {
   return -1;
 }
 
+bool NetworkCurl::HandleCompletedMessages() {
+  int left;
+  bool completed = false;
+  CURLMsg* msg(nullptr);
+
+  std::unique_lock<std::mutex> lock(event_mutex_);
+  while (IsStarted() && (msg = curl_multi_info_read(curl_, &left))) {
+    CURL* handle = msg->easy_handle;
+    if (msg->msg == CURLMSG_DONE) {
+      completed = true;
+      CURLcode result = msg->data.result;
+      curl_multi_remove_handle(curl_, msg->easy_handle);
+      lock.unlock();
+      CompleteMessage(handle, result);
+      lock.lock();
+    } else {
+      OLP_SDK_LOG_ERROR(kLogTag, "Message complete with unknown state "
+                                     << msg->msg);
+      int handle_index = GetHandleIndex(handle);
+      if (handle_index >= 0) {
+        if (!handles_[handle_index].callback) {
+          OLP_SDK_LOG_WARNING(
+              kLogTag,
+              "Complete to request with unknown state without "
+              "callback");
+        } else {
+          lock.unlock();
+          auto response =
+              NetworkResponse()
+                  .WithRequestId(handles_[handle_index].id)
+                  .WithStatus(static_cast<int>(ErrorCode::IO_ERROR))
+                  .WithError("CURL error");
+          handles_[handle_index].callback(response);
+          lock.lock();
+        }
+        curl_multi_remove_handle(curl_, handles_[handle_index].handle);
+      } else {
+        OLP_SDK_LOG_ERROR(
+            kLogTag,
+            "No handle index of message complete with unknown state");
+      }
+    }
+  }
+
+  return completed;
+}
+
+#ifdef OLP_SDK_NETWORK_HAS_EPOLL
+int NetworkCurl::SocketFunction(CURL*, curl_socket_t socket, int what,
+                                void* user_data, void*) {
+  auto* that = static_cast<NetworkCurl*>(user_data);
+  if (what == CURL_POLL_REMOVE) {
+    // The socket may be already closed, so the error is ignored.
+    epoll_ctl(that->epoll_fd_, EPOLL_CTL_DEL, socket, nullptr);
+    return 0;
+  }
+
+  epoll_event event{};
+  event.data.fd = socket;
+  if (what == CURL_POLL_IN || what == CURL_POLL_INOUT) {
+    event.events |= EPOLLIN;
+  }
+  if (what == CURL_POLL_OUT || what == CURL_POLL_INOUT) {
+    event.events |= EPOLLOUT;
+  }
+  if (epoll_ctl(that->epoll_fd_, EPOLL_CTL_MOD, socket, &event) != 0 &&
+      (errno != ENOENT ||
+       epoll_ctl(that->epoll_fd_, EPOLL_CTL_ADD, socket, &event) != 0)) {
+    OLP_SDK_LOG_ERROR(kLogTag, "epoll_ctl failed, socket="
+                                   << socket << ", err=" << errno);
+    return -1;
+  }
+  return 0;
+}
+
+int NetworkCurl::TimerFunction(CURLM*, long timeout_ms, void* user_data) {
+  auto* that = static_cast<NetworkCurl*>(user_data);
+  that->timer_set_ = timeout_ms >= 0;
+  if (that->timer_set_) {
+    that->timer_deadline_ = std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds(timeout_ms);
+  }
+  return 0;
+}
+
+void NetworkCurl::WaitAndPerform() {
+  // Limit wait time to 1s so that the idle handles are released in
+  // reasonable time.
+  auto timeout = std::chrono::milliseconds(1000);
+  if (timer_set_) {
+    const auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            timer_deadline_ - std::chrono::steady_clock::now());
+    timeout = std::max(std::chrono::milliseconds(0),
+                       std::min(timeout, remaining));
+  }
+
+  epoll_event events[kMaxEpollEvents];
+  const int count = epoll_wait(epoll_fd_, events, kMaxEpollEvents,
+                               static_cast<int>(timeout.count()));
+  if (count < 0 && errno != EINTR) {
+    OLP_SDK_LOG_ERROR(kLogTag, "epoll_wait failed, err=" << errno);
+  }
+
+  int running = 0;
+  for (int i = 0; i < count && IsStarted(); ++i) {
+    const auto& event = events[i];
+    if (event.data.fd == event_fd_) {
+      std::uint64_t value;
+      while (read(event_fd_, &value, sizeof(value)) > 0) {
+      }
+      continue;
+    }
+
+    int action = 0;
+    if (event.events & EPOLLIN) {
+      action |= CURL_CSELECT_IN;
+    }
+    if (event.events & EPOLLOUT) {
+      action |= CURL_CSELECT_OUT;
+    }
+    if (event.events & (EPOLLERR | EPOLLHUP)) {
+      action |= CURL_CSELECT_ERR;
+    }
+    curl_multi_socket_action(curl_, event.data.fd, action, &running);
+  }
+
+  if (IsStarted() && timer_set_ &&
+      timer_deadline_ <= std::chrono::steady_clock::now()) {
+    timer_set_ = false;
+    curl_multi_socket_action(curl_, CURL_SOCKET_TIMEOUT, 0, &running);
+  }
+}
+#endif  // OLP_SDK_NETWORK_HAS_EPOLL
+
 void NetworkCurl::Run() {
   {
     std::lock_guard<std::mutex> lock(event_mutex_);
@@ -978,6 +1398,8 @@ void NetworkCurl::Run() {
   }
 
   while (IsStarted()) {
+    SendPendingRequests();
+
     std::vector<CURL*> msgs;
     {
       std::lock_guard<std::mutex> lock(event_mutex_);
@@ -1020,6 +1442,10 @@ void NetworkCurl::Run() {
       }
     }
 
+#ifdef OLP_SDK_NETWORK_HAS_EPOLL
+    WaitAndPerform();
+    HandleCompletedMessages();
+#else
     // Run cURL queue
     int running = 0;
     {
@@ -1029,50 +1455,7 @@ void NetworkCurl::Run() {
     }
 
     // Handle completed messages
-    int left;
-    bool completed = false;
-    CURLMsg* msg(nullptr);
-    {
-      std::unique_lock<std::mutex> lock(event_mutex_);
-      while (IsStarted() && (msg = curl_multi_info_read(curl_, &left))) {
-        CURL* handle = msg->easy_handle;
-        if (msg->msg == CURLMSG_DONE) {
-          completed = true;
-          CURLcode result = msg->data.result;
-          curl_multi_remove_handle(curl_, msg->easy_handle);
-          lock.unlock();
-          CompleteMessage(handle, result);
-          lock.lock();
-        } else {
-          OLP_SDK_LOG_ERROR(kLogTag, "Message complete with unknown state "
-                                         << msg->msg);
-          int handle_index = GetHandleIndex(handle);
-          if (handle_index >= 0) {
-            if (!handles_[handle_index].callback) {
-              OLP_SDK_LOG_WARNING(
-                  kLogTag,
-                  "Complete to request with unknown state without "
-                  "callback");
-            } else {
-              lock.unlock();
-              auto response =
-                  NetworkResponse()
-                      .WithRequestId(handles_[handle_index].id)
-                      .WithStatus(static_cast<int>(ErrorCode::IO_ERROR))
-                      .WithError("CURL error");
-              handles_[handle_index].callback(response);
-              lock.lock();
-            }
-            curl_multi_remove_handle(curl_, handles_[handle_index].handle);
-          } else {
-            OLP_SDK_LOG_ERROR(
-                kLogTag,
-                "No handle index of message complete with unknown state");
-          }
-        }
-      }
-    }
-
+    const bool completed = HandleCompletedMessages();
     if (!IsStarted() || completed) {
       continue;
     }
@@ -1227,6 +1610,7 @@ void NetworkCurl::Run() {
       }
 #endif
     }
+#endif  // OLP_SDK_NETWORK_HAS_EPOLL
 
     auto now = std::chrono::steady_clock::now();
     long usable_handles = static_handle_count_;
@@ -1234,7 +1618,7 @@ void NetworkCurl::Run() {
     for (int i = static_handle_count_; i < handles_.size(); ++i) {
       auto& handle = handles_[i];
       if (handle.handle && !handle.in_use &&
-          handle.send_time + kHandleReuseTimeout < now) {
+          handle.send_time + handle_idle_timeout_ < now) {
         curl_easy_cleanup(handle.handle);
         handle.handle = nullptr;
       }
@@ -1245,6 +1629,10 @@ void NetworkCurl::Run() {
     // Make CURL close only those idle connections that we no longer plan to
     // reuse
     curl_multi_setopt(curl_, CURLMOPT_MAXCONNECTS, usable_handles);
+    {
+      std::lock_guard<std::mutex> statistics_lock(statistics_mutex_);
+      statistics_.open_handles = usable_handles;
+    }
   }  // end of the main loop
   Teardown();
   {
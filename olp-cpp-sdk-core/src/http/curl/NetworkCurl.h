@@ -29,10 +29,12 @@
 #include <cstddef>
 #include <cstdint>
 #include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 #ifdef OLP_SDK_NETWORK_HAS_OPENSSL
 #include <openssl/crypto.h>
 #endif
@@ -48,8 +50,10 @@ class NetworkCurl : public olp::http::Network,
  public:
   /**
    * @brief NetworkCurl constructor.
+   * @param[in] settings The handles pool, the pending requests queue and
+   * the connection limits.
    */
-  explicit NetworkCurl(size_t max_requests_count);
+  explicit NetworkCurl(NetworkInitializationSettings settings);
 
   /**
    * @brief ~NetworkCurl destructor.
@@ -88,6 +92,29 @@ class NetworkCurl : public olp::http::Network,
    */
   void Cancel(RequestId id) override;
 
+  /**
+   * @brief Implementation of GetStatistics method from Network abstract class.
+   */
+  NetworkStatistics GetStatistics() const override;
+
+  /**
+   * @brief Gets the pipelining mode set on the multi handle.
+   *
+   * @return `CURLPIPE_MULTIPLEX` if cURL supports HTTP/2 multiplexing, 0
+   * otherwise.
+   */
+  static long GetPipeliningMode();
+
+  /**
+   * @brief Gets the HTTP version set on the easy handle of a request.
+   *
+   * @param[in] settings The settings of the request.
+   *
+   * @return `CURL_HTTP_VERSION_2TLS` if HTTP/2 multiplexing is enabled and
+   * supported by cURL, `CURL_HTTP_VERSION_1_1` otherwise.
+   */
+  static long GetHttpVersion(const NetworkSettings& settings);
+
  private:
   /**
    * @brief Context of each individual network request.
@@ -147,6 +174,55 @@ class NetworkCurl : public olp::http::Network,
     RequestHandle* handle{};
   };
 
+  /**
+   * @brief The request that waits in the pending queue for a free handle.
+   */
+  struct PendingRequest {
+    /**
+     * @brief PendingRequest constructor.
+     */
+    PendingRequest(NetworkRequest request, RequestId id,
+                   Network::Payload payload, Network::Callback callback,
+                   Network::HeaderCallback header_callback,
+                   Network::DataCallback data_callback)
+        : request(std::move(request)),
+          id(id),
+          payload(std::move(payload)),
+          callback(std::move(callback)),
+          header_callback(std::move(header_callback)),
+          data_callback(std::move(data_callback)),
+          enqueue_time(std::chrono::steady_clock::now()) {}
+
+    /// The request to send.
+    NetworkRequest request;
+
+    /// Unique request id.
+    RequestId id{};
+
+    /// Stream for response body.
+    Network::Payload payload{};
+
+    /// Request's callback.
+    Network::Callback callback{};
+
+    /// Request's header callback.
+    Network::HeaderCallback header_callback{};
+
+    /// Request's data callback.
+    Network::DataCallback data_callback{};
+
+    /// The time when the request was queued.
+    std::chrono::steady_clock::time_point enqueue_time{};
+  };
+
+  /**
+   * @brief The pending requests ordered by the priority aged by the waiting
+   * time, see `olp::thread::AgedEnqueueTime`. The requests with the same
+   * order keep the order they were queued in.
+   */
+  using PendingRequests =
+      std::multimap<std::chrono::steady_clock::time_point, PendingRequest>;
+
   /**
    * @brief Actual routine that sends network request.
    *
@@ -208,7 +284,31 @@ class NetworkCurl : public olp::http::Network,
   int GetHandleIndex(CURL* handle);
 
   /**
-   * @brief Allocate new handle RequestHandle.
+   * @brief Set the request options on the allocated handle.
+   * @param[in] request Network request.
+   * @param[in] handle Request handle.
+   * @return ErrorCode.
+   */
+  ErrorCode SetupHandle(const NetworkRequest& request, RequestHandle* handle);
+
+  /**
+   * @brief Put the request into the pending queue. Must be called with
+   * event_mutex_ locked.
+   * @param[in] request Pending request.
+   * @return @c true if the request is queued, @c false if the queue is full.
+   */
+  bool EnqueuePendingRequest(PendingRequest request);
+
+  /**
+   * @brief Send the pending requests while there are free handles, and
+   * complete the cancelled pending requests. Must be called from the worker
+   * thread only.
+   */
+  void SendPendingRequests();
+
+  /**
+   * @brief Allocate new handle RequestHandle. Must be called with
+   * event_mutex_ locked.
    * @param[in] id Unique request id.
    * @param[in] callback Request's callback.
    * @param[in] header_callback Request's header callback.
@@ -244,6 +344,13 @@ class NetworkCurl : public olp::http::Network,
    */
   void CompleteMessage(CURL* handle, CURLcode result);
 
+  /**
+   * @brief Update the statistics with the completed request.
+   * @param[in] handle CURL handle associated with request.
+   * @param[in] result CURL return code.
+   */
+  void UpdateStatistics(CURL* handle, CURLcode result);
+
   /**
    * @brief CURL read callback.
    */
@@ -256,6 +363,32 @@ class NetworkCurl : public olp::http::Network,
   static size_t HeaderFunction(char* ptr, size_t size, size_t nmemb,
                                RequestHandle* handle);
 
+  /**
+   * @brief Read the messages of the completed transfers from CURL and complete
+   * the associated requests.
+   * @return @c true if any request is completed, @c false otherwise.
+   */
+  bool HandleCompletedMessages();
+
+#ifdef OLP_SDK_NETWORK_HAS_EPOLL
+  /**
+   * @brief Wait for the socket activity, the CURL timeout, or the worker
+   * thread notification, and let CURL handle them.
+   */
+  void WaitAndPerform();
+
+  /**
+   * @brief CURL socket callback, updates the sockets watched by epoll.
+   */
+  static int SocketFunction(CURL* handle, curl_socket_t socket, int what,
+                            void* user_data, void* socket_data);
+
+  /**
+   * @brief CURL timer callback, updates the timeout of the next wait.
+   */
+  static int TimerFunction(CURLM* multi, long timeout_ms, void* user_data);
+#endif
+
   /**
    * @brief The worker thread's main method.
    */
@@ -273,6 +406,11 @@ class NetworkCurl : public olp::http::Network,
    */
   void AddEvent(EventInfo::Type type, RequestHandle* handle);
 
+  /**
+   * @brief Wake up the worker thread.
+   */
+  void NotifyWorker();
+
   /**
    * @brief Checks whether the worker thread is started.
    * @return @c true if the thread is started, @c false otherwise.
@@ -285,6 +423,19 @@ class NetworkCurl : public olp::http::Network,
   /// Number of CURL easy handles that are always opened.
   const size_t static_handle_count_;
 
+  /// Maximum number of requests in pending_requests_.
+  const size_t max_pending_requests_;
+
+  /// The time after which the idle CURL easy handles above
+  /// static_handle_count_ are closed.
+  const std::chrono::seconds handle_idle_timeout_;
+
+  /// The requests that wait for a free handle.
+  PendingRequests pending_requests_{};
+
+  /// The pending requests that are cancelled, but not completed yet.
+  std::vector<PendingRequest> cancelled_requests_{};
+
   /// Condition variable used to notify worker thread on event.
   std::condition_variable event_condition_;
 
@@ -319,6 +470,18 @@ class NetworkCurl : public olp::http::Network,
   /// CURL multi handle. Shared among all network requests.
   CURLM* curl_{nullptr};
 
+  /// Maximum number of connections per host set to curl_, 0 means no limit.
+  const size_t max_host_connections_;
+
+  /// Maximum number of concurrent streams per connection set to curl_.
+  const size_t max_streams_;
+
+  /// Synchronization mutex used to access statistics_.
+  mutable std::mutex statistics_mutex_;
+
+  /// Statistics of the completed requests.
+  NetworkStatistics statistics_{};
+
   /// Turn on and off verbose mode for CURL.
   bool verbose_{false};
 
@@ -328,6 +491,20 @@ class NetworkCurl : public olp::http::Network,
   /// UNIX Pipe used to notify sleeping worker thread during select() call.
   int pipe_[2]{};
 
+#ifdef OLP_SDK_NETWORK_HAS_EPOLL
+  /// The epoll instance that watches the CURL sockets and event_fd_.
+  int epoll_fd_{-1};
+
+  /// The eventfd used to notify the worker thread sleeping in epoll_wait().
+  int event_fd_{-1};
+
+  /// The time when CURL should be called with CURL_SOCKET_TIMEOUT.
+  std::chrono::steady_clock::time_point timer_deadline_{};
+
+  /// Whether CURL requested a timeout, used by the worker thread only.
+  bool timer_set_{false};
+#endif
+
 #ifdef OLP_SDK_NETWORK_HAS_OPENSSL
   /// Mutexes that are used by OpenSSL to synchronize during concurrent
   /// network transfer.
@@ -234,12 +234,13 @@ olp::http::SendOutcome OLPNetworkIOS::Send(
       }
 
       const size_t len = data.length;
-      if (data_callback) {
+      // The data callback receives only the successful body, the error body
+      // goes to the payload.
+      const int status = response_data.status;
+      if (data_callback && status >= 200 && status < 300) {
         data_callback(reinterpret_cast<uint8_t*>(const_cast<void*>(data.bytes)),
                       response_data.offset + response_data.count, len);
-      }
-
-      if (auto payload = strong_task.payload) {
+      } else if (auto payload = strong_task.payload) {
         if (payload->tellp() != std::streampos(response_data.count)) {
           payload->seekp(response_data.count);
           if (payload->fail()) {
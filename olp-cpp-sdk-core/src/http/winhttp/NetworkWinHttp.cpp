@@ -847,14 +847,19 @@ void NetworkWinHttp::RequestCallback(HINTERNET, DWORD_PTR context, DWORD status,
       if (data_len) {
         std::uint64_t total_offset = 0;
 
-        if (handle->data_callback)
+        // The data callback receives only the successful body, the error
+        // body goes to the payload.
+        const int status = handle->result_data->status;
+        const bool to_data_callback =
+            handle->data_callback && status >= 200 && status < 300;
+        if (to_data_callback)
           handle->data_callback((const uint8_t*)data_buffer, total_offset,
                                 data_len);
 
         {
           std::unique_lock<std::recursive_mutex> lock(
               handle->connection_data->self->mutex_);
-          if (handle->payload) {
+          if (handle->payload && !to_data_callback) {
             if (handle->payload->tellp() !=
                 std::streampos(handle->result_data->count)) {
               handle->payload->seekp(handle->result_data->count);
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "DelayedTaskQueue.h"
+
+#include <algorithm>
+
+namespace olp {
+namespace thread {
+
+DelayedTaskQueue::DelayedTaskQueue() : state_(std::make_shared<State>()) {}
+
+DelayedTaskQueue::~DelayedTaskQueue() { Stop(); }
+
+void DelayedTaskQueue::Schedule(CallFuncType&& func,
+                                std::chrono::milliseconds delay) {
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::max(delay, delay.zero());
+
+  auto& state = *state_;
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (state.stop) {
+    return;
+  }
+
+  if (!thread_.joinable()) {
+    thread_ = std::thread(&DelayedTaskQueue::Run, state_);
+  }
+
+  state.tasks.push_back({std::move(func), deadline, state.sequence++});
+  std::push_heap(state.tasks.begin(), state.tasks.end(), IsLater);
+
+  // Only the new earliest deadline changes the time the timer thread wakes
+  // up at.
+  if (state.tasks.front().sequence == state.sequence - 1) {
+    state.condition.notify_one();
+  }
+}
+
+void DelayedTaskQueue::Stop() {
+  std::vector<DelayedTask> tasks;
+  std::thread thread;
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->stop = true;
+    tasks.swap(state_->tasks);
+    thread.swap(thread_);
+  }
+  state_->condition.notify_one();
+
+  if (thread.joinable()) {
+    if (thread.get_id() == std::this_thread::get_id()) {
+      // The timer thread exits after the current task, and keeps the state.
+      thread.detach();
+    } else {
+      thread.join();
+    }
+  }
+
+  // The captured state of the dropped tasks is released without the lock.
+  tasks.clear();
+}
+
+bool DelayedTaskQueue::IsLater(const DelayedTask& lhs,
+                               const DelayedTask& rhs) {
+  return lhs.deadline != rhs.deadline ? lhs.deadline > rhs.deadline
+                                      : lhs.sequence > rhs.sequence;
+}
+
+void DelayedTaskQueue::Run(const std::shared_ptr<State>& state) {
+  std::unique_lock<std::mutex> lock(state->mutex);
+  while (!state->stop) {
+    auto& tasks = state->tasks;
+    if (tasks.empty()) {
+      state->condition.wait(lock);
+      continue;
+    }
+
+    const auto deadline = tasks.front().deadline;
+    if (std::chrono::steady_clock::now() < deadline) {
+      state->condition.wait_until(lock, deadline);
+      continue;
+    }
+
+    std::pop_heap(tasks.begin(), tasks.end(), IsLater);
+    auto task = std::move(tasks.back().function);
+    tasks.pop_back();
+
+    lock.unlock();
+    task();
+    // The captured state is released without the lock.
+    task = nullptr;
+    lock.lock();
+  }
+}
+
+}  // namespace thread
+}  // namespace olp
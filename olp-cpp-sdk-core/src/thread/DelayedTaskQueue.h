@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "olp/core/thread/TaskScheduler.h"
+
+namespace olp {
+namespace thread {
+
+/**
+ * @brief Runs the tasks after the given delays on one timer thread.
+ *
+ * The waiting tasks cost no threads: the timer thread sleeps until the
+ * earliest deadline, so the tasks should be short, for example, enqueue
+ * the real work to a task scheduler or send a network request.
+ */
+class DelayedTaskQueue {
+ public:
+  using CallFuncType = TaskScheduler::CallFuncType;
+
+  /// The timer thread is started by the first `Schedule` call.
+  DelayedTaskQueue();
+  /// Calls `Stop`.
+  ~DelayedTaskQueue();
+
+  DelayedTaskQueue(const DelayedTaskQueue&) = delete;
+  DelayedTaskQueue& operator=(const DelayedTaskQueue&) = delete;
+
+  /// Runs the task on the timer thread after the delay. Does nothing after
+  /// `Stop`.
+  void Schedule(CallFuncType&& func, std::chrono::milliseconds delay);
+
+  /// Stops the timer thread, and destroys the waiting tasks on the calling
+  /// thread without running them, so a task that must complete something
+  /// should do it from the destructor of its captured state. Can be called
+  /// from a task.
+  void Stop();
+
+ private:
+  struct DelayedTask {
+    CallFuncType function;
+    std::chrono::steady_clock::time_point deadline;
+    /// Runs the tasks with the same deadline in the order they were
+    /// scheduled in.
+    std::uint64_t sequence;
+  };
+
+  /// Shared with the timer thread, which is detached if the queue is stopped
+  /// by one of its tasks.
+  struct State {
+    std::mutex mutex;
+    std::condition_variable condition;
+    /// The heap of the tasks, the earliest deadline is at the front.
+    std::vector<DelayedTask> tasks;
+    std::uint64_t sequence{0};
+    bool stop{false};
+  };
+
+  static bool IsLater(const DelayedTask& lhs, const DelayedTask& rhs);
+  static void Run(const std::shared_ptr<State>& state);
+
+  std::shared_ptr<State> state_;
+  std::thread thread_;
+};
+
+}  // namespace thread
+}  // namespace olp
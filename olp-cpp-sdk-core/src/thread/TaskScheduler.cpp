@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "olp/core/thread/TaskScheduler.h"
+
+#include "DelayedTaskQueue.h"
+#include "olp/core/porting/make_unique.h"
+
+namespace olp {
+namespace thread {
+
+TaskScheduler::TaskScheduler() = default;
+
+TaskScheduler::~TaskScheduler() {
+  if (delayed_tasks_) {
+    delayed_tasks_->Stop();
+  }
+}
+
+void TaskScheduler::EnqueueDelayedTask(CallFuncType&& func,
+                                       std::chrono::milliseconds delay,
+                                       std::uint32_t priority) {
+  CORE_UNUSED(priority);
+  std::unique_lock<std::mutex> lock(delayed_tasks_mutex_);
+  if (!delayed_tasks_) {
+    delayed_tasks_ = std::make_unique<DelayedTaskQueue>();
+  }
+  auto& delayed_tasks = *delayed_tasks_;
+  lock.unlock();
+  delayed_tasks.Schedule(std::move(func), delay);
+}
+
+}  // namespace thread
+}  // namespace olp
@@ -29,9 +29,12 @@
 #endif
 #include <pthread.h>
 #endif
+#include <algorithm>
 #include <string>
 
+#include "DelayedTaskQueue.h"
 #include "olp/core/logging/Log.h"
+#include "olp/core/porting/make_unique.h"
 #include "olp/core/porting/platform.h"
 #include "olp/core/utils/WarningWorkarounds.h"
 
@@ -65,7 +68,39 @@ void SetCurrentThreadName(const std::string& thread_name) {
 
 }  // namespace
 
-ThreadPoolTaskScheduler::ThreadPoolTaskScheduler(size_t thread_count) {
+bool ThreadPoolTaskScheduler::PriorityQueue::IsLater(
+    const PrioritizedTask& lhs, const PrioritizedTask& rhs) {
+  return lhs.order != rhs.order ? lhs.order > rhs.order
+                                : lhs.sequence > rhs.sequence;
+}
+
+bool ThreadPoolTaskScheduler::PriorityQueue::empty() const {
+  return heap_.empty();
+}
+
+void ThreadPoolTaskScheduler::PriorityQueue::push(PrioritizedTask&& task) {
+  task.sequence = sequence_++;
+  heap_.push_back(std::move(task));
+  std::push_heap(heap_.begin(), heap_.end(), IsLater);
+}
+
+void ThreadPoolTaskScheduler::PriorityQueue::push(
+    const PrioritizedTask& task) {
+  push(PrioritizedTask(task));
+}
+
+ThreadPoolTaskScheduler::PrioritizedTask&
+ThreadPoolTaskScheduler::PriorityQueue::front() {
+  return heap_.front();
+}
+
+void ThreadPoolTaskScheduler::PriorityQueue::pop() {
+  std::pop_heap(heap_.begin(), heap_.end(), IsLater);
+  heap_.pop_back();
+}
+
+ThreadPoolTaskScheduler::ThreadPoolTaskScheduler(size_t thread_count)
+    : delayed_tasks_(std::make_unique<DelayedTaskQueue>()) {
   thread_pool_.reserve(thread_count);
 
   for (size_t idx = 0; idx < thread_count; ++idx) {
@@ -76,9 +111,9 @@ ThreadPoolTaskScheduler::ThreadPoolTaskScheduler(size_t thread_count) {
       OLP_SDK_LOG_INFO_F(kLogTag, "Starting thread '%s'", thread_name.c_str());
 
       for (;;) {
-        TaskScheduler::CallFuncType task;
+        PrioritizedTask task;
         if (!sync_queue_.Pull(task)) return;
-        task();
+        task.function();
       }
     });
 
@@ -87,6 +122,9 @@ ThreadPoolTaskScheduler::ThreadPoolTaskScheduler(size_t thread_count) {
 }
 
 ThreadPoolTaskScheduler::~ThreadPoolTaskScheduler() {
+  // Stop the timer first, so no delayed task is enqueued to the closed queue.
+  // The waiting tasks are destroyed here, before the pool threads stop.
+  delayed_tasks_->Stop();
   sync_queue_.Close();
   for (auto& thread : thread_pool_) {
     thread.join();
@@ -95,7 +133,23 @@ ThreadPoolTaskScheduler::~ThreadPoolTaskScheduler() {
 }
 
 void ThreadPoolTaskScheduler::EnqueueTask(TaskScheduler::CallFuncType&& func) {
-  sync_queue_.Push(std::move(func));
+  EnqueueTask(std::move(func), NORMAL);
+}
+
+void ThreadPoolTaskScheduler::EnqueueTask(TaskScheduler::CallFuncType&& func,
+                                          std::uint32_t priority) {
+  sync_queue_.Push(
+      {std::move(func),
+       AgedEnqueueTime(std::chrono::steady_clock::now(), priority), 0u});
+}
+
+void ThreadPoolTaskScheduler::EnqueueDelayedTask(
+    TaskScheduler::CallFuncType&& func, std::chrono::milliseconds delay,
+    std::uint32_t priority) {
+  auto task = std::make_shared<TaskScheduler::CallFuncType>(std::move(func));
+  delayed_tasks_->Schedule(
+      [this, task, priority]() { EnqueueTask(std::move(*task), priority); },
+      delay);
 }
 
 }  // namespace thread
@@ -19,14 +19,23 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <chrono>
+#include <cstdio>
 #include <fstream>
+#include <future>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include <olp/core/cache/CacheSettings.h>
 #include <olp/core/cache/DefaultCache.h>
+#include <olp/core/cache/KeyEncoder.h>
+#include <olp/core/cache/MappedCacheBuilder.h>
+#include <olp/core/thread/ThreadPoolTaskScheduler.h>
 #include <olp/core/utils/Dir.h>
+#include "DiskCache.h"
+#include "DiskCacheRecord.h"
 
 TEST(DefaultCacheTest, BasicTest) {
   olp::cache::CacheSettings settings;
@@ -277,6 +286,80 @@ TEST(DefaultCacheTest, ProtectedCacheTest) {
   }
 }
 
+TEST(DefaultCacheTest, MappedProtectedCache) {
+  const auto source_path = olp::utils::Dir::TempDirectory() + "/protected";
+  const auto mapped_path =
+      olp::utils::Dir::TempDirectory() + "/protected.mapped";
+  const auto mutable_path = olp::utils::Dir::TempDirectory() + "/unittest";
+  const std::string key1_data_string = "this is key1's data";
+  const auto key2_data = std::make_shared<std::vector<unsigned char>>(
+      1024u, static_cast<unsigned char>(0xab));
+  const auto decoder = [](const std::string& data) { return data; };
+  {
+    SCOPED_TRACE("Setup cache");
+    olp::cache::CacheSettings settings;
+    settings.disk_path_mutable = source_path;
+    olp::cache::DefaultCache cache(settings);
+    ASSERT_EQ(olp::cache::DefaultCache::Success, cache.Open());
+    ASSERT_TRUE(cache.Clear());
+    ASSERT_TRUE(cache.Put("key1", key1_data_string,
+                          [=]() { return key1_data_string; },
+                          (std::numeric_limits<time_t>::max)()));
+    ASSERT_TRUE(cache.Put("key2", key2_data, 3600));
+    cache.Close();
+
+    ASSERT_TRUE(olp::cache::MappedCacheBuilder::ConvertDiskCache(source_path,
+                                                                 mapped_path));
+  }
+  {
+    SCOPED_TRACE("Get from mapped protected");
+    olp::cache::CacheSettings settings;
+    settings.disk_path_protected = mapped_path;
+    settings.disk_path_mutable = mutable_path;
+    settings.max_memory_cache_size = 0;
+    settings.openOptions = olp::cache::CheckCrc;
+    olp::cache::DefaultCache cache(settings);
+    ASSERT_EQ(olp::cache::DefaultCache::Success, cache.Open());
+    ASSERT_TRUE(cache.Clear());
+
+    auto key1_data = cache.Get("key1", decoder);
+    ASSERT_FALSE(key1_data.empty());
+    EXPECT_EQ(key1_data_string, boost::any_cast<std::string>(key1_data));
+
+    auto key2_read = cache.Get("key2");
+    ASSERT_TRUE(key2_read);
+    EXPECT_EQ(*key2_data, *key2_read);
+
+    EXPECT_FALSE(cache.Get("key"));
+    EXPECT_FALSE(cache.Get("key3"));
+
+    auto values = cache.GetBatch({"key3", "key1"}, decoder);
+    ASSERT_EQ(2u, values.size());
+    EXPECT_TRUE(values[0].empty());
+    EXPECT_FALSE(values[1].empty());
+
+    SCOPED_TRACE("Fall-back to mutable");
+    const std::string key3_data_string = "this is key3's data";
+    ASSERT_TRUE(cache.Put("key3", key3_data_string,
+                          [=]() { return key3_data_string; },
+                          (std::numeric_limits<time_t>::max)()));
+    auto key3_data = cache.Get("key3", decoder);
+    ASSERT_FALSE(key3_data.empty());
+    EXPECT_EQ(key3_data_string, boost::any_cast<std::string>(key3_data));
+    ASSERT_TRUE(cache.Clear());
+  }
+  {
+    SCOPED_TRACE("Duplicate keys");
+    olp::cache::MappedCacheBuilder builder(mapped_path + ".duplicate");
+    EXPECT_TRUE(builder.Add("key1", key1_data_string));
+    EXPECT_TRUE(builder.Add("key1", *key2_data));
+    EXPECT_FALSE(builder.Finish());
+  }
+
+  olp::utils::Dir::remove(source_path);
+  std::remove(mapped_path.c_str());
+}
+
 TEST(DefaultCacheTest, ExpiredMemTest) {
   olp::cache::DefaultCache cache;
   ASSERT_EQ(olp::cache::DefaultCache::Success, cache.Open());
@@ -369,4 +452,863 @@ TEST(DefaultCacheTest, ValueGreaterThanMemCacheLimit) {
                          content.begin()));
 
   cache.Close();
-}
\ No newline at end of file
+}
+
+TEST(DefaultCacheTest, ShardedCache) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.shard_count = 4;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/sharded";
+
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  ASSERT_TRUE(cache.Clear());
+
+  const std::string data_string{"this is the data"};
+  const auto decoder = [](const std::string& data) { return data; };
+
+  std::vector<std::thread> threads;
+  for (int thread_id = 0; thread_id < 4; ++thread_id) {
+    threads.emplace_back([&, thread_id]() {
+      for (int i = 0; i < 100; ++i) {
+        const auto key =
+            "key" + std::to_string(thread_id) + "_" + std::to_string(i);
+        EXPECT_TRUE(cache.Put(key, data_string,
+                              [=]() { return data_string; },
+                              (std::numeric_limits<time_t>::max)()));
+        EXPECT_FALSE(cache.Get(key, decoder).empty());
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Prefix removal affects all the shards.
+  ASSERT_TRUE(cache.RemoveKeysWithPrefix("key1_"));
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(cache.Get("key1_" + std::to_string(i), decoder).empty());
+    EXPECT_FALSE(cache.Get("key2_" + std::to_string(i), decoder).empty());
+  }
+
+  ASSERT_TRUE(cache.Clear());
+  EXPECT_TRUE(cache.Get("key2_0", decoder).empty());
+}
+
+TEST(DefaultCacheTest, ConcurrentMemoryReads) {
+  using namespace olp::cache;
+
+  const auto value = std::make_shared<KeyValueCache::ValueType>(10u, 'x');
+  const auto expiry = (std::numeric_limits<time_t>::max)();
+
+  CacheSettings settings;
+  settings.max_memory_cache_size = 10u * value->size();
+  settings.concurrent_memory_reads = true;
+
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+
+  {
+    SCOPED_TRACE("Buffered promotions keep the hot key");
+    ASSERT_TRUE(cache.Put("hot", value, expiry));
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_TRUE(cache.Put("key" + std::to_string(i), value, expiry));
+      for (int read = 0; read < 32; ++read) {
+        ASSERT_NE(nullptr, cache.Get("hot"));
+      }
+    }
+    EXPECT_EQ(nullptr, cache.Get("key0"));
+  }
+
+  {
+    SCOPED_TRACE("Reads in parallel with writes");
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+      for (int i = 0; i < 10000; ++i) {
+        const auto key = "key" + std::to_string(i % 20);
+        EXPECT_TRUE(cache.Put(key, value, i % 2 ? expiry : 100));
+      }
+      done = true;
+    });
+
+    std::vector<std::thread> readers;
+    for (int thread_id = 0; thread_id < 8; ++thread_id) {
+      readers.emplace_back([&, thread_id]() {
+        for (int i = 0; !done; ++i) {
+          auto result = cache.Get("key" + std::to_string((i + thread_id) % 20));
+          if (result) {
+            EXPECT_EQ(*value, *result);
+          }
+        }
+      });
+    }
+
+    writer.join();
+    for (auto& reader : readers) {
+      reader.join();
+    }
+  }
+
+  cache.Close();
+  EXPECT_EQ(nullptr, cache.Get("hot"));
+}
+
+TEST(DefaultCacheTest, BatchPutGet) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.max_memory_cache_size = 0;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/unittest";
+
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  ASSERT_TRUE(cache.Clear());
+
+  KeyValueCache::BatchItems items;
+  for (int i = 0; i < 10; ++i) {
+    const auto data = "data" + std::to_string(i);
+    KeyValueCache::BatchItem item;
+    item.key = "key" + std::to_string(i);
+    item.value = data;
+    item.encoder = [=]() { return data; };
+    // Every odd item is already expired.
+    item.expiry = (i % 2) ? -1 : KeyValueCache::kDefaultExpiry;
+    items.emplace_back(std::move(item));
+  }
+  ASSERT_TRUE(cache.PutBatch(items));
+
+  const std::vector<std::string> keys = {"key0", "key1", "key2", "unknown"};
+  const auto values =
+      cache.GetBatch(keys, [](const std::string& data) { return data; });
+  ASSERT_EQ(keys.size(), values.size());
+  EXPECT_EQ("data0", boost::any_cast<std::string>(values[0]));
+  EXPECT_TRUE(values[1].empty());
+  EXPECT_EQ("data2", boost::any_cast<std::string>(values[2]));
+  EXPECT_TRUE(values[3].empty());
+
+  ASSERT_TRUE(cache.Clear());
+}
+
+TEST(DefaultCacheTest, CompressedValues) {
+  using namespace olp::cache;
+
+  const auto path = olp::utils::Dir::TempDirectory() + "/unittest_compressed";
+  const std::string compressible(10000u, 'x');
+  const std::string small(100u, 'x');
+  const auto decoder = [](const std::string& data) { return data; };
+
+  CacheSettings settings;
+  settings.max_memory_cache_size = 0;
+  settings.disk_path_mutable = path;
+  settings.compression_codec = CompressionCodec::Zlib;
+  settings.compression_threshold = 1000u;
+  {
+    DefaultCache cache(settings);
+    ASSERT_EQ(DefaultCache::Success, cache.Open());
+    ASSERT_TRUE(cache.Clear());
+    ASSERT_TRUE(cache.Put("compressible", compressible,
+                          [&]() { return compressible; },
+                          KeyValueCache::kDefaultExpiry));
+    ASSERT_TRUE(cache.Put("small", small, [&]() { return small; },
+                          KeyValueCache::kDefaultExpiry));
+  }
+
+  {
+    SCOPED_TRACE("Stored records");
+    StorageSettings storage_settings;
+    storage_settings.max_disk_storage = DiskCache::kSizeMax;
+    DiskCache disk_cache;
+    ASSERT_EQ(OpenResult::Success,
+              disk_cache.Open(path, path, storage_settings,
+                              OpenOptions::ReadOnly));
+    const auto record = disk_cache.Get("compressible");
+    ASSERT_TRUE(record);
+    EXPECT_LT(record->size(), compressible.size() / 10u);
+    ASSERT_TRUE(disk_cache.Get("small"));
+    EXPECT_EQ(DiskCacheRecord::kHeaderSize + small.size(),
+              disk_cache.Get("small")->size());
+  }
+
+  {
+    SCOPED_TRACE("Read without compression");
+    settings.compression_codec = CompressionCodec::None;
+    settings.openOptions = CheckCrc;
+    DefaultCache cache(settings);
+    ASSERT_EQ(DefaultCache::Success, cache.Open());
+    EXPECT_EQ(compressible,
+              boost::any_cast<std::string>(cache.Get("compressible", decoder)));
+    EXPECT_EQ(small, boost::any_cast<std::string>(cache.Get("small", decoder)));
+    const auto value = cache.Get("compressible");
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ(compressible, std::string(value->begin(), value->end()));
+    ASSERT_TRUE(cache.Clear());
+  }
+}
+
+TEST(DefaultCacheTest, LegacyExpiryMigration) {
+  using namespace olp::cache;
+
+  const auto path = olp::utils::Dir::TempDirectory() + "/unittest_migration";
+  const auto now = std::chrono::system_clock::to_time_t(
+      std::chrono::system_clock::now());
+  StorageSettings storage_settings;
+  storage_settings.max_disk_storage = DiskCache::kSizeMax;
+  {
+    // Fill the cache the way the older SDK versions did.
+    olp::utils::Dir::remove(path);
+    DiskCache disk_cache;
+    ASSERT_EQ(OpenResult::Success,
+              disk_cache.Open(path, path, storage_settings,
+                              OpenOptions::Default));
+    ASSERT_TRUE(disk_cache.Put("valid", "valid data"));
+    ASSERT_TRUE(disk_cache.Put("valid::expiry", std::to_string(now + 1000)));
+    ASSERT_TRUE(disk_cache.Put("expired", "expired data"));
+    ASSERT_TRUE(disk_cache.Put("expired::expiry", std::to_string(now - 1)));
+    ASSERT_TRUE(disk_cache.Put("no_expiry", "no expiry data"));
+    // Already converted by a migration that was interrupted.
+    ASSERT_TRUE(disk_cache.Put(
+        "migrated", DiskCacheRecord::Encode("migrated data", now + 1000)));
+  }
+
+  CacheSettings settings;
+  settings.max_memory_cache_size = 0;
+  settings.disk_path_mutable = path;
+  {
+    DefaultCache cache(settings);
+    ASSERT_EQ(DefaultCache::Success, cache.Open());
+
+    auto decoder = [](const std::string& data) { return data; };
+    EXPECT_EQ("valid data",
+              boost::any_cast<std::string>(cache.Get("valid", decoder)));
+    EXPECT_TRUE(cache.Get("expired", decoder).empty());
+    EXPECT_EQ("no expiry data",
+              boost::any_cast<std::string>(cache.Get("no_expiry", decoder)));
+    EXPECT_EQ("migrated data",
+              boost::any_cast<std::string>(cache.Get("migrated", decoder)));
+  }
+
+  {
+    // Every item is stored in one record now.
+    DiskCache disk_cache;
+    ASSERT_EQ(OpenResult::Success,
+              disk_cache.Open(path, path, storage_settings,
+                              OpenOptions::Default));
+    EXPECT_FALSE(disk_cache.Get("valid::expiry"));
+    EXPECT_FALSE(disk_cache.Get("expired::expiry"));
+    EXPECT_FALSE(disk_cache.Get("expired"));
+
+    auto record = disk_cache.Get("valid");
+    ASSERT_TRUE(record);
+    time_t expiry = 0;
+    ASSERT_TRUE(DiskCacheRecord::Decode(*record, expiry, true));
+    EXPECT_EQ("valid data", *record);
+    EXPECT_EQ(now + 1000, expiry);
+    EXPECT_TRUE(disk_cache.Clear());
+  }
+}
+
+TEST(DefaultCacheTest, ProtectedCacheLegacyKeys) {
+  using namespace olp::cache;
+
+  const auto path = olp::utils::Dir::TempDirectory() + "/unittest_legacy";
+  const auto mapped_path = path + ".mapped";
+  const std::string hrn = "hrn:here:data::olp-here-test:hereos-internal-test";
+  const KeyEncoder encoder(hrn);
+  const auto decoder = [](const std::string& data) { return data; };
+  {
+    // Fill the cache with the keys of the older SDK versions.
+    olp::utils::Dir::remove(path);
+    StorageSettings storage_settings;
+    storage_settings.max_disk_storage = DiskCache::kSizeMax;
+    DiskCache disk_cache;
+    ASSERT_EQ(OpenResult::Success,
+              disk_cache.Open(path, path, storage_settings,
+                              OpenOptions::Default));
+    ASSERT_TRUE(disk_cache.Put(hrn + "::catalog", "catalog"));
+    ASSERT_TRUE(disk_cache.Put(hrn + "::config::v1::api", "api"));
+    ASSERT_TRUE(disk_cache.Put(hrn + "::layer::269::4::partition", "269"));
+    ASSERT_TRUE(disk_cache.Put(hrn + "::layer::handle::Data", "data"));
+  }
+  ASSERT_TRUE(MappedCacheBuilder::ConvertDiskCache(path, mapped_path));
+
+  for (const auto& protected_path : {path, mapped_path}) {
+    SCOPED_TRACE(protected_path);
+
+    CacheSettings settings;
+    settings.max_memory_cache_size = 0;
+    settings.disk_path_protected = protected_path;
+    DefaultCache cache(settings);
+    ASSERT_EQ(DefaultCache::Success, cache.Open());
+
+    auto catalog = cache.Get(encoder.Catalog(), decoder);
+    ASSERT_FALSE(catalog.empty());
+    EXPECT_EQ("catalog", boost::any_cast<std::string>(catalog));
+
+    auto data = cache.Get(encoder.Data("layer", "handle"));
+    ASSERT_TRUE(data);
+    EXPECT_EQ("data", std::string(data->begin(), data->end()));
+
+    auto values = cache.GetBatch({encoder.Api("config", "v1"),
+                                  encoder.Partition("layer", "269", 4),
+                                  encoder.Partition("layer", "269", 5)},
+                                 decoder);
+    ASSERT_EQ(3u, values.size());
+    ASSERT_FALSE(values[0].empty());
+    EXPECT_EQ("api", boost::any_cast<std::string>(values[0]));
+    ASSERT_FALSE(values[1].empty());
+    EXPECT_EQ("269", boost::any_cast<std::string>(values[1]));
+    EXPECT_TRUE(values[2].empty());
+
+    EXPECT_TRUE(cache.Get(encoder.LatestVersion(), decoder).empty());
+    EXPECT_FALSE(cache.Get(encoder.Data("layer", "other")));
+  }
+
+  olp::utils::Dir::remove(path);
+  std::remove(mapped_path.c_str());
+}
+
+TEST(DefaultCacheTest, DiskCacheMaintenance) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.max_memory_cache_size = 0;
+  settings.max_disk_storage = 40000u;
+  settings.disk_storage_low_water_mark = 25u;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/unittest";
+
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  ASSERT_TRUE(cache.Clear());
+
+  const std::string data(1000u, 'd');
+  auto encoder = [=]() { return data; };
+  auto decoder = [](const std::string& value) { return value; };
+  for (int i = 0; i < 10; ++i) {
+    const auto key = std::to_string(i);
+    ASSERT_TRUE(cache.Put("expired" + key, data, encoder, -1));
+    ASSERT_TRUE(
+        cache.Put("key" + key, data, encoder, KeyValueCache::kDefaultExpiry));
+  }
+
+  // Make the first half of the keys recently used.
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_FALSE(cache.Get("key" + std::to_string(i), decoder).empty());
+  }
+
+  // All the expired values and the least recently used values are evicted
+  // until the cache size is below 10000 bytes.
+  const auto reclaimed = cache.RunMaintenance();
+  EXPECT_GT(reclaimed, 11000u);
+  EXPECT_EQ(reclaimed, cache.GetReclaimedBytes());
+
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_FALSE(cache.Get("key" + std::to_string(i), decoder).empty());
+  }
+  EXPECT_TRUE(cache.Get("key5", decoder).empty());
+  EXPECT_TRUE(cache.Get("expired0", decoder).empty());
+
+  ASSERT_TRUE(cache.Clear());
+}
+
+TEST(DefaultCacheTest, DiskCacheMaintenanceAfterReopen) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.max_memory_cache_size = 0;
+  settings.max_disk_storage = 100000u;
+  settings.disk_storage_low_water_mark = 50u;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/unittest";
+
+  const std::string data(4000u, 'd');
+  auto encoder = [=]() { return data; };
+  auto decoder = [](const std::string& value) { return value; };
+  {
+    DefaultCache cache(settings);
+    ASSERT_EQ(DefaultCache::Success, cache.Open());
+    ASSERT_TRUE(cache.Clear());
+    for (int i = 0; i < 10; ++i) {
+      ASSERT_TRUE(cache.Put("key" + std::to_string(i), data, encoder,
+                            KeyValueCache::kDefaultExpiry));
+    }
+
+    // Make the first half of the keys recently used.
+    for (int i = 0; i < 5; ++i) {
+      ASSERT_FALSE(cache.Get("key" + std::to_string(i), decoder).empty());
+    }
+  }
+
+  // The access order is stored on the disk, so the least recently used values
+  // are evicted after the restart.
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  EXPECT_GT(cache.RunMaintenance(), 0u);
+
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_FALSE(cache.Get("key" + std::to_string(i), decoder).empty());
+  }
+  EXPECT_TRUE(cache.Get("key5", decoder).empty());
+
+  ASSERT_TRUE(cache.Clear());
+}
+
+TEST(DefaultCacheTest, DiskCacheMaintenanceConcurrentReads) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.concurrent_memory_reads = true;
+  settings.max_disk_storage = 100000u;
+  settings.disk_storage_low_water_mark = 50u;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/unittest";
+
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  ASSERT_TRUE(cache.Clear());
+
+  const std::string data(4000u, 'd');
+  auto encoder = [=]() { return data; };
+  auto decoder = [](const std::string& value) { return value; };
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_TRUE(cache.Put("key" + std::to_string(i), data, encoder,
+                          KeyValueCache::kDefaultExpiry));
+  }
+
+  // The memory hits do not take the shard lock, but still make the first half
+  // of the keys recently used on the disk.
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_FALSE(cache.Get("key" + std::to_string(i), decoder).empty());
+  }
+  EXPECT_GT(cache.RunMaintenance(), 0u);
+
+  // Reopen to read the values from the disk.
+  cache.Close();
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_FALSE(cache.Get("key" + std::to_string(i), decoder).empty());
+  }
+  EXPECT_TRUE(cache.Get("key5", decoder).empty());
+
+  ASSERT_TRUE(cache.Clear());
+}
+
+TEST(DefaultCacheTest, DiskCacheBackgroundMaintenance) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.max_memory_cache_size = 0;
+  settings.max_disk_storage = 40000u;
+  settings.disk_storage_low_water_mark = 25u;
+  settings.disk_storage_high_water_mark = 50u;
+  settings.disk_maintenance_interval = 0u;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/unittest";
+  settings.task_scheduler =
+      std::make_shared<olp::thread::ThreadPoolTaskScheduler>(1u);
+
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  ASSERT_TRUE(cache.Clear());
+
+  // The maintenance is scheduled in the background at the high-water mark,
+  // long before the disk is full.
+  const std::string data(1000u, 'd');
+  auto encoder = [=]() { return data; };
+  int index = 0;
+  while (cache.GetReclaimedBytes() == 0u) {
+    ASSERT_TRUE(cache.Put(std::to_string(index), data, encoder,
+                          KeyValueCache::kDefaultExpiry));
+    ASSERT_LT(++index, 35);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  EXPECT_GE(index, 10);
+  ASSERT_TRUE(cache.Clear());
+}
+
+TEST(DefaultCacheTest, DiskCachePeriodicMaintenance) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.max_memory_cache_size = 0;
+  settings.disk_maintenance_interval = 1u;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/unittest";
+  settings.task_scheduler =
+      std::make_shared<olp::thread::ThreadPoolTaskScheduler>(1u);
+
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  ASSERT_TRUE(cache.Clear());
+
+  const std::string data(1000u, 'd');
+  auto encoder = [=]() { return data; };
+  ASSERT_TRUE(cache.Put("expired", data, encoder, -1));
+
+  // The first write after the interval removes the expired values, although
+  // the disk is almost empty.
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  ASSERT_TRUE(cache.Put("new", data, encoder, KeyValueCache::kDefaultExpiry));
+  for (int i = 0; i < 100 && cache.GetReclaimedBytes() == 0u; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  EXPECT_GT(cache.GetReclaimedBytes(), 0u);
+  ASSERT_TRUE(cache.Clear());
+}
+
+TEST(DefaultCacheTest, DiskCacheFullRetry) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.max_memory_cache_size = 0;
+  settings.max_disk_storage = 20000u;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/unittest";
+  settings.enable_statistics = true;
+
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  ASSERT_TRUE(cache.Clear());
+
+  // Without a task scheduler, the writes that find the disk full run
+  // the maintenance and are retried, so none of them is dropped.
+  const std::string data(1000u, 'd');
+  auto encoder = [=]() { return data; };
+  auto decoder = [](const std::string& value) { return value; };
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(cache.Put(std::to_string(i), data, encoder,
+                          KeyValueCache::kDefaultExpiry));
+  }
+  EXPECT_GT(cache.GetReclaimedBytes(), 0u);
+  EXPECT_FALSE(cache.Get("99", decoder).empty());
+  EXPECT_TRUE(cache.Get("0", decoder).empty());
+  EXPECT_EQ(0u, cache.GetStatistics().total.put_failures);
+  ASSERT_TRUE(cache.Clear());
+}
+
+TEST(DefaultCacheTest, WriteBehind) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.max_memory_cache_size = 0;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/unittest";
+  settings.write_behind = true;
+  // Small enough for Put to wait for the writer thread.
+  settings.max_write_behind_queue_size = 4096u;
+
+  const std::string data(1000u, 'd');
+  auto encoder = [=]() { return data; };
+  auto decoder = [](const std::string& value) { return value; };
+  {
+    DefaultCache cache(settings);
+    ASSERT_EQ(DefaultCache::Success, cache.Open());
+    ASSERT_TRUE(cache.Clear());
+
+    // The values are readable while queued, the memory cache is disabled.
+    for (int i = 0; i < 100; ++i) {
+      const auto key = std::to_string(i);
+      ASSERT_TRUE(cache.Put(key, data, encoder, KeyValueCache::kDefaultExpiry));
+      ASSERT_FALSE(cache.Get(key, decoder).empty()) << key;
+    }
+    ASSERT_TRUE(cache.Put("expired", data, encoder, -1));
+    EXPECT_TRUE(cache.Get("expired", decoder).empty());
+
+    ASSERT_TRUE(cache.Remove("0"));
+    EXPECT_TRUE(cache.Get("0", decoder).empty());
+    EXPECT_TRUE(cache.Flush());
+    ASSERT_TRUE(
+        cache.Put("last", data, encoder, KeyValueCache::kDefaultExpiry));
+  }
+
+  // The queued values are written when the cache is destroyed.
+  settings.write_behind = false;
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  for (int i = 1; i < 100; ++i) {
+    EXPECT_FALSE(cache.Get(std::to_string(i), decoder).empty()) << i;
+  }
+  EXPECT_FALSE(cache.Get("last", decoder).empty());
+  EXPECT_TRUE(cache.Get("0", decoder).empty());
+  EXPECT_TRUE(cache.Flush());
+  ASSERT_TRUE(cache.Clear());
+}
+
+TEST(DefaultCacheTest, WriteBehindSaturated) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/unittest";
+  settings.shard_count = 1u;
+  settings.write_behind = true;
+  // Every Put waits for the writer thread.
+  settings.max_write_behind_queue_size = 1u;
+
+  const std::string data(64u * 1024u, 'd');
+  auto encoder = [=]() { return data; };
+  auto decoder = [](const std::string& value) { return value; };
+
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  ASSERT_TRUE(cache.Clear());
+  ASSERT_TRUE(cache.Put("hot", data, encoder, KeyValueCache::kDefaultExpiry));
+  ASSERT_TRUE(
+      cache.Put("removed", data, encoder, KeyValueCache::kDefaultExpiry));
+
+  // The readers and the removals of the shard run while the writers wait for
+  // the queue.
+  std::atomic<bool> writing{true};
+  std::vector<std::thread> writers;
+  for (int writer = 0; writer < 4; ++writer) {
+    writers.emplace_back([&, writer]() {
+      for (int i = 0; i < 50; ++i) {
+        const auto key = std::to_string(writer) + "::" + std::to_string(i);
+        EXPECT_TRUE(
+            cache.Put(key, data, encoder, KeyValueCache::kDefaultExpiry));
+      }
+    });
+  }
+
+  std::atomic<int> reads{0};
+  std::thread reader([&]() {
+    do {
+      EXPECT_FALSE(cache.Get("hot", decoder).empty());
+      EXPECT_TRUE(cache.Remove("removed"));
+      ++reads;
+    } while (writing);
+  });
+
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  writing = false;
+  reader.join();
+
+  EXPECT_GT(reads, 0);
+  EXPECT_TRUE(cache.RemoveKeysWithPrefix("1::"));
+  EXPECT_TRUE(cache.Flush());
+  EXPECT_TRUE(cache.Get("removed", decoder).empty());
+  EXPECT_TRUE(cache.Get("1::49", decoder).empty());
+  EXPECT_FALSE(cache.Get("2::49", decoder).empty());
+  ASSERT_TRUE(cache.Clear());
+}
+
+TEST(DefaultCacheTest, Statistics) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.max_memory_cache_size = 2500u;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/unittest";
+  settings.enable_statistics = true;
+
+  const std::string data(1000u, 'd');
+  auto encoder = [=]() { return data; };
+  auto decoder = [](const std::string& value) { return value; };
+  const std::string data_key = "hrn:here:data::catalog::layer::handle::Data";
+  const std::string api_key = "hrn:here:data::catalog::config::v1::api";
+
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  ASSERT_TRUE(cache.Clear());
+  cache.ResetStatistics();
+
+  ASSERT_TRUE(
+      cache.Put(data_key, data, encoder, KeyValueCache::kDefaultExpiry));
+  ASSERT_TRUE(cache.Put(api_key, data, encoder, KeyValueCache::kDefaultExpiry));
+  // Evicts the data key from the memory cache.
+  ASSERT_TRUE(cache.Put("other", data, encoder, KeyValueCache::kDefaultExpiry));
+
+  EXPECT_FALSE(cache.Get(api_key, decoder).empty());
+  EXPECT_FALSE(cache.Get(data_key, decoder).empty());
+  EXPECT_TRUE(cache.Get("missing", decoder).empty());
+
+  auto statistics = cache.GetStatistics();
+  const auto& data_counters = statistics.Get(CacheKeyNamespace::Data);
+  const auto& api_counters = statistics.Get(CacheKeyNamespace::Api);
+  EXPECT_EQ(1u, api_counters.memory_hits);
+  EXPECT_EQ(1u, data_counters.disk_hits);
+  EXPECT_EQ(1u, data_counters.evictions);
+  EXPECT_GE(data_counters.bytes_read, data.size());
+  EXPECT_GE(data_counters.bytes_written, data.size());
+  EXPECT_EQ(1u, statistics.Get(CacheKeyNamespace::Other).misses);
+  EXPECT_EQ(1u, statistics.total.memory_hits);
+  EXPECT_EQ(1u, statistics.total.disk_hits);
+  EXPECT_EQ(1u, statistics.total.misses);
+  EXPECT_EQ(1u, statistics.memory_hit_latency.Count());
+  EXPECT_EQ(2u, statistics.disk_lookup_latency.Count());
+  EXPECT_EQ(3u, statistics.disk_write_latency.Count());
+  EXPECT_GT(statistics.disk_write_latency.Percentile(0.99).count(), 0);
+
+  cache.ResetStatistics();
+  statistics = cache.GetStatistics();
+  EXPECT_EQ(0u, statistics.total.memory_hits);
+  EXPECT_EQ(0u, statistics.disk_write_latency.Count());
+
+  EXPECT_EQ(CacheKeyNamespace::Partition,
+            CacheStatistics::GetKeyNamespace("hrn::layer::1::partitions"));
+  EXPECT_EQ(CacheKeyNamespace::Catalog,
+            CacheStatistics::GetKeyNamespace("hrn::catalog"));
+  EXPECT_EQ(0u, LatencyHistogram::GetBucket(std::chrono::nanoseconds(999)));
+  EXPECT_EQ(3u, LatencyHistogram::GetBucket(std::chrono::microseconds(5)));
+  ASSERT_TRUE(cache.Clear());
+}
+
+TEST(DefaultCacheTest, BlobStore) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.max_memory_cache_size = 0;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/unittest";
+  settings.blob_threshold = 1000u;
+  // One value per segment.
+  settings.max_blob_segment_size = 4000u;
+
+  const std::string small_data(100u, 's');
+  const std::string large_data(3000u, 'l');
+  auto decoder = [](const std::string& value) { return value; };
+  const auto put = [](DefaultCache& cache, const std::string& key,
+                      const std::string& value) {
+    return cache.Put(key, value, [=]() { return value; },
+                     KeyValueCache::kDefaultExpiry);
+  };
+  const auto get = [&](DefaultCache& cache, const std::string& key) {
+    auto value = cache.Get(key, decoder);
+    return value.empty() ? std::string() : boost::any_cast<std::string>(value);
+  };
+  const auto blob_path = settings.disk_path_mutable.get() + "/blobs";
+
+  {
+    DefaultCache cache(settings);
+    ASSERT_EQ(DefaultCache::Success, cache.Open());
+    ASSERT_TRUE(cache.Clear());
+
+    ASSERT_TRUE(put(cache, "small", small_data));
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_TRUE(put(cache, "large" + std::to_string(i), large_data));
+    }
+    EXPECT_TRUE(olp::utils::Dir::FileExists(blob_path + "/0.seg"));
+    EXPECT_TRUE(olp::utils::Dir::FileExists(blob_path + "/3.seg"));
+    EXPECT_EQ(large_data, get(cache, "large0"));
+
+    // The segments of the removed values are removed by the maintenance, and
+    // the referenced values are moved out of the mostly unused segments.
+    ASSERT_TRUE(cache.Remove("large0"));
+    ASSERT_TRUE(put(cache, "large1", small_data));
+    cache.RunMaintenance();
+    EXPECT_FALSE(olp::utils::Dir::FileExists(blob_path + "/0.seg"));
+    EXPECT_FALSE(olp::utils::Dir::FileExists(blob_path + "/1.seg"));
+    EXPECT_EQ(small_data, get(cache, "large1"));
+    EXPECT_EQ(large_data, get(cache, "large2"));
+  }
+
+  // The values are read from the segments after the cache is reopened, also
+  // when the values are not moved to the segments anymore.
+  settings.blob_threshold = 0u;
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  EXPECT_EQ(small_data, get(cache, "small"));
+  EXPECT_EQ(large_data, get(cache, "large2"));
+  EXPECT_EQ(large_data, get(cache, "large3"));
+  EXPECT_TRUE(get(cache, "large0").empty());
+  ASSERT_TRUE(cache.Clear());
+  EXPECT_FALSE(olp::utils::Dir::exists(blob_path));
+}
+
+TEST(DefaultCacheTest, Warmup) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/unittest";
+  settings.enable_statistics = true;
+  settings.task_scheduler =
+      std::make_shared<olp::thread::ThreadPoolTaskScheduler>(2u);
+
+  const std::string data(100u, 'd');
+  auto encoder = [=]() { return data; };
+  auto decoder = [](const std::string& value) { return value; };
+  const auto hot_keys_path =
+      olp::utils::Dir::TempDirectory() + "/unittest_hot_keys";
+  const auto warmup = [](DefaultCache& cache, const WarmupManifest& manifest) {
+    std::promise<size_t> loaded;
+    if (!cache.Warmup(manifest,
+                      [&](size_t count) { loaded.set_value(count); })) {
+      return size_t(-1);
+    }
+    return loaded.get_future().get();
+  };
+
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  ASSERT_TRUE(cache.Clear());
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(cache.Put("a::" + std::to_string(i), data, encoder,
+                          KeyValueCache::kDefaultExpiry));
+    ASSERT_TRUE(cache.Put("b::" + std::to_string(i), data, encoder,
+                          KeyValueCache::kDefaultExpiry));
+  }
+  ASSERT_TRUE(cache.Put(
+      "binary",
+      std::make_shared<KeyValueCache::ValueType>(data.begin(), data.end()),
+      KeyValueCache::kDefaultExpiry));
+  ASSERT_TRUE(cache.DumpHotKeys(hot_keys_path, 5u));
+
+  // The snapshot holds the most recently used keys.
+  cache.Close();
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  WarmupManifest manifest;
+  manifest.hot_keys_path = hot_keys_path;
+  EXPECT_EQ(5u, warmup(cache, manifest));
+
+  cache.ResetStatistics();
+  const auto binary = cache.Get("binary");
+  ASSERT_TRUE(binary);
+  EXPECT_EQ(data, std::string(binary->begin(), binary->end()));
+  EXPECT_EQ(data,
+            boost::any_cast<std::string>(cache.Get("b::9", decoder)));
+  EXPECT_EQ(data, boost::any_cast<std::string>(
+                      cache.GetBatch({"a::9", "b::8"}, decoder)[1]));
+  EXPECT_EQ(4u, cache.GetStatistics().total.memory_hits);
+  EXPECT_EQ(0u, cache.GetStatistics().total.disk_hits);
+
+  // The loaded values are not loaded again, and the budget stops the warm-up.
+  manifest.hot_keys_path.clear();
+  manifest.key_prefixes = {"a::", "b::"};
+  manifest.max_bytes = 10u * data.size();
+  EXPECT_EQ(10u, warmup(cache, manifest));
+
+  manifest.hot_keys_path = hot_keys_path + "_missing";
+  EXPECT_EQ(size_t(-1), warmup(cache, manifest));
+  std::remove(hot_keys_path.c_str());
+  ASSERT_TRUE(cache.Clear());
+}
+
+TEST(DefaultCacheTest, LevelDbProfile) {
+  using namespace olp::cache;
+
+  CacheSettings settings;
+  settings.max_memory_cache_size = 0;
+  settings.disk_path_mutable = olp::utils::Dir::TempDirectory() + "/unittest";
+
+  const std::string data(1000u, 'd');
+  auto encoder = [=]() { return data; };
+  auto decoder = [](const std::string& value) { return value; };
+
+  // The databases written with one profile are readable with the others.
+  const std::vector<LevelDbProfile> profiles = {
+      LevelDbProfile::WriteOptimized(), LevelDbProfile::ReadOptimized(),
+      LevelDbProfile()};
+  for (size_t i = 0; i < profiles.size(); ++i) {
+    SCOPED_TRACE(i);
+    settings.leveldb_profile = profiles[i];
+    settings.leveldb_profile.paranoid_checks = true;
+    DefaultCache cache(settings);
+    ASSERT_EQ(DefaultCache::Success, cache.Open());
+    ASSERT_TRUE(cache.Put(std::to_string(i), data, encoder,
+                          KeyValueCache::kDefaultExpiry));
+    for (size_t j = 0; j <= i; ++j) {
+      EXPECT_FALSE(cache.Get(std::to_string(j), decoder).empty()) << j;
+    }
+    EXPECT_TRUE(cache.Get("missing", decoder).empty());
+  }
+
+  settings.leveldb_profile.bloom_filter_bits_per_key = 0;
+  DefaultCache cache(settings);
+  ASSERT_EQ(DefaultCache::Success, cache.Open());
+  EXPECT_FALSE(cache.Get("0", decoder).empty());
+  ASSERT_TRUE(cache.Clear());
+}
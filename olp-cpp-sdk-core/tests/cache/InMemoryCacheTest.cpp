@@ -330,6 +330,57 @@ TEST(InMemoryCacheTest, ItemsWithExpiryEvicted) {
   ASSERT_FALSE(cache.Get(no_expiry).empty());
 }
 
+TEST(InMemoryCacheTest, ExpiryUpdated) {
+  time_t now = std::time(nullptr);
+
+  olp::cache::InMemoryCache cache(10, EqualityCacheCost(), [&] { return now; });
+
+  cache.Put("expiry", "value", 1);
+  cache.Put("expiry", "value", 10);
+  cache.Put("no_expiry", "value", 1);
+  cache.Put("no_expiry", "value");
+  cache.Put("removed", "value", 1);
+  ASSERT_TRUE(cache.Remove("removed"));
+  cache.Put("removed", "value");
+
+  now += 2;
+
+  cache.Put("trigger", "value");
+  ASSERT_EQ(4u, cache.Size());
+  ASSERT_FALSE(cache.Get("expiry").empty());
+  ASSERT_FALSE(cache.Get("no_expiry").empty());
+  ASSERT_FALSE(cache.Get("removed").empty());
+}
+
+TEST(InMemoryCacheTest, ManyExpiries) {
+  time_t now = std::time(nullptr);
+  const int count = 1000;
+
+  olp::cache::InMemoryCache cache(count, EqualityCacheCost(),
+                                  [&] { return now; });
+
+  // The expiry times are mixed, so the heap is reordered on every change.
+  for (int i = 0; i < count; i++) {
+    cache.Put(Key(i), Value(i), 1 + (i * 7919) % count);
+  }
+  for (int i = 0; i < count; i += 3) {
+    cache.Remove(Key(i));
+  }
+  cache.RemoveKeysWithPrefix("key1");
+
+  for (time_t elapsed = 1; elapsed <= count; elapsed += 10) {
+    now += 10;
+    cache.Put("trigger", "value");
+    for (int i = 0; i < count; i++) {
+      const auto expiry = 1 + (i * 7919) % count;
+      const bool removed = i % 3 == 0 || Key(i).compare(0, 4, "key1") == 0;
+      const bool expected = !removed && expiry >= elapsed + 9;
+      ASSERT_EQ(expected, !cache.Get(Key(i)).empty()) << i;
+    }
+  }
+  ASSERT_EQ(1u, cache.Size());
+}
+
 TEST(InMemoryCacheTest, CustomCost) {
   std::string oversized("oversized");
   auto oversized_model = "value: " + oversized;
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+
+#include <olp/core/cache/CacheStatistics.h>
+#include <olp/core/cache/KeyEncoder.h>
+
+namespace {
+using olp::cache::CacheKeyNamespace;
+using olp::cache::CacheStatistics;
+using olp::cache::KeyEncoder;
+
+constexpr auto kCatalog = "hrn:here:data::olp-here-test:hereos-internal-test";
+
+bool StartsWith(const std::string& key, const std::string& prefix) {
+  return key.compare(0, prefix.size(), prefix) == 0;
+}
+
+TEST(KeyEncoderTest, Prefixes) {
+  const KeyEncoder encoder(kCatalog);
+  const auto catalog_prefix = encoder.CatalogPrefix();
+  const auto layer_prefix = encoder.LayerPrefix("testlayer");
+  const auto partition_prefix = encoder.PartitionPrefix("testlayer", "269");
+
+  const std::set<std::string> keys = {
+      encoder.Catalog(),
+      encoder.LatestVersion(),
+      encoder.CatalogValidator(),
+      encoder.Api("config", "v1"),
+      encoder.LayerVersions(4),
+      encoder.Partitions("testlayer", boost::none),
+      encoder.Partitions("testlayer", 4),
+      encoder.PartitionsValidator("testlayer", boost::none),
+      encoder.PartitionsValidator("testlayer", 4),
+      encoder.StalePartitions("testlayer", boost::none),
+      encoder.Partition("testlayer", "269", boost::none),
+      encoder.Partition("testlayer", "269", 4),
+      encoder.Partition("testlayer", "2690", 4),
+      encoder.Data("testlayer", "4eed6ed1-0d32-43b9-ae79-043cb4256432")};
+  EXPECT_EQ(14u, keys.size());
+
+  for (const auto& key : keys) {
+    EXPECT_TRUE(StartsWith(key, catalog_prefix));
+  }
+
+  EXPECT_TRUE(StartsWith(encoder.Data("testlayer", "handle"), layer_prefix));
+  EXPECT_TRUE(StartsWith(encoder.PartitionsValidator("testlayer", 4),
+                         layer_prefix));
+  EXPECT_TRUE(StartsWith(encoder.Partition("testlayer", "269", 4),
+                         partition_prefix));
+  // The partition IDs are length-prefixed, so a prefix matches only
+  // the versions of the same partition.
+  EXPECT_FALSE(StartsWith(encoder.Partition("testlayer", "2690", 4),
+                          partition_prefix));
+  EXPECT_FALSE(StartsWith(encoder.Partition("otherlayer", "269", 4),
+                          layer_prefix));
+  EXPECT_FALSE(
+      StartsWith(KeyEncoder(std::string(kCatalog) + "2").Catalog(),
+                 catalog_prefix));
+
+  // The IDs are not hashed, so the similar ones never collide.
+  EXPECT_NE(encoder.LayerPrefix("testlayer"), encoder.LayerPrefix("testlaye"));
+  EXPECT_FALSE(StartsWith(KeyEncoder("hrn:a").Catalog(),
+                          KeyEncoder("hrn:").CatalogPrefix()));
+
+  // The same arguments always give the same key.
+  EXPECT_EQ(encoder.Api("config", "v1"),
+            KeyEncoder(kCatalog).Api("config", "v1"));
+  EXPECT_NE(encoder.Api("config", "v1"), encoder.Api("confi", "gv1"));
+}
+
+TEST(KeyEncoderTest, KeyNamespace) {
+  const KeyEncoder encoder(kCatalog);
+  EXPECT_EQ(CacheKeyNamespace::Catalog,
+            KeyEncoder::GetKeyNamespace(encoder.Catalog()));
+  EXPECT_EQ(CacheKeyNamespace::Catalog,
+            KeyEncoder::GetKeyNamespace(encoder.LatestVersion()));
+  EXPECT_EQ(CacheKeyNamespace::Catalog,
+            KeyEncoder::GetKeyNamespace(encoder.CatalogValidator()));
+  EXPECT_EQ(CacheKeyNamespace::Catalog,
+            KeyEncoder::GetKeyNamespace(encoder.LayerVersions(1)));
+  EXPECT_EQ(CacheKeyNamespace::Api,
+            KeyEncoder::GetKeyNamespace(encoder.Api("query", "v1")));
+  EXPECT_EQ(CacheKeyNamespace::Partition,
+            KeyEncoder::GetKeyNamespace(encoder.Partitions("layer", 1)));
+  EXPECT_EQ(CacheKeyNamespace::Partition,
+            KeyEncoder::GetKeyNamespace(
+                encoder.PartitionsValidator("layer", boost::none)));
+  EXPECT_EQ(CacheKeyNamespace::Partition,
+            KeyEncoder::GetKeyNamespace(
+                encoder.StalePartitions("layer", boost::none)));
+  EXPECT_EQ(CacheKeyNamespace::Partition,
+            KeyEncoder::GetKeyNamespace(encoder.Partition("layer", "1", 1)));
+  EXPECT_EQ(CacheKeyNamespace::Data,
+            KeyEncoder::GetKeyNamespace(encoder.Data("layer", "handle")));
+  EXPECT_EQ(CacheKeyNamespace::Other,
+            KeyEncoder::GetKeyNamespace(encoder.LayerPrefix("layer")));
+  EXPECT_EQ(CacheKeyNamespace::Other,
+            KeyEncoder::GetKeyNamespace("hrn::layer::handle::Data"));
+
+  EXPECT_EQ(CacheKeyNamespace::Data,
+            CacheStatistics::GetKeyNamespace(encoder.Data("layer", "handle")));
+  EXPECT_EQ(CacheKeyNamespace::Data,
+            CacheStatistics::GetKeyNamespace("hrn::layer::handle::Data"));
+}
+TEST(KeyEncoderTest, LegacyKeys) {
+  const KeyEncoder encoder(kCatalog);
+  const std::string catalog = kCatalog;
+
+  EXPECT_EQ(catalog + "::catalog", KeyEncoder::ToLegacyKey(encoder.Catalog()));
+  EXPECT_EQ(catalog + "::latestVersion",
+            KeyEncoder::ToLegacyKey(encoder.LatestVersion()));
+  EXPECT_EQ(catalog + "::config::v1::api",
+            KeyEncoder::ToLegacyKey(encoder.Api("config", "v1")));
+  EXPECT_EQ(catalog + "::4::layerVersions",
+            KeyEncoder::ToLegacyKey(encoder.LayerVersions(4)));
+  EXPECT_EQ(catalog + "::testlayer::",
+            KeyEncoder::ToLegacyKey(encoder.Partitions("testlayer",
+                                                       boost::none)));
+  EXPECT_EQ(catalog + "::testlayer::4::partitions",
+            KeyEncoder::ToLegacyKey(encoder.Partitions("testlayer", 4)));
+  EXPECT_EQ(catalog + "::testlayer::269::",
+            KeyEncoder::ToLegacyKey(
+                encoder.Partition("testlayer", "269", boost::none)));
+  EXPECT_EQ(
+      catalog + "::testlayer::269::300::partition",
+      KeyEncoder::ToLegacyKey(encoder.Partition("testlayer", "269", 300)));
+  EXPECT_EQ(catalog + "::testlayer::handle::Data",
+            KeyEncoder::ToLegacyKey(encoder.Data("testlayer", "handle")));
+
+  // The keys that the older SDK versions did not have.
+  EXPECT_EQ("", KeyEncoder::ToLegacyKey(encoder.CatalogValidator()));
+  EXPECT_EQ("", KeyEncoder::ToLegacyKey(
+                    encoder.PartitionsValidator("testlayer", 4)));
+  EXPECT_EQ("", KeyEncoder::ToLegacyKey(encoder.LayerPrefix("testlayer")));
+  EXPECT_EQ("", KeyEncoder::ToLegacyKey("hrn::layer::handle::Data"));
+
+  // The truncated keys are not decoded.
+  const auto key = encoder.Data("testlayer", "handle");
+  EXPECT_EQ("", KeyEncoder::ToLegacyKey(key.substr(0, key.size() - 1)));
+}
+}  // namespace
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "WriteBehindQueue.h"
+
+namespace {
+using olp::cache::WriteBehindQueue;
+
+constexpr auto kWaitTime = std::chrono::seconds(5);
+constexpr auto kBlockedTime = std::chrono::milliseconds(50);
+
+// The writer that blocks until it is released, like a slow disk.
+class GatedWriter {
+ public:
+  WriteBehindQueue::Writer Writer() {
+    return [this](const WriteBehindQueue::Items& items) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ++batches_;
+      batch_condition_.notify_all();
+      release_condition_.wait(lock, [&]() { return released_; });
+      for (const auto& item : items) {
+        written_.push_back(item.first);
+      }
+      return true;
+    };
+  }
+
+  bool WaitForBatch(size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return batch_condition_.wait_for(lock, kWaitTime,
+                                     [&]() { return batches_ >= count; });
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    released_ = true;
+    release_condition_.notify_all();
+  }
+
+  std::vector<std::string> Written() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable batch_condition_;
+  std::condition_variable release_condition_;
+  size_t batches_{0u};
+  bool released_{false};
+  std::vector<std::string> written_;
+};
+
+TEST(WriteBehindQueueTest, SaturatedQueue) {
+  GatedWriter writer;
+  WriteBehindQueue queue(writer.Writer(), 10u);
+
+  // The writer takes the first record and blocks.
+  queue.Push("a", "1234567890");
+  ASSERT_TRUE(writer.WaitForBatch(1u));
+
+  // The queue is full, but the pushes never block.
+  queue.Push("b", "1234567890");
+  EXPECT_FALSE(queue.HasSpace());
+  queue.Push("c", "1234567890");
+
+  std::string record;
+  EXPECT_TRUE(queue.Get("a", record));
+  EXPECT_TRUE(queue.Get("c", record));
+
+  {
+    SCOPED_TRACE("The record being written can not be discarded");
+    const auto matches = [](const std::string& key) { return key == "a"; };
+    EXPECT_FALSE(queue.Discard(matches));
+    EXPECT_TRUE(queue.Get("a", record));
+  }
+
+  {
+    SCOPED_TRACE("The queued records are discarded");
+    const auto matches = [](const std::string& key) { return key == "b"; };
+    EXPECT_TRUE(queue.Discard(matches));
+    EXPECT_FALSE(queue.Get("b", record));
+  }
+
+  auto space = std::async(std::launch::async, [&]() {
+    return queue.WaitForSpace();
+  });
+  auto write = std::async(std::launch::async, [&]() {
+    return queue.WaitForWrite();
+  });
+  EXPECT_EQ(std::future_status::timeout, space.wait_for(kBlockedTime));
+  EXPECT_EQ(std::future_status::timeout, write.wait_for(kBlockedTime));
+
+  writer.Release();
+  ASSERT_EQ(std::future_status::ready, space.wait_for(kWaitTime));
+  EXPECT_TRUE(space.get());
+  ASSERT_EQ(std::future_status::ready, write.wait_for(kWaitTime));
+  EXPECT_TRUE(write.get());
+
+  EXPECT_TRUE(queue.Flush());
+  EXPECT_EQ(std::vector<std::string>({"a", "c"}), writer.Written());
+}
+
+TEST(WriteBehindQueueTest, DiscardLast) {
+  GatedWriter writer;
+  WriteBehindQueue queue(writer.Writer(), 10u);
+
+  queue.Push("a", "1");
+  ASSERT_TRUE(writer.WaitForBatch(1u));
+  queue.Push("b", "2");
+  EXPECT_TRUE(queue.Discard([](const std::string& key) { return key == "b"; }));
+  writer.Release();
+
+  // The flush does not wait for the discarded record.
+  auto flushed =
+      std::async(std::launch::async, [&]() { return queue.Flush(); });
+  ASSERT_EQ(std::future_status::ready, flushed.wait_for(kWaitTime));
+  EXPECT_TRUE(flushed.get());
+  EXPECT_EQ(std::vector<std::string>({"a"}), writer.Written());
+}
+
+TEST(WriteBehindQueueTest, StopWakesWaiting) {
+  GatedWriter writer;
+  WriteBehindQueue queue(writer.Writer(), 1u);
+
+  queue.Push("a", "1");
+  ASSERT_TRUE(writer.WaitForBatch(1u));
+  queue.Push("b", "2");
+
+  auto space = std::async(std::launch::async, [&]() {
+    return queue.WaitForSpace();
+  });
+  EXPECT_EQ(std::future_status::timeout, space.wait_for(kBlockedTime));
+
+  auto stopped = std::async(std::launch::async, [&]() { queue.Stop(); });
+  ASSERT_EQ(std::future_status::ready, space.wait_for(kWaitTime));
+  EXPECT_FALSE(space.get());
+
+  // The queued records are still written.
+  writer.Release();
+  ASSERT_EQ(std::future_status::ready, stopped.wait_for(kWaitTime));
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}), writer.Written());
+}
+
+}  // namespace
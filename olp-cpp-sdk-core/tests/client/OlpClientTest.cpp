@@ -22,8 +22,11 @@
 
 #include <chrono>
 #include <future>
+#include <mutex>
 #include <queue>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <olp/core/client/ApiError.h>
 #include <olp/core/client/OlpClient.h>
@@ -32,6 +35,7 @@
 
 #include <olp/core/http/Network.h>
 #include <olp/core/logging/Log.h>
+#include <olp/core/porting/make_unique.h>
 
 namespace {
 using olp::client::HttpResponse;
@@ -847,6 +851,39 @@ TEST_P(OlpClientTest, HeaderParams) {
   }
 }
 
+TEST_P(OlpClientTest, ResponseHeaders) {
+  auto network = std::make_shared<NetworkMock>();
+  client_settings_.network_request_handler = network;
+  client_.SetSettings(client_settings_);
+
+  EXPECT_CALL(*network, Send(_, _, _, _, _))
+      .WillOnce([&](olp::http::NetworkRequest request,
+                    olp::http::Network::Payload payload,
+                    olp::http::Network::Callback callback,
+                    olp::http::Network::HeaderCallback header_callback,
+                    olp::http::Network::DataCallback data_callback) {
+        EXPECT_TRUE(header_callback);
+        if (header_callback) {
+          header_callback("ETag", "\"abc\"");
+          header_callback("Last-Modified", "Wed, 21 Oct 2015 07:28:00 GMT");
+        }
+        callback(olp::http::NetworkResponse().WithStatus(304));
+        return olp::http::SendOutcome(olp::http::RequestId(5));
+      });
+
+  auto response = call_wrapper_->CallApi(
+      std::string(), "GET", std::multimap<std::string, std::string>(),
+      std::multimap<std::string, std::string>(),
+      std::multimap<std::string, std::string>(), nullptr, std::string());
+
+  EXPECT_EQ(304, response.status);
+  ASSERT_EQ(2u, response.headers.size());
+  EXPECT_EQ("ETag", response.headers[0].first);
+  EXPECT_EQ("\"abc\"", response.headers[0].second);
+  EXPECT_EQ("Last-Modified", response.headers[1].first);
+  EXPECT_EQ("Wed, 21 Oct 2015 07:28:00 GMT", response.headers[1].second);
+}
+
 TEST_P(OlpClientTest, DefaultHeaderParams) {
   std::vector<std::pair<std::string, std::string>> result_headers;
   client_.GetMutableDefaultHeaders().insert(std::make_pair("head1", "value1"));
@@ -1189,6 +1226,117 @@ TEST_P(OlpClientTest, CancelRetry) {
   ASSERT_LT(*number_of_tries, client_settings_.retry_settings.max_attempts);
 }
 
+TEST_P(OlpClientTest, CancelDuringBackdown) {
+  client_settings_.retry_settings.max_attempts = 3;
+  client_settings_.retry_settings.initial_backdown_period = 10000;
+  client_settings_.retry_settings.retry_condition =
+      ([](const olp::client::HttpResponse& response) {
+        return response.status == 429;
+      });
+
+  auto first_response = std::make_shared<std::promise<void>>();
+  auto number_of_tries = std::make_shared<std::atomic_int>(0);
+
+  auto network = std::make_shared<NetworkMock>();
+  client_settings_.network_request_handler = network;
+  client_.SetSettings(client_settings_);
+
+  EXPECT_CALL(*network, Send(_, _, _, _, _))
+      .WillRepeatedly([&](olp::http::NetworkRequest request,
+                          olp::http::Network::Payload payload,
+                          olp::http::Network::Callback callback,
+                          olp::http::Network::HeaderCallback header_callback,
+                          olp::http::Network::DataCallback data_callback) {
+        auto tries = ++(*number_of_tries);
+        std::thread handler_thread([first_response, callback, tries]() {
+          callback(olp::http::NetworkResponse().WithStatus(429));
+          if (tries == 1) {
+            first_response->set_value();
+          }
+        });
+        handler_thread.detach();
+        return olp::http::SendOutcome(olp::http::RequestId(5));
+      });
+
+  olp::client::CancellationContext context;
+
+  auto response = std::async(std::launch::async, [&]() {
+    return call_wrapper_->CallApi(std::string(), std::string(),
+                                  std::multimap<std::string, std::string>(),
+                                  std::multimap<std::string, std::string>(),
+                                  std::multimap<std::string, std::string>(),
+                                  nullptr, std::string(), context);
+  });
+
+  // The cancellation completes the request without waiting for the end of
+  // the backdown period.
+  first_response->get_future().get();
+  context.CancelOperation();
+
+  ASSERT_EQ(std::future_status::ready,
+            response.wait_for(std::chrono::seconds(2)));
+  auto response_value = response.get();
+  EXPECT_EQ(static_cast<int>(olp::http::ErrorCode::CANCELLED_ERROR),
+            response_value.status)
+      << response_value.response.str();
+  EXPECT_EQ(1, number_of_tries->load());
+}
+
+TEST_P(OlpClientTest, BackdownDoesNotBlockNetworkThread) {
+  client_settings_.retry_settings.max_attempts = 2;
+  client_settings_.retry_settings.initial_backdown_period = 500;
+  client_settings_.retry_settings.retry_condition =
+      ([](const olp::client::HttpResponse& response) {
+        return response.status == 429;
+      });
+
+  auto network = std::make_shared<NetworkMock>();
+  client_settings_.network_request_handler = network;
+  client_.SetSettings(client_settings_);
+
+  std::mutex mutex;
+  std::vector<std::chrono::milliseconds> callback_durations;
+  std::vector<std::thread> handler_threads;
+
+  EXPECT_CALL(*network, Send(_, _, _, _, _))
+      .Times(3)
+      .WillRepeatedly([&](olp::http::NetworkRequest request,
+                          olp::http::Network::Payload payload,
+                          olp::http::Network::Callback callback,
+                          olp::http::Network::HeaderCallback header_callback,
+                          olp::http::Network::DataCallback data_callback) {
+        std::lock_guard<std::mutex> lock(mutex);
+        handler_threads.emplace_back([&, callback]() {
+          const auto start = std::chrono::steady_clock::now();
+          callback(olp::http::NetworkResponse().WithStatus(429));
+          const auto duration =
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - start);
+          std::lock_guard<std::mutex> lock(mutex);
+          callback_durations.push_back(duration);
+        });
+        return olp::http::SendOutcome(olp::http::RequestId(5));
+      });
+
+  const auto start = std::chrono::steady_clock::now();
+  auto response = call_wrapper_->CallApi(
+      std::string(), "GET", std::multimap<std::string, std::string>(),
+      std::multimap<std::string, std::string>(),
+      std::multimap<std::string, std::string>(), nullptr, std::string());
+  const auto duration = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(429, response.status);
+  EXPECT_GE(duration, std::chrono::milliseconds(1000));
+
+  for (auto& thread : handler_threads) {
+    thread.join();
+  }
+  ASSERT_EQ(3u, callback_durations.size());
+  for (const auto& callback_duration : callback_durations) {
+    EXPECT_LT(callback_duration, std::chrono::milliseconds(200));
+  }
+}
+
 TEST_P(OlpClientTest, QueryMultiParams) {
   std::string uri;
   std::vector<std::pair<std::string, std::string>> headers;
@@ -1265,6 +1413,382 @@ TEST_P(OlpClientTest, SlowDownError) {
   EXPECT_EQ(olp::client::ErrorCode::SlowDown, api_error.GetErrorCode());
 }
 
+/// Keeps the delayed tasks until they are dropped by the test.
+class DroppingTaskScheduler : public olp::thread::TaskScheduler {
+ public:
+  void DropDelayedTasks() {
+    std::vector<CallFuncType> tasks;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks.swap(delayed_tasks_);
+    }
+  }
+
+  size_t DelayedTasksCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return delayed_tasks_.size();
+  }
+
+ protected:
+  void EnqueueTask(CallFuncType&& func) override { func(); }
+
+  void EnqueueDelayedTask(CallFuncType&& func, std::chrono::milliseconds,
+                          std::uint32_t) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    delayed_tasks_.push_back(std::move(func));
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<CallFuncType> delayed_tasks_;
+};
+
+TEST(OlpClientRetryTest, DroppedRetryIsCancelled) {
+  auto network = std::make_shared<NetworkMock>();
+  auto task_scheduler = std::make_shared<DroppingTaskScheduler>();
+
+  olp::client::OlpClientSettings settings;
+  settings.network_request_handler = network;
+  settings.task_scheduler = task_scheduler;
+  settings.retry_settings.max_attempts = 3;
+  settings.retry_settings.retry_condition =
+      [](const olp::client::HttpResponse& response) {
+        return response.status == 429;
+      };
+  olp::client::OlpClient client;
+  client.SetSettings(settings);
+
+  std::thread handler_thread;
+  EXPECT_CALL(*network, Send(_, _, _, _, _))
+      .WillOnce([&](olp::http::NetworkRequest, olp::http::Network::Payload,
+                    olp::http::Network::Callback callback,
+                    olp::http::Network::HeaderCallback,
+                    olp::http::Network::DataCallback) {
+        handler_thread = std::thread([callback]() {
+          callback(olp::http::NetworkResponse().WithStatus(429));
+        });
+        return olp::http::SendOutcome(olp::http::RequestId(5));
+      });
+
+  std::promise<olp::client::HttpResponse> promise;
+  auto token = client.CallApi({}, "GET", {}, {}, {}, nullptr, {},
+                              [&](olp::client::HttpResponse response) {
+                                promise.set_value(std::move(response));
+                              });
+  handler_thread.join();
+
+  // The scheduler drops the retry that waits for the backdown period, for
+  // example, because it is destroyed. The request still completes.
+  ASSERT_EQ(1u, task_scheduler->DelayedTasksCount());
+  task_scheduler->DropDelayedTasks();
+
+  auto future = promise.get_future();
+  ASSERT_EQ(std::future_status::ready,
+            future.wait_for(std::chrono::seconds(2)));
+  EXPECT_EQ(static_cast<int>(olp::http::ErrorCode::CANCELLED_ERROR),
+            future.get().status);
+}
+
+TEST(OlpClientRetryTest, DestroyedClientCancelsRetry) {
+  auto network = std::make_shared<NetworkMock>();
+
+  olp::client::OlpClientSettings settings;
+  settings.network_request_handler = network;
+  settings.retry_settings.max_attempts = 3;
+  settings.retry_settings.initial_backdown_period = 10000;
+  settings.retry_settings.retry_condition =
+      [](const olp::client::HttpResponse& response) {
+        return response.status == 429;
+      };
+  auto client = std::make_unique<olp::client::OlpClient>();
+  client->SetSettings(settings);
+
+  std::thread handler_thread;
+  EXPECT_CALL(*network, Send(_, _, _, _, _))
+      .WillOnce([&](olp::http::NetworkRequest, olp::http::Network::Payload,
+                    olp::http::Network::Callback callback,
+                    olp::http::Network::HeaderCallback,
+                    olp::http::Network::DataCallback) {
+        handler_thread = std::thread([callback]() {
+          callback(olp::http::NetworkResponse().WithStatus(429));
+        });
+        return olp::http::SendOutcome(olp::http::RequestId(5));
+      });
+
+  std::promise<olp::client::HttpResponse> promise;
+  auto token = client->CallApi({}, "GET", {}, {}, {}, nullptr, {},
+                               [&](olp::client::HttpResponse response) {
+                                 promise.set_value(std::move(response));
+                               });
+  handler_thread.join();
+
+  // Without a task scheduler, the retry waits on the timer of the client, and
+  // is cancelled when the client is destroyed.
+  client.reset();
+
+  auto future = promise.get_future();
+  ASSERT_EQ(std::future_status::ready,
+            future.wait_for(std::chrono::milliseconds(0)));
+  EXPECT_EQ(static_cast<int>(olp::http::ErrorCode::CANCELLED_ERROR),
+            future.get().status);
+}
+
+TEST(OlpClientBufferTest, CallApiToBuffer) {
+  auto network = std::make_shared<NetworkMock>();
+  olp::client::OlpClientSettings settings;
+  settings.network_request_handler = network;
+  olp::client::OlpClient client;
+  client.SetSettings(settings);
+
+  const std::string content = "content";
+
+  {
+    SCOPED_TRACE("Body is written to the buffer");
+
+    EXPECT_CALL(*network, Send(_, _, _, _, _))
+        .WillOnce([&](olp::http::NetworkRequest request,
+                      olp::http::Network::Payload payload,
+                      olp::http::Network::Callback callback,
+                      olp::http::Network::HeaderCallback header_callback,
+                      olp::http::Network::DataCallback data_callback) {
+          EXPECT_TRUE(header_callback);
+          if (header_callback) {
+            header_callback("content-length", std::to_string(content.size()));
+          }
+          *payload << content;
+          callback(olp::http::NetworkResponse().WithStatus(200));
+          return olp::http::SendOutcome(olp::http::RequestId(5));
+        });
+
+    auto response =
+        client.CallApiToBuffer({}, "GET", {}, {}, {}, nullptr, {}, {});
+    EXPECT_EQ(200, response.status);
+    ASSERT_TRUE(response.body);
+    EXPECT_EQ(content, std::string(response.body->begin(),
+                                   response.body->end()));
+    EXPECT_EQ(content.size(), response.body->capacity());
+    EXPECT_TRUE(response.response.str().empty());
+    testing::Mock::VerifyAndClearExpectations(network.get());
+  }
+
+  {
+    SCOPED_TRACE("Only the final size is preallocated, up to the limit");
+
+    EXPECT_CALL(*network, Send(_, _, _, _, _))
+        .WillOnce([&](olp::http::NetworkRequest request,
+                      olp::http::Network::Payload payload,
+                      olp::http::Network::Callback callback,
+                      olp::http::Network::HeaderCallback header_callback,
+                      olp::http::Network::DataCallback data_callback) {
+          // The redirect, then the final response with a wrong size.
+          header_callback("Content-Length", "1");
+          header_callback("Location", "https://redirected");
+          header_callback("Content-Length", "1000000000000000");
+          *payload << content;
+          callback(olp::http::NetworkResponse().WithStatus(200));
+          return olp::http::SendOutcome(olp::http::RequestId(6));
+        });
+
+    auto response =
+        client.CallApiToBuffer({}, "GET", {}, {}, {}, nullptr, {}, {});
+    EXPECT_EQ(200, response.status);
+    ASSERT_TRUE(response.body);
+    EXPECT_EQ(content, std::string(response.body->begin(),
+                                   response.body->end()));
+    EXPECT_GE(response.body->capacity(), content.size());
+    EXPECT_LE(response.body->capacity(), 64u * 1024u * 1024u);
+    testing::Mock::VerifyAndClearExpectations(network.get());
+  }
+
+  {
+    SCOPED_TRACE("Error is written to the response");
+
+    EXPECT_CALL(*network, Send(_, _, _, _, _))
+        .WillOnce([&](olp::http::NetworkRequest request,
+                      olp::http::Network::Payload payload,
+                      olp::http::Network::Callback callback,
+                      olp::http::Network::HeaderCallback header_callback,
+                      olp::http::Network::DataCallback data_callback) {
+          *payload << "not found";
+          callback(olp::http::NetworkResponse().WithStatus(404));
+          return olp::http::SendOutcome(olp::http::RequestId(6));
+        });
+
+    auto response =
+        client.CallApiToBuffer({}, "GET", {}, {}, {}, nullptr, {}, {});
+    EXPECT_EQ(404, response.status);
+    EXPECT_FALSE(response.body);
+    EXPECT_EQ("not found", response.response.str());
+  }
+}
+
+TEST(OlpClientStreamTest, CallApiStream) {
+  auto network = std::make_shared<NetworkMock>();
+  olp::client::OlpClientSettings settings;
+  settings.network_request_handler = network;
+  olp::client::OlpClient client;
+  client.SetSettings(settings);
+
+  std::string received;
+  auto data_callback = [&](const std::uint8_t* data, std::uint64_t offset,
+                           std::size_t length) {
+    received.resize(offset);
+    received.append(reinterpret_cast<const char*>(data), length);
+  };
+
+  auto send_chunks = [](olp::http::Network::DataCallback& data_callback,
+                        const std::string& content) {
+    for (size_t offset = 0; offset < content.size(); offset += 3) {
+      const auto length = std::min<size_t>(3u, content.size() - offset);
+      data_callback(
+          reinterpret_cast<const std::uint8_t*>(content.data() + offset),
+          offset, length);
+    }
+  };
+
+  {
+    SCOPED_TRACE("Body is passed to the data callback");
+
+    const std::string content = "streamed content";
+    EXPECT_CALL(*network, Send(_, _, _, _, _))
+        .WillOnce([&](olp::http::NetworkRequest request,
+                      olp::http::Network::Payload payload,
+                      olp::http::Network::Callback callback,
+                      olp::http::Network::HeaderCallback header_callback,
+                      olp::http::Network::DataCallback data_callback) {
+          EXPECT_TRUE(payload);
+          EXPECT_TRUE(data_callback);
+          send_chunks(data_callback, content);
+          callback(olp::http::NetworkResponse().WithStatus(200));
+          return olp::http::SendOutcome(olp::http::RequestId(5));
+        });
+
+    auto response = client.CallApiStream({}, "GET", {}, {}, {}, nullptr, {},
+                                         data_callback, {});
+    EXPECT_EQ(200, response.status);
+    EXPECT_FALSE(response.body);
+    EXPECT_TRUE(response.response.str().empty());
+    EXPECT_EQ(content, received);
+    testing::Mock::VerifyAndClearExpectations(network.get());
+  }
+
+  {
+    SCOPED_TRACE("Error is written to the response, not to the sink");
+
+    // The network passes the error body to the payload only.
+    EXPECT_CALL(*network, Send(_, _, _, _, _))
+        .WillOnce([&](olp::http::NetworkRequest request,
+                      olp::http::Network::Payload payload,
+                      olp::http::Network::Callback callback,
+                      olp::http::Network::HeaderCallback header_callback,
+                      olp::http::Network::DataCallback data_callback) {
+          *payload << "not found";
+          callback(olp::http::NetworkResponse().WithStatus(404));
+          return olp::http::SendOutcome(olp::http::RequestId(6));
+        });
+
+    received.clear();
+    auto response = client.CallApiStream({}, "GET", {}, {}, {}, nullptr, {},
+                                         data_callback, {});
+    EXPECT_EQ(404, response.status);
+    EXPECT_EQ("not found", response.response.str());
+    EXPECT_TRUE(received.empty());
+    testing::Mock::VerifyAndClearExpectations(network.get());
+  }
+
+  {
+    SCOPED_TRACE("Data callback is not called after the timeout");
+
+    settings.retry_settings.timeout = 1;
+    client.SetSettings(settings);
+
+    std::promise<olp::http::Network::DataCallback> late_callback;
+    EXPECT_CALL(*network, Send(_, _, _, _, _))
+        .WillOnce([&](olp::http::NetworkRequest request,
+                      olp::http::Network::Payload payload,
+                      olp::http::Network::Callback callback,
+                      olp::http::Network::HeaderCallback header_callback,
+                      olp::http::Network::DataCallback data_callback) {
+          late_callback.set_value(data_callback);
+          return olp::http::SendOutcome(olp::http::RequestId(7));
+        });
+    EXPECT_CALL(*network, Cancel(7)).Times(1);
+
+    received.clear();
+    auto response = client.CallApiStream({}, "GET", {}, {}, {}, nullptr, {},
+                                         data_callback, {});
+    EXPECT_EQ(static_cast<int>(olp::http::ErrorCode::TIMEOUT_ERROR),
+              response.status);
+
+    auto network_callback = late_callback.get_future().get();
+    send_chunks(network_callback, "late");
+    EXPECT_TRUE(received.empty());
+  }
+}
+
+TEST(OlpClientStreamTest, CallApiStreamRetry) {
+  auto network = std::make_shared<NetworkMock>();
+  olp::client::OlpClientSettings settings;
+  settings.network_request_handler = network;
+  settings.retry_settings.max_attempts = 3;
+  settings.retry_settings.initial_backdown_period = 10;
+  settings.retry_settings.retry_condition =
+      [](const olp::client::HttpResponse& response) {
+        return response.status ==
+               static_cast<int>(olp::http::ErrorCode::IO_ERROR);
+      };
+  olp::client::OlpClient client;
+  client.SetSettings(settings);
+
+  // The sink only appends, like a file or a socket.
+  std::string received;
+  std::uint64_t next_offset = 0;
+  auto data_callback = [&](const std::uint8_t* data, std::uint64_t offset,
+                           std::size_t length) {
+    EXPECT_EQ(next_offset, offset);
+    received.append(reinterpret_cast<const char*>(data), length);
+    next_offset = offset + length;
+  };
+
+  const std::string content = "the content that is streamed in chunks";
+  auto send_chunks = [&](olp::http::Network::DataCallback& data_callback,
+                         size_t end) {
+    for (size_t offset = 0; offset < end; offset += 5) {
+      const auto length = std::min<size_t>(5u, end - offset);
+      data_callback(
+          reinterpret_cast<const std::uint8_t*>(content.data() + offset),
+          offset, length);
+    }
+  };
+
+  // The connection breaks in the middle of a chunk twice, each retry
+  // replays the body from the start.
+  const std::vector<size_t> breaks = {12u, 23u};
+  size_t attempt = 0;
+  EXPECT_CALL(*network, Send(_, _, _, _, _))
+      .Times(3)
+      .WillRepeatedly([&](olp::http::NetworkRequest,
+                          olp::http::Network::Payload,
+                          olp::http::Network::Callback callback,
+                          olp::http::Network::HeaderCallback,
+                          olp::http::Network::DataCallback data_callback) {
+        if (attempt < breaks.size()) {
+          send_chunks(data_callback, breaks[attempt++]);
+          callback(olp::http::NetworkResponse().WithStatus(
+              static_cast<int>(olp::http::ErrorCode::IO_ERROR)));
+        } else {
+          send_chunks(data_callback, content.size());
+          callback(olp::http::NetworkResponse().WithStatus(200));
+        }
+        return olp::http::SendOutcome(olp::http::RequestId(5));
+      });
+
+  auto response = client.CallApiStream({}, "GET", {}, {}, {}, nullptr, {},
+                                       data_callback, {});
+  EXPECT_EQ(200, response.status);
+  EXPECT_EQ(content, received);
+}
+
 INSTANTIATE_TEST_SUITE_P(, OlpClientTest,
                          ::testing::Values(CallApiType::ASYNC,
                                            CallApiType::SYNC));
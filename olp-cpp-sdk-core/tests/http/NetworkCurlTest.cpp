@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#ifdef OLP_SDK_NETWORK_HAS_CURL
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/http/HttpStatusCode.h>
+#include <olp/core/http/Network.h>
+#include <olp/core/http/NetworkSettings.h>
+#include <olp/core/http/NetworkTypes.h>
+#include <olp/core/thread/Priority.h>
+
+#include "curl/NetworkCurl.h"
+
+namespace {
+using olp::http::ErrorCode;
+using olp::http::Network;
+using olp::http::NetworkInitializationSettings;
+using olp::http::NetworkRequest;
+using olp::http::NetworkResponse;
+
+constexpr auto kWaitTime = std::chrono::seconds(5);
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+// The loopback HTTP server that answers every request with its path. While
+// held, the server receives the requests but does not answer them, so they
+// stay in flight.
+class LocalServer {
+ public:
+  LocalServer() {
+    listen_socket_ = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (bind(listen_socket_, reinterpret_cast<sockaddr*>(&address), length) ||
+        listen(listen_socket_, 64) ||
+        getsockname(listen_socket_, reinterpret_cast<sockaddr*>(&address),
+                    &length)) {
+      ADD_FAILURE() << "The local server failed to start";
+    }
+    port_ = ntohs(address.sin_port);
+    accept_thread_ = std::thread(&LocalServer::Accept, this);
+  }
+
+  ~LocalServer() {
+    stopped_ = true;
+    Release();
+    accept_thread_.join();
+    close(listen_socket_);
+
+    std::vector<std::thread> threads;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      threads.swap(threads_);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  std::string Url(const std::string& path) const {
+    return "http://127.0.0.1:" + std::to_string(port_) + path;
+  }
+
+  void Hold() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    held_ = true;
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    held_ = false;
+    condition_.notify_all();
+  }
+
+  bool WaitForRequests(size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return condition_.wait_for(lock, kWaitTime,
+                               [&]() { return paths_.size() >= count; });
+  }
+
+  // The paths of the received requests, in the order they were received.
+  std::vector<std::string> Paths() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return paths_;
+  }
+
+ private:
+  void Accept() {
+    while (!stopped_) {
+      pollfd descriptor{listen_socket_, POLLIN, 0};
+      if (poll(&descriptor, 1, 50) <= 0) {
+        continue;
+      }
+
+      const auto connection = accept(listen_socket_, nullptr, nullptr);
+      if (connection < 0) {
+        continue;
+      }
+#ifdef SO_NOSIGPIPE
+      int enabled = 1;
+      setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &enabled,
+                 sizeof(enabled));
+#endif
+      std::lock_guard<std::mutex> lock(mutex_);
+      threads_.emplace_back(&LocalServer::Serve, this, connection);
+    }
+  }
+
+  void Serve(int connection) {
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos) {
+      const auto size = recv(connection, buffer, sizeof(buffer), 0);
+      if (size <= 0) {
+        close(connection);
+        return;
+      }
+      request.append(buffer, static_cast<size_t>(size));
+    }
+
+    // The request line is "GET /path HTTP/1.1".
+    const auto begin = request.find(' ') + 1;
+    const auto path = request.substr(begin, request.find(' ', begin) - begin);
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      paths_.push_back(path);
+      condition_.notify_all();
+      condition_.wait(lock, [&]() { return !held_; });
+    }
+
+    const auto response = "HTTP/1.1 200 OK\r\nContent-Length: " +
+                          std::to_string(path.size()) +
+                          "\r\nConnection: close\r\n\r\n" + path;
+    send(connection, response.data(), response.size(), kSendFlags);
+    close(connection);
+  }
+
+  int listen_socket_{-1};
+  int port_{0};
+  std::atomic<bool> stopped_{false};
+  std::thread accept_thread_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool held_{false};
+  std::vector<std::string> paths_;
+  std::vector<std::thread> threads_;
+};
+
+// Collects the responses of the requests by their paths.
+class Responses {
+ public:
+  Network::Callback Callback(const std::string& path) {
+    return [=](NetworkResponse response) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      responses_.emplace_back(path, response.GetStatus());
+      condition_.notify_all();
+    };
+  }
+
+  bool WaitFor(size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return condition_.wait_for(lock, kWaitTime,
+                               [&]() { return responses_.size() >= count; });
+  }
+
+  std::vector<std::pair<std::string, int>> Get() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return responses_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<std::pair<std::string, int>> responses_;
+};
+
+NetworkInitializationSettings SingleHandleSettings() {
+  NetworkInitializationSettings settings;
+  settings.max_requests_count = 1u;
+  settings.min_requests_count = 1u;
+  return settings;
+}
+
+olp::http::SendOutcome Send(Network& network, LocalServer& server,
+                            Responses& responses, const std::string& path,
+                            std::uint32_t priority = olp::thread::NORMAL) {
+  return network.Send(NetworkRequest(server.Url(path)).WithPriority(priority),
+                      std::make_shared<std::stringstream>(),
+                      responses.Callback(path));
+}
+
+TEST(NetworkCurlTest, PendingRequestsOrder) {
+  LocalServer server;
+  server.Hold();
+  Responses responses;
+  auto network = olp::http::CreateDefaultNetwork(SingleHandleSettings());
+
+  ASSERT_TRUE(Send(*network, server, responses, "/first").IsSuccessful());
+  ASSERT_TRUE(server.WaitForRequests(1u));
+
+  // The only handle is busy, so the requests wait in the queue, and are sent
+  // by their priority.
+  ASSERT_TRUE(Send(*network, server, responses, "/low", olp::thread::LOW)
+                  .IsSuccessful());
+  ASSERT_TRUE(Send(*network, server, responses, "/normal").IsSuccessful());
+  ASSERT_TRUE(Send(*network, server, responses, "/high", olp::thread::HIGH)
+                  .IsSuccessful());
+  auto statistics = network->GetStatistics();
+  EXPECT_EQ(3u, statistics.pending_requests);
+  EXPECT_EQ(3u, statistics.requests_queued);
+  EXPECT_EQ(std::vector<std::string>({"/first"}), server.Paths());
+
+  server.Release();
+  ASSERT_TRUE(responses.WaitFor(4u));
+  EXPECT_EQ(std::vector<std::string>({"/first", "/high", "/normal", "/low"}),
+            server.Paths());
+  for (const auto& response : responses.Get()) {
+    EXPECT_EQ(olp::http::HttpStatusCode::OK, response.second)
+        << response.first;
+  }
+  EXPECT_EQ(0u, network->GetStatistics().pending_requests);
+}
+
+TEST(NetworkCurlTest, PendingQueueFull) {
+  LocalServer server;
+  server.Hold();
+  auto settings = SingleHandleSettings();
+  settings.max_pending_requests_count = 1u;
+  Responses responses;
+  auto network = olp::http::CreateDefaultNetwork(settings);
+
+  ASSERT_TRUE(Send(*network, server, responses, "/first").IsSuccessful());
+  ASSERT_TRUE(server.WaitForRequests(1u));
+  ASSERT_TRUE(Send(*network, server, responses, "/queued").IsSuccessful());
+
+  const auto outcome = Send(*network, server, responses, "/rejected");
+  ASSERT_FALSE(outcome.IsSuccessful());
+  EXPECT_EQ(ErrorCode::NETWORK_OVERLOAD_ERROR, outcome.GetErrorCode());
+  EXPECT_EQ(1u, network->GetStatistics().requests_rejected);
+
+  server.Release();
+  ASSERT_TRUE(responses.WaitFor(2u));
+  EXPECT_EQ(std::vector<std::string>({"/first", "/queued"}), server.Paths());
+}
+
+TEST(NetworkCurlTest, CancelPendingRequest) {
+  LocalServer server;
+  server.Hold();
+  Responses responses;
+  auto network = olp::http::CreateDefaultNetwork(SingleHandleSettings());
+
+  ASSERT_TRUE(Send(*network, server, responses, "/first").IsSuccessful());
+  ASSERT_TRUE(server.WaitForRequests(1u));
+  const auto outcome = Send(*network, server, responses, "/cancelled");
+  ASSERT_TRUE(outcome.IsSuccessful());
+
+  // The cancelled request leaves the queue right away, while the request in
+  // flight still waits for the server.
+  network->Cancel(outcome.GetRequestId());
+  ASSERT_TRUE(responses.WaitFor(1u));
+  EXPECT_EQ(std::make_pair(std::string("/cancelled"),
+                           static_cast<int>(ErrorCode::CANCELLED_ERROR)),
+            responses.Get().front());
+  EXPECT_EQ(0u, network->GetStatistics().pending_requests);
+
+  server.Release();
+  ASSERT_TRUE(responses.WaitFor(2u));
+  EXPECT_EQ(std::vector<std::string>({"/first"}), server.Paths());
+}
+
+// The event loop waits for up to a second when no transfer is due, so the
+// tests below fail if a request or a cancellation does not wake it up.
+constexpr auto kWakeupTime = std::chrono::milliseconds(500);
+
+TEST(NetworkCurlTest, WakeupOnNewRequest) {
+  LocalServer server;
+  Responses responses;
+  auto network = olp::http::CreateDefaultNetwork(SingleHandleSettings());
+
+  ASSERT_TRUE(Send(*network, server, responses, "/first").IsSuccessful());
+  ASSERT_TRUE(responses.WaitFor(1u));
+
+  // Let the worker block waiting for the events of the idle network.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  const auto start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(Send(*network, server, responses, "/second").IsSuccessful());
+  ASSERT_TRUE(responses.WaitFor(2u));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, kWakeupTime);
+  EXPECT_EQ(olp::http::HttpStatusCode::OK, responses.Get().back().second);
+}
+
+TEST(NetworkCurlTest, CancelWhileWaiting) {
+  LocalServer server;
+  server.Hold();
+  Responses responses;
+  auto network = olp::http::CreateDefaultNetwork(SingleHandleSettings());
+
+  const auto outcome = Send(*network, server, responses, "/cancelled");
+  ASSERT_TRUE(outcome.IsSuccessful());
+  ASSERT_TRUE(server.WaitForRequests(1u));
+
+  // The worker waits for the response that the server holds back.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  const auto start = std::chrono::steady_clock::now();
+  network->Cancel(outcome.GetRequestId());
+  ASSERT_TRUE(responses.WaitFor(1u));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, kWakeupTime);
+  EXPECT_EQ(static_cast<int>(ErrorCode::CANCELLED_ERROR),
+            responses.Get().front().second);
+
+  // The handle is free again.
+  server.Release();
+  ASSERT_TRUE(Send(*network, server, responses, "/next").IsSuccessful());
+  ASSERT_TRUE(responses.WaitFor(2u));
+  EXPECT_EQ(olp::http::HttpStatusCode::OK, responses.Get().back().second);
+}
+
+TEST(NetworkCurlTest, ShutdownWhileWaiting) {
+  LocalServer server;
+  server.Hold();
+  Responses responses;
+  auto network = olp::http::CreateDefaultNetwork(SingleHandleSettings());
+
+  ASSERT_TRUE(Send(*network, server, responses, "/first").IsSuccessful());
+  ASSERT_TRUE(server.WaitForRequests(1u));
+  ASSERT_TRUE(Send(*network, server, responses, "/queued").IsSuccessful());
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  // Destroying the network stops the worker, and completes the requests in
+  // flight and in the queue.
+  const auto start = std::chrono::steady_clock::now();
+  network.reset();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, kWakeupTime);
+  ASSERT_TRUE(responses.WaitFor(2u));
+  for (const auto& response : responses.Get()) {
+    EXPECT_EQ(static_cast<int>(ErrorCode::OFFLINE_ERROR), response.second)
+        << response.first;
+  }
+}
+
+#if LIBCURL_VERSION_NUM >= 0x072F00
+TEST(NetworkCurlTest, Http2Multiplexing) {
+  using olp::http::NetworkCurl;
+
+  // The requests to one host share a connection, when the server negotiates
+  // HTTP/2 over TLS.
+  EXPECT_EQ(CURLPIPE_MULTIPLEX, NetworkCurl::GetPipeliningMode());
+
+  olp::http::NetworkSettings settings;
+  EXPECT_EQ(CURL_HTTP_VERSION_2TLS, NetworkCurl::GetHttpVersion(settings));
+  settings.WithHttp2Multiplexing(false);
+  EXPECT_EQ(CURL_HTTP_VERSION_1_1, NetworkCurl::GetHttpVersion(settings));
+}
+#endif
+
+}  // namespace
+
+#endif  // OLP_SDK_NETWORK_HAS_CURL
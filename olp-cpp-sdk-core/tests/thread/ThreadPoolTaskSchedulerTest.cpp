@@ -20,6 +20,12 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include <olp/core/client/CancellationContext.h>
 #include <olp/core/thread/ThreadPoolTaskScheduler.h>
 
@@ -126,3 +132,184 @@ TEST(ThreadPoolTaskSchedulerTest, MultiUserPush) {
   }
   push_threads.clear();
 }
+
+TEST(ThreadPoolTaskSchedulerTest, Priorities) {
+  SCOPED_TRACE("Tasks with a higher priority are executed first");
+
+  auto thread_pool = std::make_shared<ThreadPool>(1u);
+  TaskScheduler& scheduler = *thread_pool;
+
+  // Block the only thread, so the tasks below wait in the queue.
+  std::promise<void> unblock;
+  auto unblocked = unblock.get_future().share();
+  scheduler.ScheduleTask([unblocked]() { unblocked.wait(); });
+
+  std::mutex mutex;
+  std::vector<int> order;
+  auto push = [&](int id, uint32_t priority) {
+    scheduler.ScheduleTask(
+        [&, id]() {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.push_back(id);
+        },
+        priority);
+  };
+
+  push(1, olp::thread::LOW);
+  push(2, olp::thread::NORMAL);
+  push(3, olp::thread::HIGH);
+  push(4, olp::thread::NORMAL);
+  push(5, olp::thread::HIGH);
+
+  std::promise<void> done;
+  scheduler.ScheduleTask([&]() { done.set_value(); }, olp::thread::LOW);
+  unblock.set_value();
+  ASSERT_EQ(done.get_future().wait_for(milliseconds(kMaxWaitMs)),
+            std::future_status::ready);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_THAT(order, ElementsAre(3, 5, 2, 4, 1));
+}
+
+TEST(ThreadPoolTaskSchedulerTest, PriorityAging) {
+  SCOPED_TRACE("Waiting tasks are not starved by the higher priority tasks");
+
+  auto thread_pool = std::make_shared<ThreadPool>(1u);
+  TaskScheduler& scheduler = *thread_pool;
+
+  std::promise<void> unblock;
+  auto unblocked = unblock.get_future().share();
+  scheduler.ScheduleTask([unblocked]() { unblocked.wait(); });
+
+  std::mutex mutex;
+  std::vector<int> order;
+  auto push = [&](int id, uint32_t priority) {
+    scheduler.ScheduleTask(
+        [&, id]() {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.push_back(id);
+        },
+        priority);
+  };
+
+  // The first task waits for longer than the aging of the priority
+  // difference, so it is executed before the second one.
+  const uint32_t priority = olp::thread::NORMAL;
+  const uint32_t difference = 5u;
+  push(1, priority);
+  std::this_thread::sleep_for(olp::thread::kPriorityAgingInterval *
+                              (2 * difference));
+  push(2, priority + difference);
+  push(3, priority + 10 * difference);
+
+  std::promise<void> done;
+  scheduler.ScheduleTask([&]() { done.set_value(); }, olp::thread::LOW);
+  unblock.set_value();
+  ASSERT_EQ(done.get_future().wait_for(milliseconds(kMaxWaitMs)),
+            std::future_status::ready);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_THAT(order, ElementsAre(3, 1, 2));
+}
+
+TEST(ThreadPoolTaskSchedulerTest, PriorityOverBacklog) {
+  SCOPED_TRACE("High priority work is served before a long low backlog");
+
+  const auto now = steady_clock::now();
+  const auto high = olp::thread::AgedEnqueueTime(now, olp::thread::HIGH);
+
+  // The low priority work queued seconds ago still waits.
+  EXPECT_LT(high,
+            olp::thread::AgedEnqueueTime(now - seconds(5), olp::thread::LOW));
+  EXPECT_LT(high, olp::thread::AgedEnqueueTime(now - seconds(3),
+                                               olp::thread::NORMAL));
+
+  // Until it waits for longer than the aging of the priority difference.
+  EXPECT_GT(high,
+            olp::thread::AgedEnqueueTime(now - seconds(10), olp::thread::LOW));
+}
+
+TEST(ThreadPoolTaskSchedulerTest, DelayedTasks) {
+  SCOPED_TRACE("Delayed tasks are executed after the delay");
+
+  auto thread_pool = std::make_shared<ThreadPool>(1u);
+  TaskScheduler& scheduler = *thread_pool;
+
+  std::mutex mutex;
+  std::vector<int> order;
+  auto push = [&](int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    order.push_back(id);
+  };
+
+  const auto start = steady_clock::now();
+  std::promise<void> done;
+  scheduler.ScheduleDelayedTask(
+      [&]() {
+        push(3);
+        done.set_value();
+      },
+      2 * kSleep);
+  scheduler.ScheduleDelayedTask([&]() { push(2); }, kSleep);
+
+  // The waiting delayed tasks do not block the pool thread.
+  std::promise<void> immediate;
+  scheduler.ScheduleTask([&]() {
+    push(1);
+    immediate.set_value();
+  });
+  ASSERT_EQ(immediate.get_future().wait_for(kSleep / 2),
+            std::future_status::ready);
+
+  ASSERT_EQ(done.get_future().wait_for(milliseconds(kMaxWaitMs)),
+            std::future_status::ready);
+  EXPECT_GE(steady_clock::now() - start, 2 * kSleep);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_THAT(order, ElementsAre(1, 2, 3));
+}
+
+TEST(ThreadPoolTaskSchedulerTest, DelayedTasksDroppedOnDestruction) {
+  SCOPED_TRACE("Waiting delayed tasks are dropped by the destructor");
+
+  std::atomic_bool executed{false};
+  {
+    ThreadPool thread_pool(1u);
+    thread_pool.ScheduleDelayedTask([&]() { executed = true; },
+                                    milliseconds(kMaxWaitMs));
+  }
+  EXPECT_FALSE(executed);
+}
+
+namespace {
+// Uses the timer of the TaskScheduler base class for the delayed tasks.
+class InlineTaskScheduler : public TaskScheduler {
+ protected:
+  void EnqueueTask(CallFuncType&& func) override { func(); }
+};
+}  // namespace
+
+TEST(TaskSchedulerTest, DefaultDelayedTasks) {
+  auto scheduler = std::make_shared<InlineTaskScheduler>();
+
+  auto dropped = std::make_shared<int>(0);
+  std::weak_ptr<int> weak_dropped = dropped;
+  scheduler->ScheduleDelayedTask([dropped]() { ADD_FAILURE(); },
+                                 milliseconds(kMaxWaitMs));
+  dropped.reset();
+
+  // A task can release the last reference to its scheduler, which drops
+  // the other waiting tasks.
+  std::promise<void> done;
+  scheduler->ScheduleDelayedTask(
+      [&]() {
+        scheduler.reset();
+        EXPECT_TRUE(weak_dropped.expired());
+        done.set_value();
+      },
+      kSleep);
+
+  ASSERT_EQ(done.get_future().wait_for(milliseconds(kMaxWaitMs)),
+            std::future_status::ready);
+  EXPECT_TRUE(weak_dropped.expired());
+}
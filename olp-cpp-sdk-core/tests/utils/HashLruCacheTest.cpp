@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <olp/core/utils/HashLruCache.h>
+
+namespace {
+using Cache = olp::utils::HashLruCache<std::string, int>;
+using OrderedCache =
+    olp::utils::HashLruCache<std::string, int, olp::utils::CacheCost<int>,
+                             std::hash<std::string>,
+                             std::equal_to<std::string>, true>;
+
+template <typename CacheType>
+std::vector<std::string> Keys(const CacheType& cache) {
+  std::vector<std::string> keys;
+  for (const auto& item : cache) {
+    keys.push_back(item.key());
+  }
+  return keys;
+}
+
+TEST(HashLruCacheTest, InsertAndFind) {
+  Cache cache(10);
+  EXPECT_TRUE(cache.Insert("key1", 1).second);
+  EXPECT_TRUE(cache.Insert("key2", 2).second);
+
+  // Insert does not update the existing value.
+  auto result = cache.Insert("key1", 10);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(1, result.first.value());
+
+  // InsertOrAssign does.
+  result = cache.InsertOrAssign("key2", 20);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(20, result.first.value());
+
+  EXPECT_EQ(2u, cache.Size());
+  EXPECT_EQ(20, cache.Find("key2", 0));
+  EXPECT_EQ(0, cache.Find("key3", 0));
+  EXPECT_TRUE(cache.FindNoPromote("key3") == cache.end());
+
+  EXPECT_TRUE(cache.Erase("key1"));
+  EXPECT_FALSE(cache.Erase("key1"));
+  EXPECT_EQ(1u, cache.Size());
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.Size());
+  EXPECT_TRUE(cache.begin() == cache.end());
+  EXPECT_TRUE(cache.FindNoPromote("key2") == cache.end());
+}
+
+TEST(HashLruCacheTest, LruOrderAndEviction) {
+  Cache cache(3);
+  std::vector<std::string> evicted;
+  cache.SetEvictionCallback(
+      [&](const std::string& key, int&&) { evicted.push_back(key); });
+
+  cache.Insert("key1", 1);
+  cache.Insert("key2", 2);
+  cache.Insert("key3", 3);
+  EXPECT_EQ((std::vector<std::string>{"key3", "key2", "key1"}), Keys(cache));
+
+  // Find promotes, FindNoPromote does not.
+  cache.Find("key1");
+  cache.FindNoPromote("key2");
+  EXPECT_EQ((std::vector<std::string>{"key1", "key3", "key2"}), Keys(cache));
+
+  cache.Insert("key4", 4);
+  EXPECT_EQ((std::vector<std::string>{"key2"}), evicted);
+  EXPECT_EQ((std::vector<std::string>{"key4", "key1", "key3"}), Keys(cache));
+
+  // Erase does not call the eviction callback.
+  cache.Erase("key1");
+  EXPECT_EQ(1u, evicted.size());
+
+  cache.Resize(1);
+  EXPECT_EQ((std::vector<std::string>{"key2", "key3"}), evicted);
+  EXPECT_EQ((std::vector<std::string>{"key4"}), Keys(cache));
+
+  // The reverse iteration follows the LRU chain back.
+  auto it = cache.end();
+  --it;
+  EXPECT_EQ("key4", it->key());
+}
+
+TEST(HashLruCacheTest, ManyItems) {
+  const int count = 10000;
+  Cache cache(count / 2);
+  for (int i = 0; i < count; ++i) {
+    cache.InsertOrAssign(std::to_string(i), i);
+  }
+  EXPECT_EQ(static_cast<size_t>(count / 2), cache.Size());
+
+  // Erase every other key, so the probing chains are shifted back.
+  for (int i = count / 2; i < count; i += 2) {
+    EXPECT_TRUE(cache.Erase(std::to_string(i)));
+  }
+
+  for (int i = 0; i < count; ++i) {
+    const auto it = cache.FindNoPromote(std::to_string(i));
+    const bool expected = i >= count / 2 && (i - count / 2) % 2 == 1;
+    ASSERT_EQ(expected, it != cache.end()) << i;
+    if (expected) {
+      EXPECT_EQ(i, it->value());
+    }
+  }
+
+  // The erased nodes are reused.
+  for (int i = 0; i < count / 4; ++i) {
+    cache.InsertOrAssign("new" + std::to_string(i), i);
+  }
+  EXPECT_EQ(static_cast<size_t>(count / 2), cache.Size());
+}
+
+TEST(HashLruCacheTest, EraseWhile) {
+  OrderedCache cache(100);
+  cache.Insert("a::1", 1);
+  cache.Insert("b::1", 2);
+  cache.Insert("b::2", 3);
+  cache.Insert("b", 4);
+  cache.Insert("c::1", 5);
+
+  const std::string prefix = "b::";
+  const auto erased = cache.EraseWhile(prefix, [&](const std::string& key) {
+    return key.compare(0, prefix.size(), prefix) == 0;
+  });
+  EXPECT_EQ(2u, erased);
+  EXPECT_EQ((std::vector<std::string>{"c::1", "b", "a::1"}), Keys(cache));
+
+  cache.Insert("b::3", 6);
+  EXPECT_EQ(6, cache.Find("b::3", 0));
+}
+}  // namespace
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <olp/dataservice/read/DataServiceReadApi.h>
+
+namespace olp {
+namespace dataservice {
+namespace read {
+
+/**
+ * @brief The counters of the requests that reached the network stage of
+ * the fetch.
+ *
+ * The concurrent requests for the same resource share one network request
+ * and one parse of the response. The requests served by the cache are not
+ * counted.
+ */
+struct DATASERVICE_READ_API CoalescingCounters {
+  /// The requests that needed the network.
+  std::uint64_t requests = 0u;
+  /// The requests that joined a network request of another identical
+  /// request instead of sending their own.
+  std::uint64_t coalesced = 0u;
+
+  /**
+   * @brief Gets the share of the requests that did not send their own
+   * network request.
+   *
+   * @return The ratio from 0 to 1, or zero if no requests are counted.
+   */
+  double DeduplicationRatio() const {
+    return requests == 0u ? 0.0 : static_cast<double>(coalesced) / requests;
+  }
+};
+
+/**
+ * @brief The snapshot of the request coalescing statistics of all
+ * the layer clients.
+ */
+struct DATASERVICE_READ_API CoalescingStatistics {
+  /// The data blob requests of the versioned and volatile layers.
+  CoalescingCounters data;
+  /// The partition metadata requests, including the partition lookups by
+  /// `GetData`.
+  CoalescingCounters partitions;
+};
+
+/**
+ * @brief Gets the request coalescing statistics collected since the process
+ * started or the statistics were reset.
+ *
+ * @return The statistics snapshot.
+ */
+DATASERVICE_READ_API CoalescingStatistics GetCoalescingStatistics();
+
+/**
+ * @brief Resets the request coalescing statistics to zero.
+ */
+DATASERVICE_READ_API void ResetCoalescingStatistics();
+
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
@@ -19,9 +19,11 @@
 
 #pragma once
 
+#include <cstdint>
 #include <sstream>
 #include <string>
 
+#include <olp/core/thread/Priority.h>
 #include <olp/dataservice/read/DataServiceReadApi.h>
 #include <olp/dataservice/read/FetchOptions.h>
 #include <boost/optional.hpp>
@@ -220,6 +222,99 @@ class DATASERVICE_READ_API DataRequest final {
     return *this;
   }
 
+  /**
+   * @brief Gets the priority of the request.
+   *
+   * The tasks and the network requests with a higher priority are served
+   * first. The default priority is `olp::thread::NORMAL`.
+   *
+   * @return The request priority.
+   */
+  inline std::uint32_t GetPriority() const { return priority_; }
+
+  /**
+   * @brief Sets the priority of the request.
+   *
+   * @see `GetPriority()` for information on usage.
+   *
+   * @param priority The request priority, see `olp::thread::Priority`.
+   *
+   * @return A reference to the updated `DataRequest` instance.
+   */
+  inline DataRequest& WithPriority(std::uint32_t priority) {
+    priority_ = priority;
+    return *this;
+  }
+
+  /**
+   * @brief Gets the size of the byte ranges in which the data is downloaded.
+   *
+   * If set, the data blob of a versioned layer is downloaded in byte ranges of
+   * this size, up to `GetMaxParallelDownloads()` ranges at once. A range that
+   * fails with a network error is resumed from the last received byte, so
+   * the download of a large blob does not restart from the beginning. Use it
+   * for large blobs, especially on links with a high latency. The size of
+   * the blob does not have to be known in advance.
+   *
+   * The data of the volatile layers is always downloaded in one request, as
+   * is the data that the server sends without the byte ranges.
+   *
+   * @return The range size in bytes, or `boost::none` if the data is
+   * downloaded in one request.
+   */
+  inline const boost::optional<std::uint64_t>& GetDownloadChunkSize() const {
+    return download_chunk_size_;
+  }
+
+  /**
+   * @brief Sets the size of the byte ranges in which the data is downloaded.
+   *
+   * @see `GetDownloadChunkSize()` for information on usage.
+   *
+   * @param chunk_size The range size in bytes, or `boost::none` to download
+   * the data in one request. Must not be zero.
+   *
+   * @return A reference to the updated `DataRequest` instance.
+   */
+  inline DataRequest& WithDownloadChunkSize(
+      boost::optional<std::uint64_t> chunk_size) {
+    download_chunk_size_ = chunk_size;
+    return *this;
+  }
+
+  /**
+   * @brief Gets the maximum number of the byte ranges that are downloaded at
+   * once.
+   *
+   * The ranges are downloaded in parallel on the task scheduler of the client
+   * settings. Without the task scheduler, they are downloaded one by one.
+   * The default value is 4.
+   *
+   * @see `GetDownloadChunkSize()` for information on the ranged downloads.
+   *
+   * @return The maximum number of the parallel downloads.
+   */
+  inline std::uint32_t GetMaxParallelDownloads() const {
+    return max_parallel_downloads_;
+  }
+
+  /**
+   * @brief Sets the maximum number of the byte ranges that are downloaded at
+   * once.
+   *
+   * @see `GetMaxParallelDownloads()` for information on usage.
+   *
+   * @param max_parallel_downloads The maximum number of the parallel
+   * downloads.
+   *
+   * @return A reference to the updated `DataRequest` instance.
+   */
+  inline DataRequest& WithMaxParallelDownloads(
+      std::uint32_t max_parallel_downloads) {
+    max_parallel_downloads_ = max_parallel_downloads;
+    return *this;
+  }
+
   /**
    * @brief Creates a readable format for the request.
    *
@@ -252,6 +347,9 @@ class DATASERVICE_READ_API DataRequest final {
   boost::optional<std::string> data_handle_;
   boost::optional<std::string> billing_tag_;
   FetchOptions fetch_option_{OnlineIfNotFound};
+  std::uint32_t priority_{thread::NORMAL};
+  boost::optional<std::uint64_t> download_chunk_size_;
+  std::uint32_t max_parallel_downloads_{4u};
 };
 
 }  // namespace read
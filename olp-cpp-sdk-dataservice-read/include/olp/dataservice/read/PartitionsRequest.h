@@ -22,6 +22,7 @@
 #include <sstream>
 #include <string>
 
+#include <olp/core/thread/Priority.h>
 #include <olp/dataservice/read/DataServiceReadApi.h>
 #include <olp/dataservice/read/FetchOptions.h>
 #include <boost/optional.hpp>
@@ -129,6 +130,30 @@ class DATASERVICE_READ_API PartitionsRequest final {
     return *this;
   }
 
+  /**
+   * @brief Gets the priority of the request.
+   *
+   * The tasks and the network requests with a higher priority are served
+   * first. The default priority is `olp::thread::NORMAL`.
+   *
+   * @return The request priority.
+   */
+  inline std::uint32_t GetPriority() const { return priority_; }
+
+  /**
+   * @brief Sets the priority of the request.
+   *
+   * @see `GetPriority()` for information on usage.
+   *
+   * @param priority The request priority, see `olp::thread::Priority`.
+   *
+   * @return A reference to the updated `PartitionsRequest` instance.
+   */
+  inline PartitionsRequest& WithPriority(std::uint32_t priority) {
+    priority_ = priority;
+    return *this;
+  }
+
   /**
    * @brief Creates a readable format for the request.
    *
@@ -153,6 +178,7 @@ class DATASERVICE_READ_API PartitionsRequest final {
   boost::optional<int64_t> catalog_version_;
   boost::optional<std::string> billing_tag_;
   FetchOptions fetch_option_{OnlineIfNotFound};
+  std::uint32_t priority_{thread::NORMAL};
 };
 
 }  // namespace read
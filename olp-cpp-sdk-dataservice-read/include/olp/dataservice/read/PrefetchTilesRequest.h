@@ -24,6 +24,7 @@
 #include <vector>
 
 #include <olp/core/geo/tiling/TileKey.h>
+#include <olp/core/thread/Priority.h>
 #include <olp/dataservice/read/DataServiceReadApi.h>
 #include <boost/optional.hpp>
 
@@ -182,6 +183,31 @@ class DATASERVICE_READ_API PrefetchTilesRequest final {
     return *this;
   }
 
+  /**
+   * @brief Gets the priority of the request.
+   *
+   * The tasks and the network requests with a higher priority are served
+   * first. The prefetch is a background
+   * work, so the default priority is `olp::thread::LOW`.
+   *
+   * @return The request priority.
+   */
+  inline std::uint32_t GetPriority() const { return priority_; }
+
+  /**
+   * @brief Sets the priority of the request.
+   *
+   * @see `GetPriority()` for information on usage.
+   *
+   * @param priority The request priority, see `olp::thread::Priority`.
+   *
+   * @return A reference to the updated `PrefetchTilesRequest` instance.
+   */
+  inline PrefetchTilesRequest& WithPriority(std::uint32_t priority) {
+    priority_ = priority;
+    return *this;
+  }
+
   /**
    * @brief Creates a readable format for the request.
    *
@@ -209,6 +235,7 @@ class DATASERVICE_READ_API PrefetchTilesRequest final {
   unsigned int max_level_{0};
   boost::optional<int64_t> catalog_version_;
   boost::optional<std::string> billing_tag_;
+  std::uint32_t priority_{thread::LOW};
 };
 
 }  // namespace read
@@ -19,6 +19,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 
 #include <olp/core/client/ApiError.h>
@@ -72,6 +75,17 @@ using DataResponse = Response<DataResult>;
 /// The callback type of the data response.
 using DataResponseCallback = Callback<DataResult>;
 
+/// The callback type of the streamed data chunks, it receives the chunk,
+/// the offset of the chunk in the data, and the chunk size.
+using DataChunkCallback = std::function<void(
+    const std::uint8_t* data, std::uint64_t offset, std::size_t size)>;
+/// The size of the streamed data in bytes.
+using DataStreamResult = std::uint64_t;
+/// The streamed data response type.
+using DataStreamResponse = Response<DataStreamResult>;
+/// The callback type of the streamed data response.
+using DataStreamResponseCallback = Callback<DataStreamResult>;
+
 /// The alias of the prefetch tiles result.
 using PrefetchTilesResult = std::vector<std::shared_ptr<PrefetchTileResult>>;
 /// The prefetch tiles response type.
@@ -157,6 +157,43 @@ class DATASERVICE_READ_API VersionedLayerClient final {
    */
   client::CancellableFuture<DataResponse> GetData(DataRequest data_request);
 
+  /**
+   * @brief Fetches data asynchronously using a partition ID or data handle,
+   * and passes it to the chunk callback chunk by chunk, as it is received.
+   *
+   * Use it for large data that should be processed or written to a file
+   * while it is downloaded, without keeping the whole data in memory. Every
+   * chunk is passed with its offset in the data. If the download is retried,
+   * it starts again at the offset zero, so write the chunks at their offsets
+   * and use the data only if the callback receives a successful response.
+   * The downloaded data is passed on the network thread, the data found in
+   * the cache on the thread that runs the request, and the byte ranges
+   * described below on that thread and on the task scheduler threads.
+   *
+   * If `DataRequest::GetDownloadChunkSize` is set, the data is downloaded in
+   * byte ranges, and every range is passed in one chunk once it is complete.
+   * The ranges may come in any order, but the chunk callback is not called
+   * concurrently, and a resumed range is not passed again.
+   *
+   * The data found in the cache is passed in one chunk. The downloaded data
+   * is not stored in the cache, so the `CacheWithUpdate` fetch option is not
+   * supported.
+   *
+   * @param data_request The `DataRequest` instance that contains a complete set
+   * of request parameters.
+   * @note The `GetLayerId` value of the \c DataRequest object is ignored, and
+   * the parameter from the constructor is used instead.
+   * @param chunk_callback The `DataChunkCallback` object that receives
+   * the chunks of the data.
+   * @param callback The `DataStreamResponseCallback` object that is invoked
+   * with the size of the data when all of it is received, or with an error.
+   *
+   * @return A token that can be used to cancel this request.
+   */
+  client::CancellationToken GetData(DataRequest data_request,
+                                    DataChunkCallback chunk_callback,
+                                    DataStreamResponseCallback callback);
+
   /**
    * @brief Fetches a list of partitions of the given generic layer
    * asynchronously.
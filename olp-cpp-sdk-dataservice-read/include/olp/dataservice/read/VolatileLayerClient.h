@@ -111,6 +111,11 @@ class DATASERVICE_READ_API VolatileLayerClient final {
    * partition IDs, then this operation can fail because of the large amount of
    * data.
    *
+   * When the list of partitions is requested online, and it is still in
+   * the cache or has expired less than a day ago, the list is revalidated
+   * with its `ETag` or `Last-Modified` header. The unchanged list is not
+   * downloaded again, and its expiry time is renewed.
+   *
    * @param request The `PartitionsRequest` instance that contains a complete
    * set of request parameters.
    * @param callback The `PartitionsResponseCallback` object that is invoked if
@@ -175,6 +180,35 @@ class DATASERVICE_READ_API VolatileLayerClient final {
    */
   olp::client::CancellableFuture<DataResponse> GetData(DataRequest request);
 
+  /**
+   * @brief Fetches data asynchronously using a partition ID or data handle,
+   * and passes it to the chunk callback chunk by chunk, as it is received.
+   *
+   * Use it for large data that should be processed or written to a file
+   * while it is downloaded, without keeping the whole data in memory. Every
+   * chunk is passed with its offset in the data. If the download is retried,
+   * it starts again at the offset zero, so write the chunks at their offsets
+   * and use the data only if the callback receives a successful response.
+   * The downloaded data is passed on the network thread, and the data found
+   * in the cache on the thread that runs the request.
+   *
+   * The data found in the cache is passed in one chunk. The downloaded data
+   * is not stored in the cache, so the `CacheWithUpdate` fetch option is not
+   * supported.
+   *
+   * @param request The `DataRequest` instance that contains a complete set of
+   * request parameters.
+   * @param chunk_callback The `DataChunkCallback` object that receives
+   * the chunks of the data.
+   * @param callback The `DataStreamResponseCallback` object that is invoked
+   * with the size of the data when all of it is received, or with an error.
+   *
+   * @return A token that can be used to cancel this request.
+   */
+  olp::client::CancellationToken GetData(DataRequest request,
+                                         DataChunkCallback chunk_callback,
+                                         DataStreamResponseCallback callback);
+
  private:
   std::unique_ptr<VolatileLayerClientImpl> impl_;
 };
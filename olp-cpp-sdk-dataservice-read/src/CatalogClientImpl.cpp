@@ -73,7 +73,7 @@ CancellationToken CatalogClientImpl::GetCatalog(
           std::move(settings));
     };
 
-    return AddTask(task_scheduler_, pending_requests_,
+    return AddTask(task_scheduler_, pending_requests_, thread::NORMAL,
                    std::move(get_catalog_task), std::move(callback));
   };
 
@@ -106,7 +106,7 @@ CancellationToken CatalogClientImpl::GetLatestVersion(
           std::move(settings));
     };
 
-    return AddTask(task_scheduler_, pending_requests_,
+    return AddTask(task_scheduler_, pending_requests_, thread::NORMAL,
                    std::move(get_latest_version_task), std::move(callback));
   };
 
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "olp/dataservice/read/CoalescingStatistics.h"
+
+#include "repositories/DataRepository.h"
+#include "repositories/PartitionsRepository.h"
+#include "repositories/SingleFlight.h"
+
+namespace olp {
+namespace dataservice {
+namespace read {
+
+CoalescingStatistics GetCoalescingStatistics() {
+  CoalescingStatistics statistics;
+  statistics.data = repository::DataRepository::GetBlobFlights().GetCounters();
+  statistics.partitions =
+      repository::PartitionsRepository::GetPartitionsFlights().GetCounters();
+  return statistics;
+}
+
+void ResetCoalescingStatistics() {
+  repository::DataRepository::GetBlobFlights().ResetCounters();
+  repository::PartitionsRepository::GetPartitionsFlights().ResetCounters();
+}
+
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
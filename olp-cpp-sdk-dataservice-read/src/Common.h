@@ -68,6 +68,7 @@ inline client::CancellationToken ScheduleFetch(TaskScheduler&& schedule_task,
  * @param task_scheduler Task scheduler instance.
  * @param pending_requests PendingRequests instance that tracks current
  * requests.
+ * @param priority The priority of the task, see `olp::thread::Priority`.
  * @param task Function that will be executed.
  * @param callback Function that will consume task output.
  * @param args Additional agrs to pass to TaskContext.
@@ -77,15 +78,19 @@ template <typename Function, typename Callback, typename... Args>
 inline client::CancellationToken AddTask(
     const std::shared_ptr<thread::TaskScheduler>& task_scheduler,
     const std::shared_ptr<client::PendingRequests>& pending_requests,
-    Function task, Callback callback, Args&&... args) {
+    std::uint32_t priority, Function task, Callback callback,
+    Args&&... args) {
   auto context = client::TaskContext::Create(
       std::move(task), std::move(callback), std::forward<Args>(args)...);
   pending_requests->Insert(context);
 
-  repository::ExecuteOrSchedule(task_scheduler, [=] {
-    context.Execute();
-    pending_requests->Remove(context);
-  });
+  repository::ExecuteOrSchedule(
+      task_scheduler,
+      [=] {
+        context.Execute();
+        pending_requests->Remove(context);
+      },
+      priority);
 
   return context.CancelToken();
 }
@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "RangedDownload.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <olp/core/client/Condition.h>
+#include <olp/core/client/HttpResponse.h>
+#include <olp/core/http/HttpStatusCode.h>
+#include <olp/core/logging/Log.h>
+#include <olp/core/thread/TaskScheduler.h>
+
+namespace olp {
+namespace dataservice {
+namespace read {
+
+namespace {
+constexpr auto kLogTag = "RangedDownload";
+
+using ChunkResponse = client::ApiResponse<std::uint64_t, client::ApiError>;
+
+// Waits for the backdown period, the cancellation interrupts the wait.
+// Returns false if the download is cancelled.
+bool WaitForBackdown(client::CancellationContext& context,
+                     std::chrono::milliseconds period) {
+  auto condition = std::make_shared<client::Condition>();
+  const bool executed = context.ExecuteOrCancelled([&]() {
+    return client::CancellationToken([condition]() { condition->Notify(); });
+  });
+  if (!executed) {
+    return false;
+  }
+
+  condition->Wait(period);
+  return !context.IsCancelled();
+}
+
+class Download {
+ public:
+  Download(RangedDownload::RangeRequest request, std::uint64_t chunk_size,
+           DataChunkCallback sink, RangedDownload::SizeCallback size_callback,
+           client::RetrySettings retry_settings)
+      : request_(std::move(request)),
+        chunk_size_(chunk_size),
+        sink_(std::move(sink)),
+        size_callback_(std::move(size_callback)),
+        retry_settings_(std::move(retry_settings)) {}
+
+  // Takes the next range and downloads it until no ranges are left.
+  void Work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!finished_ && !error_ && next_chunk_ < end_chunk_) {
+      const auto index = next_chunk_++;
+      auto context = contexts_.emplace(contexts_.end());
+      ++active_workers_;
+      lock.unlock();
+
+      auto response = DownloadChunk(index, *context);
+
+      lock.lock();
+      contexts_.erase(context);
+      --active_workers_;
+      if (!response.IsSuccessful()) {
+        if (!error_) {
+          error_ = response.GetError();
+        }
+        lock.unlock();
+        CancelChunks();
+        lock.lock();
+      } else if (response.GetResult() == 0u) {
+        // The range is past the end of the blob.
+        end_chunk_ = std::min(end_chunk_, index);
+      } else {
+        const auto size = response.GetResult();
+        size_ = std::max(size_, index * chunk_size_ + size);
+        if (size < chunk_size_) {
+          // Only the last range is shorter than requested.
+          end_chunk_ = std::min(end_chunk_, index + 1u);
+        }
+      }
+      condition_.notify_all();
+    }
+  }
+
+  // Waits for the ranges that are being downloaded, and stops the download.
+  DataStreamResponse Finish() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [&]() { return active_workers_ == 0u; });
+    finished_ = true;
+    if (error_) {
+      return *error_;
+    }
+    return size_;
+  }
+
+  void Cancel() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (finished_) {
+        return;
+      }
+      if (!error_) {
+        error_ = client::ApiError(client::ErrorCode::Cancelled, "Cancelled");
+      }
+    }
+    CancelChunks();
+  }
+
+ private:
+  void CancelChunks() {
+    std::vector<client::CancellationContext> contexts;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      contexts.assign(contexts_.begin(), contexts_.end());
+    }
+    for (auto& context : contexts) {
+      context.CancelOperation();
+    }
+  }
+
+  // Downloads the range and passes it to the sink. Returns the size of
+  // the range, zero if the range is past the end of the blob.
+  ChunkResponse DownloadChunk(std::uint64_t index,
+                              client::CancellationContext context) {
+    const auto begin = index * chunk_size_;
+    const auto last = begin + chunk_size_ - 1u;
+    auto backdown_period =
+        std::chrono::milliseconds(retry_settings_.initial_backdown_period);
+    std::vector<std::uint8_t> chunk;
+    std::uint64_t blob_size = 0u;
+
+    for (int attempt = 0;; ++attempt) {
+      const auto resumed_size = chunk.size();
+      // Keeps the memory bounded if the server sends more than the range,
+      // most likely the whole blob, and stops the transfer right away.
+      bool overflow = false;
+      auto response = request_(
+          "bytes=" + std::to_string(begin + resumed_size) + "-" +
+              std::to_string(last),
+          [&](const std::uint8_t* data, std::uint64_t, std::size_t length) {
+            if (overflow) {
+              return;
+            }
+            const auto size =
+                std::min<std::uint64_t>(length, chunk_size_ - chunk.size());
+            chunk.insert(chunk.end(), data, data + size);
+            if (size < length) {
+              overflow = true;
+              context.CancelOperation();
+            }
+          },
+          context);
+      if (overflow) {
+        return client::ApiError(http::HttpStatusCode::PARTIAL_CONTENT,
+                                "The byte range is ignored by the server");
+      }
+      if (response.IsSuccessful()) {
+        blob_size = response.GetResult();
+        break;
+      }
+
+      const auto& error = response.GetError();
+      const auto status = error.GetHttpStatusCode();
+      if (RangedDownload::IsRangeIgnored(error)) {
+        // The received data is not the requested range, so it is never
+        // appended to the resumed range.
+        return error;
+      }
+      if (status == http::HttpStatusCode::REQUESTED_RANGE_NOT_SATISFIABLE) {
+        // The range starts at the end of the blob or past it.
+        break;
+      }
+
+      // The transfer that was broken after receiving some data is resumed
+      // even if the retry condition does not cover the network errors.
+      const bool progressed = chunk.size() > resumed_size;
+      if (context.IsCancelled() || attempt >= retry_settings_.max_attempts ||
+          !(progressed ||
+            retry_settings_.retry_condition(client::HttpResponse(status)))) {
+        return error;
+      }
+
+      OLP_SDK_LOG_DEBUG_F(
+          kLogTag, "Range %llu failed with status %d, resuming at byte %llu",
+          static_cast<unsigned long long>(index), status,
+          static_cast<unsigned long long>(begin + chunk.size()));
+
+      if (!WaitForBackdown(context, backdown_period)) {
+        return client::ApiError(client::ErrorCode::Cancelled, "Cancelled");
+      }
+      if (retry_settings_.backdown_policy) {
+        backdown_period = std::chrono::milliseconds(
+            retry_settings_.backdown_policy(
+                static_cast<int>(backdown_period.count())));
+      }
+    }
+
+    if (blob_size > 0u) {
+      // The ranges past the end of the blob are not requested.
+      std::lock_guard<std::mutex> lock(mutex_);
+      end_chunk_ =
+          std::min(end_chunk_, (blob_size + chunk_size_ - 1u) / chunk_size_);
+    }
+
+    std::lock_guard<std::mutex> lock(sink_mutex_);
+    if (blob_size > 0u && !size_passed_) {
+      size_passed_ = true;
+      if (size_callback_) {
+        size_callback_(blob_size);
+      }
+    }
+    if (!chunk.empty()) {
+      sink_(chunk.data(), begin, chunk.size());
+    }
+    return chunk.size();
+  }
+
+  const RangedDownload::RangeRequest request_;
+  const std::uint64_t chunk_size_;
+  const DataChunkCallback sink_;
+  const RangedDownload::SizeCallback size_callback_;
+  const client::RetrySettings retry_settings_;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::list<client::CancellationContext> contexts_;
+  std::uint64_t next_chunk_{0u};
+  std::uint64_t end_chunk_{std::numeric_limits<std::uint64_t>::max()};
+  std::uint64_t size_{0u};
+  size_t active_workers_{0u};
+  bool finished_{false};
+  boost::optional<client::ApiError> error_;
+
+  std::mutex sink_mutex_;
+  bool size_passed_{false};
+};
+}  // namespace
+
+DataStreamResponse RangedDownload::Run(
+    RangeRequest request, std::uint64_t chunk_size,
+    std::uint32_t max_parallel_downloads, DataChunkCallback sink,
+    const client::OlpClientSettings& settings, std::uint32_t priority,
+    client::CancellationContext context, SizeCallback size_callback) {
+  if (chunk_size == 0u) {
+    return client::ApiError(client::ErrorCode::InvalidArgument,
+                            "The download chunk size is zero");
+  }
+
+  auto download = std::make_shared<Download>(
+      std::move(request), chunk_size, std::move(sink),
+      std::move(size_callback), settings.retry_settings);
+
+  const bool executed = context.ExecuteOrCancelled([&]() {
+    return client::CancellationToken([download]() { download->Cancel(); });
+  });
+  if (!executed) {
+    return client::ApiError(client::ErrorCode::Cancelled, "Cancelled");
+  }
+
+  // The calling thread downloads the ranges too, so the download is finished
+  // even if the scheduled tasks do not start in time.
+  if (settings.task_scheduler) {
+    for (std::uint32_t i = 1u; i < max_parallel_downloads; ++i) {
+      settings.task_scheduler->ScheduleTask([download]() { download->Work(); },
+                                            priority);
+    }
+  }
+
+  download->Work();
+  return download->Finish();
+}
+
+bool RangedDownload::IsRangeIgnored(const client::ApiError& error) {
+  const auto status = error.GetHttpStatusCode();
+  return status == http::HttpStatusCode::OK ||
+         status == http::HttpStatusCode::PARTIAL_CONTENT;
+}
+
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
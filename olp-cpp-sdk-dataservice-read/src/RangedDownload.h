@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <olp/core/client/CancellationContext.h>
+#include <olp/core/client/OlpClientSettings.h>
+#include <olp/core/http/Network.h>
+#include "generated/api/BlobApi.h"
+#include "olp/dataservice/read/Types.h"
+
+namespace olp {
+namespace dataservice {
+namespace read {
+
+/// Downloads a blob in byte ranges of a fixed size, several ranges at once.
+///
+/// The size of the blob is not needed: the ranges are requested one after
+/// another until a range comes back shorter than requested, or is rejected
+/// as past the end of the blob, or until the size of the blob is known from
+/// the response to a range. A range that fails with a network error after
+/// receiving a part of its data is resumed from the last received byte.
+///
+/// If the server ignores the byte ranges, the download fails with the error
+/// for which `IsRangeIgnored` returns true, and the blob should be
+/// downloaded in one request instead.
+class RangedDownload final {
+ public:
+  /// Requests the given byte range, for example, `bytes=0-1023`, and passes
+  /// the received data to the callback. Must not retry the request. Returns
+  /// the size of the blob, zero if it is unknown, or an error with
+  /// a successful HTTP status if the response is not the requested range,
+  /// see `BlobApi::StreamBlob`.
+  using RangeRequest = std::function<BlobApi::StreamResponse(
+      const std::string& range, http::Network::DataCallback data_callback,
+      client::CancellationContext context)>;
+
+  /// Receives the size of the blob.
+  using SizeCallback = std::function<void(std::uint64_t size)>;
+
+  /// Downloads the blob.
+  ///
+  /// The calling thread downloads the ranges, and the other ranges are
+  /// downloaded by the tasks scheduled on `settings.task_scheduler`.
+  ///
+  /// @param request Requests a byte range of the blob.
+  /// @param chunk_size The size of the ranges.
+  /// @param max_parallel_downloads The maximum number of the ranges that are
+  /// downloaded at once.
+  /// @param sink Receives every range once it is complete, in any order, with
+  /// the offset of the range in the blob. Not called concurrently.
+  /// @param settings The task scheduler and the retry settings.
+  /// @param priority The priority of the scheduled tasks.
+  /// @param context Cancels the download.
+  /// @param size_callback Receives the size of the blob once it is known from
+  /// the response to a range, before the range is passed to the sink. Not
+  /// called if the size is unknown. Can be null.
+  ///
+  /// @return The size of the blob or an error.
+  static DataStreamResponse Run(RangeRequest request, std::uint64_t chunk_size,
+                                std::uint32_t max_parallel_downloads,
+                                DataChunkCallback sink,
+                                const client::OlpClientSettings& settings,
+                                std::uint32_t priority,
+                                client::CancellationContext context,
+                                SizeCallback size_callback = nullptr);
+
+  /// Checks whether the range request failed because the server did not send
+  /// the requested range, for example, it sent the whole blob with the status
+  /// 200.
+  static bool IsRangeIgnored(const client::ApiError& error);
+};
+
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "ResponseValidator.h"
+
+#include <cctype>
+
+#include <olp/core/client/HttpResponse.h>
+#include <olp/core/http/NetworkConstants.h>
+
+namespace olp {
+namespace dataservice {
+namespace read {
+
+namespace {
+// The header values can not contain the line breaks.
+constexpr char kSeparator = '\n';
+
+bool EqualsIgnoreCase(const std::string& lhs, const char* rhs) {
+  size_t i = 0;
+  for (; i < lhs.size() && rhs[i] != '\0'; ++i) {
+    if (std::tolower(static_cast<unsigned char>(lhs[i])) !=
+        std::tolower(static_cast<unsigned char>(rhs[i]))) {
+      return false;
+    }
+  }
+  return i == lhs.size() && rhs[i] == '\0';
+}
+}  // namespace
+
+boost::optional<ResponseValidator> ResponseValidator::FromResponse(
+    const client::HttpResponse& response) {
+  ResponseValidator validator;
+  for (const auto& header : response.headers) {
+    if (EqualsIgnoreCase(header.first, http::kETagHeader)) {
+      validator.etag = header.second;
+    } else if (EqualsIgnoreCase(header.first, http::kLastModifiedHeader)) {
+      validator.last_modified = header.second;
+    }
+  }
+
+  if (validator.Empty()) {
+    return boost::none;
+  }
+  return validator;
+}
+
+boost::optional<ResponseValidator> ResponseValidator::Decode(
+    const std::string& value) {
+  const auto etag_end = value.find(kSeparator);
+  if (etag_end == std::string::npos ||
+      value.find(kSeparator, etag_end + 1) != std::string::npos) {
+    return boost::none;
+  }
+
+  ResponseValidator validator;
+  validator.etag = value.substr(0, etag_end);
+  validator.last_modified = value.substr(etag_end + 1);
+  return validator;
+}
+
+std::string ResponseValidator::Encode() const {
+  std::string value;
+  value.reserve(etag.size() + last_modified.size() + 1u);
+  value.append(etag).push_back(kSeparator);
+  value.append(last_modified);
+  return value;
+}
+
+void ResponseValidator::AddConditionalHeaders(
+    std::multimap<std::string, std::string>& header_params) const {
+  if (!etag.empty()) {
+    header_params.emplace(http::kIfNoneMatchHeader, etag);
+  }
+  if (!last_modified.empty()) {
+    header_params.emplace(http::kIfModifiedSinceHeader, last_modified);
+  }
+}
+
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
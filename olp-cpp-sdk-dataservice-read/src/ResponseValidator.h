@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <boost/optional.hpp>
+
+namespace olp {
+namespace client {
+class HttpResponse;
+}
+
+namespace dataservice {
+namespace read {
+
+/// The validator of a cached response: its `ETag` and `Last-Modified`
+/// headers.
+///
+/// The validator is sent back in the conditional request headers, so
+/// the server answers `304 Not Modified` without the body if the resource is
+/// unchanged, and the cached entry is kept instead.
+struct ResponseValidator {
+  /// Gets the validator of the successful response.
+  ///
+  /// @param response The response with the headers.
+  ///
+  /// @return The validator, or `boost::none` if the response has neither
+  /// the `ETag` nor the `Last-Modified` header.
+  static boost::optional<ResponseValidator> FromResponse(
+      const client::HttpResponse& response);
+
+  /// Decodes the validator stored in the cache.
+  ///
+  /// @param value The value returned by `Encode`.
+  ///
+  /// @return The validator, or `boost::none` if the value is malformed.
+  static boost::optional<ResponseValidator> Decode(const std::string& value);
+
+  /// Checks whether the validator has neither the `ETag` nor
+  /// the `Last-Modified` value.
+  bool Empty() const { return etag.empty() && last_modified.empty(); }
+
+  /// Encodes the validator to be stored in the cache.
+  std::string Encode() const;
+
+  /// Adds the `If-None-Match` and the `If-Modified-Since` headers.
+  void AddConditionalHeaders(
+      std::multimap<std::string, std::string>& header_params) const;
+
+  /// The value of the `ETag` header, may be empty.
+  std::string etag;
+  /// The value of the `Last-Modified` header, may be empty.
+  std::string last_modified;
+};
+
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
@@ -149,7 +149,7 @@ client::CancellationToken StreamLayerClientImpl::Subscribe(
     return subscripton_id;
   };
 
-  return AddTask(settings_.task_scheduler, pending_requests_,
+  return AddTask(settings_.task_scheduler, pending_requests_, thread::NORMAL,
                  std::move(subscribe_task), std::move(callback));
 }
 
@@ -217,7 +217,7 @@ client::CancellationToken StreamLayerClientImpl::Unsubscribe(
     return subscription_id;
   };
 
-  return AddTask(settings_.task_scheduler, pending_requests_,
+  return AddTask(settings_.task_scheduler, pending_requests_, thread::NORMAL,
                  std::move(unsubscribe_task), std::move(callback));
 }
 
@@ -267,7 +267,7 @@ client::CancellationToken StreamLayerClientImpl::GetData(
     return blob_response;
   };
 
-  return AddTask(settings_.task_scheduler, pending_requests_,
+  return AddTask(settings_.task_scheduler, pending_requests_, thread::NORMAL,
                  std::move(get_data_task), std::move(callback));
 }
 
@@ -364,7 +364,7 @@ client::CancellationToken StreamLayerClientImpl::Poll(
 
   };
 
-  return AddTask(settings_.task_scheduler, pending_requests_,
+  return AddTask(settings_.task_scheduler, pending_requests_, thread::NORMAL,
                  std::move(poll_task), std::move(callback));
 }
 
@@ -54,6 +54,13 @@ client::CancellableFuture<DataResponse> VersionedLayerClient::GetData(
   return impl_->GetData(std::move(data_request));
 }
 
+client::CancellationToken VersionedLayerClient::GetData(
+    DataRequest data_request, DataChunkCallback chunk_callback,
+    DataStreamResponseCallback callback) {
+  return impl_->GetData(std::move(data_request), std::move(chunk_callback),
+                        std::move(callback));
+}
+
 client::CancellationToken VersionedLayerClient::GetPartitions(
     PartitionsRequest partitions_request, PartitionsResponseCallback callback) {
   return impl_->GetPartitions(std::move(partitions_request),
@@ -76,7 +76,8 @@ client::CancellationToken VersionedLayerClientImpl::GetPartitions(
     };
 
     return AddTask(settings.task_scheduler, pending_requests_,
-                   std::move(partitions_task), std::move(callback));
+                   request.GetPriority(), std::move(partitions_task),
+                   std::move(callback));
   };
 
   return ScheduleFetch(std::move(schedule_get_partitions), std::move(request),
@@ -109,7 +110,8 @@ client::CancellationToken VersionedLayerClientImpl::GetData(
     };
 
     return AddTask(settings.task_scheduler, pending_requests_,
-                   std::move(data_task), std::move(callback));
+                   request.GetPriority(), std::move(data_task),
+                   std::move(callback));
   };
   return ScheduleFetch(std::move(schedule_get_data), std::move(request),
                        std::move(callback));
@@ -126,6 +128,23 @@ client::CancellableFuture<DataResponse> VersionedLayerClientImpl::GetData(
                                                  std::move(promise));
 }
 
+client::CancellationToken VersionedLayerClientImpl::GetData(
+    DataRequest request, DataChunkCallback chunk_callback,
+    DataStreamResponseCallback callback) {
+  auto catalog = catalog_;
+  auto layer_id = layer_id_;
+  auto settings = settings_;
+
+  auto data_task = [=](client::CancellationContext context) {
+    return repository::DataRepository::StreamVersionedData(
+        catalog, layer_id, request, chunk_callback, context, settings);
+  };
+
+  return AddTask(settings.task_scheduler, pending_requests_,
+                 request.GetPriority(), std::move(data_task),
+                 std::move(callback));
+}
+
 client::CancellationToken VersionedLayerClientImpl::PrefetchTiles(
     PrefetchTilesRequest request, PrefetchTilesResponseCallback callback) {
   // Used as empty response to be able to execute initial task
@@ -142,7 +161,7 @@ client::CancellationToken VersionedLayerClientImpl::PrefetchTiles(
   auto pending_requests = pending_requests_;
 
   auto token = AddTask(
-      settings.task_scheduler, pending_requests,
+      settings.task_scheduler, pending_requests, request.GetPriority(),
       [=](CancellationContext context) mutable -> EmptyResponse {
         if (request.GetTileKeys().empty()) {
           OLP_SDK_LOG_WARNING_F(kLogTag,
@@ -228,12 +247,15 @@ client::CancellationToken VersionedLayerClientImpl::PrefetchTiles(
           auto context_it = contexts.emplace(contexts.end());
 
           AddTask(settings.task_scheduler, pending_requests,
+                  request.GetPriority(),
                   [=](CancellationContext inner_context) {
                     // Get blob data
                     auto data = repository::DataRepository::GetVersionedData(
                         catalog, layer_id,
-                        DataRequest().WithDataHandle(handle).WithBillingTag(
-                            request.GetBillingTag()),
+                        DataRequest()
+                            .WithDataHandle(handle)
+                            .WithBillingTag(request.GetBillingTag())
+                            .WithPriority(request.GetPriority()),
                         inner_context, settings);
 
                     if (!data.IsSuccessful()) {
@@ -263,7 +285,7 @@ client::CancellationToken VersionedLayerClientImpl::PrefetchTiles(
         // Task to wait for previously triggered data download to collect
         // responses and trigger user callback.
         AddTask(
-            settings.task_scheduler, pending_requests,
+            settings.task_scheduler, pending_requests, request.GetPriority(),
             [=](CancellationContext inner_context) -> PrefetchTilesResponse {
               PrefetchTilesResult result;
               result.reserve(futures->size());
@@ -59,6 +59,10 @@ class VersionedLayerClientImpl {
   virtual client::CancellableFuture<DataResponse> GetData(
       DataRequest data_request);
 
+  virtual client::CancellationToken GetData(
+      DataRequest data_request, DataChunkCallback chunk_callback,
+      DataStreamResponseCallback callback);
+
   virtual client::CancellationToken GetPartitions(
       PartitionsRequest partitions_request,
       PartitionsResponseCallback callback);
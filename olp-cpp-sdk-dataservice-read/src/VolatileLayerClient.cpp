@@ -63,6 +63,13 @@ olp::client::CancellableFuture<DataResponse> VolatileLayerClient::GetData(
     DataRequest request) {
   return impl_->GetData(std::move(request));
 }
+
+client::CancellationToken VolatileLayerClient::GetData(
+    DataRequest request, DataChunkCallback chunk_callback,
+    DataStreamResponseCallback callback) {
+  return impl_->GetData(std::move(request), std::move(chunk_callback),
+                        std::move(callback));
+}
 }  // namespace read
 }  // namespace dataservice
 }  // namespace olp
@@ -76,7 +76,8 @@ client::CancellationToken VolatileLayerClientImpl::GetPartitions(
     };
 
     return AddTask(settings.task_scheduler, pending_requests_,
-                   std::move(data_task), std::move(callback));
+                   request.GetPriority(), std::move(data_task),
+                   std::move(callback));
   };
 
   return ScheduleFetch(std::move(schedule_get_partitions), std::move(request),
@@ -107,7 +108,8 @@ client::CancellationToken VolatileLayerClientImpl::GetData(
     };
 
     return AddTask(settings.task_scheduler, pending_requests_,
-                   std::move(partitions_task), std::move(callback));
+                   request.GetPriority(), std::move(partitions_task),
+                   std::move(callback));
   };
 
   return ScheduleFetch(std::move(schedule_get_data), std::move(request),
@@ -124,6 +126,23 @@ client::CancellableFuture<DataResponse> VolatileLayerClientImpl::GetData(
   return olp::client::CancellableFuture<DataResponse>(token, promise);
 }
 
+client::CancellationToken VolatileLayerClientImpl::GetData(
+    DataRequest request, DataChunkCallback chunk_callback,
+    DataStreamResponseCallback callback) {
+  auto catalog = catalog_;
+  auto layer_id = layer_id_;
+  auto settings = settings_;
+
+  auto data_task = [=](client::CancellationContext context) {
+    return repository::DataRepository::StreamVolatileData(
+        catalog, layer_id, request, chunk_callback, context, settings);
+  };
+
+  return AddTask(settings.task_scheduler, pending_requests_,
+                 request.GetPriority(), std::move(data_task),
+                 std::move(callback));
+}
+
 }  // namespace read
 }  // namespace dataservice
 }  // namespace olp
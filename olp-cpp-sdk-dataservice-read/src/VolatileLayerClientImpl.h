@@ -59,6 +59,10 @@ class VolatileLayerClientImpl {
 
   virtual client::CancellableFuture<DataResponse> GetData(DataRequest request);
 
+  virtual client::CancellationToken GetData(
+      DataRequest data_request, DataChunkCallback chunk_callback,
+      DataStreamResponseCallback callback);
+
  private:
   client::HRN catalog_;
   std::string layer_id_;
@@ -19,18 +19,72 @@
 
 #include "BlobApi.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
 #include <map>
 #include <memory>
 #include <sstream>
 
 #include <olp/core/client/HttpResponse.h>
 #include <olp/core/client/OlpClient.h>
+#include <olp/core/http/NetworkConstants.h>
 
 namespace olp {
 namespace dataservice {
 namespace read {
 using namespace olp::client;
 
+namespace {
+bool EqualsIgnoreCase(const std::string& lhs, const std::string& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char l, char r) {
+           return std::tolower(static_cast<unsigned char>(l)) ==
+                  std::tolower(static_cast<unsigned char>(r));
+         });
+}
+
+const std::string* FindContentRange(const HttpResponse& response) {
+  const auto header = std::find_if(
+      response.headers.begin(), response.headers.end(),
+      [](const std::pair<std::string, std::string>& header) {
+        return EqualsIgnoreCase(header.first, http::kContentRangeHeader);
+      });
+  return header != response.headers.end() ? &header->second : nullptr;
+}
+
+// Checks that the partial content starts at the first byte of the requested
+// `bytes=first-last` range.
+bool IsRequestedRange(const std::string& range, const HttpResponse& response) {
+  const auto content_range = FindContentRange(response);
+  if (!content_range) {
+    return false;
+  }
+
+  unsigned long long requested_first = 0;
+  unsigned long long first = 0;
+  return std::sscanf(range.c_str(), "bytes=%llu-", &requested_first) == 1 &&
+         std::sscanf(content_range->c_str(), "bytes %llu-", &first) == 1 &&
+         first == requested_first;
+}
+
+// Returns the size of the whole blob from the `bytes first-last/size`
+// content range, or zero if the size is unknown.
+std::uint64_t GetBlobSize(const HttpResponse& response) {
+  const auto content_range = FindContentRange(response);
+  unsigned long long first = 0;
+  unsigned long long last = 0;
+  unsigned long long size = 0;
+  if (!content_range ||
+      std::sscanf(content_range->c_str(), "bytes %llu-%llu/%llu", &first,
+                  &last, &size) != 3) {
+    return 0u;
+  }
+  return size;
+}
+}  // namespace
+
 BlobApi::DataResponse BlobApi::GetBlob(const client::OlpClient& client,
                                        const std::string& layer_id,
                                        const std::string& data_handle,
@@ -49,17 +103,63 @@ BlobApi::DataResponse BlobApi::GetBlob(const client::OlpClient& client,
   }
 
   std::string metadata_uri = "/layers/" + layer_id + "/data/" + data_handle;
+  // The blob is received directly into the buffer that is returned.
   auto api_response =
-          client.CallApi(metadata_uri, "GET", query_params, header_params,
-  {}, nullptr, "", context);
+          client.CallApiToBuffer(metadata_uri, "GET", query_params,
+  header_params, {}, nullptr, "", context);
 
-  auto str_response = api_response.response.str();
   if (api_response.status != http::HttpStatusCode::OK) {
-    return ApiError(api_response.status, str_response);
+    return ApiError(api_response.status, api_response.response.str());
+  }
+
+  return api_response.body;
+}
+
+BlobApi::StreamResponse BlobApi::StreamBlob(
+    const client::OlpClient& client, const std::string& layer_id,
+    const std::string& data_handle, boost::optional<std::string> billing_tag,
+    boost::optional<std::string> range,
+    http::Network::DataCallback data_callback,
+    const client::CancellationContext& context) {
+  std::multimap<std::string, std::string> header_params;
+  header_params.emplace("Accept", "application/json");
+  if (range) {
+    header_params.emplace("Range", *range);
+  }
+
+  std::multimap<std::string, std::string> query_params;
+  if (billing_tag) {
+    query_params.emplace("billingTag", *billing_tag);
+  }
+
+  std::string metadata_uri = "/layers/" + layer_id + "/data/" + data_handle;
+  auto api_response = client.CallApiStream(
+      metadata_uri, "GET", query_params, header_params, {}, nullptr, "",
+      std::move(data_callback), context);
+
+  if (!range) {
+    if (api_response.status != http::HttpStatusCode::OK) {
+      return ApiError(api_response.status, api_response.response.str());
+    }
+    return 0u;
+  }
+
+  // The server that does not support the byte ranges sends the whole blob
+  // with the status 200 and without the content range, and the received data
+  // is not the requested range. The network may report the partial content
+  // that starts at the first byte of the blob with the status 200 too.
+  const bool successful = api_response.status == http::HttpStatusCode::OK ||
+                          api_response.status ==
+                              http::HttpStatusCode::PARTIAL_CONTENT;
+  if (successful && !IsRequestedRange(*range, api_response)) {
+    return ApiError(api_response.status,
+                    "The byte range is ignored by the server");
+  }
+  if (!successful) {
+    return ApiError(api_response.status, api_response.response.str());
   }
 
-  return std::make_shared<std::vector<unsigned char>>(str_response.begin(),
-                                                      str_response.end());
+  return GetBlobSize(api_response);
 }
 }  // namespace read
 }  // namespace dataservice
@@ -19,10 +19,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include <olp/core/client/ApiError.h>
+#include <olp/core/client/ApiNoResult.h>
 #include <olp/core/client/ApiResponse.h>
+#include <olp/core/http/Network.h>
 #include <boost/optional.hpp>
 #include "olp/dataservice/read/model/Data.h"
 
@@ -40,6 +43,7 @@ namespace read {
 class BlobApi {
  public:
   using DataResponse = client::ApiResponse<model::Data, client::ApiError>;
+  using StreamResponse = client::ApiResponse<std::uint64_t, client::ApiError>;
 
   /**
    * @brief Retrieves a data blob for specified handle.
@@ -66,6 +70,34 @@ class BlobApi {
                               boost::optional<std::string> billing_tag,
                               boost::optional<std::string> range,
                               const client::CancellationContext& context);
+
+  /**
+   * @brief Retrieves a data blob for specified handle and passes it to
+   * the data callback chunk by chunk, as it is received.
+   * @param client Instance of OlpClient used to make REST request.
+   * @param layer_id Layer id.
+   * @param data_handle Indentifies a specific blob.
+   * @param billing_tag An optional free-form tag which is used for grouping
+   * billing records together.
+   * @param range An optional single byte range, see `GetBlob`. The response
+   * to the range must be partial content that starts at the first requested
+   * byte, otherwise an error with the received HTTP status is returned, see
+   * `RangedDownload::IsRangeIgnored`.
+   * @param data_callback Receives the chunks of the blob, see
+   * `OlpClient::CallApiStream`.
+   * @param context A CancellationContext, which can be used to cancel the
+   * pending request.
+   *
+   * @return The size of the whole blob from the content range of the partial
+   * content, or zero if the size is unknown or no range is requested.
+   */
+  static StreamResponse StreamBlob(const client::OlpClient& client,
+                                   const std::string& layer_id,
+                                   const std::string& data_handle,
+                                   boost::optional<std::string> billing_tag,
+                                   boost::optional<std::string> range,
+                                   http::Network::DataCallback data_callback,
+                                   const client::CancellationContext& context);
 };
 
 }  // namespace read
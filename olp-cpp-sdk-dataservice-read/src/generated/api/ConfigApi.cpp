@@ -24,6 +24,7 @@
 
 #include <olp/core/client/HttpResponse.h>
 #include <olp/core/client/OlpClient.h>
+#include "ResponseValidator.h"
 // clang-format off
 #include "generated/parser/CatalogParser.h"
 #include <olp/core/generated/parser/JsonParser.h>
@@ -37,9 +38,12 @@ using namespace olp::client;
 ConfigApi::CatalogResponse ConfigApi::GetCatalog(
     const OlpClient& client, const std::string& catalog_hrn,
     boost::optional<std::string> billing_tag,
-    client::CancellationContext context) {
+    client::CancellationContext context, ResponseValidator* validator) {
   std::multimap<std::string, std::string> header_params;
   header_params.insert(std::make_pair("Accept", "application/json"));
+  if (validator) {
+    validator->AddConditionalHeaders(header_params);
+  }
   std::multimap<std::string, std::string> query_params;
   if (billing_tag) {
     query_params.insert(std::make_pair("billingTag", *billing_tag));
@@ -52,6 +56,10 @@ ConfigApi::CatalogResponse ConfigApi::GetCatalog(
   if (response.status != olp::http::HttpStatusCode::OK) {
     return client::ApiError(response.status, response.response.str());
   }
+  if (validator) {
+    auto received = ResponseValidator::FromResponse(response);
+    *validator = received ? std::move(*received) : ResponseValidator();
+  }
   return olp::parser::parse<model::Catalog>(response.response);
 }
 
@@ -35,6 +35,8 @@ class OlpClient;
 
 namespace dataservice {
 namespace read {
+struct ResponseValidator;
+
 /**
  * @brief Api to access catalogs.
  */
@@ -52,12 +54,17 @@ class ConfigApi {
    * contain only alpha/numeric ASCII characters  [A-Za-z0-9].
    * @param context A CancellationContext instance which can be used to cancel
    * this method.
+   * @param validator The validator of the cached catalog, if any. It is sent
+   * in the conditional request headers, and is replaced by the validator of
+   * the received response. If the catalog is not modified, the request fails
+   * with the `304 Not Modified` status, and the validator is kept.
    * @return The result of operation as a client::ApiResponse object.
    */
   static CatalogResponse GetCatalog(const client::OlpClient& client,
                                     const std::string& catalog_hrn,
                                     boost::optional<std::string> billing_tag,
-                                    client::CancellationContext context);
+                                    client::CancellationContext context,
+                                    ResponseValidator* validator = nullptr);
 };
 
 }  // namespace read
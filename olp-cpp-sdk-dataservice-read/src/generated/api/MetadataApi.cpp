@@ -25,6 +25,7 @@
 
 #include <olp/core/client/HttpResponse.h>
 #include <olp/core/client/OlpClient.h>
+#include "ResponseValidator.h"
 
 // clang-format off
 #include "generated/parser/LayerVersionsParser.h"
@@ -87,12 +88,15 @@ MetadataApi::PartitionsResponse MetadataApi::GetPartitions(
     boost::optional<std::vector<std::string>> additional_fields,
     boost::optional<std::string> range,
     boost::optional<std::string> billing_tag,
-    const client::CancellationContext& context) {
+    const client::CancellationContext& context, ResponseValidator* validator) {
   std::multimap<std::string, std::string> header_params;
   header_params.emplace("Accept", "application/json");
   if (range) {
     header_params.emplace("Range", *range);
   }
+  if (validator) {
+    validator->AddConditionalHeaders(header_params);
+  }
 
   std::multimap<std::string, std::string> query_params;
   if (additional_fields) {
@@ -115,6 +119,11 @@ MetadataApi::PartitionsResponse MetadataApi::GetPartitions(
     return ApiError(api_response.status, api_response.response.str());
   }
 
+  if (validator) {
+    auto received = ResponseValidator::FromResponse(api_response);
+    *validator = received ? std::move(*received) : ResponseValidator();
+  }
+
   return PartitionsResponse(
       olp::parser::parse<model::Partitions>(api_response.response));
 }
@@ -37,6 +37,8 @@ class CancellationContext;
 
 namespace dataservice {
 namespace read {
+struct ResponseValidator;
+
 /**
  * @brief Api to get information about catalogs, layers, and partitions.
  */
@@ -87,6 +89,10 @@ class MetadataApi {
    * billing records together. If supplied, it must be between 4 - 16
    * characters, contain only alpha/numeric ASCII characters  [A-Za-z0-9].
    * @param context A CancellationContext, which can be used to cancel request.
+   * @param validator The validator of the cached partitions, if any. It is
+   * sent in the conditional request headers, and is replaced by the validator
+   * of the received response. If the partitions are not modified, the request
+   * fails with the `304 Not Modified` status, and the validator is kept.
    *
    * @return The Partitions response.
    */
@@ -96,7 +102,8 @@ class MetadataApi {
       boost::optional<std::vector<std::string>> additional_fields,
       boost::optional<std::string> range,
       boost::optional<std::string> billing_tag,
-      const client::CancellationContext& context);
+      const client::CancellationContext& context,
+      ResponseValidator* validator = nullptr);
 
   /**
    * @brief Retrieves the latest metadata version for the catalog.
@@ -44,17 +44,41 @@ VolatileBlobApi::DataResponse VolatileBlobApi::GetVolatileBlob(
 
   std::multimap<std::string, std::string> form_params;
   std::string metadata_uri = "/layers/" + layer_id + "/data/" + data_handle;
+  // The blob is received directly into the buffer that is returned.
   auto response =
-      client.CallApi(metadata_uri, "GET", query_params, header_params,
-                     form_params, nullptr, "", context);
-  
-  auto str_response = response.response.str();
+      client.CallApiToBuffer(metadata_uri, "GET", query_params, header_params,
+                             form_params, nullptr, "", context);
+
+  if (response.status != http::HttpStatusCode::OK) {
+    return ApiError(response.status, response.response.str());
+  }
+
+  return response.body;
+}
+
+VolatileBlobApi::StreamResponse VolatileBlobApi::StreamVolatileBlob(
+    const OlpClient& client, const std::string& layer_id,
+    const std::string& data_handle, boost::optional<std::string> billing_tag,
+    http::Network::DataCallback data_callback,
+    const CancellationContext& context) {
+  std::multimap<std::string, std::string> header_params;
+  header_params.insert(std::make_pair("Accept", "application/json"));
+  std::multimap<std::string, std::string> query_params;
+  if (billing_tag) {
+    query_params.insert(std::make_pair("billingTag", *billing_tag));
+  }
+
+  std::multimap<std::string, std::string> form_params;
+  std::string metadata_uri = "/layers/" + layer_id + "/data/" + data_handle;
+  auto response = client.CallApiStream(
+      metadata_uri, "GET", query_params, header_params, form_params, nullptr,
+      "", std::move(data_callback), context);
+
   if (response.status != http::HttpStatusCode::OK) {
-    return ApiError(response.status, str_response);
+    return ApiError(response.status, response.response.str());
   }
 
-  return std::make_shared<std::vector<unsigned char>>(str_response.begin(),
-                                                      str_response.end());
+  return ApiNoResult();
 }
 }  // namespace read
 }  // namespace dataservice
@@ -22,7 +22,9 @@
 #include <string>
 
 #include <olp/core/client/ApiError.h>
+#include <olp/core/client/ApiNoResult.h>
 #include <olp/core/client/ApiResponse.h>
+#include <olp/core/http/Network.h>
 #include <boost/optional.hpp>
 #include "olp/dataservice/read/model/Data.h"
 
@@ -40,6 +42,8 @@ namespace read {
 class VolatileBlobApi {
  public:
   using DataResponse = client::ApiResponse<model::Data, client::ApiError>;
+  using StreamResponse =
+      client::ApiResponse<client::ApiNoResult, client::ApiError>;
 
   /**
    * @brief Retrieves a volatile data blob for specified handle.
@@ -58,6 +62,26 @@ class VolatileBlobApi {
                                       const std::string& data_handle,
                                       boost::optional<std::string> billing_tag,
                                       const client::CancellationContext& context);
+
+  /**
+   * @brief Retrieves a volatile data blob for specified handle and passes it
+   * to the data callback chunk by chunk, as it is received.
+   * @param client Instance of OlpClient used to make REST request.
+   * @param layer_id Layer id.
+   * @param data_handle Identifies a specific blob.
+   * @param billing_tag An optional free-form tag which is used for grouping
+   * billing records together.
+   * @param data_callback Receives the chunks of the blob, see
+   * `OlpClient::CallApiStream`.
+   * @param context A CancellationContext, which can be used to cancel request.
+   *
+   * @return Stream response.
+   */
+  static StreamResponse StreamVolatileBlob(
+      const client::OlpClient& client, const std::string& layer_id,
+      const std::string& data_handle, boost::optional<std::string> billing_tag,
+      http::Network::DataCallback data_callback,
+      const client::CancellationContext& context);
 };
 
 }  // namespace read
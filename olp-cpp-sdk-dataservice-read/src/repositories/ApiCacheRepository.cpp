@@ -24,11 +24,6 @@
 
 namespace {
 constexpr auto kLogTag = "ApiCacheRepository";
-
-std::string CreateKey(const std::string& hrn, const std::string& service,
-                      const std::string& serviceVersion) {
-  return hrn + "::" + service + "::" + serviceVersion + "::api";
-}
 }  // namespace
 
 namespace olp {
@@ -38,23 +33,24 @@ namespace repository {
 using namespace olp::client;
 ApiCacheRepository::ApiCacheRepository(
     const HRN& hrn, std::shared_ptr<cache::KeyValueCache> cache)
-    : hrn_(hrn), cache_(cache) {}
+    : hrn_(hrn), key_encoder_(hrn.ToCatalogHRNString()), cache_(cache) {}
 
 void ApiCacheRepository::Put(const std::string& service,
                              const std::string& serviceVersion,
                              const std::string& serviceUrl) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn, service, serviceVersion);
-  OLP_SDK_LOG_TRACE_F(kLogTag, "Put '%s'", key.c_str());
-  cache_->Put(CreateKey(hrn, service, serviceVersion), serviceUrl,
+  OLP_SDK_LOG_TRACE_F(kLogTag, "Put '%s', service '%s/%s'",
+                      hrn_.ToCatalogHRNString().c_str(), service.c_str(),
+                      serviceVersion.c_str());
+  cache_->Put(key_encoder_.Api(service, serviceVersion), serviceUrl,
               [serviceUrl]() { return serviceUrl; }, 3600);
 }
 
 boost::optional<std::string> ApiCacheRepository::Get(
     const std::string& service, const std::string& serviceVersion) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn, service, serviceVersion);
-  OLP_SDK_LOG_TRACE_F(kLogTag, "Get '%s'", key.c_str());
+  auto key = key_encoder_.Api(service, serviceVersion);
+  OLP_SDK_LOG_TRACE_F(kLogTag, "Get '%s', service '%s/%s'",
+                      hrn_.ToCatalogHRNString().c_str(), service.c_str(),
+                      serviceVersion.c_str());
   auto url = cache_->Get(key, [](const std::string& value) { return value; });
   if (url.empty()) {
     return boost::none;
@@ -21,6 +21,7 @@
 
 #include <memory>
 
+#include <olp/core/cache/KeyEncoder.h>
 #include <olp/core/client/HRN.h>
 #include <boost/optional.hpp>
 #include <string>
@@ -48,6 +49,7 @@ class ApiCacheRepository final {
 
  private:
   client::HRN hrn_;
+  cache::KeyEncoder key_encoder_;
   std::shared_ptr<cache::KeyValueCache> cache_;
 };
 }  // namespace repository
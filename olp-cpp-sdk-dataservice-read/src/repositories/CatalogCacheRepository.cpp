@@ -39,11 +39,6 @@ constexpr auto kLogTag = "CatalogCacheRepository";
 // Currently, we expire the catalog version after 5 minutes. Later we plan to
 // give the user the control when to expire it.
 constexpr auto kCatalogVersionExpireTime = 5 * 60;
-
-std::string CreateKey(const std::string& hrn) { return hrn + "::catalog"; }
-std::string VersionKey(const std::string& hrn) {
-  return hrn + "::latestVersion";
-}
 }  // namespace
 
 namespace olp {
@@ -53,22 +48,18 @@ namespace repository {
 using namespace olp::client;
 CatalogCacheRepository::CatalogCacheRepository(
     const HRN& hrn, std::shared_ptr<cache::KeyValueCache> cache)
-    : hrn_(hrn), cache_(cache) {}
+    : hrn_(hrn), key_encoder_(hrn.ToCatalogHRNString()), cache_(cache) {}
 
 void CatalogCacheRepository::Put(const model::Catalog& catalog) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn);
-  OLP_SDK_LOG_TRACE_F(kLogTag, "Put '%s'", key.c_str());
-  cache_->Put(key, catalog,
+  OLP_SDK_LOG_TRACE_F(kLogTag, "Put '%s'", hrn_.ToCatalogHRNString().c_str());
+  cache_->Put(key_encoder_.Catalog(), catalog,
               [catalog]() { return olp::serializer::serialize(catalog); });
 }
 
 boost::optional<model::Catalog> CatalogCacheRepository::Get() {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn);
-  OLP_SDK_LOG_TRACE_F(kLogTag, "Get '%s'", key.c_str());
-  auto cachedCatalog =
-      cache_->Get(key, [](const std::string& serializedObject) {
+  OLP_SDK_LOG_TRACE_F(kLogTag, "Get '%s'", hrn_.ToCatalogHRNString().c_str());
+  auto cachedCatalog = cache_->Get(
+      key_encoder_.Catalog(), [](const std::string& serializedObject) {
         return parser::parse<model::Catalog>(serializedObject);
       });
   if (cachedCatalog.empty()) {
@@ -78,20 +69,50 @@ boost::optional<model::Catalog> CatalogCacheRepository::Get() {
   return boost::any_cast<model::Catalog>(cachedCatalog);
 }
 
+void CatalogCacheRepository::PutValidator(
+    const ResponseValidator& validator) {
+  OLP_SDK_LOG_TRACE_F(kLogTag, "PutValidator '%s'",
+                      hrn_.ToCatalogHRNString().c_str());
+  if (validator.Empty()) {
+    cache_->Remove(key_encoder_.CatalogValidator());
+    return;
+  }
+  // The validator is cached without expiry, as the catalog it validates.
+  cache_->Put(key_encoder_.CatalogValidator(), validator,
+              [validator]() { return validator.Encode(); });
+}
+
+boost::optional<ResponseValidator> CatalogCacheRepository::GetValidator() {
+  OLP_SDK_LOG_TRACE_F(kLogTag, "GetValidator '%s'",
+                      hrn_.ToCatalogHRNString().c_str());
+  auto cached_validator = cache_->Get(
+      key_encoder_.CatalogValidator(),
+      [](const std::string& value) -> boost::any {
+        auto validator = ResponseValidator::Decode(value);
+        if (!validator) {
+          return boost::any();
+        }
+        return *validator;
+      });
+  if (cached_validator.empty()) {
+    return boost::none;
+  }
+  return boost::any_cast<ResponseValidator>(cached_validator);
+}
+
 void CatalogCacheRepository::PutVersion(const model::VersionResponse& version) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  OLP_SDK_LOG_TRACE_F(kLogTag, "PutVersion '%s'", hrn.c_str());
-  cache_->Put(VersionKey(hrn), version,
+  OLP_SDK_LOG_TRACE_F(kLogTag, "PutVersion '%s'",
+                      hrn_.ToCatalogHRNString().c_str());
+  cache_->Put(key_encoder_.LatestVersion(), version,
               [version]() { return olp::serializer::serialize(version); },
               kCatalogVersionExpireTime);
 }
 
 boost::optional<model::VersionResponse> CatalogCacheRepository::GetVersion() {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = VersionKey(hrn);
-  OLP_SDK_LOG_TRACE_F(kLogTag, "GetVersion '%s'", key.c_str());
-  auto cachedVersion =
-      cache_->Get(key, [](const std::string& serializedObject) {
+  OLP_SDK_LOG_TRACE_F(kLogTag, "GetVersion '%s'",
+                      hrn_.ToCatalogHRNString().c_str());
+  auto cachedVersion = cache_->Get(
+      key_encoder_.LatestVersion(), [](const std::string& serializedObject) {
         return parser::parse<model::VersionResponse>(serializedObject);
       });
   if (cachedVersion.empty()) {
@@ -101,9 +122,8 @@ boost::optional<model::VersionResponse> CatalogCacheRepository::GetVersion() {
 }
 
 void CatalogCacheRepository::Clear() {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  OLP_SDK_LOG_TRACE_F(kLogTag, "Clear '%s'", CreateKey(hrn).c_str());
-  cache_->RemoveKeysWithPrefix(hrn);
+  OLP_SDK_LOG_TRACE_F(kLogTag, "Clear '%s'", hrn_.ToCatalogHRNString().c_str());
+  cache_->RemoveKeysWithPrefix(key_encoder_.CatalogPrefix());
 }
 
 }  // namespace repository
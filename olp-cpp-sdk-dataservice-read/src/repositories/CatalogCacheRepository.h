@@ -21,10 +21,12 @@
 
 #include <memory>
 
+#include <olp/core/cache/KeyEncoder.h>
 #include <olp/core/client/HRN.h>
 #include <olp/dataservice/read/model/Catalog.h>
 #include <olp/dataservice/read/model/VersionResponse.h>
 #include <boost/optional.hpp>
+#include "ResponseValidator.h"
 
 namespace olp {
 namespace cache {
@@ -45,6 +47,10 @@ class CatalogCacheRepository final {
 
   boost::optional<model::Catalog> Get();
 
+  void PutValidator(const ResponseValidator& validator);
+
+  boost::optional<ResponseValidator> GetValidator();
+
   void PutVersion(const model::VersionResponse& version);
 
   boost::optional<model::VersionResponse> GetVersion();
@@ -53,6 +59,7 @@ class CatalogCacheRepository final {
 
  private:
   client::HRN hrn_;
+  cache::KeyEncoder key_encoder_;
   std::shared_ptr<cache::KeyValueCache> cache_;
 };
 }  // namespace repository
@@ -27,6 +27,7 @@
 #include "ApiClientLookup.h"
 #include "CatalogCacheRepository.h"
 #include "ExecuteOrSchedule.inl"
+#include "ResponseValidator.h"
 #include "generated/api/ConfigApi.h"
 #include "generated/api/MetadataApi.h"
 #include "olp/dataservice/read/CatalogRequest.h"
@@ -75,14 +76,35 @@ CatalogResponse CatalogRepository::GetCatalog(
     return config_api.GetError();
   }
 
+  // The cached catalog is revalidated, so the unchanged catalog is not
+  // downloaded again on refresh.
+  boost::optional<model::Catalog> cached_catalog;
+  auto cached_validator = repository.GetValidator();
+  if (cached_validator) {
+    cached_catalog = repository.Get();
+    if (!cached_catalog) {
+      cached_validator = boost::none;
+    }
+  }
+  auto validator = cached_validator.value_or(ResponseValidator());
+
   const OlpClient& client = config_api.GetResult();
-  auto catalog_response =
-      ConfigApi::GetCatalog(client, catalog.ToCatalogHRNString(),
-                            request.GetBillingTag(), cancellation_context);
+  auto catalog_response = ConfigApi::GetCatalog(
+      client, catalog.ToCatalogHRNString(), request.GetBillingTag(),
+      cancellation_context, &validator);
   if (catalog_response.IsSuccessful()) {
     repository.Put(catalog_response.GetResult());
+    if (cached_validator || !validator.Empty()) {
+      repository.PutValidator(validator);
+    }
   } else {
     const auto& error = catalog_response.GetError();
+    if (cached_validator && error.GetHttpStatusCode() ==
+                                http::HttpStatusCode::NOT_MODIFIED) {
+      OLP_SDK_LOG_INFO_F(kLogTag, "catalog '%s' not modified",
+                         request_key.c_str());
+      return *cached_catalog;
+    }
     if (error.GetHttpStatusCode() == http::HttpStatusCode::FORBIDDEN) {
       repository.Clear();
     }
@@ -24,11 +24,6 @@
 
 namespace {
 constexpr auto kLogTag = "DataCacheRepository";
-
-std::string CreateKey(const std::string& hrn, const std::string& layer_id,
-                      const std::string& datahandle) {
-  return hrn + "::" + layer_id + "::" + datahandle + "::Data";
-}
 }  // namespace
 
 namespace olp {
@@ -38,22 +33,24 @@ namespace repository {
 using namespace olp::client;
 DataCacheRepository::DataCacheRepository(
     const HRN& hrn, std::shared_ptr<cache::KeyValueCache> cache)
-    : hrn_(hrn), cache_(cache) {}
+    : hrn_(hrn), key_encoder_(hrn.ToCatalogHRNString()), cache_(cache) {}
 
 void DataCacheRepository::Put(const model::Data& data,
                               const std::string& layer_id,
                               const std::string& data_handle) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn, layer_id, data_handle);
-  OLP_SDK_LOG_TRACE_F(kLogTag, "Put '%s'", key.c_str());
+  auto key = key_encoder_.Data(layer_id, data_handle);
+  OLP_SDK_LOG_TRACE_F(kLogTag, "Put '%s', layer '%s', data handle '%s'",
+                      hrn_.ToCatalogHRNString().c_str(), layer_id.c_str(),
+                      data_handle.c_str());
   cache_->Put(key, data);
 }
 
 boost::optional<model::Data> DataCacheRepository::Get(
     const std::string& layer_id, const std::string& data_handle) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn, layer_id, data_handle);
-  OLP_SDK_LOG_TRACE_F(kLogTag, "Get '%s'", key.c_str());
+  auto key = key_encoder_.Data(layer_id, data_handle);
+  OLP_SDK_LOG_TRACE_F(kLogTag, "Get '%s', layer '%s', data handle '%s'",
+                      hrn_.ToCatalogHRNString().c_str(), layer_id.c_str(),
+                      data_handle.c_str());
   auto cachedData = cache_->Get(key);
   if (!cachedData) {
     return boost::none;
@@ -64,9 +61,10 @@ boost::optional<model::Data> DataCacheRepository::Get(
 
 void DataCacheRepository::Clear(const std::string& layer_id,
                                 const std::string& data_handle) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn, layer_id, data_handle);
-  OLP_SDK_LOG_TRACE_F(kLogTag, "Clear '%s'", key.c_str());
+  auto key = key_encoder_.Data(layer_id, data_handle);
+  OLP_SDK_LOG_TRACE_F(kLogTag, "Clear '%s', layer '%s', data handle '%s'",
+                      hrn_.ToCatalogHRNString().c_str(), layer_id.c_str(),
+                      data_handle.c_str());
   cache_->RemoveKeysWithPrefix(key);
 }
 
@@ -21,6 +21,7 @@
 
 #include <memory>
 
+#include <olp/core/cache/KeyEncoder.h>
 #include <olp/core/client/HRN.h>
 #include <olp/dataservice/read/model/Data.h>
 #include <boost/optional.hpp>
@@ -50,6 +51,7 @@ class DataCacheRepository final {
 
  private:
   client::HRN hrn_;
+  cache::KeyEncoder key_encoder_;
   std::shared_ptr<cache::KeyValueCache> cache_;
 };
 }  // namespace repository
@@ -20,7 +20,10 @@
 #include "DataRepository.h"
 
 #include <algorithm>
+#include <iterator>
+#include <map>
 #include <sstream>
+#include <vector>
 
 #include <olp/core/client/Condition.h>
 #include <olp/core/logging/Log.h>
@@ -30,6 +33,8 @@
 #include "ExecuteOrSchedule.inl"
 #include "PartitionsCacheRepository.h"
 #include "PartitionsRepository.h"
+#include "RangedDownload.h"
+#include "SingleFlight.h"
 #include "generated/api/BlobApi.h"
 #include "generated/api/VolatileBlobApi.h"
 #include "olp/dataservice/read/CatalogRequest.h"
@@ -48,53 +53,200 @@ constexpr auto kDataInlinePrefix = "data:";
 constexpr auto kLogTag = "DataRepository";
 constexpr auto kBlobService = "blob";
 constexpr auto kVolatileBlobService = "volatile-blob";
+
+// The concurrent requests are coalesced only if they share the cache, so
+// a client never gets the data that it could not read from its own cache.
+std::string CoalescingKey(const client::OlpClientSettings& settings,
+                          const client::HRN& catalog, const std::string& layer,
+                          const std::string& service,
+                          const std::string& data_handle,
+                          const boost::optional<std::string>& billing_tag) {
+  std::stringstream out;
+  out << static_cast<const void*>(settings.cache.get())
+      << "::" << catalog.ToCatalogHRNString() << "::" << layer
+      << "::" << service << "::" << data_handle;
+  if (billing_tag) {
+    out << "$" << billing_tag.get();
+  }
+  return out.str();
+}
+
+// Passes the chunks to the sink, except the parts that were already passed,
+// so the sink gets each byte of the blob once, even if the ranged download
+// falls back to streaming the whole blob. Not thread safe.
+class ChunkFilter {
+ public:
+  explicit ChunkFilter(DataChunkCallback sink) : sink_(std::move(sink)) {}
+
+  void Pass(const std::uint8_t* data, std::uint64_t offset,
+            std::size_t size) {
+    const auto end = offset + size;
+    auto position = offset;
+    while (position < end) {
+      auto next = passed_.upper_bound(position);
+      if (next != passed_.begin()) {
+        const auto previous = std::prev(next);
+        if (previous->second > position) {
+          position = std::min(previous->second, end);
+          continue;
+        }
+      }
+
+      const auto part_end =
+          next == passed_.end() ? end : std::min(next->first, end);
+      sink_(data + (position - offset), position,
+            static_cast<std::size_t>(part_end - position));
+      Add(position, part_end, next);
+      position = part_end;
+    }
+  }
+
+ private:
+  // Adds the passed part that ends at or before `next`, and merges it with
+  // the adjacent parts, so the streamed blob takes one entry.
+  void Add(std::uint64_t begin, std::uint64_t end,
+           std::map<std::uint64_t, std::uint64_t>::iterator next) {
+    if (next != passed_.end() && next->first == end) {
+      end = next->second;
+      next = passed_.erase(next);
+    }
+    if (next != passed_.begin()) {
+      const auto previous = std::prev(next);
+      if (previous->second == begin) {
+        previous->second = end;
+        return;
+      }
+    }
+    passed_.emplace_hint(next, begin, end);
+  }
+
+  const DataChunkCallback sink_;
+  // The passed parts of the blob, the first byte mapped to the end.
+  std::map<std::uint64_t, std::uint64_t> passed_;
+};
+
+// Downloads the blob in byte ranges, see `DataRequest::GetDownloadChunkSize`.
+DataStreamResponse StreamBlobInRanges(
+    client::OlpClient client, const std::string& layer,
+    const DataRequest& request, const client::OlpClientSettings& settings,
+    DataChunkCallback sink, client::CancellationContext context,
+    RangedDownload::SizeCallback size_callback) {
+  // The ranges are retried and resumed by the ranged download, so that
+  // the received part of a range is not downloaded again.
+  auto range_settings = settings;
+  range_settings.retry_settings.max_attempts = 0;
+  client.SetSettings(range_settings);
+
+  const auto data_handle = request.GetDataHandle().value();
+  const auto billing_tag = request.GetBillingTag();
+  auto range_request = [=](const std::string& range,
+                           http::Network::DataCallback data_callback,
+                           client::CancellationContext range_context) {
+    return BlobApi::StreamBlob(client, layer, data_handle, billing_tag, range,
+                               std::move(data_callback), range_context);
+  };
+
+  return RangedDownload::Run(std::move(range_request),
+                             request.GetDownloadChunkSize().value(),
+                             request.GetMaxParallelDownloads(), std::move(sink),
+                             settings, request.GetPriority(), context,
+                             std::move(size_callback));
+}
+
+// Downloads the blob in byte ranges, and puts them together in one buffer.
+BlobApi::DataResponse GetBlobInRanges(client::OlpClient client,
+                                      const std::string& layer,
+                                      const DataRequest& request,
+                                      const client::OlpClientSettings& settings,
+                                      client::CancellationContext context) {
+  // The ranges are written in place. The buffer takes the size of the blob
+  // before the first range is written, or grows if the size is unknown.
+  auto data = std::make_shared<std::vector<unsigned char>>();
+  auto size_callback = [&](std::uint64_t size) {
+    data->resize(static_cast<size_t>(size));
+  };
+  auto sink = [&](const std::uint8_t* chunk, std::uint64_t offset,
+                  std::size_t size) {
+    if (data->size() < offset + size) {
+      data->resize(static_cast<size_t>(offset + size));
+    }
+    std::copy(chunk, chunk + size, data->begin() + offset);
+  };
+
+  auto response = StreamBlobInRanges(std::move(client), layer, request,
+                                     settings, sink, context, size_callback);
+  if (!response.IsSuccessful()) {
+    return response.GetError();
+  }
+
+  data->resize(static_cast<size_t>(response.GetResult()));
+  return data;
+}
 }  // namespace
 
-DataResponse DataRepository::GetVersionedData(
-    const client::HRN& catalog, const std::string& layer_id,
-    DataRequest request, client::CancellationContext context,
-    client::OlpClientSettings settings) {
+SingleFlight<DataResponse>& DataRepository::GetBlobFlights() {
+  static SingleFlight<DataResponse> flights;
+  return flights;
+}
+
+boost::optional<client::ApiError> DataRepository::ResolveDataHandle(
+    const client::HRN& catalog, const std::string& layer_id, bool versioned,
+    DataRequest& request, client::CancellationContext context,
+    const client::OlpClientSettings& settings) {
   if (request.GetDataHandle() && request.GetPartitionId()) {
     return ApiError(ErrorCode::PreconditionFailed,
                     "Both data handle and partition id specified");
   }
 
-  if (!request.GetDataHandle()) {
-    if (!request.GetVersion()) {
-      // get latest version of the layer if it wasn't set by the user
-      CatalogVersionRequest version_request;
-      version_request.WithFetchOption(request.GetFetchOption())
-          .WithBillingTag(request.GetBillingTag());
-      auto latest_version_response =
-          repository::CatalogRepository::GetLatestVersion(
-              catalog, context, std::move(version_request), settings);
-      if (!latest_version_response.IsSuccessful()) {
-        return latest_version_response.GetError();
-      }
-      request.WithVersion(latest_version_response.GetResult().GetVersion());
+  if (request.GetDataHandle()) {
+    return boost::none;
+  }
+
+  if (versioned && !request.GetVersion()) {
+    // get latest version of the layer if it wasn't set by the user
+    CatalogVersionRequest version_request;
+    version_request.WithFetchOption(request.GetFetchOption())
+        .WithBillingTag(request.GetBillingTag());
+    auto latest_version_response =
+        repository::CatalogRepository::GetLatestVersion(
+            catalog, context, std::move(version_request), settings);
+    if (!latest_version_response.IsSuccessful()) {
+      return latest_version_response.GetError();
     }
+    request.WithVersion(latest_version_response.GetResult().GetVersion());
+  }
 
-    // get data handle for a partition to be queried
-    auto partitions_response =
-        repository::PartitionsRepository::GetPartitionById(
-            catalog, layer_id, context, request, settings);
+  // get data handle for a partition to be queried
+  auto partitions_response = repository::PartitionsRepository::GetPartitionById(
+      catalog, layer_id, context, request, settings);
 
-    if (!partitions_response.IsSuccessful()) {
-      return partitions_response.GetError();
-    }
+  if (!partitions_response.IsSuccessful()) {
+    return partitions_response.GetError();
+  }
 
-    const auto& partitions = partitions_response.GetResult().GetPartitions();
-    if (partitions.empty()) {
-      OLP_SDK_LOG_INFO_F(kLogTag, "Partition %s not found",
-                         request.GetPartitionId()
-                             ? request.GetPartitionId().get().c_str()
-                             : "<none>");
+  const auto& partitions = partitions_response.GetResult().GetPartitions();
+  if (partitions.empty()) {
+    OLP_SDK_LOG_INFO_F(kLogTag, "Partition %s not found",
+                       request.GetPartitionId()
+                           ? request.GetPartitionId().get().c_str()
+                           : "<none>");
 
-      return client::ApiError(client::ErrorCode::NotFound,
-                              "Partition not found");
-    }
+    return client::ApiError(client::ErrorCode::NotFound,
+                            "Partition not found");
+  }
+
+  request.WithDataHandle(partitions.front().GetDataHandle());
+  return boost::none;
+}
 
-    request.WithDataHandle(partitions.front().GetDataHandle());
+DataResponse DataRepository::GetVersionedData(
+    const client::HRN& catalog, const std::string& layer_id,
+    DataRequest request, client::CancellationContext context,
+    client::OlpClientSettings settings) {
+  auto error =
+      ResolveDataHandle(catalog, layer_id, true, request, context, settings);
+  if (error) {
+    return *error;
   }
 
   // finally get the data using a data handle
@@ -132,73 +284,215 @@ DataResponse DataRepository::GetBlobData(
     }
   }
 
-  auto blob_api = ApiClientLookup::LookupApi(
-      catalog, cancellation_context, service, "v1", fetch_option, settings);
+  auto fetch = [&](client::CancellationContext context) -> DataResponse {
+    auto blob_api = ApiClientLookup::LookupApi(catalog, context, service, "v1",
+                                               fetch_option, settings);
 
-  if (!blob_api.IsSuccessful()) {
-    return blob_api.GetError();
-  }
+    if (!blob_api.IsSuccessful()) {
+      return blob_api.GetError();
+    }
 
-  BlobApi::DataResponse blob_response;
+    auto blob_client = blob_api.MoveResult();
+    blob_client.SetPriority(data_request.GetPriority());
+
+    BlobApi::DataResponse blob_response;
+    bool download_at_once = true;
+
+    if (service == kBlobService && data_request.GetDownloadChunkSize()) {
+      blob_response = GetBlobInRanges(blob_client, layer, data_request,
+                                      settings, context);
+      download_at_once =
+          !blob_response.IsSuccessful() &&
+          RangedDownload::IsRangeIgnored(blob_response.GetError());
+      if (download_at_once) {
+        OLP_SDK_LOG_INFO_F(kLogTag, "byte ranges of '%s' are ignored",
+                           data_request.CreateKey(layer).c_str());
+      }
+    }
 
-  if (service == kBlobService) {
-    blob_response = BlobApi::GetBlob(
-        blob_api.GetResult(), layer, data_handle.value(),
-        data_request.GetBillingTag(), boost::none, cancellation_context);
-  } else {
-    blob_response = VolatileBlobApi::GetVolatileBlob(
-        blob_api.GetResult(), layer, data_handle.value(),
-        data_request.GetBillingTag(), cancellation_context);
-  }
+    if (service == kBlobService && download_at_once) {
+      blob_response = BlobApi::GetBlob(blob_client, layer, data_handle.value(),
+                                       data_request.GetBillingTag(),
+                                       boost::none, context);
+    } else if (service != kBlobService) {
+      blob_response = VolatileBlobApi::GetVolatileBlob(
+          blob_client, layer, data_handle.value(),
+          data_request.GetBillingTag(), context);
+    }
 
-  if (blob_response.IsSuccessful()) {
-    repository.Put(blob_response.GetResult(), layer, data_handle.value());
-  } else {
-    const auto& error = blob_response.GetError();
-    if (error.GetHttpStatusCode() == http::HttpStatusCode::FORBIDDEN) {
-      OLP_SDK_LOG_INFO_F(kLogTag, "clear '%s' cache",
-                         data_request.CreateKey(layer).c_str());
-      repository.Clear(layer, data_handle.value());
+    if (blob_response.IsSuccessful()) {
+      repository.Put(blob_response.GetResult(), layer, data_handle.value());
+    } else {
+      const auto& error = blob_response.GetError();
+      if (error.GetHttpStatusCode() == http::HttpStatusCode::FORBIDDEN) {
+        OLP_SDK_LOG_INFO_F(kLogTag, "clear '%s' cache",
+                           data_request.CreateKey(layer).c_str());
+        repository.Clear(layer, data_handle.value());
+      }
     }
-  }
 
-  return blob_response;
+    return blob_response;
+  };
+
+  const auto key = CoalescingKey(settings, catalog, layer, service,
+                                 data_handle.value(),
+                                 data_request.GetBillingTag());
+  return GetBlobFlights().Execute(key, cancellation_context, fetch);
 }
 
 DataResponse DataRepository::GetVolatileData(
     const client::HRN& catalog, const std::string& layer_id,
     DataRequest request, client::CancellationContext context,
     client::OlpClientSettings settings) {
-  if (request.GetDataHandle() && request.GetPartitionId()) {
-    return ApiError(ErrorCode::PreconditionFailed,
-                    "Both data handle and partition id specified");
+  auto error =
+      ResolveDataHandle(catalog, layer_id, false, request, context, settings);
+  if (error) {
+    return *error;
   }
 
-  if (!request.GetDataHandle()) {
-    auto partitions_response =
-        repository::PartitionsRepository::GetPartitionById(
-            catalog, layer_id, context, request, settings);
+  return repository::DataRepository::GetBlobData(
+      catalog, layer_id, kVolatileBlobService, request, context, settings);
+}
+
+DataStreamResponse DataRepository::StreamVersionedData(
+    const client::HRN& catalog, const std::string& layer_id,
+    DataRequest request, DataChunkCallback chunk_callback,
+    client::CancellationContext context, client::OlpClientSettings settings) {
+  auto error =
+      ResolveDataHandle(catalog, layer_id, true, request, context, settings);
+  if (error) {
+    return *error;
+  }
+
+  return repository::DataRepository::StreamBlobData(
+      catalog, layer_id, kBlobService, request, std::move(chunk_callback),
+      context, settings);
+}
+
+DataStreamResponse DataRepository::StreamVolatileData(
+    const client::HRN& catalog, const std::string& layer_id,
+    DataRequest request, DataChunkCallback chunk_callback,
+    client::CancellationContext context, client::OlpClientSettings settings) {
+  auto error =
+      ResolveDataHandle(catalog, layer_id, false, request, context, settings);
+  if (error) {
+    return *error;
+  }
+
+  return repository::DataRepository::StreamBlobData(
+      catalog, layer_id, kVolatileBlobService, request,
+      std::move(chunk_callback), context, settings);
+}
+
+DataStreamResponse DataRepository::StreamBlobData(
+    const client::HRN& catalog, const std::string& layer,
+    const std::string& service, const DataRequest& data_request,
+    DataChunkCallback chunk_callback,
+    client::CancellationContext cancellation_context,
+    client::OlpClientSettings settings) {
+  auto fetch_option = data_request.GetFetchOption();
+  const auto& data_handle = data_request.GetDataHandle();
+
+  if (!data_handle) {
+    return ApiError(ErrorCode::PreconditionFailed, "Data handle is missing");
+  }
+
+  // The streamed data is not stored in the cache, so there is nothing to
+  // update.
+  if (fetch_option == CacheWithUpdate) {
+    return ApiError(ErrorCode::InvalidArgument,
+                    "CacheWithUpdate is not supported for the streamed data");
+  }
+
+  repository::DataCacheRepository repository(catalog, settings.cache);
+
+  if (fetch_option != OnlineOnly) {
+    auto cached_data = repository.Get(layer, data_handle.value());
+    if (cached_data && cached_data.value()) {
+      OLP_SDK_LOG_INFO_F(kLogTag, "cache data '%s' found!",
+                         data_request.CreateKey(layer).c_str());
+      const auto& data = *cached_data.value();
+      if (!data.empty()) {
+        chunk_callback(data.data(), 0u, data.size());
+      }
+      return DataStreamResult(data.size());
+    } else if (fetch_option == CacheOnly) {
+      OLP_SDK_LOG_INFO_F(kLogTag, "cache data '%s' not found!",
+                         data_request.CreateKey(layer).c_str());
+      return ApiError(ErrorCode::NotFound,
+                      "Cache only resource not found in cache (data).");
+    }
+  }
+
+  auto blob_api = ApiClientLookup::LookupApi(
+      catalog, cancellation_context, service, "v1", fetch_option, settings);
+
+  if (!blob_api.IsSuccessful()) {
+    return blob_api.GetError();
+  }
 
-    if (!partitions_response.IsSuccessful()) {
-      return partitions_response.GetError();
+  auto blob_client = blob_api.MoveResult();
+  blob_client.SetPriority(data_request.GetPriority());
+
+  // The retries skip the data that was already received, so the end of
+  // the last chunk is the size of the data.
+  ChunkFilter filter(std::move(chunk_callback));
+  DataStreamResult size = 0u;
+  auto data_callback = [&](const std::uint8_t* data, std::uint64_t offset,
+                           std::size_t length) {
+    size = offset + length;
+    filter.Pass(data, offset, length);
+  };
+
+  if (service == kBlobService && data_request.GetDownloadChunkSize()) {
+    auto response = StreamBlobInRanges(
+        blob_client, layer, data_request, settings,
+        [&](const std::uint8_t* data, std::uint64_t offset,
+            std::size_t length) { filter.Pass(data, offset, length); },
+        cancellation_context, nullptr);
+    if (!response.IsSuccessful() &&
+        response.GetError().GetHttpStatusCode() ==
+            http::HttpStatusCode::FORBIDDEN) {
+      OLP_SDK_LOG_INFO_F(kLogTag, "clear '%s' cache",
+                         data_request.CreateKey(layer).c_str());
+      repository.Clear(layer, data_handle.value());
+    }
+    if (response.IsSuccessful() ||
+        !RangedDownload::IsRangeIgnored(response.GetError())) {
+      return response;
     }
 
-    const auto& partitions = partitions_response.GetResult().GetPartitions();
-    if (partitions.empty()) {
-      OLP_SDK_LOG_INFO_F(kLogTag, "Partition %s not found",
-                         request.GetPartitionId()
-                             ? request.GetPartitionId().get().c_str()
-                             : "<none>");
+    // The blob is streamed from the start in one request, the ranges that
+    // were already passed to the chunk callback are skipped.
+    OLP_SDK_LOG_INFO_F(kLogTag, "byte ranges of '%s' are ignored",
+                       data_request.CreateKey(layer).c_str());
+  }
 
-      return client::ApiError(client::ErrorCode::NotFound,
-                              "Partition not found");
+  VolatileBlobApi::StreamResponse blob_response = client::ApiNoResult();
+  if (service == kBlobService) {
+    auto response = BlobApi::StreamBlob(
+        blob_client, layer, data_handle.value(), data_request.GetBillingTag(),
+        boost::none, data_callback, cancellation_context);
+    if (!response.IsSuccessful()) {
+      blob_response = response.GetError();
     }
+  } else {
+    blob_response = VolatileBlobApi::StreamVolatileBlob(
+        blob_client, layer, data_handle.value(), data_request.GetBillingTag(),
+        data_callback, cancellation_context);
+  }
 
-    request.WithDataHandle(partitions.front().GetDataHandle());
+  if (!blob_response.IsSuccessful()) {
+    const auto& error = blob_response.GetError();
+    if (error.GetHttpStatusCode() == http::HttpStatusCode::FORBIDDEN) {
+      OLP_SDK_LOG_INFO_F(kLogTag, "clear '%s' cache",
+                         data_request.CreateKey(layer).c_str());
+      repository.Clear(layer, data_handle.value());
+    }
+    return error;
   }
 
-  return repository::DataRepository::GetBlobData(
-      catalog, layer_id, kVolatileBlobService, request, context, settings);
+  return size;
 }
 
 }  // namespace repository
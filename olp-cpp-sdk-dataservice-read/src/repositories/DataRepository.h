@@ -30,6 +30,8 @@ namespace dataservice {
 namespace read {
 class DataRequest;
 namespace repository {
+template <typename Response>
+class SingleFlight;
 
 class DataRepository final {
  public:
@@ -50,6 +52,34 @@ class DataRepository final {
       const std::string& service, const DataRequest& data_request,
       client::CancellationContext cancellation_context,
       client::OlpClientSettings settings);
+
+  static DataStreamResponse StreamVersionedData(
+      const client::HRN& catalog, const std::string& layer_id,
+      DataRequest data_request, DataChunkCallback chunk_callback,
+      client::CancellationContext context, client::OlpClientSettings settings);
+
+  static DataStreamResponse StreamVolatileData(
+      const client::HRN& catalog, const std::string& layer_id,
+      DataRequest data_request, DataChunkCallback chunk_callback,
+      client::CancellationContext context, client::OlpClientSettings settings);
+
+  static DataStreamResponse StreamBlobData(
+      const client::HRN& catalog, const std::string& layer,
+      const std::string& service, const DataRequest& data_request,
+      DataChunkCallback chunk_callback,
+      client::CancellationContext cancellation_context,
+      client::OlpClientSettings settings);
+
+  /// Gets the fetches of the data blobs that are in flight, shared by all
+  /// the clients.
+  static SingleFlight<DataResponse>& GetBlobFlights();
+
+ private:
+  static boost::optional<client::ApiError> ResolveDataHandle(
+      const client::HRN& catalog, const std::string& layer_id,
+      bool versioned, DataRequest& request,
+      client::CancellationContext context,
+      const client::OlpClientSettings& settings);
 };
 }  // namespace repository
 }  // namespace read
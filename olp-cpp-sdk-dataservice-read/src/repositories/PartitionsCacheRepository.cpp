@@ -19,6 +19,8 @@
 
 #include "PartitionsCacheRepository.h"
 
+#include <algorithm>
+#include <limits>
 #include <string>
 
 #include <olp/core/cache/KeyValueCache.h>
@@ -36,20 +38,9 @@
 namespace {
 constexpr auto kLogTag = "PartitionsCacheRepository";
 
-std::string CreateKey(const std::string& hrn, const std::string& layer_id,
-                      const std::string& partitionId,
-                      const boost::optional<int64_t>& version) {
-  return hrn + "::" + layer_id + "::" + partitionId +
-         "::" + (version ? std::to_string(*version) + "::partition" : "");
-}
-std::string CreateKey(const std::string& hrn, const std::string& layer_id,
-                      const boost::optional<int64_t>& version) {
-  return hrn + "::" + layer_id +
-         "::" + (version ? std::to_string(*version) + "::partitions" : "");
-}
-std::string CreateKey(const std::string& hrn, const int64_t catalogVersion) {
-  return hrn + "::" + std::to_string(catalogVersion) + "::layerVersions";
-}
+// How long the validator and the stale copy of the partitions are kept after
+// the partitions expire.
+constexpr time_t kStaleTime = 24 * 60 * 60;
 }  // namespace
 
 namespace olp {
@@ -59,52 +50,66 @@ namespace repository {
 using namespace olp::client;
 PartitionsCacheRepository::PartitionsCacheRepository(
     const HRN& hrn, std::shared_ptr<cache::KeyValueCache> cache)
-    : hrn_(hrn), cache_(cache) {}
+    : hrn_(hrn), key_encoder_(hrn.ToCatalogHRNString()), cache_(cache) {}
 
 void PartitionsCacheRepository::Put(const PartitionsRequest& request,
                                     const model::Partitions& partitions,
                                     const std::string& layer_id,
                                     const boost::optional<time_t>& expiry,
                                     bool allLayer) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  OLP_SDK_LOG_TRACE_F(kLogTag, "Put '%s'", hrn.c_str());
+  OLP_SDK_LOG_TRACE_F(kLogTag, "Put '%s'", hrn_.ToCatalogHRNString().c_str());
   std::vector<std::string> partitionIds;
   time_t no_expiry = std::numeric_limits<time_t>::max();
 
-  for (auto partition : partitions.GetPartitions()) {
-    auto key = CreateKey(hrn, layer_id, partition.GetPartition(),
-                         request.GetVersion());
-    OLP_SDK_LOG_INFO_F(kLogTag, "Put '%s'", key.c_str());
-    cache_->Put(key, partition,
-                [=]() { return olp::serializer::serialize(partition); },
-                expiry.get_value_or(no_expiry));
+  // All the partitions are written to the cache in one batch.
+  cache::KeyValueCache::BatchItems items;
+  items.reserve(partitions.GetPartitions().size() + 1);
+  for (const auto& partition : partitions.GetPartitions()) {
+    cache::KeyValueCache::BatchItem item;
+    item.key = key_encoder_.Partition(layer_id, partition.GetPartition(),
+                                      request.GetVersion());
+    OLP_SDK_LOG_INFO_F(kLogTag, "Put partition '%s', layer '%s'",
+                       partition.GetPartition().c_str(), layer_id.c_str());
+    item.value = partition;
+    item.encoder = [=]() { return olp::serializer::serialize(partition); };
+    item.expiry = expiry.get_value_or(no_expiry);
+    items.emplace_back(std::move(item));
     if (allLayer) {
       partitionIds.push_back(partition.GetPartition());
     }
   }
   if (allLayer) {
-    auto key = CreateKey(hrn, layer_id, request.GetVersion());
-    OLP_SDK_LOG_INFO_F(kLogTag, "Put '%s'", key.c_str());
-    cache_->Put(key, partitionIds,
-                [=]() { return olp::serializer::serialize(partitionIds); },
-                expiry.get_value_or(no_expiry));
+    cache::KeyValueCache::BatchItem item;
+    item.key = key_encoder_.Partitions(layer_id, request.GetVersion());
+    OLP_SDK_LOG_INFO_F(kLogTag, "Put partitions, layer '%s'",
+                       layer_id.c_str());
+    item.value = partitionIds;
+    item.encoder = [=]() { return olp::serializer::serialize(partitionIds); };
+    item.expiry = expiry.get_value_or(no_expiry);
+    items.emplace_back(std::move(item));
   }
+  cache_->PutBatch(items);
 }
 
 model::Partitions PartitionsCacheRepository::Get(
     const PartitionsRequest& request,
     const std::vector<std::string>& partitionIds, const std::string& layer_id) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  OLP_SDK_LOG_TRACE_F(kLogTag, "Get '%s'", hrn.c_str());
+  OLP_SDK_LOG_TRACE_F(kLogTag, "Get '%s'", hrn_.ToCatalogHRNString().c_str());
   model::Partitions cachedPartitionsModel;
   std::vector<model::Partition> cachedPartitions;
-  for (auto partitionId : partitionIds) {
-    auto key = CreateKey(hrn, layer_id, partitionId, request.GetVersion());
-    OLP_SDK_LOG_INFO_F(kLogTag, "Get '%s'", key.c_str());
-    auto cachedPartition =
-        cache_->Get(key, [](const std::string& serializedObject) {
-          return parser::parse<model::Partition>(serializedObject);
-        });
+  std::vector<std::string> keys;
+  keys.reserve(partitionIds.size());
+  for (const auto& partitionId : partitionIds) {
+    keys.push_back(
+        key_encoder_.Partition(layer_id, partitionId, request.GetVersion()));
+    OLP_SDK_LOG_INFO_F(kLogTag, "Get partition '%s', layer '%s'",
+                       partitionId.c_str(), layer_id.c_str());
+  }
+  auto cachedValues =
+      cache_->GetBatch(keys, [](const std::string& serializedObject) {
+        return parser::parse<model::Partition>(serializedObject);
+      });
+  for (const auto& cachedPartition : cachedValues) {
     if (!cachedPartition.empty()) {
       cachedPartitions.push_back(
           boost::any_cast<model::Partition>(cachedPartition));
@@ -116,9 +121,9 @@ model::Partitions PartitionsCacheRepository::Get(
 
 boost::optional<model::Partitions> PartitionsCacheRepository::Get(
     const PartitionsRequest& request, const std::string& layer_id) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn, layer_id, request.GetVersion());
-  OLP_SDK_LOG_TRACE_F(kLogTag, "Get '%s'", key.c_str());
+  auto key = key_encoder_.Partitions(layer_id, request.GetVersion());
+  OLP_SDK_LOG_TRACE_F(kLogTag, "Get '%s', layer '%s'",
+                      hrn_.ToCatalogHRNString().c_str(), layer_id.c_str());
   auto cachedIds = cache_->Get(key, [](const std::string& serializedIds) {
     return parser::parse<std::vector<std::string>>(serializedIds);
   });
@@ -130,21 +135,95 @@ boost::optional<model::Partitions> PartitionsCacheRepository::Get(
              layer_id);
 }
 
+void PartitionsCacheRepository::PutValidator(
+    const PartitionsRequest& request, const std::string& layer_id,
+    const ResponseValidator& validator, const model::Partitions& partitions,
+    const boost::optional<time_t>& expiry) {
+  OLP_SDK_LOG_TRACE_F(kLogTag, "PutValidator '%s', layer '%s'",
+                      hrn_.ToCatalogHRNString().c_str(), layer_id.c_str());
+  auto key = key_encoder_.PartitionsValidator(layer_id, request.GetVersion());
+  auto stale_key =
+      key_encoder_.StalePartitions(layer_id, request.GetVersion());
+  if (validator.Empty()) {
+    cache_->Remove(key);
+    cache_->Remove(stale_key);
+    return;
+  }
+
+  // The partitions without expiry are never stale.
+  if (!expiry) {
+    cache_->Put(key, validator, [validator]() { return validator.Encode(); });
+    cache_->Remove(stale_key);
+    return;
+  }
+
+  const auto stale_expiry =
+      std::min(*expiry, std::numeric_limits<time_t>::max() - kStaleTime) +
+      kStaleTime;
+  cache::KeyValueCache::BatchItems items(2u);
+  items[0].key = std::move(key);
+  items[0].value = validator;
+  items[0].encoder = [validator]() { return validator.Encode(); };
+  items[0].expiry = stale_expiry;
+  items[1].key = std::move(stale_key);
+  items[1].value = partitions;
+  items[1].encoder = [partitions]() {
+    return olp::serializer::serialize(partitions);
+  };
+  items[1].expiry = stale_expiry;
+  cache_->PutBatch(items);
+}
+
+boost::optional<ResponseValidator> PartitionsCacheRepository::GetValidator(
+    const PartitionsRequest& request, const std::string& layer_id) {
+  OLP_SDK_LOG_TRACE_F(kLogTag, "GetValidator '%s', layer '%s'",
+                      hrn_.ToCatalogHRNString().c_str(), layer_id.c_str());
+  auto cached_validator =
+      cache_->Get(key_encoder_.PartitionsValidator(layer_id,
+                                                   request.GetVersion()),
+                  [](const std::string& value) -> boost::any {
+                    auto validator = ResponseValidator::Decode(value);
+                    if (!validator) {
+                      return boost::any();
+                    }
+                    return *validator;
+                  });
+  if (cached_validator.empty()) {
+    return boost::none;
+  }
+  return boost::any_cast<ResponseValidator>(cached_validator);
+}
+
+boost::optional<model::Partitions> PartitionsCacheRepository::GetStale(
+    const PartitionsRequest& request, const std::string& layer_id) {
+  OLP_SDK_LOG_TRACE_F(kLogTag, "GetStale '%s', layer '%s'",
+                      hrn_.ToCatalogHRNString().c_str(), layer_id.c_str());
+  auto cached_partitions = cache_->Get(
+      key_encoder_.StalePartitions(layer_id, request.GetVersion()),
+      [](const std::string& serialized_partitions) {
+        return parser::parse<model::Partitions>(serialized_partitions);
+      });
+  if (cached_partitions.empty()) {
+    return boost::none;
+  }
+  return boost::any_cast<model::Partitions>(cached_partitions);
+}
+
 void PartitionsCacheRepository::Put(int64_t catalogVersion,
                                     const model::LayerVersions& layerVersions) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  OLP_SDK_LOG_INFO_F(kLogTag, "Put '%s'", hrn.c_str());
-  cache_->Put(CreateKey(hrn, catalogVersion), layerVersions,
+  OLP_SDK_LOG_INFO_F(kLogTag, "Put '%s'", hrn_.ToCatalogHRNString().c_str());
+  cache_->Put(key_encoder_.LayerVersions(catalogVersion), layerVersions,
               [=]() { return olp::serializer::serialize(layerVersions); });
 }
 
 boost::optional<model::LayerVersions> PartitionsCacheRepository::Get(
     int64_t catalogVersion) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn, catalogVersion);
-  OLP_SDK_LOG_INFO_F(kLogTag, "Get '%s'", key.c_str());
-  auto cachedLayerVersions =
-      cache_->Get(key, [](const std::string& serializedObject) {
+  OLP_SDK_LOG_INFO_F(kLogTag, "Get '%s', layer versions of %lld",
+                     hrn_.ToCatalogHRNString().c_str(),
+                     static_cast<long long>(catalogVersion));
+  auto cachedLayerVersions = cache_->Get(
+      key_encoder_.LayerVersions(catalogVersion),
+      [](const std::string& serializedObject) {
         return parser::parse<model::LayerVersions>(serializedObject);
       });
   if (cachedLayerVersions.empty()) {
@@ -154,24 +233,23 @@ boost::optional<model::LayerVersions> PartitionsCacheRepository::Get(
 }
 
 void PartitionsCacheRepository::Clear(const std::string& layer_id) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  auto key = CreateKey(hrn, layer_id, boost::none);
-  OLP_SDK_LOG_INFO_F(kLogTag, "Clear '%s'", key.c_str());
-  cache_->RemoveKeysWithPrefix(key);
+  OLP_SDK_LOG_INFO_F(kLogTag, "Clear '%s', layer '%s'",
+                     hrn_.ToCatalogHRNString().c_str(), layer_id.c_str());
+  cache_->RemoveKeysWithPrefix(key_encoder_.LayerPrefix(layer_id));
 }
 
 void PartitionsCacheRepository::ClearPartitions(
     const PartitionsRequest& request,
     const std::vector<std::string>& partitionIds, const std::string& layer_id) {
-  std::string hrn(hrn_.ToCatalogHRNString());
-  OLP_SDK_LOG_INFO_F(kLogTag, "ClearPartitions '%s'", hrn.c_str());
+  OLP_SDK_LOG_INFO_F(kLogTag, "ClearPartitions '%s'",
+                     hrn_.ToCatalogHRNString().c_str());
   auto cachedPartitions = Get(request, partitionIds, layer_id);
   // Partitions not processed here are not cached to begin with.
   for (auto partition : cachedPartitions.GetPartitions()) {
-    cache_->RemoveKeysWithPrefix(hrn + "::" + layer_id +
-                                 "::" + partition.GetDataHandle());
-    cache_->RemoveKeysWithPrefix(hrn + "::" + layer_id +
-                                 "::" + partition.GetPartition());
+    cache_->RemoveKeysWithPrefix(
+        key_encoder_.Data(layer_id, partition.GetDataHandle()));
+    cache_->RemoveKeysWithPrefix(
+        key_encoder_.PartitionPrefix(layer_id, partition.GetPartition()));
   }
 }
 
@@ -21,10 +21,12 @@
 
 #include <memory>
 
+#include <olp/core/cache/KeyEncoder.h>
 #include <olp/core/client/HRN.h>
 #include <olp/dataservice/read/PartitionsRequest.h>
 #include <olp/dataservice/read/model/Partitions.h>
 #include <boost/optional.hpp>
+#include "ResponseValidator.h"
 #include "generated/model/LayerVersions.h"
 
 namespace olp {
@@ -53,6 +55,23 @@ class PartitionsCacheRepository final {
   boost::optional<model::Partitions> Get(const PartitionsRequest& request,
                                          const std::string& layer_id);
 
+  /// Puts the validator of the partitions and, if the partitions expire,
+  /// their stale copy. Both are kept for a while after the partitions
+  /// expire, so the expired partitions can be revalidated. Removes both if
+  /// the validator is empty.
+  void PutValidator(const PartitionsRequest& request,
+                    const std::string& layer_id,
+                    const ResponseValidator& validator,
+                    const model::Partitions& partitions,
+                    const boost::optional<time_t>& expiry);
+
+  boost::optional<ResponseValidator> GetValidator(
+      const PartitionsRequest& request, const std::string& layer_id);
+
+  /// Gets the stale copy of the expired partitions, see `PutValidator`.
+  boost::optional<model::Partitions> GetStale(const PartitionsRequest& request,
+                                              const std::string& layer_id);
+
   void Put(int64_t catalogVersion, const model::LayerVersions& layerVersions);
 
   boost::optional<model::LayerVersions> Get(int64_t catalogVersion);
@@ -65,6 +84,7 @@ class PartitionsCacheRepository final {
 
  private:
   client::HRN hrn_;
+  cache::KeyEncoder key_encoder_;
   std::shared_ptr<cache::KeyValueCache> cache_;
 };
 }  // namespace repository
@@ -19,12 +19,16 @@
 
 #include "PartitionsRepository.h"
 
+#include <sstream>
+
 #include <olp/core/client/Condition.h>
 #include <olp/core/logging/Log.h>
 
 #include "ApiClientLookup.h"
 #include "CatalogRepository.h"
 #include "PartitionsCacheRepository.h"
+#include "ResponseValidator.h"
+#include "SingleFlight.h"
 #include "generated/api/MetadataApi.h"
 #include "generated/api/QueryApi.h"
 #include "olp/dataservice/read/CatalogRequest.h"
@@ -60,8 +64,34 @@ ApiResponse<boost::optional<time_t>, ApiError> TtlForLayer(
                   "Layer specified doesn't exist.");
 }
 
+// The concurrent requests are coalesced only if they share the cache, so
+// a client never gets the metadata that it could not read from its own cache.
+std::string CoalescingKey(const client::OlpClientSettings& settings,
+                          const client::HRN& catalog, const std::string& layer,
+                          const std::string& resource,
+                          const boost::optional<int64_t>& version,
+                          const boost::optional<std::string>& billing_tag) {
+  std::stringstream out;
+  out << static_cast<const void*>(settings.cache.get())
+      << "::" << catalog.ToCatalogHRNString() << "::" << layer
+      << "::" << resource;
+  if (version) {
+    out << "@" << version.get();
+  }
+  if (billing_tag) {
+    out << "$" << billing_tag.get();
+  }
+  return out.str();
+}
+
 }  // namespace
 
+SingleFlight<PartitionsResponse>&
+PartitionsRepository::GetPartitionsFlights() {
+  static SingleFlight<PartitionsResponse> flights;
+  return flights;
+}
+
 PartitionsResponse PartitionsRepository::GetVersionedPartitions(
     client::HRN catalog, std::string layer,
     client::CancellationContext cancellation_context, PartitionsRequest request,
@@ -137,32 +167,76 @@ PartitionsResponse PartitionsRepository::GetPartitions(
     }
   }
 
-  auto query_api =
-      ApiClientLookup::LookupApi(catalog, cancellation_context, "metadata",
-                                 "v1", fetch_option, std::move(settings));
+  auto fetch = [&](client::CancellationContext context) -> PartitionsResponse {
+    auto query_api = ApiClientLookup::LookupApi(catalog, context, "metadata",
+                                                "v1", fetch_option, settings);
 
-  if (!query_api.IsSuccessful()) {
-    return query_api.GetError();
-  }
+    if (!query_api.IsSuccessful()) {
+      return query_api.GetError();
+    }
+
+    auto metadata_client = query_api.MoveResult();
+    metadata_client.SetPriority(request.GetPriority());
+
+    // The partitions of a layer version never change, while the partitions
+    // of a volatile layer are revalidated, also after they expire, so
+    // the unchanged partitions are not downloaded again on refresh.
+    const bool revalidate = !request.GetVersion();
+    boost::optional<model::Partitions> cached_partitions;
+    boost::optional<ResponseValidator> cached_validator;
+    if (revalidate) {
+      cached_validator = repository.GetValidator(request, layer);
+    }
+    if (cached_validator) {
+      cached_partitions = repository.Get(request, layer);
+      if (!cached_partitions) {
+        cached_partitions = repository.GetStale(request, layer);
+      }
+      if (!cached_partitions) {
+        cached_validator = boost::none;
+      }
+    }
+    auto validator = cached_validator.value_or(ResponseValidator());
 
-  auto metadata_response = MetadataApi::GetPartitions(
-      query_api.GetResult(), layer, request.GetVersion(), boost::none,
-      boost::none, request.GetBillingTag(), cancellation_context);
-
-  if (metadata_response.IsSuccessful()) {
-    OLP_SDK_LOG_INFO_F(kLogTag, "put '%s' to cache",
-                       request.CreateKey(layer).c_str());
-    repository.Put(request, metadata_response.GetResult(), layer, expiry, true);
-  } else {
-    const auto& error = metadata_response.GetError();
-    if (error.GetHttpStatusCode() == http::HttpStatusCode::FORBIDDEN) {
-      OLP_SDK_LOG_INFO_F(kLogTag, "clear '%s' cache",
+    auto metadata_response = MetadataApi::GetPartitions(
+        metadata_client, layer, request.GetVersion(), boost::none, boost::none,
+        request.GetBillingTag(), context, revalidate ? &validator : nullptr);
+
+    if (metadata_response.IsSuccessful()) {
+      OLP_SDK_LOG_INFO_F(kLogTag, "put '%s' to cache",
                          request.CreateKey(layer).c_str());
-      repository.Clear(layer);
+      repository.Put(request, metadata_response.GetResult(), layer, expiry,
+                     true);
+      if (revalidate && (cached_validator || !validator.Empty())) {
+        repository.PutValidator(request, layer, validator,
+                                metadata_response.GetResult(), expiry);
+      }
+    } else {
+      const auto& error = metadata_response.GetError();
+      if (cached_validator && error.GetHttpStatusCode() ==
+                                  http::HttpStatusCode::NOT_MODIFIED) {
+        // The cached partitions are put back to refresh their expiry.
+        OLP_SDK_LOG_INFO_F(kLogTag, "put '%s' to cache, not modified",
+                           request.CreateKey(layer).c_str());
+        repository.Put(request, *cached_partitions, layer, expiry, true);
+        repository.PutValidator(request, layer, validator, *cached_partitions,
+                                expiry);
+        return std::move(*cached_partitions);
+      }
+      if (error.GetHttpStatusCode() == http::HttpStatusCode::FORBIDDEN) {
+        OLP_SDK_LOG_INFO_F(kLogTag, "clear '%s' cache",
+                           request.CreateKey(layer).c_str());
+        repository.Clear(layer);
+      }
     }
-  }
 
-  return metadata_response;
+    return metadata_response;
+  };
+
+  const auto key =
+      CoalescingKey(settings, catalog, layer, "partitions",
+                    request.GetVersion(), request.GetBillingTag());
+  return GetPartitionsFlights().Execute(key, cancellation_context, fetch);
 }
 
 PartitionsResponse PartitionsRepository::GetPartitionById(
@@ -201,36 +275,43 @@ PartitionsResponse PartitionsRepository::GetPartitionById(
     }
   }
 
-  auto query_api =
-      ApiClientLookup::LookupApi(catalog, cancellation_context, "query", "v1",
-                                 fetch_option, std::move(settings));
+  auto fetch = [&](client::CancellationContext context) -> PartitionsResponse {
+    auto query_api = ApiClientLookup::LookupApi(catalog, context, "query",
+                                                "v1", fetch_option, settings);
 
-  if (!query_api.IsSuccessful()) {
-    return query_api.GetError();
-  }
+    if (!query_api.IsSuccessful()) {
+      return query_api.GetError();
+    }
+
+    auto client = query_api.MoveResult();
+    client.SetPriority(data_request.GetPriority());
+
+    PartitionsResponse query_response = QueryApi::GetPartitionsbyId(
+        client, layer, partitions, version, boost::none,
+        data_request.GetBillingTag(), context);
 
-  const client::OlpClient& client = query_api.GetResult();
-
-  PartitionsResponse query_response = QueryApi::GetPartitionsbyId(
-      client, layer, partitions, version, boost::none,
-      data_request.GetBillingTag(), cancellation_context);
-
-  if (query_response.IsSuccessful()) {
-    OLP_SDK_LOG_INFO_F(kLogTag, "put '%s' to cache",
-                       data_request.CreateKey(layer).c_str());
-    repository.Put(partition_request, query_response.GetResult(), layer,
-                   boost::none /* TODO: expiration */);
-  } else {
-    const auto& error = query_response.GetError();
-    if (error.GetHttpStatusCode() == http::HttpStatusCode::FORBIDDEN) {
-      OLP_SDK_LOG_INFO_F(kLogTag, "clear '%s' cache",
+    if (query_response.IsSuccessful()) {
+      OLP_SDK_LOG_INFO_F(kLogTag, "put '%s' to cache",
                          data_request.CreateKey(layer).c_str());
-      // Delete partitions only but not the layer
-      repository.ClearPartitions(partition_request, partitions, layer);
+      repository.Put(partition_request, query_response.GetResult(), layer,
+                     boost::none /* TODO: expiration */);
+    } else {
+      const auto& error = query_response.GetError();
+      if (error.GetHttpStatusCode() == http::HttpStatusCode::FORBIDDEN) {
+        OLP_SDK_LOG_INFO_F(kLogTag, "clear '%s' cache",
+                           data_request.CreateKey(layer).c_str());
+        // Delete partitions only but not the layer
+        repository.ClearPartitions(partition_request, partitions, layer);
+      }
     }
-  }
 
-  return query_response;
+    return query_response;
+  };
+
+  const auto key = CoalescingKey(settings, catalog, layer,
+                                 "partition::" + partition_id.get(), version,
+                                 data_request.GetBillingTag());
+  return GetPartitionsFlights().Execute(key, cancellation_context, fetch);
 }
 
 }  // namespace repository
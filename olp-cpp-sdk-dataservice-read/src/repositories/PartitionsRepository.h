@@ -38,6 +38,8 @@ namespace repository {
 class ApiRepository;
 class CatalogRepository;
 class PartitionsCacheRepository;
+template <typename Response>
+class SingleFlight;
 
 class PartitionsRepository final {
  public:
@@ -56,6 +58,10 @@ class PartitionsRepository final {
       client::CancellationContext cancellation_context,
       const DataRequest& data_request, client::OlpClientSettings settings);
 
+  /// Gets the fetches of the partition metadata that are in flight, shared by
+  /// all the clients.
+  static SingleFlight<PartitionsResponse>& GetPartitionsFlights();
+
  private:
   static PartitionsResponse GetPartitions(
       client::HRN catalog, std::string layer,
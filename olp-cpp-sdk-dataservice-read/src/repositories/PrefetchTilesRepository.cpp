@@ -219,8 +219,11 @@ SubQuadsResponse PrefetchTilesRepository::GetSubQuads(
   OLP_SDK_LOG_INFO_F(kLogTag,
                      "GetSubQuads execute(%s, %" PRId64 ", %" PRId32 ")",
                      tile_key.c_str(), version, depth);
+  auto query_client = query_api.MoveResult();
+  query_client.SetPriority(request.GetPriority());
+
   auto quad_tree = QueryApi::QuadTreeIndex(
-      query_api.GetResult(), layer_id, version, tile_key, depth, boost::none,
+      query_client, layer_id, version, tile_key, depth, boost::none,
       request.GetBillingTag(), context);
 
   if (!quad_tree.IsSuccessful()) {
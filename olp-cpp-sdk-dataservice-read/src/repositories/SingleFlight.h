@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/optional.hpp>
+
+#include <olp/core/client/ApiError.h>
+#include <olp/core/client/CancellationContext.h>
+#include <olp/core/client/CancellationToken.h>
+#include "olp/dataservice/read/CoalescingStatistics.h"
+
+namespace olp {
+namespace dataservice {
+namespace read {
+namespace repository {
+
+/// Lets the concurrent identical requests share one fetch.
+///
+/// The first caller of `Execute` for a key runs the fetch on its own thread,
+/// and the callers that come with the same key while the fetch is in flight
+/// wait for its response. The fetch gets its own cancellation context that is
+/// cancelled only when every caller has cancelled. A cancelled caller returns
+/// right away, except for the one that runs the fetch: it returns when the
+/// fetch is finished.
+template <typename Response>
+class SingleFlight final {
+ public:
+  using FetchFunc = std::function<Response(client::CancellationContext)>;
+
+  /// Runs the fetch, or waits for the fetch with the same key that is already
+  /// in flight.
+  ///
+  /// @param key The key of the fetched resource, including everything that
+  /// changes the response.
+  /// @param context The cancellation context of the caller.
+  /// @param fetch The fetch that is run if no fetch is in flight.
+  ///
+  /// @return The response of the shared fetch, or the `Cancelled` error if
+  /// the caller is cancelled.
+  Response Execute(const std::string& key, client::CancellationContext context,
+                   const FetchFunc& fetch) {
+    std::shared_ptr<Flight> flight;
+    bool leader = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = flights_.find(key);
+      if (it != flights_.end() && !it->second->cancelled) {
+        flight = it->second;
+        coalesced_.fetch_add(1u, std::memory_order_relaxed);
+      } else {
+        flight = std::make_shared<Flight>();
+        flights_[key] = flight;
+        leader = true;
+      }
+      ++flight->waiters;
+      requests_.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    // Set under the lock by the cancellation of the caller, as the context
+    // can not be checked under the lock.
+    auto cancelled = std::make_shared<bool>(false);
+    auto leave = [=]() { Leave(flight, cancelled); };
+    context.ExecuteOrCancelled(
+        [=]() { return client::CancellationToken(leave); }, leave);
+
+    if (leader) {
+      auto response = fetch(flight->context);
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = flights_.find(key);
+      if (it != flights_.end() && it->second == flight) {
+        flights_.erase(it);
+      }
+      flight->response = std::move(response);
+      flight->done = true;
+      flight->condition.notify_all();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    flight->condition.wait(
+        lock, [&]() { return flight->done || *cancelled; });
+    if (*cancelled) {
+      return client::ApiError(client::ErrorCode::Cancelled, "Cancelled");
+    }
+    return *flight->response;
+  }
+
+  /// Gets the counters of the requests.
+  CoalescingCounters GetCounters() const {
+    CoalescingCounters counters;
+    counters.requests = requests_.load(std::memory_order_relaxed);
+    counters.coalesced = coalesced_.load(std::memory_order_relaxed);
+    return counters;
+  }
+
+  /// Resets the counters of the requests to zero.
+  void ResetCounters() {
+    requests_.store(0u, std::memory_order_relaxed);
+    coalesced_.store(0u, std::memory_order_relaxed);
+  }
+
+ private:
+  struct Flight {
+    client::CancellationContext context;
+    std::condition_variable condition;
+    size_t waiters{0u};
+    bool cancelled{false};
+    bool done{false};
+    boost::optional<Response> response;
+  };
+
+  /// Called when a caller is cancelled. Wakes the caller up, and cancels
+  /// the fetch if no caller is left.
+  void Leave(const std::shared_ptr<Flight>& flight,
+             const std::shared_ptr<bool>& cancelled) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (*cancelled) {
+        return;
+      }
+      *cancelled = true;
+      flight->condition.notify_all();
+      if (flight->done || --flight->waiters > 0u) {
+        return;
+      }
+      flight->cancelled = true;
+    }
+
+    // The fetch context is cancelled without the lock, as the cancellation
+    // may call back to the network.
+    flight->context.CancelOperation();
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<Flight>> flights_;
+  std::atomic<std::uint64_t> requests_{0u};
+  std::atomic<std::uint64_t> coalesced_{0u};
+};
+
+}  // namespace repository
+}  // namespace read
+}  // namespace dataservice
+}  // namespace olp
@@ -21,6 +21,7 @@
 #include <matchers/NetworkUrlMatchers.h>
 #include <mocks/CacheMock.h>
 #include <mocks/NetworkMock.h>
+#include <olp/core/cache/KeyEncoder.h>
 #include "../src/ApiClientLookup.h"
 
 using namespace olp;
@@ -55,7 +56,7 @@ TEST(ApiClientLookupTest, LookupApi) {
   const std::string config_url =
       "https://config.data.api.platform.in.here.com/config/v1";
   const std::string cache_key =
-      catalog + "::" + service_name + "::" + service_version + "::api";
+      cache::KeyEncoder(catalog).Api(service_name, service_version);
   const std::string lookup_url =
       "https://api-lookup.data.api.platform.here.com/lookup/v1/resources/" +
       catalog + "/apis/" + service_name + "/" + service_version;
@@ -19,12 +19,16 @@
 
 #include "repositories/CatalogRepository.h"
 
+#include <algorithm>
+
 #include <gtest/gtest.h>
 #include <matchers/NetworkUrlMatchers.h>
 #include <mocks/CacheMock.h>
 #include <mocks/NetworkMock.h>
+#include <olp/core/cache/KeyEncoder.h>
 #include <olp/core/client/OlpClientFactory.h>
 #include "ApiClientLookup.h"
+#include "ResponseValidator.h"
 #include "olp/dataservice/read/CatalogRequest.h"
 #include "olp/dataservice/read/CatalogVersionRequest.h"
 #include "olp/dataservice/read/DataRequest.h"
@@ -60,15 +64,17 @@ using namespace olp::tests::common;
 
 const std::string kCatalog =
     "hrn:here:data::olp-here-test:hereos-internal-test-v2";
-const std::string kLatestVersionCacheKey = kCatalog + "::latestVersion";
-const std::string kCatalogCacheKey = kCatalog + "::catalog";
+const olp::cache::KeyEncoder kKeyEncoder(kCatalog);
+const std::string kLatestVersionCacheKey = kKeyEncoder.LatestVersion();
+const std::string kCatalogCacheKey = kKeyEncoder.Catalog();
+const std::string kCatalogValidatorCacheKey = kKeyEncoder.CatalogValidator();
 const std::string kMetadataServiceName = "metadata";
 const std::string kConfigServiceName = "config";
 const std::string kServiceVersion = "v1";
 const std::string kMetadataCacheKey =
-    kCatalog + "::" + kMetadataServiceName + "::" + kServiceVersion + "::api";
+    kKeyEncoder.Api(kMetadataServiceName, kServiceVersion);
 const std::string kConfigCacheKey =
-    kCatalog + "::" + kConfigServiceName + "::" + kServiceVersion + "::api";
+    kKeyEncoder.Api(kConfigServiceName, kServiceVersion);
 const std::string kLookupUrl =
     "https://api-lookup.data.api.platform.here.com/lookup/v1/resources/" +
     kCatalog + "/apis/" + kMetadataServiceName + "/" + kServiceVersion;
@@ -350,6 +356,10 @@ TEST_F(CatalogRepositoryTest, GetCatalogOnlineOnlyFoundAndCacheWritten) {
         ADD_FAILURE() << "Cache should not be used in OnlineOnly request";
         return boost::any{};
       });
+  // Only the validator is read to revalidate the cached catalog.
+  ON_CALL(*cache_, Get(kCatalogValidatorCacheKey, _))
+      .WillByDefault(Return(boost::any{}));
+  EXPECT_CALL(*cache_, Get(kCatalogCacheKey, _)).Times(0);
 
   EXPECT_CALL(*cache_, Put(Eq(kCatalogCacheKey), _, _, _)).Times(1);
 
@@ -371,6 +381,52 @@ TEST_F(CatalogRepositoryTest, GetCatalogOnlineOnlyFoundAndCacheWritten) {
   ASSERT_TRUE(response.IsSuccessful());
 }
 
+TEST_F(CatalogRepositoryTest, GetCatalogOnlineOnlyNotModified) {
+  olp::client::CancellationContext context;
+
+  auto request = CatalogRequest();
+  request.WithFetchOption(OnlineOnly);
+
+  model::Catalog catalog;
+  catalog.SetVersion(3);
+  ResponseValidator validator;
+  validator.etag = "\"3\"";
+
+  EXPECT_CALL(*cache_, Get(kCatalogCacheKey, _)).WillOnce(Return(catalog));
+  EXPECT_CALL(*cache_, Get(kCatalogValidatorCacheKey, _))
+      .WillOnce(Return(validator));
+  // The catalog is cached without expiry and is not written again.
+  EXPECT_CALL(*cache_, Put(Eq(kCatalogCacheKey), _, _, _)).Times(0);
+  EXPECT_CALL(*cache_, Put(Eq(kCatalogValidatorCacheKey), _, _, _)).Times(0);
+
+  ON_CALL(*network_, Send(IsGetRequest(OLP_SDK_URL_LOOKUP_CONFIG), _, _, _, _))
+      .WillByDefault(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                            olp::http::HttpStatusCode::OK),
+                                        OLP_SDK_HTTP_RESPONSE_LOOKUP_CONFIG));
+
+  EXPECT_CALL(*network_, Send(IsGetRequest(OLP_SDK_URL_CONFIG), _, _, _, _))
+      .WillOnce([&](olp::http::NetworkRequest request,
+                    olp::http::Network::Payload payload,
+                    olp::http::Network::Callback callback,
+                    olp::http::Network::HeaderCallback header_callback,
+                    olp::http::Network::DataCallback data_callback) {
+        const auto& headers = request.GetHeaders();
+        EXPECT_NE(std::find(headers.begin(), headers.end(),
+                            olp::http::Header("If-None-Match", "\"3\"")),
+                  headers.end());
+        return ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                      olp::http::HttpStatusCode::NOT_MODIFIED),
+                                  "")(request, payload, callback,
+                                      header_callback, data_callback);
+      });
+
+  auto response = repository::CatalogRepository::GetCatalog(kHrn, context,
+                                                            request, settings_);
+
+  ASSERT_TRUE(response.IsSuccessful());
+  EXPECT_EQ(3, response.GetResult().GetVersion());
+}
+
 TEST_F(CatalogRepositoryTest, GetCatalogCacheOnlyFound) {
   olp::client::CancellationContext context;
 
@@ -19,6 +19,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
 #include <matchers/NetworkUrlMatchers.h>
 #include <mocks/NetworkMock.h>
 #include <olp/core/cache/CacheSettings.h>
@@ -192,6 +196,262 @@ TEST_F(DataRepositoryTest, GetBlobDataCache) {
   ASSERT_TRUE(response.IsSuccessful());
 }
 
+TEST_F(DataRepositoryTest, StreamBlobData) {
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(URL_LOOKUP_BLOB), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   HTTP_RESPONSE_LOOKUP_BLOB));
+
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(URL_BLOB_DATA_269), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   "someData"));
+
+  olp::client::CancellationContext context;
+
+  olp::dataservice::read::DataRequest request;
+  request.WithDataHandle(BLOB_DATA_HANDLE);
+
+  olp::client::HRN hrn(GetTestCatalog());
+
+  std::string data;
+  auto response =
+      olp::dataservice::read::repository::DataRepository::StreamBlobData(
+          hrn, kLayerId, kService, request,
+          [&](const std::uint8_t* chunk, std::uint64_t offset,
+              std::size_t size) {
+            data.resize(offset);
+            data.append(reinterpret_cast<const char*>(chunk), size);
+          },
+          context, *settings_);
+
+  ASSERT_TRUE(response.IsSuccessful());
+  EXPECT_EQ(8u, response.GetResult());
+  EXPECT_EQ("someData", data);
+
+  // The streamed data is not cached.
+  request.WithFetchOption(olp::dataservice::read::CacheOnly);
+  auto cached_response =
+      olp::dataservice::read::repository::DataRepository::GetBlobData(
+          hrn, kLayerId, kService, request, context, *settings_);
+  EXPECT_FALSE(cached_response.IsSuccessful());
+}
+
+TEST_F(DataRepositoryTest, StreamBlobDataCache) {
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(URL_LOOKUP_BLOB), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   HTTP_RESPONSE_LOOKUP_BLOB));
+
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(URL_BLOB_DATA_269), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   "someData"));
+
+  olp::client::CancellationContext context;
+
+  olp::dataservice::read::DataRequest request;
+  request.WithDataHandle(BLOB_DATA_HANDLE);
+
+  olp::client::HRN hrn(GetTestCatalog());
+
+  auto response =
+      olp::dataservice::read::repository::DataRepository::GetBlobData(
+          hrn, kLayerId, kService, request, context, *settings_);
+  ASSERT_TRUE(response.IsSuccessful());
+
+  // The cached data is passed in one chunk without network calls.
+  std::string data;
+  size_t chunks = 0u;
+  auto stream_response =
+      olp::dataservice::read::repository::DataRepository::StreamBlobData(
+          hrn, kLayerId, kService, request,
+          [&](const std::uint8_t* chunk, std::uint64_t offset,
+              std::size_t size) {
+            ++chunks;
+            data.append(reinterpret_cast<const char*>(chunk), size);
+          },
+          context, *settings_);
+
+  ASSERT_TRUE(stream_response.IsSuccessful());
+  EXPECT_EQ(1u, chunks);
+  EXPECT_EQ("someData", data);
+
+  request.WithFetchOption(olp::dataservice::read::CacheWithUpdate);
+  stream_response =
+      olp::dataservice::read::repository::DataRepository::StreamBlobData(
+          hrn, kLayerId, kService, request,
+          [](const std::uint8_t*, std::uint64_t, std::size_t) {}, context,
+          *settings_);
+  ASSERT_FALSE(stream_response.IsSuccessful());
+  EXPECT_EQ(olp::client::ErrorCode::InvalidArgument,
+            stream_response.GetError().GetErrorCode());
+}
+
+TEST_F(DataRepositoryTest, StreamBlobDataFailedDataFetch403) {
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(URL_LOOKUP_BLOB), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   HTTP_RESPONSE_LOOKUP_BLOB));
+
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(URL_BLOB_DATA_269), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::FORBIDDEN),
+                                   HTTP_RESPONSE_403));
+
+  olp::client::CancellationContext context;
+
+  olp::dataservice::read::DataRequest request;
+  request.WithDataHandle(BLOB_DATA_HANDLE);
+
+  olp::client::HRN hrn(GetTestCatalog());
+
+  auto response =
+      olp::dataservice::read::repository::DataRepository::StreamBlobData(
+          hrn, kLayerId, kService, request,
+          [](const std::uint8_t*, std::uint64_t, std::size_t) {
+            ADD_FAILURE() << "The error body is passed to the sink";
+          },
+          context, *settings_);
+
+  ASSERT_FALSE(response.IsSuccessful());
+  EXPECT_EQ(olp::http::HttpStatusCode::FORBIDDEN,
+            response.GetError().GetHttpStatusCode());
+  EXPECT_EQ(HTTP_RESPONSE_403, response.GetError().GetMessage());
+}
+
+TEST_F(DataRepositoryTest, GetBlobDataInRanges) {
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(URL_LOOKUP_BLOB), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   HTTP_RESPONSE_LOOKUP_BLOB));
+
+  // The size of the blob in the content range ends the download, so no range
+  // past the end is requested.
+  const std::string content = "someDataInRanges";
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(URL_BLOB_DATA_269), _, _, _, _))
+      .Times(3)
+      .WillRepeatedly([&](olp::http::NetworkRequest request,
+                          olp::http::Network::Payload payload,
+                          olp::http::Network::Callback callback,
+                          olp::http::Network::HeaderCallback header_callback,
+                          olp::http::Network::DataCallback data_callback) {
+        unsigned long long first = 0;
+        for (const auto& header : request.GetHeaders()) {
+          if (header.first == "Range") {
+            EXPECT_EQ(1, std::sscanf(header.second.c_str(), "bytes=%llu-",
+                                     &first));
+          }
+        }
+        const auto last = std::min<unsigned long long>(first + 5u, 15u);
+        const auto content_range = "bytes " + std::to_string(first) + "-" +
+                                   std::to_string(last) + "/16";
+        return ReturnHttpResponse(
+            olp::http::NetworkResponse().WithStatus(
+                olp::http::HttpStatusCode::PARTIAL_CONTENT),
+            content.substr(first, last + 1u - first),
+            {{"Content-Range", content_range}})(
+            request, payload, callback, header_callback, data_callback);
+      });
+
+  olp::client::CancellationContext context;
+
+  olp::dataservice::read::DataRequest request;
+  request.WithDataHandle(BLOB_DATA_HANDLE)
+      .WithDownloadChunkSize(6u)
+      .WithMaxParallelDownloads(1u);
+
+  olp::client::HRN hrn(GetTestCatalog());
+
+  auto response =
+      olp::dataservice::read::repository::DataRepository::GetBlobData(
+          hrn, kLayerId, kService, request, context, *settings_);
+
+  ASSERT_TRUE(response.IsSuccessful());
+  ASSERT_TRUE(response.GetResult());
+  EXPECT_EQ(content, std::string(response.GetResult()->begin(),
+                                 response.GetResult()->end()));
+}
+
+TEST_F(DataRepositoryTest, StreamBlobDataRangesIgnored) {
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(URL_LOOKUP_BLOB), _, _, _, _))
+      .WillOnce(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                       olp::http::HttpStatusCode::OK),
+                                   HTTP_RESPONSE_LOOKUP_BLOB));
+
+  // The server sends the first range, ignores the second one, and breaks
+  // the connection while the whole blob is streamed.
+  const std::string content = "someDataInRanges";
+  bool connection_broken = false;
+  EXPECT_CALL(*network_mock_, Send(IsGetRequest(URL_BLOB_DATA_269), _, _, _, _))
+      .Times(4)
+      .WillRepeatedly([&](olp::http::NetworkRequest request,
+                          olp::http::Network::Payload payload,
+                          olp::http::Network::Callback callback,
+                          olp::http::Network::HeaderCallback header_callback,
+                          olp::http::Network::DataCallback data_callback) {
+        std::string range;
+        for (const auto& header : request.GetHeaders()) {
+          if (header.first == "Range") {
+            range = header.second;
+          }
+        }
+
+        if (range == "bytes=0-3") {
+          return ReturnHttpResponse(
+              olp::http::NetworkResponse().WithStatus(
+                  olp::http::HttpStatusCode::PARTIAL_CONTENT),
+              content.substr(0, 4), {{"Content-Range", "bytes 0-3/16"}})(
+              request, payload, callback, header_callback, data_callback);
+        }
+        if (!range.empty() || connection_broken) {
+          return ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                        olp::http::HttpStatusCode::OK),
+                                    content)(request, payload, callback,
+                                             header_callback, data_callback);
+        }
+
+        connection_broken = true;
+        data_callback(reinterpret_cast<const std::uint8_t*>(content.data()),
+                      0u, 10u);
+        callback(olp::http::NetworkResponse().WithStatus(
+            static_cast<int>(olp::http::ErrorCode::IO_ERROR)));
+        return olp::http::SendOutcome(olp::http::RequestId(5));
+      });
+
+  settings_->retry_settings.initial_backdown_period = 10;
+  settings_->retry_settings.retry_condition =
+      [](const olp::client::HttpResponse& response) {
+        return response.status ==
+               static_cast<int>(olp::http::ErrorCode::IO_ERROR);
+      };
+
+  olp::client::CancellationContext context;
+
+  olp::dataservice::read::DataRequest request;
+  request.WithDataHandle(BLOB_DATA_HANDLE)
+      .WithDownloadChunkSize(4u)
+      .WithMaxParallelDownloads(1u);
+
+  olp::client::HRN hrn(GetTestCatalog());
+
+  // The sink only appends, so every byte must be passed once and in order.
+  std::string data;
+  auto response =
+      olp::dataservice::read::repository::DataRepository::StreamBlobData(
+          hrn, kLayerId, kService, request,
+          [&](const std::uint8_t* chunk, std::uint64_t offset,
+              std::size_t size) {
+            EXPECT_EQ(data.size(), offset);
+            data.append(reinterpret_cast<const char*>(chunk), size);
+          },
+          context, *settings_);
+
+  ASSERT_TRUE(response.IsSuccessful());
+  EXPECT_EQ(content.size(), response.GetResult());
+  EXPECT_EQ(content, data);
+}
+
 TEST_F(DataRepositoryTest, GetBlobDataImmediateCancel) {
   ON_CALL(*network_mock_, Send(IsGetRequest(URL_LOOKUP_BLOB), _, _, _, _))
       .WillByDefault(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
@@ -19,11 +19,14 @@
 
 #include "repositories/PartitionsRepository.h"
 
+#include <algorithm>
+
 #include <gmock/gmock.h>
 #include <matchers/NetworkUrlMatchers.h>
 #include <mocks/CacheMock.h>
 #include <mocks/NetworkMock.h>
 #include <olp/core/cache/CacheSettings.h>
+#include <olp/core/cache/KeyEncoder.h>
 #include <olp/core/client/OlpClientSettings.h>
 #include <olp/core/client/OlpClientSettingsFactory.h>
 #include <olp/dataservice/read/DataRequest.h>
@@ -52,7 +55,8 @@ const std::string kOlpSdkUrlLookupMetadata =
     kCatalog + R"(/apis/query/v1)";
 const std::string kOlpSdkHttpResponseLookupMetadata =
     R"jsonString([{"api":"metadata","version":"v1","baseURL":"https://metadata.data.api.platform.here.com/metadata/v1/catalogs/hereos-internal-test-v2","parameters":{}}])jsonString";
-const std::string kCacheKeyMetadata = kCatalog + "::query::v1::api";
+const std::string kCacheKeyMetadata =
+    cache::KeyEncoder(kCatalog).Api("query", "v1");
 
 const std::string kOlpSdkUrlPartitionByIdNoVersion =
     R"(https://metadata.data.api.platform.here.com/metadata/v1/catalogs/hereos-internal-test-v2/layers/)" +
@@ -106,10 +110,11 @@ TEST(PartitionsRepositoryTest, GetPartitionById) {
   const DataRequest request{
       DataRequest().WithPartitionId(kPartitionId).WithVersion(kVersion)};
 
+  const cache::KeyEncoder key_encoder(kCatalog);
   const std::string cache_key_no_version =
-      kCatalog + "::" + kLayerId + "::" + kPartitionId + "::";
+      key_encoder.Partition(kLayerId, kPartitionId, boost::none);
   const std::string cache_key =
-      cache_key_no_version + std::to_string(kVersion) + "::partition";
+      key_encoder.Partition(kLayerId, kPartitionId, kVersion);
 
   auto setup_online_only_mocks = [&]() {
     ON_CALL(*cache, Get(_, _))
@@ -596,4 +601,181 @@ TEST(PartitionsRepositoryTest, GetVolatilePartitions) {
     EXPECT_EQ(cache_only_response.GetResult().GetPartitions().size(), 4);
   }
 }
+
+TEST(PartitionsRepositoryTest, GetVolatilePartitionsNotModified) {
+  using namespace testing;
+
+  std::shared_ptr<cache::KeyValueCache> default_cache =
+      olp::client::OlpClientSettingsFactory::CreateDefaultCache({});
+
+  auto mock_network = std::make_shared<NetworkMock>();
+  const auto catalog = HRN::FromString(kCatalog);
+  const auto layer = "testlayer_volatile";
+  const std::string etag = "\"1\"";
+
+  OlpClientSettings settings;
+  settings.cache = default_cache;
+  settings.network_request_handler = mock_network;
+  settings.retry_settings.timeout = 1;
+
+  // The online only requests fetch the catalog and the APIs again.
+  ON_CALL(*mock_network, Send(IsGetRequest(kOlpSdkUrlLookupConfig), _, _, _, _))
+      .WillByDefault(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                            olp::http::HttpStatusCode::OK),
+                                        kOlpSdkHttpResponseLookupConfig));
+
+  ON_CALL(*mock_network, Send(IsGetRequest(kOlpSdkUrlConfig), _, _, _, _))
+      .WillByDefault(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                            olp::http::HttpStatusCode::OK),
+                                        kOlpSdkHttpResponseConfig));
+
+  ON_CALL(*mock_network,
+          Send(IsGetRequest(kOlpSdkUrlLookupMetadata2), _, _, _, _))
+      .WillByDefault(ReturnHttpResponse(olp::http::NetworkResponse().WithStatus(
+                                            olp::http::HttpStatusCode::OK),
+                                        kOlpSdkHttpResponseLookupMetadata2));
+
+  {
+    SCOPED_TRACE("The validator is stored with the partitions");
+
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(kOlpSdkUrlPartitions), _, _, _, _))
+        .WillOnce(ReturnHttpResponse(
+            olp::http::NetworkResponse().WithStatus(
+                olp::http::HttpStatusCode::OK),
+            kOlpSdkHttpResponsePartitions, {{"ETag", etag}}));
+
+    CancellationContext context;
+    auto response = repository::PartitionsRepository::GetVolatilePartitions(
+        catalog, layer, context, PartitionsRequest(), settings);
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    EXPECT_EQ(response.GetResult().GetPartitions().size(), 4);
+    Mock::VerifyAndClearExpectations(mock_network.get());
+  }
+
+  {
+    SCOPED_TRACE("The cached partitions are revalidated");
+
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(kOlpSdkUrlPartitions), _, _, _, _))
+        .WillOnce([&](olp::http::NetworkRequest request,
+                      olp::http::Network::Payload payload,
+                      olp::http::Network::Callback callback,
+                      olp::http::Network::HeaderCallback header_callback,
+                      olp::http::Network::DataCallback data_callback) {
+          const auto& headers = request.GetHeaders();
+          EXPECT_NE(std::find(headers.begin(), headers.end(),
+                              olp::http::Header("If-None-Match", etag)),
+                    headers.end());
+          return ReturnHttpResponse(
+              olp::http::NetworkResponse().WithStatus(
+                  olp::http::HttpStatusCode::NOT_MODIFIED),
+              std::string())(request, payload, callback, header_callback,
+                             data_callback);
+        });
+
+    CancellationContext context;
+    auto response = repository::PartitionsRepository::GetVolatilePartitions(
+        catalog, layer, context,
+        PartitionsRequest().WithFetchOption(FetchOptions::OnlineOnly),
+        settings);
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    EXPECT_EQ(response.GetResult().GetPartitions().size(), 4);
+    Mock::VerifyAndClearExpectations(mock_network.get());
+  }
+
+  {
+    SCOPED_TRACE("The revalidated partitions are cached again");
+
+    CancellationContext context;
+    auto response = repository::PartitionsRepository::GetVolatilePartitions(
+        catalog, layer, context,
+        PartitionsRequest().WithFetchOption(FetchOptions::CacheOnly),
+        settings);
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    EXPECT_EQ(response.GetResult().GetPartitions().size(), 4);
+  }
+
+  {
+    SCOPED_TRACE("The expired partitions are revalidated");
+
+    // Expire the partitions, the stale copy is kept with the validator.
+    default_cache->Remove(
+        cache::KeyEncoder(kCatalog).Partitions(layer, boost::none));
+
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(kOlpSdkUrlPartitions), _, _, _, _))
+        .WillOnce([&](olp::http::NetworkRequest request,
+                      olp::http::Network::Payload payload,
+                      olp::http::Network::Callback callback,
+                      olp::http::Network::HeaderCallback header_callback,
+                      olp::http::Network::DataCallback data_callback) {
+          const auto& headers = request.GetHeaders();
+          EXPECT_NE(std::find(headers.begin(), headers.end(),
+                              olp::http::Header("If-None-Match", etag)),
+                    headers.end());
+          return ReturnHttpResponse(
+              olp::http::NetworkResponse().WithStatus(
+                  olp::http::HttpStatusCode::NOT_MODIFIED),
+              std::string())(request, payload, callback, header_callback,
+                             data_callback);
+        });
+
+    CancellationContext context;
+    auto response = repository::PartitionsRepository::GetVolatilePartitions(
+        catalog, layer, context, PartitionsRequest(), settings);
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    EXPECT_EQ(response.GetResult().GetPartitions().size(), 4);
+    Mock::VerifyAndClearExpectations(mock_network.get());
+
+    // The expiry is renewed.
+    auto cache_only_response =
+        repository::PartitionsRepository::GetVolatilePartitions(
+            catalog, layer, context,
+            PartitionsRequest().WithFetchOption(FetchOptions::CacheOnly),
+            settings);
+
+    ASSERT_TRUE(cache_only_response.IsSuccessful())
+        << cache_only_response.GetError().GetMessage();
+    EXPECT_EQ(cache_only_response.GetResult().GetPartitions().size(), 4);
+  }
+
+  {
+    SCOPED_TRACE("The partitions without a stale copy are downloaded again");
+
+    const cache::KeyEncoder encoder(kCatalog);
+    default_cache->Remove(encoder.Partitions(layer, boost::none));
+    default_cache->Remove(encoder.StalePartitions(layer, boost::none));
+
+    EXPECT_CALL(*mock_network,
+                Send(IsGetRequest(kOlpSdkUrlPartitions), _, _, _, _))
+        .WillOnce([&](olp::http::NetworkRequest request,
+                      olp::http::Network::Payload payload,
+                      olp::http::Network::Callback callback,
+                      olp::http::Network::HeaderCallback header_callback,
+                      olp::http::Network::DataCallback data_callback) {
+          const auto& headers = request.GetHeaders();
+          EXPECT_EQ(std::find(headers.begin(), headers.end(),
+                              olp::http::Header("If-None-Match", etag)),
+                    headers.end());
+          return ReturnHttpResponse(
+              olp::http::NetworkResponse().WithStatus(
+                  olp::http::HttpStatusCode::OK),
+              kOlpSdkHttpResponsePartitions,
+              {{"ETag", etag}})(request, payload, callback, header_callback,
+                                data_callback);
+        });
+
+    CancellationContext context;
+    auto response = repository::PartitionsRepository::GetVolatilePartitions(
+        catalog, layer, context, PartitionsRequest(), settings);
+
+    ASSERT_TRUE(response.IsSuccessful()) << response.GetError().GetMessage();
+    EXPECT_EQ(response.GetResult().GetPartitions().size(), 4);
+  }
+}
 }  // namespace
@@ -0,0 +1,370 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <olp/core/client/OlpClientSettingsFactory.h>
+#include <olp/core/http/HttpStatusCode.h>
+#include <olp/core/http/NetworkTypes.h>
+#include "../src/RangedDownload.h"
+
+namespace {
+using namespace olp;
+using namespace olp::dataservice::read;
+
+using Ranges = std::map<std::uint64_t, std::vector<std::uint8_t>>;
+
+std::vector<std::uint8_t> CreateBlob(size_t size) {
+  std::vector<std::uint8_t> blob(size);
+  for (size_t i = 0; i < size; ++i) {
+    blob[i] = static_cast<std::uint8_t>(i * 7u);
+  }
+  return blob;
+}
+
+// Serves the byte ranges of the blob, like the blob service does.
+class BlobServer {
+ public:
+  explicit BlobServer(std::vector<std::uint8_t> blob)
+      : blob_(std::move(blob)) {}
+
+  RangedDownload::RangeRequest Request() {
+    return [this](const std::string& range,
+                  http::Network::DataCallback data_callback,
+                  client::CancellationContext context)
+               -> BlobApi::StreamResponse {
+      std::uint64_t first = 0u;
+      std::uint64_t last = 0u;
+      EXPECT_EQ(2, std::sscanf(range.c_str(), "bytes=%llu-%llu",
+                               reinterpret_cast<unsigned long long*>(&first),
+                               reinterpret_cast<unsigned long long*>(&last)));
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests_.push_back(range);
+      }
+      if (on_request_) {
+        auto response = on_request_(first, data_callback);
+        if (context.IsCancelled()) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          ++cancelled_requests_;
+        }
+        if (response) {
+          return *response;
+        }
+      }
+      if (first >= blob_.size()) {
+        return client::ApiError(
+            http::HttpStatusCode::REQUESTED_RANGE_NOT_SATISFIABLE);
+      }
+
+      last = std::min<std::uint64_t>(last, blob_.size() - 1u);
+      // Deliver the range in two chunks with the offsets in the blob.
+      const auto middle = first + (last - first + 1u) / 2u;
+      data_callback(blob_.data() + first, first, middle - first);
+      data_callback(blob_.data() + middle, middle, last + 1u - middle);
+      return report_size_ ? blob_.size() : 0u;
+    };
+  }
+
+  std::vector<std::string> Requests() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return requests_;
+  }
+
+  // The requests that were cancelled while the data was received.
+  size_t CancelledRequests() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cancelled_requests_;
+  }
+
+  // Sends the size of the blob with the ranges, like the content range does.
+  bool report_size_{true};
+
+  using OnRequest = std::function<boost::optional<BlobApi::StreamResponse>(
+      std::uint64_t first, const http::Network::DataCallback& data_callback)>;
+  OnRequest on_request_;
+
+ private:
+  std::vector<std::uint8_t> blob_;
+  std::mutex mutex_;
+  std::vector<std::string> requests_;
+  size_t cancelled_requests_{0u};
+};
+
+DataChunkCallback CollectTo(Ranges& ranges) {
+  return [&ranges](const std::uint8_t* data, std::uint64_t offset,
+                   std::size_t size) {
+    EXPECT_TRUE(ranges.find(offset) == ranges.end());
+    ranges[offset].assign(data, data + size);
+  };
+}
+
+std::vector<std::uint8_t> Join(const Ranges& ranges) {
+  std::vector<std::uint8_t> data;
+  for (const auto& range : ranges) {
+    EXPECT_EQ(data.size(), range.first);
+    data.insert(data.end(), range.second.begin(), range.second.end());
+  }
+  return data;
+}
+
+client::OlpClientSettings Settings() {
+  client::OlpClientSettings settings;
+  settings.retry_settings.initial_backdown_period = 1;
+  return settings;
+}
+
+TEST(RangedDownloadTest, DownloadInParallel) {
+  for (size_t blob_size : {0u, 1000u, 8192u, 10000u}) {
+    SCOPED_TRACE(blob_size);
+    const auto blob = CreateBlob(blob_size);
+    BlobServer server(blob);
+    auto settings = Settings();
+    settings.task_scheduler =
+        client::OlpClientSettingsFactory::CreateDefaultTaskScheduler(4u);
+
+    Ranges ranges;
+    auto response = RangedDownload::Run(server.Request(), 1024u, 4u,
+                                        CollectTo(ranges), settings,
+                                        thread::NORMAL, {});
+
+    ASSERT_TRUE(response.IsSuccessful());
+    EXPECT_EQ(blob_size, response.GetResult());
+    EXPECT_EQ(blob, Join(ranges));
+
+    // Every range is requested once, and at most one request per worker
+    // is past the end of the blob.
+    auto requests = server.Requests();
+    std::sort(requests.begin(), requests.end());
+    EXPECT_TRUE(std::adjacent_find(requests.begin(), requests.end()) ==
+                requests.end());
+    EXPECT_LE(requests.size(), (blob_size + 1023u) / 1024u + 4u);
+  }
+}
+
+TEST(RangedDownloadTest, DownloadWithoutTaskScheduler) {
+  const auto blob = CreateBlob(5000u);
+  BlobServer server(blob);
+
+  Ranges ranges;
+  std::vector<std::uint64_t> sizes;
+  auto response = RangedDownload::Run(
+      server.Request(), 1000u, 4u,
+      [&](const std::uint8_t* data, std::uint64_t offset, std::size_t size) {
+        EXPECT_EQ(1u, sizes.size());
+        CollectTo(ranges)(data, offset, size);
+      },
+      Settings(), thread::NORMAL, {},
+      [&](std::uint64_t size) { sizes.push_back(size); });
+
+  ASSERT_TRUE(response.IsSuccessful());
+  EXPECT_EQ(5000u, response.GetResult());
+  EXPECT_EQ(blob, Join(ranges));
+  // The size of the blob is passed once, before the first range.
+  EXPECT_EQ(std::vector<std::uint64_t>({5000u}), sizes);
+  // The ranges are downloaded one by one, the size of the blob from the first
+  // range ends the download.
+  EXPECT_EQ(5u, server.Requests().size());
+}
+
+TEST(RangedDownloadTest, DownloadWithoutBlobSize) {
+  const auto blob = CreateBlob(5000u);
+  BlobServer server(blob);
+  server.report_size_ = false;
+
+  Ranges ranges;
+  auto response = RangedDownload::Run(
+      server.Request(), 1000u, 1u, CollectTo(ranges), Settings(),
+      thread::NORMAL, {}, [](std::uint64_t) {
+        ADD_FAILURE() << "The size of the blob is unknown";
+      });
+
+  ASSERT_TRUE(response.IsSuccessful());
+  EXPECT_EQ(5000u, response.GetResult());
+  EXPECT_EQ(blob, Join(ranges));
+  // The ranges are downloaded one by one, up to the empty one past the end.
+  EXPECT_EQ(6u, server.Requests().size());
+}
+
+TEST(RangedDownloadTest, ResumeBrokenRange) {
+  const auto blob = CreateBlob(3000u);
+  BlobServer server(blob);
+  bool broken = false;
+  server.on_request_ = [&](std::uint64_t first,
+                           const http::Network::DataCallback& data_callback)
+      -> boost::optional<BlobApi::StreamResponse> {
+    if (first == 1024u && !broken) {
+      // The connection breaks after 100 bytes.
+      broken = true;
+      data_callback(blob.data() + first, first, 100u);
+      return BlobApi::StreamResponse(client::ApiError(
+          static_cast<int>(http::ErrorCode::IO_ERROR), "Broken"));
+    }
+    return boost::none;
+  };
+
+  Ranges ranges;
+  auto response = RangedDownload::Run(server.Request(), 1024u, 1u,
+                                      CollectTo(ranges), Settings(),
+                                      thread::NORMAL, {});
+
+  ASSERT_TRUE(response.IsSuccessful());
+  EXPECT_EQ(blob, Join(ranges));
+  const auto requests = server.Requests();
+  ASSERT_LE(3u, requests.size());
+  EXPECT_EQ("bytes=1024-2047", requests[1]);
+  EXPECT_EQ("bytes=1124-2047", requests[2]);
+}
+
+TEST(RangedDownloadTest, IgnoredRangeStopsDownload) {
+  const auto blob = CreateBlob(3000u);
+  BlobServer server(blob);
+  server.on_request_ = [&](std::uint64_t,
+                           const http::Network::DataCallback& data_callback)
+      -> boost::optional<BlobApi::StreamResponse> {
+    // The server sends the whole blob with the status 200.
+    data_callback(blob.data(), 0u, blob.size());
+    return BlobApi::StreamResponse(
+        client::ApiError(http::HttpStatusCode::OK, "Ignored"));
+  };
+
+  Ranges ranges;
+  auto response = RangedDownload::Run(server.Request(), 1024u, 1u,
+                                      CollectTo(ranges), Settings(),
+                                      thread::NORMAL, {});
+
+  ASSERT_FALSE(response.IsSuccessful());
+  EXPECT_TRUE(RangedDownload::IsRangeIgnored(response.GetError()));
+  EXPECT_TRUE(ranges.empty());
+  EXPECT_EQ(1u, server.Requests().size());
+}
+
+TEST(RangedDownloadTest, ResumeIsNotAppendedToIgnoredRange) {
+  const auto blob = CreateBlob(3000u);
+  BlobServer server(blob);
+  int attempts = 0;
+  server.on_request_ = [&](std::uint64_t first,
+                           const http::Network::DataCallback& data_callback)
+      -> boost::optional<BlobApi::StreamResponse> {
+    if (first < 1024u || first >= 2048u) {
+      return boost::none;
+    }
+    if (attempts++ == 0) {
+      // The connection breaks after 100 bytes.
+      data_callback(blob.data() + first, first, 100u);
+      return BlobApi::StreamResponse(client::ApiError(
+          static_cast<int>(http::ErrorCode::IO_ERROR), "Broken"));
+    }
+    // The resumed request gets the whole blob with the status 200.
+    data_callback(blob.data(), 0u, blob.size());
+    return BlobApi::StreamResponse(
+        client::ApiError(http::HttpStatusCode::OK, "Ignored"));
+  };
+
+  Ranges ranges;
+  auto response = RangedDownload::Run(server.Request(), 1024u, 1u,
+                                      CollectTo(ranges), Settings(),
+                                      thread::NORMAL, {});
+
+  ASSERT_FALSE(response.IsSuccessful());
+  EXPECT_TRUE(RangedDownload::IsRangeIgnored(response.GetError()));
+  EXPECT_EQ(0u, ranges.count(1024u));
+  EXPECT_EQ(2, attempts);
+}
+
+TEST(RangedDownloadTest, RangeLongerThanRequested) {
+  const auto blob = CreateBlob(3000u);
+  BlobServer server(blob);
+  server.on_request_ = [&](std::uint64_t first,
+                           const http::Network::DataCallback& data_callback)
+      -> boost::optional<BlobApi::StreamResponse> {
+    // The partial content goes on past the requested range, the rest of it
+    // is not received once the range is full.
+    for (auto offset = first; offset < blob.size(); offset += 100u) {
+      const auto size = std::min<std::uint64_t>(100u, blob.size() - offset);
+      data_callback(blob.data() + offset, offset, size);
+    }
+    return BlobApi::StreamResponse(std::uint64_t{0u});
+  };
+
+  Ranges ranges;
+  auto response = RangedDownload::Run(server.Request(), 1024u, 1u,
+                                      CollectTo(ranges), Settings(),
+                                      thread::NORMAL, {});
+
+  ASSERT_FALSE(response.IsSuccessful());
+  EXPECT_TRUE(RangedDownload::IsRangeIgnored(response.GetError()));
+  EXPECT_TRUE(ranges.empty());
+  EXPECT_EQ(1u, server.CancelledRequests());
+}
+
+TEST(RangedDownloadTest, ErrorStopsDownload) {
+  BlobServer server(CreateBlob(10000u));
+  server.on_request_ = [&](std::uint64_t first,
+                           const http::Network::DataCallback&)
+      -> boost::optional<BlobApi::StreamResponse> {
+    if (first == 2048u) {
+      return BlobApi::StreamResponse(
+          client::ApiError(http::HttpStatusCode::FORBIDDEN));
+    }
+    return boost::none;
+  };
+
+  Ranges ranges;
+  auto response = RangedDownload::Run(server.Request(), 1024u, 1u,
+                                      CollectTo(ranges), Settings(),
+                                      thread::NORMAL, {});
+
+  ASSERT_FALSE(response.IsSuccessful());
+  EXPECT_EQ(http::HttpStatusCode::FORBIDDEN,
+            response.GetError().GetHttpStatusCode());
+  EXPECT_EQ(3u, server.Requests().size());
+}
+
+TEST(RangedDownloadTest, Cancel) {
+  BlobServer server(CreateBlob(10000u));
+  client::CancellationContext context;
+  server.on_request_ = [&](std::uint64_t first,
+                           const http::Network::DataCallback&)
+      -> boost::optional<BlobApi::StreamResponse> {
+    if (first == 1024u) {
+      context.CancelOperation();
+      return BlobApi::StreamResponse(
+          client::ApiError(client::ErrorCode::Cancelled, "Cancelled"));
+    }
+    return boost::none;
+  };
+
+  Ranges ranges;
+  auto response = RangedDownload::Run(server.Request(), 1024u, 1u,
+                                      CollectTo(ranges), Settings(),
+                                      thread::NORMAL, context);
+
+  ASSERT_FALSE(response.IsSuccessful());
+  EXPECT_EQ(client::ErrorCode::Cancelled,
+            response.GetError().GetErrorCode());
+  EXPECT_EQ(2u, server.Requests().size());
+}
+}  // namespace
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include <olp/core/client/HttpResponse.h>
+#include "../src/ResponseValidator.h"
+
+namespace {
+using olp::client::HttpResponse;
+using olp::dataservice::read::ResponseValidator;
+
+TEST(ResponseValidatorTest, FromResponse) {
+  {
+    SCOPED_TRACE("Headers are matched case-insensitively");
+
+    HttpResponse response(200, "{\"version\":3}");
+    response.headers = {{"etag", "\"3\""},
+                        {"LAST-MODIFIED", "Wed, 21 Oct 2015 07:28:00 GMT"},
+                        {"Content-Type", "application/json"}};
+
+    auto validator = ResponseValidator::FromResponse(response);
+    ASSERT_TRUE(validator);
+    EXPECT_EQ("\"3\"", validator->etag);
+    EXPECT_EQ("Wed, 21 Oct 2015 07:28:00 GMT", validator->last_modified);
+  }
+
+  {
+    SCOPED_TRACE("Weak validator");
+
+    HttpResponse response(200, "{}");
+    response.headers = {{"ETag", "W/\"1\""}};
+
+    auto validator = ResponseValidator::FromResponse(response);
+    ASSERT_TRUE(validator);
+    EXPECT_EQ("W/\"1\"", validator->etag);
+    EXPECT_TRUE(validator->last_modified.empty());
+  }
+
+  {
+    SCOPED_TRACE("No validator without the headers");
+
+    HttpResponse response(200, "{}");
+    response.headers = {{"Content-Type", "application/json"}};
+    EXPECT_FALSE(ResponseValidator::FromResponse(response));
+  }
+}
+
+TEST(ResponseValidatorTest, EncodeDecode) {
+  ResponseValidator validator;
+  validator.etag = "\"3\"";
+
+  auto decoded = ResponseValidator::Decode(validator.Encode());
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(validator.etag, decoded->etag);
+  EXPECT_TRUE(decoded->last_modified.empty());
+
+  validator.last_modified = "Wed, 21 Oct 2015 07:28:00 GMT";
+  decoded = ResponseValidator::Decode(validator.Encode());
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(validator.etag, decoded->etag);
+  EXPECT_EQ(validator.last_modified, decoded->last_modified);
+
+  EXPECT_FALSE(ResponseValidator::Decode(""));
+  // The validators stored with the response body are not used.
+  EXPECT_FALSE(ResponseValidator::Decode("\"3\"\n\n{}"));
+}
+
+TEST(ResponseValidatorTest, AddConditionalHeaders) {
+  std::multimap<std::string, std::string> header_params;
+  ResponseValidator().AddConditionalHeaders(header_params);
+  EXPECT_TRUE(header_params.empty());
+
+  ResponseValidator validator;
+  validator.etag = "\"3\"";
+  validator.last_modified = "Wed, 21 Oct 2015 07:28:00 GMT";
+  validator.AddConditionalHeaders(header_params);
+
+  ASSERT_EQ(2u, header_params.size());
+  EXPECT_EQ("\"3\"", header_params.find("If-None-Match")->second);
+  EXPECT_EQ("Wed, 21 Oct 2015 07:28:00 GMT",
+            header_params.find("If-Modified-Since")->second);
+}
+
+}  // namespace
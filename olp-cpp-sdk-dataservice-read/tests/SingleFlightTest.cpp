@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <string>
+#include <thread>
+
+#include <olp/core/client/ApiResponse.h>
+#include <olp/core/client/Condition.h>
+#include "../src/repositories/SingleFlight.h"
+
+namespace {
+using namespace olp;
+using namespace olp::dataservice::read;
+
+using Response = client::ApiResponse<std::string, client::ApiError>;
+using Flights = repository::SingleFlight<Response>;
+
+constexpr auto kWaitTimeout = std::chrono::seconds(5);
+
+TEST(SingleFlightTest, CoalesceConcurrentRequests) {
+  Flights flights;
+  std::atomic<int> fetches{0};
+  client::Condition fetch_started;
+  std::promise<void> release;
+  auto released = release.get_future().share();
+
+  auto fetch = [&](client::CancellationContext) -> Response {
+    ++fetches;
+    fetch_started.Notify();
+    released.wait();
+    return std::string("value");
+  };
+
+  auto leader = std::async(std::launch::async, [&]() {
+    return flights.Execute("key", client::CancellationContext(), fetch);
+  });
+  ASSERT_TRUE(fetch_started.Wait(kWaitTimeout));
+
+  auto follower = std::async(std::launch::async, [&]() {
+    return flights.Execute("key", client::CancellationContext(), fetch);
+  });
+  // A different key is not coalesced.
+  auto other = std::async(std::launch::async, [&]() {
+    return flights.Execute("other", client::CancellationContext(), fetch);
+  });
+  ASSERT_TRUE(fetch_started.Wait(kWaitTimeout));
+
+  // Wait until the follower joins the flight.
+  while (flights.GetCounters().requests < 3u) {
+    std::this_thread::yield();
+  }
+  release.set_value();
+
+  EXPECT_EQ("value", leader.get().GetResult());
+  EXPECT_EQ("value", follower.get().GetResult());
+  EXPECT_EQ("value", other.get().GetResult());
+  EXPECT_EQ(2, fetches.load());
+
+  auto counters = flights.GetCounters();
+  EXPECT_EQ(3u, counters.requests);
+  EXPECT_EQ(1u, counters.coalesced);
+
+  // The finished flight is not reused.
+  EXPECT_EQ("value", flights.Execute("key", {}, fetch).GetResult());
+  EXPECT_EQ(3, fetches.load());
+
+  flights.ResetCounters();
+  EXPECT_EQ(0u, flights.GetCounters().requests);
+}
+
+TEST(SingleFlightTest, CancelWhenAllCallersCancelled) {
+  Flights flights;
+  client::Condition fetch_started;
+  client::Condition fetch_cancelled;
+
+  auto fetch = [&](client::CancellationContext context) -> Response {
+    fetch_started.Notify();
+    context.ExecuteOrCancelled(
+        [&]() {
+          return client::CancellationToken(
+              [&]() { fetch_cancelled.Notify(); });
+        },
+        [&]() { fetch_cancelled.Notify(); });
+    EXPECT_TRUE(fetch_cancelled.Wait(kWaitTimeout));
+    return client::ApiError(client::ErrorCode::Cancelled, "Cancelled");
+  };
+
+  client::CancellationContext leader_context;
+  client::CancellationContext follower_context;
+
+  auto leader = std::async(std::launch::async, [&]() {
+    return flights.Execute("key", leader_context, fetch);
+  });
+  ASSERT_TRUE(fetch_started.Wait(kWaitTimeout));
+
+  auto follower = std::async(std::launch::async, [&]() {
+    return flights.Execute("key", follower_context, fetch);
+  });
+  while (flights.GetCounters().coalesced < 1u) {
+    std::this_thread::yield();
+  }
+
+  // The follower returns right away, the fetch goes on for the leader.
+  follower_context.CancelOperation();
+  ASSERT_EQ(std::future_status::ready, follower.wait_for(kWaitTimeout));
+  EXPECT_EQ(client::ErrorCode::Cancelled,
+            follower.get().GetError().GetErrorCode());
+  EXPECT_EQ(std::future_status::timeout,
+            leader.wait_for(std::chrono::milliseconds(50)));
+
+  // The last caller cancels the fetch.
+  leader_context.CancelOperation();
+  ASSERT_EQ(std::future_status::ready, leader.wait_for(kWaitTimeout));
+  EXPECT_EQ(client::ErrorCode::Cancelled,
+            leader.get().GetError().GetErrorCode());
+}
+
+TEST(SingleFlightTest, LeaderCancelledFollowerGetsResponse) {
+  Flights flights;
+  client::Condition fetch_started;
+  std::promise<void> release;
+  auto released = release.get_future().share();
+
+  auto fetch = [&](client::CancellationContext context) -> Response {
+    fetch_started.Notify();
+    released.wait();
+    EXPECT_FALSE(context.IsCancelled());
+    return std::string("value");
+  };
+
+  client::CancellationContext leader_context;
+  auto leader = std::async(std::launch::async, [&]() {
+    return flights.Execute("key", leader_context, fetch);
+  });
+  ASSERT_TRUE(fetch_started.Wait(kWaitTimeout));
+
+  auto follower = std::async(std::launch::async, [&]() {
+    return flights.Execute("key", client::CancellationContext(), fetch);
+  });
+  while (flights.GetCounters().coalesced < 1u) {
+    std::this_thread::yield();
+  }
+
+  leader_context.CancelOperation();
+  release.set_value();
+
+  EXPECT_EQ(client::ErrorCode::Cancelled,
+            leader.get().GetError().GetErrorCode());
+  EXPECT_EQ("value", follower.get().GetResult());
+}
+}  // namespace
@@ -19,6 +19,7 @@
 
 #include "ApiClientLookup.h"
 
+#include <olp/core/cache/KeyEncoder.h>
 #include <olp/core/cache/KeyValueCache.h>
 #include <olp/core/client/ApiError.h>
 #include <olp/core/client/Condition.h>
@@ -48,12 +49,6 @@ std::string GetDatastoreServerUrl(const std::string& partition) {
              : "";
 }
 
-std::string CreateKeyForCache(const std::string& hrn,
-                              const std::string& service,
-                              const std::string& service_version) {
-  return hrn + "::" + service + "::" + service_version + "::api";
-}
-
 }  // namespace
 
 client::CancellationToken ApiClientLookup::LookupApi(
@@ -139,8 +134,8 @@ ApiClientLookup::ApiClientResponse ApiClientLookup::LookupApiClient(
     const client::HRN& catalog,
     client::CancellationContext cancellation_context, std::string service,
     std::string service_version, client::OlpClientSettings settings) {
-  auto cache_key =
-      CreateKeyForCache(catalog.ToCatalogHRNString(), service, service_version);
+  auto cache_key = cache::KeyEncoder(catalog.ToCatalogHRNString())
+                       .Api(service, service_version);
   // first, try to find the corresponding Base URL from cache
   auto cache = settings.cache;
   if (cache) {
@@ -224,10 +219,11 @@ ApiClientLookup::ApiClientResponse ApiClientLookup::LookupApiClient(
             cache_key, output_base_url,
             [output_base_url]() { return output_base_url; },
             kExpiryTimeInSecs)) {
-      OLP_SDK_LOG_TRACE_F(kLogTag, "Put '%s' to cache", cache_key.c_str());
+      OLP_SDK_LOG_TRACE_F(kLogTag, "Put '%s/%s' to cache", service.c_str(),
+                          service_version.c_str());
     } else {
-      OLP_SDK_LOG_WARNING_F(kLogTag, "Failed to put '%s' to cache",
-                            cache_key.c_str());
+      OLP_SDK_LOG_WARNING_F(kLogTag, "Failed to put '%s/%s' to cache",
+                            service.c_str(), service_version.c_str());
     }
   }
 
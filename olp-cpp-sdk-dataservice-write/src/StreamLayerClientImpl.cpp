@@ -151,9 +151,6 @@ boost::optional<std::string> StreamLayerClientImpl::Queue(
   {
     std::lock_guard<std::mutex> lock(cache_mutex_);
     const auto publish_data_key = GenerateUuid();
-    cache_->Put(publish_data_key, request, [=]() {
-      return olp::serializer::serialize<PublishDataRequest>(request);
-    });
 
     const auto uuid_list_any =
         cache_->Get(GetUuidListKey(), [](const std::string& s) { return s; });
@@ -163,8 +160,18 @@ boost::optional<std::string> StreamLayerClientImpl::Queue(
     }
     uuid_list += publish_data_key + ",";
 
-    cache_->Put(GetUuidListKey(), uuid_list,
-                [&uuid_list]() { return uuid_list; });
+    // The request and the updated list of the queued requests are stored in
+    // one batch, so the disk cache writes them together.
+    cache::KeyValueCache::BatchItems items(2);
+    items[0].key = publish_data_key;
+    items[0].value = request;
+    items[0].encoder = [&request]() {
+      return olp::serializer::serialize<PublishDataRequest>(request);
+    };
+    items[1].key = GetUuidListKey();
+    items[1].value = uuid_list;
+    items[1].encoder = [&uuid_list]() { return uuid_list; };
+    cache_->PutBatch(items);
   }
 
   return boost::none;
@@ -21,6 +21,7 @@
 #include <matchers/NetworkUrlMatchers.h>
 #include <mocks/CacheMock.h>
 #include <mocks/NetworkMock.h>
+#include <olp/core/cache/KeyEncoder.h>
 #include "ApiClientLookup.h"
 
 namespace {
@@ -140,7 +141,7 @@ TEST_P(ApiClientLookupTest, LookupApiClientSync) {
   const std::string kServiceVersion = "v1";
 
   const std::string kCacheKey =
-      kCatalog + "::" + kServiceName + "::" + kServiceVersion + "::api";
+      olp::cache::KeyEncoder(kCatalog).Api(kServiceName, kServiceVersion);
   const auto kHrn = olp::client::HRN::FromString(kCatalog);
 
   {
@@ -19,6 +19,7 @@
 
 #include "NetworkMock.h"
 
+#include <cstdint>
 #include <thread>
 
 namespace olp {
@@ -103,7 +104,8 @@ GenerateNetworkMockActions(std::shared_ptr<std::promise<void>> pre_signal,
 ///
 
 NetworkCallback ReturnHttpResponse(olp::http::NetworkResponse response,
-                                   const std::string& response_body) {
+                                   const std::string& response_body,
+                                   const olp::http::Headers& headers) {
   return [=](olp::http::NetworkRequest request,
              olp::http::Network::Payload payload,
              olp::http::Network::Callback callback,
@@ -111,7 +113,20 @@ NetworkCallback ReturnHttpResponse(olp::http::NetworkResponse response,
              olp::http::Network::DataCallback data_callback)
              -> olp::http::SendOutcome {
     std::thread([=]() {
-      *payload << response_body;
+      if (header_callback) {
+        for (const auto& header : headers) {
+          header_callback(header.first, header.second);
+        }
+      }
+      // Only the successful body is passed to the data callback.
+      const auto status = response.GetStatus();
+      if (data_callback && status >= 200 && status < 300) {
+        data_callback(
+            reinterpret_cast<const std::uint8_t*>(response_body.data()), 0,
+            response_body.size());
+      } else if (payload) {
+        *payload << response_body;
+      }
       callback(response);
     }).detach();
 
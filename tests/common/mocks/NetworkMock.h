@@ -90,7 +90,8 @@ GenerateNetworkMockActions(std::shared_ptr<std::promise<void>> pre_signal,
 ///
 
 NetworkCallback ReturnHttpResponse(olp::http::NetworkResponse response,
-                                   const std::string& response_body);
+                                   const std::string& response_body,
+                                   const olp::http::Headers& headers = {});
 
 }  // namespace common
 }  // namespace tests
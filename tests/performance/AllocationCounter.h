@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/*
+ * The global operator new of the performance tests counts the allocations
+ * made while g_count_allocations is set.
+ */
+extern std::atomic_bool g_count_allocations;
+/// The number of all the counted allocations.
+extern std::atomic_size_t g_allocations;
+/// The number of the counted allocations of at least kLargeAllocationSize.
+extern std::atomic_size_t g_large_allocations;
+/// The bytes of the counted large allocations.
+extern std::atomic_size_t g_large_allocated_bytes;
+
+constexpr size_t kLargeAllocationSize = 64u * 1024u;
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/cache/CacheSettings.h>
+#include <olp/core/cache/DefaultCache.h>
+#include <olp/core/client/OlpClient.h>
+#include <olp/core/client/OlpClientSettings.h>
+#include <olp/core/http/Network.h>
+#include <olp/core/logging/Log.h>
+#include <olp/core/porting/make_unique.h>
+#include <olp/core/utils/Dir.h>
+#include <testutils/CustomParameters.hpp>
+#include "AllocationCounter.h"
+
+namespace {
+struct BlobTestConfiguration {
+  std::string configuration_name;
+  size_t blob_size = 10u * 1024u * 1024u;
+  bool with_content_length = true;
+  bool with_disk_cache = false;
+  bool to_buffer = true;
+  size_t iterations = 20;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const BlobTestConfiguration& config) {
+  return os << "BlobTestConfiguration("
+            << ".configuration_name=" << config.configuration_name
+            << ", .blob_size=" << config.blob_size
+            << ", .with_content_length=" << config.with_content_length
+            << ", .with_disk_cache=" << config.with_disk_cache
+            << ", .to_buffer=" << config.to_buffer
+            << ", .iterations=" << config.iterations << ")";
+}
+
+constexpr auto kLogTag = "BlobCopyTest";
+constexpr auto kNoExpiry = olp::cache::KeyValueCache::kDefaultExpiry;
+constexpr size_t kChunkSize = 16u * 1024u;
+
+/*
+ * Serves the blob synchronously in chunks, the same way the network
+ * implementations write the received data to the payload.
+ */
+class BlobNetwork : public olp::http::Network {
+ public:
+  BlobNetwork(size_t blob_size, bool with_content_length)
+      : blob_(blob_size, 'x'), with_content_length_(with_content_length) {}
+
+  olp::http::SendOutcome Send(olp::http::NetworkRequest request,
+                              Payload payload, Callback callback,
+                              HeaderCallback header_callback = nullptr,
+                              DataCallback data_callback = nullptr) override {
+    if (header_callback && with_content_length_) {
+      header_callback("Content-Length", std::to_string(blob_.size()));
+    }
+
+    for (size_t offset = 0; offset < blob_.size(); offset += kChunkSize) {
+      const auto size = std::min(kChunkSize, blob_.size() - offset);
+      payload->write(blob_.data() + offset, size);
+    }
+
+    callback(olp::http::NetworkResponse().WithStatus(200));
+    return olp::http::SendOutcome(++request_id_);
+  }
+
+  void Cancel(olp::http::RequestId id) override {}
+
+ private:
+  std::string blob_;
+  bool with_content_length_;
+  olp::http::RequestId request_id_ = 0;
+};
+
+class BlobCopyTest : public ::testing::TestWithParam<BlobTestConfiguration> {
+ protected:
+  std::unique_ptr<olp::cache::DefaultCache> CreateCache();
+};
+
+std::unique_ptr<olp::cache::DefaultCache> BlobCopyTest::CreateCache() {
+  const auto& parameter = GetParam();
+
+  olp::cache::CacheSettings settings;
+  settings.max_memory_cache_size = 256u * 1024u * 1024u;
+  if (parameter.with_disk_cache) {
+    settings.max_memory_cache_size = 0u;
+    settings.max_disk_storage = std::uint64_t(-1);
+
+    auto location = CustomParameters::getArgument("cache_location");
+    if (location.empty()) {
+      location = olp::utils::Dir::TempDirectory() + "/performance_test_cache";
+    }
+    settings.disk_path_mutable = location;
+  }
+
+  auto cache = std::make_unique<olp::cache::DefaultCache>(settings);
+  EXPECT_EQ(cache->Open(), olp::cache::DefaultCache::Success);
+  EXPECT_TRUE(cache->Clear());
+  return cache;
+}
+
+/*
+ * Measures the number of the blob copies and the time that is spent on
+ * receiving a blob and storing it in the cache. Compare the configurations
+ * that receive the blob to the string stream (the way it was done before)
+ * with the configurations that receive the blob directly to the buffer.
+ */
+TEST_P(BlobCopyTest, ReceiveAndCache) {
+  const auto& parameter = GetParam();
+  auto cache = CreateCache();
+
+  olp::client::OlpClientSettings settings;
+  settings.network_request_handler = std::make_shared<BlobNetwork>(
+      parameter.blob_size, parameter.with_content_length);
+  olp::client::OlpClient client;
+  client.SetBaseUrl("https://localhost");
+  client.SetSettings(settings);
+
+  // The blob is received in small chunks, so every large allocation is
+  // a (re)allocation of a buffer that holds the whole blob, i.e. a copy of it.
+  g_large_allocations.store(0);
+  g_large_allocated_bytes.store(0);
+  g_count_allocations.store(true);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < parameter.iterations; ++i) {
+    std::shared_ptr<std::vector<unsigned char>> blob;
+    if (parameter.to_buffer) {
+      auto response = client.CallApiToBuffer(
+          "/blob", "GET", {}, {}, {}, nullptr, "",
+          olp::client::CancellationContext{});
+      blob = std::move(response.body);
+    } else {
+      auto response = client.CallApi("/blob", "GET", {}, {}, {}, nullptr, "",
+                                     olp::client::CancellationContext{});
+      auto str_response = response.response.str();
+      blob = std::make_shared<std::vector<unsigned char>>(str_response.begin(),
+                                                          str_response.end());
+    }
+
+    ASSERT_TRUE(blob);
+    ASSERT_EQ(parameter.blob_size, blob->size());
+    cache->Put("blob::" + std::to_string(i), blob, kNoExpiry);
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  g_count_allocations.store(false);
+
+  const auto iterations = static_cast<double>(parameter.iterations);
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, blob size %zu, large allocations per blob %.1f, "
+      "allocated %.1f bytes per blob byte, %.2f ms per blob",
+      parameter.blob_size, g_large_allocations.load() / iterations,
+      g_large_allocated_bytes.load() / iterations / parameter.blob_size,
+      elapsed.count() / iterations);
+
+  cache->Clear();
+}
+
+std::vector<BlobTestConfiguration> Configurations() {
+  std::vector<BlobTestConfiguration> configurations;
+  for (bool with_disk_cache : {false, true}) {
+    for (size_t megabytes : {5u, 10u, 20u}) {
+      for (bool to_buffer : {false, true}) {
+        BlobTestConfiguration configuration;
+        configuration.configuration_name =
+            std::string(with_disk_cache ? "disk" : "memory") + "_" +
+            std::to_string(megabytes) + "mb_" +
+            (to_buffer ? "buffer" : "stream");
+        configuration.blob_size = megabytes * 1024u * 1024u;
+        configuration.with_disk_cache = with_disk_cache;
+        configuration.to_buffer = to_buffer;
+        configurations.emplace_back(std::move(configuration));
+      }
+    }
+  }
+
+  BlobTestConfiguration configuration;
+  configuration.configuration_name = "memory_10mb_buffer_no_content_length";
+  configuration.with_content_length = false;
+  configurations.emplace_back(std::move(configuration));
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<BlobTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(BlobCopy, BlobCopyTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
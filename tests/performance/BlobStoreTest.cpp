@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/cache/CacheSettings.h>
+#include <olp/core/cache/DefaultCache.h>
+#include <olp/core/logging/Log.h>
+#include <testutils/CustomParameters.hpp>
+#include "CacheTestCommon.h"
+
+namespace {
+struct BlobStoreTestConfiguration {
+  std::string configuration_name;
+  // 0 stores all the values in LevelDB.
+  size_t blob_threshold = 0u;
+  std::uint64_t total_size = 10ull * 1024u * 1024u * 1024u;
+  size_t value_size = 4u * 1024u * 1024u;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const BlobStoreTestConfiguration& config) {
+  return ConfigurationPrinter(os, "BlobStoreTestConfiguration",
+                              config.configuration_name)
+      .Field("blob_threshold", config.blob_threshold)
+      .Field("total_size", config.total_size)
+      .Field("value_size", config.value_size)
+      .End();
+}
+
+constexpr auto kLogTag = "BlobStoreTest";
+
+// The bytes passed to the write calls by this process, so the rewrites made
+// by the LevelDB compactions are counted as well. Linux only, 0 elsewhere.
+std::uint64_t GetWrittenBytes() {
+  std::ifstream io("/proc/self/io");
+  std::string name;
+  std::uint64_t value = 0u;
+  while (io >> name >> value) {
+    if (name == "wchar:") {
+      return value;
+    }
+  }
+  return 0u;
+}
+
+class BlobStoreTest : public DiskCacheTest<BlobStoreTestConfiguration> {};
+
+/*
+ * Simulates the prefetch of large partitions into the mutable cache, with all
+ * the values stored in LevelDB and with the large values stored in
+ * the segment files. Measures the write throughput and the write
+ * amplification, the ratio of the bytes written to the disk, including
+ * the compactions, to the bytes of the values. The total size can be reduced
+ * with the `blob_total_size_mb` parameter.
+ */
+TEST_P(BlobStoreTest, PrefetchWrites) {
+  const auto& parameter = GetParam();
+
+  auto total_size = parameter.total_size;
+  const auto total_size_mb =
+      CustomParameters::getArgument("blob_total_size_mb");
+  if (!total_size_mb.empty()) {
+    total_size = std::strtoull(total_size_mb.c_str(), nullptr, 10) * 1024u *
+                 1024u;
+  }
+  const auto values_count = static_cast<size_t>(total_size /
+                                                parameter.value_size);
+
+  olp::cache::CacheSettings settings;
+  settings.disk_path_mutable = disk_cache_path_;
+  settings.max_disk_storage = std::uint64_t(-1);
+  settings.max_memory_cache_size = 0u;
+  settings.blob_threshold = parameter.blob_threshold;
+
+  const auto value = std::make_shared<olp::cache::KeyValueCache::ValueType>(
+      parameter.value_size, 'x');
+  const auto written_before = GetWrittenBytes();
+  const auto start = std::chrono::steady_clock::now();
+  {
+    olp::cache::DefaultCache cache(settings);
+    ASSERT_EQ(cache.Open(), olp::cache::DefaultCache::Success);
+    for (size_t i = 0; i < values_count; ++i) {
+      ASSERT_TRUE(cache.Put(CreateKey(i), value, kNoExpiry));
+    }
+    // Closing waits for the background compactions.
+    cache.Close();
+  }
+  const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  const auto written = GetWrittenBytes() - written_before;
+
+  const auto stored_size =
+      static_cast<double>(values_count) * parameter.value_size;
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, blob threshold %zu, values %zu, value size %zu, "
+      "time %lld ms, throughput %.1f MB/s, write amplification %.2f",
+      parameter.blob_threshold, values_count, parameter.value_size,
+      static_cast<long long>(duration.count()),
+      stored_size / (1024.0 * 1024.0) /
+          std::max<long long>(duration.count(), 1) * 1000.0,
+      stored_size > 0 ? written / stored_size : 0.0);
+}
+
+std::vector<BlobStoreTestConfiguration> Configurations() {
+  std::vector<BlobStoreTestConfiguration> configurations;
+  for (size_t blob_threshold : {0u, 1024u * 1024u}) {
+    BlobStoreTestConfiguration configuration;
+    configuration.configuration_name =
+        blob_threshold == 0u ? "leveldb" : "blob_store";
+    configuration.blob_threshold = blob_threshold;
+    configurations.emplace_back(std::move(configuration));
+  }
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<BlobStoreTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(BlobStorePrefetch, BlobStoreTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
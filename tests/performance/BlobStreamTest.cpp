@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/client/OlpClient.h>
+#include <olp/core/client/OlpClientSettings.h>
+#include <olp/core/http/Network.h>
+#include <olp/core/logging/Log.h>
+#include <olp/core/utils/Dir.h>
+
+namespace {
+enum class ReceiveMode { kBuffer, kStreamToFile, kStreamDiscard };
+
+struct BlobStreamTestConfiguration {
+  std::string configuration_name;
+  size_t blob_size = 500u * 1024u * 1024u;
+  ReceiveMode mode = ReceiveMode::kBuffer;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const BlobStreamTestConfiguration& config) {
+  return os << "BlobStreamTestConfiguration("
+            << ".configuration_name=" << config.configuration_name
+            << ", .blob_size=" << config.blob_size
+            << ", .mode=" << static_cast<int>(config.mode) << ")";
+}
+
+constexpr auto kLogTag = "BlobStreamTest";
+constexpr size_t kChunkSize = 16u * 1024u;
+
+/*
+ * Resets the peak resident set size of the process, so the peak of every
+ * configuration is measured separately. Supported only on Linux.
+ */
+void ResetPeakResidentSize() {
+#if defined(__linux__)
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+#endif
+}
+
+/*
+ * Gets the peak resident set size of the process in bytes, or zero if it is
+ * not supported.
+ */
+size_t GetPeakResidentSize() {
+#if defined(__linux__)
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {
+      return std::stoull(line.substr(6)) * 1024u;
+    }
+  }
+#endif
+  return 0u;
+}
+
+/*
+ * Serves the blob synchronously in chunks, the same way the network
+ * implementations pass the received data to the payload and to the data
+ * callback. The blob is generated chunk by chunk, so it is never held in
+ * memory by the network.
+ */
+class ChunkedBlobNetwork : public olp::http::Network {
+ public:
+  explicit ChunkedBlobNetwork(size_t blob_size)
+      : blob_size_(blob_size), chunk_(kChunkSize, 'x') {}
+
+  olp::http::SendOutcome Send(olp::http::NetworkRequest request,
+                              Payload payload, Callback callback,
+                              HeaderCallback header_callback = nullptr,
+                              DataCallback data_callback = nullptr) override {
+    if (header_callback) {
+      header_callback("Content-Length", std::to_string(blob_size_));
+    }
+
+    for (size_t offset = 0; offset < blob_size_; offset += kChunkSize) {
+      const auto size = std::min(kChunkSize, blob_size_ - offset);
+      if (data_callback) {
+        data_callback(reinterpret_cast<const std::uint8_t*>(chunk_.data()),
+                      offset, size);
+      }
+      if (payload) {
+        payload->write(chunk_.data(), size);
+      }
+    }
+
+    callback(olp::http::NetworkResponse().WithStatus(200));
+    return olp::http::SendOutcome(++request_id_);
+  }
+
+  void Cancel(olp::http::RequestId id) override {}
+
+ private:
+  size_t blob_size_;
+  std::string chunk_;
+  olp::http::RequestId request_id_ = 0;
+};
+
+class BlobStreamTest
+    : public ::testing::TestWithParam<BlobStreamTestConfiguration> {};
+
+/*
+ * Receives a large blob into the buffer, or streams it to a file or to
+ * nowhere, and measures the peak resident set size of the process and
+ * the time to the first received byte.
+ */
+TEST_P(BlobStreamTest, PeakMemory) {
+  const auto& parameter = GetParam();
+
+  olp::client::OlpClientSettings settings;
+  settings.network_request_handler =
+      std::make_shared<ChunkedBlobNetwork>(parameter.blob_size);
+  olp::client::OlpClient client;
+  client.SetBaseUrl("https://localhost");
+  client.SetSettings(settings);
+
+  const auto path =
+      olp::utils::Dir::TempDirectory() + "/performance_test_blob_stream";
+  std::ofstream file;
+  if (parameter.mode == ReceiveMode::kStreamToFile) {
+    file.open(path, std::ios::binary | std::ios::trunc);
+    ASSERT_TRUE(file.is_open());
+  }
+
+  ResetPeakResidentSize();
+  const auto initial_peak = GetPeakResidentSize();
+
+  const auto start = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point first_byte;
+  size_t received = 0u;
+
+  if (parameter.mode == ReceiveMode::kBuffer) {
+    auto response = client.CallApiToBuffer("/blob", "GET", {}, {}, {},
+                                           nullptr, "", {});
+    first_byte = std::chrono::steady_clock::now();
+    ASSERT_EQ(200, response.status);
+    ASSERT_TRUE(response.body);
+    received = response.body->size();
+  } else {
+    auto data_callback = [&](const std::uint8_t* data, std::uint64_t offset,
+                             std::size_t length) {
+      if (received == 0u) {
+        first_byte = std::chrono::steady_clock::now();
+      }
+      if (file.is_open()) {
+        if (file.tellp() != std::streampos(offset)) {
+          file.seekp(offset);
+        }
+        file.write(reinterpret_cast<const char*>(data), length);
+      }
+      received = offset + length;
+    };
+    auto response = client.CallApiStream("/blob", "GET", {}, {}, {}, nullptr,
+                                         "", data_callback, {});
+    ASSERT_EQ(200, response.status);
+  }
+
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const auto peak = GetPeakResidentSize();
+
+  if (file.is_open()) {
+    file.close();
+    std::remove(path.c_str());
+  }
+
+  EXPECT_EQ(parameter.blob_size, received);
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  using std::chrono::milliseconds;
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, %s, blob size %zu MB, peak RSS %zu MB (grew by %zu MB), "
+      "first byte after %lld us, total %lld ms",
+      parameter.configuration_name.c_str(), parameter.blob_size >> 20,
+      peak >> 20, (peak - std::min(peak, initial_peak)) >> 20,
+      static_cast<long long>(
+          duration_cast<microseconds>(first_byte - start).count()),
+      static_cast<long long>(duration_cast<milliseconds>(elapsed).count()));
+}
+
+std::vector<BlobStreamTestConfiguration> Configurations() {
+  std::vector<BlobStreamTestConfiguration> configurations;
+
+  BlobStreamTestConfiguration configuration;
+  configuration.configuration_name = "500mb_buffer";
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "500mb_stream_to_file";
+  configuration.mode = ReceiveMode::kStreamToFile;
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "500mb_stream_discard";
+  configuration.mode = ReceiveMode::kStreamDiscard;
+  configurations.push_back(configuration);
+
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<BlobStreamTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(BlobStream, BlobStreamTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/cache/CacheSettings.h>
+#include <olp/core/cache/DefaultCache.h>
+#include <olp/core/logging/Log.h>
+#include "CacheTestCommon.h"
+
+namespace {
+struct CacheExpiryTestConfiguration {
+  std::string configuration_name;
+  // The share of the items stored with an expiry time, in percent.
+  int expiring_percentage = 0;
+  size_t keys_count = 100000;
+  size_t puts_count = 1000000;
+  size_t value_size = 1024;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const CacheExpiryTestConfiguration& config) {
+  return ConfigurationPrinter(os, "CacheExpiryTestConfiguration",
+                              config.configuration_name)
+      .Field("expiring_percentage", config.expiring_percentage)
+      .Field("keys_count", config.keys_count)
+      .Field("puts_count", config.puts_count)
+      .Field("value_size", config.value_size)
+      .End();
+}
+
+constexpr auto kLogTag = "CacheExpiryTest";
+
+class CacheExpiryTest
+    : public ::testing::TestWithParam<CacheExpiryTestConfiguration> {};
+
+/*
+ * Measures the Put throughput of the in-memory cache when the items have
+ * mixed expiry times. The memory cache holds less items than there are keys,
+ * so the puts also evict and overwrite items with expiry.
+ */
+TEST_P(CacheExpiryTest, PutThroughput) {
+  const auto& parameter = GetParam();
+
+  olp::cache::CacheSettings settings;
+  settings.max_memory_cache_size =
+      parameter.keys_count * parameter.value_size / 2;
+  olp::cache::DefaultCache cache(settings);
+  ASSERT_EQ(cache.Open(), olp::cache::DefaultCache::Success);
+
+  const auto value = std::make_shared<olp::cache::KeyValueCache::ValueType>(
+      parameter.value_size, 'x');
+
+  std::vector<std::string> keys;
+  keys.reserve(parameter.keys_count);
+  for (size_t i = 0; i < parameter.keys_count; ++i) {
+    keys.push_back(CreateKey(i));
+  }
+
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<size_t> key_distribution(
+      0, parameter.keys_count - 1);
+  std::uniform_int_distribution<int> percentage_distribution(0, 99);
+  std::uniform_int_distribution<time_t> expiry_distribution(1, 24 * 3600);
+
+  std::vector<std::pair<size_t, time_t>> puts(parameter.puts_count);
+  for (auto& put : puts) {
+    put.first = key_distribution(generator);
+    put.second = percentage_distribution(generator) <
+                         parameter.expiring_percentage
+                     ? expiry_distribution(generator)
+                     : kNoExpiry;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto& put : puts) {
+    cache.Put(keys[put.first], value, put.second);
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, expiring %d%%, keys %zu, puts %zu, throughput %.0f "
+      "puts/s",
+      parameter.expiring_percentage, parameter.keys_count,
+      parameter.puts_count,
+      parameter.puts_count * 1000000.0 /
+          std::max<long long>(elapsed.count(), 1));
+
+  EXPECT_TRUE(cache.Clear());
+}
+
+std::vector<CacheExpiryTestConfiguration> Configurations() {
+  std::vector<CacheExpiryTestConfiguration> configurations;
+  for (int expiring_percentage : {0, 50, 100}) {
+    CacheExpiryTestConfiguration configuration;
+    configuration.configuration_name =
+        std::to_string(expiring_percentage) + "_percent_expiring";
+    configuration.expiring_percentage = expiring_percentage;
+    configurations.emplace_back(std::move(configuration));
+  }
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<CacheExpiryTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(CacheExpiry, CacheExpiryTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include "CacheTestCommon.h"
+
+#include <testutils/CustomParameters.hpp>
+
+std::string CreateKey(size_t index) {
+  return "hrn:here:data::olp-here-test:testhrn::layer::" +
+         std::to_string(index) + "::Data";
+}
+
+std::string GetCacheLocation() {
+  auto location = CustomParameters::getArgument("cache_location");
+  if (location.empty()) {
+    location = olp::utils::Dir::TempDirectory() + "/performance_test_cache";
+  }
+  return location;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <olp/core/cache/KeyValueCache.h>
+#include <olp/core/utils/Dir.h>
+
+/*
+ * The scaffolding shared by the cache performance tests.
+ */
+
+constexpr auto kNoExpiry = olp::cache::KeyValueCache::kDefaultExpiry;
+
+/// Creates the partition-like cache key with the given index.
+std::string CreateKey(size_t index);
+
+/// Returns the cache_location parameter or a directory in the temp directory.
+std::string GetCacheLocation();
+
+/// Prints the test configuration as "Type(.configuration_name=..., ...)".
+class ConfigurationPrinter {
+ public:
+  ConfigurationPrinter(std::ostream& os, const char* type,
+                       const std::string& configuration_name)
+      : os_(os) {
+    os_ << type << "(.configuration_name=" << configuration_name;
+  }
+
+  template <typename Value>
+  ConfigurationPrinter& Field(const char* name, const Value& value) {
+    os_ << ", ." << name << "=" << value;
+    return *this;
+  }
+
+  std::ostream& End() { return os_ << ")"; }
+
+ private:
+  std::ostream& os_;
+};
+
+/// The parameterized test fixture that removes the disk cache at
+/// GetCacheLocation() before and after each test.
+template <typename Configuration>
+class DiskCacheTest : public ::testing::TestWithParam<Configuration> {
+ protected:
+  void SetUp() override {
+    disk_cache_path_ = GetCacheLocation();
+    olp::utils::Dir::remove(disk_cache_path_);
+  }
+
+  void TearDown() override { olp::utils::Dir::remove(disk_cache_path_); }
+
+  std::string disk_cache_path_;
+};
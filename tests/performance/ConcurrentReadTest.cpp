@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/cache/CacheSettings.h>
+#include <olp/core/cache/DefaultCache.h>
+#include <olp/core/logging/Log.h>
+#include "CacheTestCommon.h"
+
+namespace {
+struct ConcurrentReadTestConfiguration {
+  std::string configuration_name;
+  bool concurrent_memory_reads = false;
+  std::uint8_t calling_thread_count = 1;
+  size_t keys_count = 10000;
+  size_t value_size = 1024;
+  size_t operations_count = 100000;
+  // The share of the operations that are writes, in percent.
+  int write_percentage = 3;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const ConcurrentReadTestConfiguration& config) {
+  return ConfigurationPrinter(os, "ConcurrentReadTestConfiguration",
+                              config.configuration_name)
+      .Field("concurrent_memory_reads", config.concurrent_memory_reads)
+      .Field("calling_thread_count",
+             static_cast<int>(config.calling_thread_count))
+      .Field("keys_count", config.keys_count)
+      .Field("value_size", config.value_size)
+      .Field("operations_count", config.operations_count)
+      .Field("write_percentage", config.write_percentage)
+      .End();
+}
+
+constexpr auto kLogTag = "ConcurrentReadTest";
+
+class ConcurrentReadTest
+    : public ::testing::TestWithParam<ConcurrentReadTestConfiguration> {};
+
+/*
+ * Measures the latency of the in-memory cache hits when several threads read
+ * the cache and occasionally write to it. All the keys fit into the in-memory
+ * cache, so every read is a hit.
+ */
+TEST_P(ConcurrentReadTest, HitLatency) {
+  const auto& parameter = GetParam();
+
+  olp::cache::CacheSettings settings;
+  settings.max_memory_cache_size =
+      2u * parameter.keys_count * parameter.value_size;
+  settings.concurrent_memory_reads = parameter.concurrent_memory_reads;
+  olp::cache::DefaultCache cache(settings);
+  ASSERT_EQ(cache.Open(), olp::cache::DefaultCache::Success);
+
+  const auto value = std::make_shared<olp::cache::KeyValueCache::ValueType>(
+      parameter.value_size, 'x');
+
+  std::vector<std::string> keys;
+  keys.reserve(parameter.keys_count);
+  for (size_t i = 0; i < parameter.keys_count; ++i) {
+    keys.push_back(CreateKey(i));
+    cache.Put(keys.back(), value, kNoExpiry);
+  }
+
+  std::mutex latencies_mutex;
+  std::vector<std::chrono::nanoseconds> latencies;
+  size_t misses = 0u;
+
+  std::vector<std::thread> threads;
+  for (uint8_t thread_id = 0; thread_id < parameter.calling_thread_count;
+       ++thread_id) {
+    threads.emplace_back([&, thread_id]() {
+      std::mt19937 generator(thread_id);
+      std::uniform_int_distribution<size_t> key_distribution(
+          0, parameter.keys_count - 1);
+      std::uniform_int_distribution<int> operation_distribution(0, 99);
+
+      std::vector<std::chrono::nanoseconds> thread_latencies;
+      thread_latencies.reserve(parameter.operations_count);
+      size_t thread_misses = 0u;
+      for (size_t i = 0; i < parameter.operations_count; ++i) {
+        const auto& key = keys[key_distribution(generator)];
+        if (operation_distribution(generator) < parameter.write_percentage) {
+          cache.Put(key, value, kNoExpiry);
+          continue;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        auto result = cache.Get(key);
+        thread_latencies.push_back(std::chrono::steady_clock::now() - start);
+        if (!result) {
+          ++thread_misses;
+        }
+      }
+
+      std::lock_guard<std::mutex> lock(latencies_mutex);
+      latencies.insert(latencies.end(), thread_latencies.begin(),
+                       thread_latencies.end());
+      misses += thread_misses;
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_FALSE(latencies.empty());
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&](double value) {
+    const auto index = static_cast<size_t>(value * (latencies.size() - 1));
+    return static_cast<long long>(latencies[index].count());
+  };
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, %s, threads %d, reads %zu, misses %zu, p50 %lld ns, "
+      "p99 %lld ns",
+      parameter.concurrent_memory_reads ? "concurrent" : "exclusive",
+      static_cast<int>(parameter.calling_thread_count), latencies.size(),
+      misses, percentile(0.5), percentile(0.99));
+
+  EXPECT_EQ(misses, 0u);
+}
+
+std::vector<ConcurrentReadTestConfiguration> Configurations() {
+  std::vector<ConcurrentReadTestConfiguration> configurations;
+  for (bool concurrent_memory_reads : {false, true}) {
+    for (std::uint8_t threads : {1, 8, 32}) {
+      ConcurrentReadTestConfiguration configuration;
+      configuration.configuration_name =
+          std::string(concurrent_memory_reads ? "concurrent" : "exclusive") +
+          "_" + std::to_string(threads) + "_threads";
+      configuration.concurrent_memory_reads = concurrent_memory_reads;
+      configuration.calling_thread_count = threads;
+      configurations.emplace_back(std::move(configuration));
+    }
+  }
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<ConcurrentReadTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(ConcurrentRead, ConcurrentReadTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/cache/CacheSettings.h>
+#include <olp/core/cache/DefaultCache.h>
+#include <olp/core/logging/Log.h>
+#include <olp/core/porting/make_unique.h>
+#include "CacheTestCommon.h"
+
+namespace {
+struct CacheTestConfiguration {
+  std::string configuration_name;
+  std::uint8_t calling_thread_count = 1;
+  size_t shard_count = 1;
+  bool with_disk_cache = false;
+  size_t keys_count = 10000;
+  size_t value_size = 1024;
+  std::chrono::seconds runtime = std::chrono::seconds(10);
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const CacheTestConfiguration& config) {
+  return ConfigurationPrinter(os, "CacheTestConfiguration",
+                              config.configuration_name)
+      .Field("calling_thread_count",
+             static_cast<int>(config.calling_thread_count))
+      .Field("shard_count", config.shard_count)
+      .Field("with_disk_cache", config.with_disk_cache)
+      .Field("runtime", config.runtime.count())
+      .End();
+}
+
+constexpr auto kLogTag = "DefaultCacheTest";
+
+class DefaultCacheTest
+    : public ::testing::TestWithParam<CacheTestConfiguration> {
+ protected:
+  std::unique_ptr<olp::cache::DefaultCache> CreateCache();
+};
+
+std::unique_ptr<olp::cache::DefaultCache> DefaultCacheTest::CreateCache() {
+  const auto& parameter = GetParam();
+
+  olp::cache::CacheSettings settings;
+  settings.shard_count = parameter.shard_count;
+  settings.max_memory_cache_size = 64u * 1024u * 1024u;
+  if (parameter.with_disk_cache) {
+    settings.max_memory_cache_size = 1024u * 1024u;
+    settings.max_disk_storage = std::uint64_t(-1);
+
+    settings.disk_path_mutable = GetCacheLocation();
+  }
+
+  auto cache = std::make_unique<olp::cache::DefaultCache>(settings);
+  EXPECT_EQ(cache->Open(), olp::cache::DefaultCache::Success);
+  EXPECT_TRUE(cache->Clear());
+  return cache;
+}
+
+/*
+ * Measures the throughput of the mixed Get/Put workload (80% reads, 20%
+ * writes) with the given number of calling threads. Compare the results of
+ * the configurations with one and several shards to see how the cache scales
+ * with the number of cores.
+ */
+TEST_P(DefaultCacheTest, GetPutThroughput) {
+  const auto& parameter = GetParam();
+  auto cache = CreateCache();
+
+  const auto value = std::make_shared<olp::cache::KeyValueCache::ValueType>(
+      parameter.value_size, 'x');
+
+  // Prefill the cache, so most of the reads are hits.
+  for (size_t i = 0; i < parameter.keys_count; ++i) {
+    cache->Put(CreateKey(i), value, kNoExpiry);
+  }
+
+  std::atomic_size_t total_gets{0};
+  std::atomic_size_t total_puts{0};
+  std::atomic_size_t total_hits{0};
+
+  const auto end_timestamp =
+      std::chrono::steady_clock::now() + parameter.runtime;
+
+  std::vector<std::thread> threads;
+  for (uint8_t thread_id = 0; thread_id < parameter.calling_thread_count;
+       ++thread_id) {
+    threads.emplace_back([&, thread_id]() {
+      std::mt19937 generator(thread_id);
+      std::uniform_int_distribution<size_t> key_distribution(
+          0, parameter.keys_count - 1);
+      std::uniform_int_distribution<int> operation_distribution(0, 99);
+
+      size_t gets = 0, puts = 0, hits = 0;
+      while (end_timestamp > std::chrono::steady_clock::now()) {
+        const auto key = CreateKey(key_distribution(generator));
+        if (operation_distribution(generator) < 80) {
+          ++gets;
+          if (cache->Get(key)) {
+            ++hits;
+          }
+        } else {
+          ++puts;
+          cache->Put(key, value, kNoExpiry);
+        }
+      }
+
+      total_gets.fetch_add(gets);
+      total_puts.fetch_add(puts);
+      total_hits.fetch_add(hits);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const auto seconds = static_cast<double>(parameter.runtime.count());
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, threads %d, shards %zu, gets %zu, puts %zu, hits %zu, "
+      "throughput %.0f ops/s",
+      static_cast<int>(parameter.calling_thread_count), parameter.shard_count,
+      total_gets.load(), total_puts.load(), total_hits.load(),
+      (total_gets.load() + total_puts.load()) / seconds);
+
+  EXPECT_GT(total_gets.load(), 0u);
+  cache->Clear();
+}
+
+std::vector<CacheTestConfiguration> Configurations() {
+  std::vector<CacheTestConfiguration> configurations;
+  for (bool with_disk_cache : {false, true}) {
+    for (size_t shard_count : {1u, 16u}) {
+      for (std::uint8_t threads : {1, 2, 4, 8, 16}) {
+        CacheTestConfiguration configuration;
+        configuration.configuration_name =
+            std::string(with_disk_cache ? "disk" : "memory") + "_" +
+            std::to_string(shard_count) + "_shards_" +
+            std::to_string(threads) + "_threads";
+        configuration.calling_thread_count = threads;
+        configuration.shard_count = shard_count;
+        configuration.with_disk_cache = with_disk_cache;
+        configurations.emplace_back(std::move(configuration));
+      }
+    }
+  }
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<CacheTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(CacheScalability, DefaultCacheTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/cache/KeyEncoder.h>
+#include <olp/core/logging/Log.h>
+#include "AllocationCounter.h"
+
+namespace {
+const std::string kCatalog =
+    "hrn:here:data::olp-here-test:hereos-internal-test-v2";
+const std::string kLayer = "testlayer";
+
+using KeyBuilder =
+    std::function<std::string(const std::string& id, size_t index)>;
+
+struct KeyEncoderTestConfiguration {
+  std::string configuration_name;
+  std::function<std::string(size_t index)> create_id;
+  KeyBuilder legacy_key;
+  KeyBuilder encoded_key;
+  size_t keys_count = 100000;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const KeyEncoderTestConfiguration& config) {
+  return os << "KeyEncoderTestConfiguration("
+            << ".configuration_name=" << config.configuration_name
+            << ", .keys_count=" << config.keys_count << ")";
+}
+
+constexpr auto kLogTag = "KeyEncoderTest";
+
+std::string CreatePartitionId(size_t index) {
+  return std::to_string(23618400 + index);
+}
+
+std::string CreateDataHandle(size_t index) {
+  return "4eed6ed1-0d32-43b9-ae79-" + std::to_string(100000000000 + index);
+}
+
+struct BuildResult {
+  size_t bytes = 0u;
+  size_t allocations = 0u;
+  std::chrono::nanoseconds time{};
+};
+
+BuildResult BuildKeys(const KeyBuilder& builder,
+                      const std::vector<std::string>& ids) {
+  BuildResult result;
+  g_allocations.store(0);
+  g_count_allocations.store(true);
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < ids.size(); ++i) {
+    result.bytes += builder(ids[i], i).size();
+  }
+  result.time = std::chrono::steady_clock::now() - start;
+  g_count_allocations.store(false);
+  result.allocations = g_allocations.load();
+  return result;
+}
+
+class KeyEncoderTest
+    : public ::testing::TestWithParam<KeyEncoderTestConfiguration> {};
+
+/*
+ * Builds the same keys in the string format of the older SDK versions and
+ * with the KeyEncoder, and compares the key sizes, the allocations per key,
+ * and the build time.
+ */
+TEST_P(KeyEncoderTest, BuildKeys) {
+  const auto& parameter = GetParam();
+
+  // The IDs are created in advance, so only the key allocations are counted.
+  std::vector<std::string> ids;
+  ids.reserve(parameter.keys_count);
+  for (size_t i = 0; i < parameter.keys_count; ++i) {
+    ids.push_back(parameter.create_id(i));
+  }
+
+  const auto legacy = BuildKeys(parameter.legacy_key, ids);
+  const auto encoded = BuildKeys(parameter.encoded_key, ids);
+
+  const auto count = static_cast<double>(parameter.keys_count);
+  const auto to_ns = [&](std::chrono::nanoseconds time) {
+    return static_cast<double>(time.count()) / count;
+  };
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, %s, keys %zu, legacy %.1f bytes %.2f allocations %.1f "
+      "ns per key, encoded %.1f bytes %.2f allocations %.1f ns per key, "
+      "saved %.1f%%",
+      parameter.configuration_name.c_str(), parameter.keys_count,
+      legacy.bytes / count, legacy.allocations / count, to_ns(legacy.time),
+      encoded.bytes / count, encoded.allocations / count, to_ns(encoded.time),
+      100.0 * (1.0 - static_cast<double>(encoded.bytes) / legacy.bytes));
+
+  EXPECT_LT(encoded.bytes, legacy.bytes);
+  EXPECT_LE(encoded.allocations, parameter.keys_count);
+}
+
+std::vector<KeyEncoderTestConfiguration> Configurations() {
+  std::vector<KeyEncoderTestConfiguration> configurations;
+  const olp::cache::KeyEncoder encoder(kCatalog);
+
+  KeyEncoderTestConfiguration configuration;
+  configuration.configuration_name = "partition";
+  configuration.create_id = CreatePartitionId;
+  configuration.legacy_key = [](const std::string& id, size_t index) {
+    return kCatalog + "::" + kLayer + "::" + id + "::" +
+           std::to_string(index) + "::partition";
+  };
+  configuration.encoded_key = [=](const std::string& id, size_t index) {
+    return encoder.Partition(kLayer, id, static_cast<std::int64_t>(index));
+  };
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "data";
+  configuration.create_id = CreateDataHandle;
+  configuration.legacy_key = [](const std::string& id, size_t) {
+    return kCatalog + "::" + kLayer + "::" + id + "::Data";
+  };
+  configuration.encoded_key = [=](const std::string& id, size_t) {
+    return encoder.Data(kLayer, id);
+  };
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "layer_versions";
+  configuration.create_id = [](size_t) { return std::string(); };
+  configuration.legacy_key = [](const std::string&, size_t index) {
+    return kCatalog + "::" + std::to_string(index) + "::layerVersions";
+  };
+  configuration.encoded_key = [=](const std::string&, size_t index) {
+    return encoder.LayerVersions(static_cast<std::int64_t>(index));
+  };
+  configurations.push_back(configuration);
+
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<KeyEncoderTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(CacheKeys, KeyEncoderTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
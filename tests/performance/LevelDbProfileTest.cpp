@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/cache/CacheSettings.h>
+#include <olp/core/cache/DefaultCache.h>
+#include <olp/core/logging/Log.h>
+#include "CacheTestCommon.h"
+
+namespace {
+struct LevelDbProfileTestConfiguration {
+  std::string configuration_name;
+  olp::cache::LevelDbProfile profile;
+  size_t keys_count = 20000;
+  size_t value_size = 1024;
+  size_t batch_size = 100;
+  size_t lookups_count = 20000;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const LevelDbProfileTestConfiguration& config) {
+  return ConfigurationPrinter(os, "LevelDbProfileTestConfiguration",
+                              config.configuration_name)
+      .Field("bloom_filter_bits_per_key",
+             config.profile.bloom_filter_bits_per_key)
+      .Field("block_cache_size", config.profile.block_cache_size)
+      .Field("block_size", config.profile.block_size)
+      .Field("reuse_logs", config.profile.reuse_logs)
+      .Field("keys_count", config.keys_count)
+      .Field("value_size", config.value_size)
+      .Field("batch_size", config.batch_size)
+      .Field("lookups_count", config.lookups_count)
+      .End();
+}
+
+constexpr auto kLogTag = "LevelDbProfileTest";
+
+using Latencies = std::vector<std::chrono::nanoseconds>;
+
+long long Percentile(Latencies& latencies, double value) {
+  std::sort(latencies.begin(), latencies.end());
+  const auto index = static_cast<size_t>(value * (latencies.size() - 1));
+  return static_cast<long long>(latencies[index].count());
+}
+
+class LevelDbProfileTest
+    : public DiskCacheTest<LevelDbProfileTestConfiguration> {};
+
+/*
+ * Compares the LevelDB profiles. Writes the values in batches, reopens
+ * the cache, and looks up the stored and the missing keys. The in-memory cache
+ * is disabled, so every lookup reads the database.
+ */
+TEST_P(LevelDbProfileTest, WriteAndLookup) {
+  const auto& parameter = GetParam();
+
+  olp::cache::CacheSettings settings;
+  settings.disk_path_mutable = disk_cache_path_;
+  settings.max_disk_storage = std::uint64_t(-1);
+  settings.max_memory_cache_size = 0u;
+  settings.leveldb_profile = parameter.profile;
+
+  const auto to_ms = [](std::chrono::steady_clock::duration duration) {
+    return static_cast<long long>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(duration)
+            .count());
+  };
+
+  std::chrono::steady_clock::duration write_time{};
+  {
+    olp::cache::DefaultCache cache(settings);
+    ASSERT_EQ(cache.Open(), olp::cache::DefaultCache::Success);
+
+    const std::string value(parameter.value_size, 'x');
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t first = 0; first < parameter.keys_count;
+         first += parameter.batch_size) {
+      const auto last =
+          std::min(first + parameter.batch_size, parameter.keys_count);
+      olp::cache::KeyValueCache::BatchItems items(last - first);
+      for (size_t i = first; i < last; ++i) {
+        auto& item = items[i - first];
+        item.key = CreateKey(i);
+        item.value = value;
+        item.encoder = [&value]() { return value; };
+        item.expiry = kNoExpiry;
+      }
+      ASSERT_TRUE(cache.PutBatch(items));
+    }
+    write_time = std::chrono::steady_clock::now() - start;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  olp::cache::DefaultCache cache(settings);
+  ASSERT_EQ(cache.Open(), olp::cache::DefaultCache::Success);
+  const auto open_time = std::chrono::steady_clock::now() - start;
+
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<size_t> key_distribution(
+      0, parameter.keys_count - 1);
+
+  Latencies hit_latencies;
+  Latencies miss_latencies;
+  hit_latencies.reserve(parameter.lookups_count);
+  miss_latencies.reserve(parameter.lookups_count);
+  size_t hits = 0u;
+  for (size_t i = 0; i < parameter.lookups_count; ++i) {
+    const auto index = key_distribution(generator);
+    start = std::chrono::steady_clock::now();
+    if (cache.Get(CreateKey(index))) {
+      ++hits;
+    }
+    hit_latencies.push_back(std::chrono::steady_clock::now() - start);
+
+    // The missing keys fall between the stored ones.
+    start = std::chrono::steady_clock::now();
+    if (cache.Get(CreateKey(index) + "::missing")) {
+      ++hits;
+    }
+    miss_latencies.push_back(std::chrono::steady_clock::now() - start);
+  }
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, %s, keys %zu, value size %zu, write %lld ms, open %lld "
+      "ms, hit p50 %lld ns, hit p99 %lld ns, miss p50 %lld ns, miss p99 %lld "
+      "ns",
+      parameter.configuration_name.c_str(), parameter.keys_count,
+      parameter.value_size, to_ms(write_time), to_ms(open_time),
+      Percentile(hit_latencies, 0.5), Percentile(hit_latencies, 0.99),
+      Percentile(miss_latencies, 0.5), Percentile(miss_latencies, 0.99));
+
+  EXPECT_EQ(hits, parameter.lookups_count);
+}
+
+std::vector<LevelDbProfileTestConfiguration> Configurations() {
+  std::vector<LevelDbProfileTestConfiguration> configurations;
+
+  LevelDbProfileTestConfiguration configuration;
+  configuration.configuration_name = "no_bloom_filter";
+  configuration.profile.bloom_filter_bits_per_key = 0;
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "default";
+  configuration.profile = olp::cache::LevelDbProfile();
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "read_optimized";
+  configuration.profile = olp::cache::LevelDbProfile::ReadOptimized();
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "write_optimized";
+  configuration.profile = olp::cache::LevelDbProfile::WriteOptimized();
+  configurations.push_back(configuration);
+
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<LevelDbProfileTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(LevelDbProfiles, LevelDbProfileTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/logging/Log.h>
+#include <olp/core/utils/HashLruCache.h>
+#include <olp/core/utils/LruCache.h>
+
+namespace {
+struct LruCacheTestConfiguration {
+  std::string configuration_name;
+  bool hash = false;
+  size_t keys_count = 10000;
+  size_t lookups_count = 1000000;
+  size_t prefixes_count = 100;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const LruCacheTestConfiguration& config) {
+  return os << "LruCacheTestConfiguration("
+            << ".configuration_name=" << config.configuration_name
+            << ", .hash=" << config.hash
+            << ", .keys_count=" << config.keys_count
+            << ", .lookups_count=" << config.lookups_count
+            << ", .prefixes_count=" << config.prefixes_count << ")";
+}
+
+constexpr auto kLogTag = "LruCacheTest";
+
+using MapCache = olp::utils::LruCache<std::string, size_t>;
+using HashCache =
+    olp::utils::HashLruCache<std::string, size_t, olp::utils::CacheCost<size_t>,
+                             std::hash<std::string>,
+                             std::equal_to<std::string>, true>;
+
+std::string CreatePrefix(size_t index) {
+  return "hrn:here:data::olp-here-test:catalog-" + std::to_string(index) +
+         "::";
+}
+
+std::string CreateKey(size_t index, size_t prefixes_count) {
+  return CreatePrefix(index % prefixes_count) + "layer::" +
+         std::to_string(index) + "::Data";
+}
+
+// The same scan as InMemoryCache did before the ordered index was added.
+size_t RemoveKeysWithPrefix(MapCache& cache, const std::string& prefix) {
+  size_t removed = 0u;
+  for (auto it = cache.begin(); it != cache.end();) {
+    if (it->key().compare(0, prefix.size(), prefix) == 0) {
+      it = cache.Erase(it);
+      ++removed;
+    } else {
+      ++it;
+    }
+  }
+  return removed;
+}
+
+size_t RemoveKeysWithPrefix(HashCache& cache, const std::string& prefix) {
+  return cache.EraseWhile(prefix, [&](const std::string& key) {
+    return key.compare(0, prefix.size(), prefix) == 0;
+  });
+}
+
+class LruCacheTest
+    : public ::testing::TestWithParam<LruCacheTestConfiguration> {
+ protected:
+  template <typename Cache>
+  void Run();
+};
+
+template <typename Cache>
+void LruCacheTest::Run() {
+  using Clock = std::chrono::steady_clock;
+  const auto& parameter = GetParam();
+
+  std::vector<std::string> keys;
+  keys.reserve(parameter.keys_count);
+  for (size_t i = 0; i < parameter.keys_count; ++i) {
+    keys.push_back(CreateKey(i, parameter.prefixes_count));
+  }
+
+  // The cache is full, so every insert above evicts the oldest item.
+  Cache cache(parameter.keys_count);
+  auto start = Clock::now();
+  for (size_t i = 0; i < parameter.keys_count; ++i) {
+    cache.InsertOrAssign(keys[i], i);
+  }
+  const auto insert_time = Clock::now() - start;
+
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<size_t> key_distribution(
+      0, parameter.keys_count - 1);
+  std::vector<size_t> lookups(parameter.lookups_count);
+  for (auto& lookup : lookups) {
+    lookup = key_distribution(generator);
+  }
+
+  size_t hits = 0u;
+  start = Clock::now();
+  for (const auto lookup : lookups) {
+    if (cache.Find(keys[lookup]) != cache.end()) {
+      ++hits;
+    }
+  }
+  const auto find_time = Clock::now() - start;
+
+  start = Clock::now();
+  const auto removed = RemoveKeysWithPrefix(cache, CreatePrefix(0));
+  const auto remove_time = Clock::now() - start;
+
+  const auto to_ns = [](Clock::duration duration) {
+    return static_cast<long long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+            .count());
+  };
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, %s, keys %zu, insert %lld ns/op, find %lld ns/op, "
+      "prefix removal of %zu keys %lld us",
+      parameter.hash ? "hash" : "map", parameter.keys_count,
+      to_ns(insert_time) / static_cast<long long>(parameter.keys_count),
+      to_ns(find_time) / static_cast<long long>(parameter.lookups_count),
+      removed, to_ns(remove_time) / 1000);
+
+  EXPECT_EQ(hits, parameter.lookups_count);
+  EXPECT_EQ(removed, parameter.keys_count / parameter.prefixes_count);
+  EXPECT_EQ(cache.Size(), parameter.keys_count - removed);
+}
+
+/*
+ * Measures the insert, the lookup and the prefix removal in the map-based
+ * LruCache and in the HashLruCache with the ordered index, which backs the
+ * InMemoryCache.
+ */
+TEST_P(LruCacheTest, Operations) {
+  if (GetParam().hash) {
+    Run<HashCache>();
+  } else {
+    Run<MapCache>();
+  }
+}
+
+std::vector<LruCacheTestConfiguration> Configurations() {
+  std::vector<LruCacheTestConfiguration> configurations;
+  for (size_t keys_count : {10000u, 100000u, 1000000u}) {
+    for (bool hash : {false, true}) {
+      LruCacheTestConfiguration configuration;
+      configuration.configuration_name =
+          std::string(hash ? "hash" : "map") + "_" +
+          std::to_string(keys_count) + "_keys";
+      configuration.hash = hash;
+      configuration.keys_count = keys_count;
+      configurations.emplace_back(std::move(configuration));
+    }
+  }
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<LruCacheTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(LruCacheOperations, LruCacheTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/http/HttpStatusCode.h>
+#include <olp/core/http/Network.h>
+#include <olp/core/logging/Log.h>
+#include <testutils/CustomParameters.hpp>
+
+namespace {
+struct NetworkEventLoopTestConfiguration {
+  std::string configuration_name;
+  size_t requests_in_flight = 64;
+  size_t requests_count = 20000;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const NetworkEventLoopTestConfiguration& config) {
+  return os << "NetworkEventLoopTestConfiguration("
+            << ".configuration_name=" << config.configuration_name
+            << ", .requests_in_flight=" << config.requests_in_flight
+            << ", .requests_count=" << config.requests_count << ")";
+}
+
+constexpr auto kLogTag = "NetworkEventLoopTest";
+
+using Latencies = std::vector<std::chrono::microseconds>;
+
+long long Percentile(Latencies& latencies, double value) {
+  std::sort(latencies.begin(), latencies.end());
+  const auto index = static_cast<size_t>(value * (latencies.size() - 1));
+  return static_cast<long long>(latencies[index].count());
+}
+
+class NetworkEventLoopTest
+    : public ::testing::TestWithParam<NetworkEventLoopTestConfiguration> {
+ protected:
+  void SetUp() override;
+
+  std::string url_;
+};
+
+void NetworkEventLoopTest::SetUp() {
+  // For example, the GET handler of tests/utils/mock_server/server.js.
+  url_ = CustomParameters::getArgument("http_server_url");
+  if (url_.empty()) {
+    GTEST_SKIP() << "http_server_url is not set";
+  }
+}
+
+/*
+ * Keeps the given number of requests in flight, and measures the time from
+ * sending every request to its completion. Every request in flight holds its
+ * own socket, so the event loop watches as many sockets.
+ */
+TEST_P(NetworkEventLoopTest, CompletionLatency) {
+  const auto& parameter = GetParam();
+
+  auto network =
+      olp::http::CreateDefaultNetwork(parameter.requests_in_flight);
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t in_flight = 0u;
+  size_t failed = 0u;
+  Latencies latencies;
+  latencies.reserve(parameter.requests_count);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < parameter.requests_count; ++i) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [&] {
+        return in_flight < parameter.requests_in_flight;
+      });
+      ++in_flight;
+    }
+
+    const auto send_time = std::chrono::steady_clock::now();
+    auto request = olp::http::NetworkRequest(url_).WithVerb(
+        olp::http::NetworkRequest::HttpVerb::GET);
+    auto outcome = network->Send(
+        request, std::make_shared<std::stringstream>(),
+        [&, send_time](olp::http::NetworkResponse response) {
+          const auto latency =
+              std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - send_time);
+          std::lock_guard<std::mutex> lock(mutex);
+          if (response.GetStatus() != olp::http::HttpStatusCode::OK) {
+            ++failed;
+          }
+          latencies.push_back(latency);
+          --in_flight;
+          condition.notify_all();
+        });
+    ASSERT_TRUE(outcome.IsSuccessful());
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&] { return in_flight == 0u; });
+  }
+  const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, %s, requests %zu, in flight %zu, %lld ms, %.1f requests "
+      "per second, latency p50 %lld us, p99 %lld us, max %lld us, failed %zu",
+      parameter.configuration_name.c_str(), parameter.requests_count,
+      parameter.requests_in_flight, static_cast<long long>(duration.count()),
+      parameter.requests_count * 1000.0 /
+          std::max<long long>(1, duration.count()),
+      Percentile(latencies, 0.5), Percentile(latencies, 0.99),
+      Percentile(latencies, 1.0), failed);
+
+  EXPECT_EQ(failed, 0u);
+}
+
+std::vector<NetworkEventLoopTestConfiguration> Configurations() {
+  std::vector<NetworkEventLoopTestConfiguration> configurations;
+
+  NetworkEventLoopTestConfiguration configuration;
+  configuration.configuration_name = "64_in_flight";
+  configuration.requests_in_flight = 64;
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "512_in_flight";
+  configuration.requests_in_flight = 512;
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "2048_in_flight";
+  configuration.requests_in_flight = 2048;
+  configurations.push_back(configuration);
+
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<NetworkEventLoopTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(NetworkEventLoop, NetworkEventLoopTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/http/HttpStatusCode.h>
+#include <olp/core/http/Network.h>
+#include <olp/core/http/NetworkSettings.h>
+#include <olp/core/logging/Log.h>
+#include <testutils/CustomParameters.hpp>
+
+namespace {
+struct NetworkMultiplexingTestConfiguration {
+  std::string configuration_name;
+  bool http2_multiplexing = true;
+  size_t max_connections_per_host = 0;
+  size_t max_streams_per_connection = 100;
+  size_t requests_count = 2000;
+  size_t requests_in_flight = 64;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const NetworkMultiplexingTestConfiguration& config) {
+  return os << "NetworkMultiplexingTestConfiguration("
+            << ".configuration_name=" << config.configuration_name
+            << ", .http2_multiplexing=" << config.http2_multiplexing
+            << ", .max_connections_per_host="
+            << config.max_connections_per_host
+            << ", .max_streams_per_connection="
+            << config.max_streams_per_connection
+            << ", .requests_count=" << config.requests_count
+            << ", .requests_in_flight=" << config.requests_in_flight << ")";
+}
+
+constexpr auto kLogTag = "NetworkMultiplexingTest";
+
+class NetworkMultiplexingTest
+    : public ::testing::TestWithParam<NetworkMultiplexingTestConfiguration> {
+ protected:
+  void SetUp() override;
+
+  std::string url_;
+};
+
+void NetworkMultiplexingTest::SetUp() {
+  // The HTTPS server should support both HTTP/1.1 and HTTP/2 and serve
+  // a small file, for example, nginx with the http2 option enabled.
+  url_ = CustomParameters::getArgument("http2_server_url");
+  if (url_.empty()) {
+    GTEST_SKIP() << "http2_server_url is not set";
+  }
+}
+
+/*
+ * Downloads many small files from one host, keeping a fixed number of
+ * requests in flight, and reports how many connections were opened.
+ */
+TEST_P(NetworkMultiplexingTest, DownloadFromOneHost) {
+  const auto& parameter = GetParam();
+
+  olp::http::NetworkInitializationSettings network_settings;
+  network_settings.max_requests_count = parameter.requests_in_flight;
+  network_settings.max_connections_per_host =
+      parameter.max_connections_per_host;
+  network_settings.max_streams_per_connection =
+      parameter.max_streams_per_connection;
+  auto network = olp::http::CreateDefaultNetwork(network_settings);
+
+  const auto settings = olp::http::NetworkSettings().WithHttp2Multiplexing(
+      parameter.http2_multiplexing);
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t in_flight = 0u;
+  size_t completed = 0u;
+  size_t failed = 0u;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < parameter.requests_count; ++i) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [&] {
+        return in_flight < parameter.requests_in_flight;
+      });
+      ++in_flight;
+    }
+
+    auto request = olp::http::NetworkRequest(url_)
+                       .WithVerb(olp::http::NetworkRequest::HttpVerb::GET)
+                       .WithSettings(settings);
+    auto outcome = network->Send(
+        request, std::make_shared<std::stringstream>(),
+        [&](olp::http::NetworkResponse response) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (response.GetStatus() != olp::http::HttpStatusCode::OK) {
+            ++failed;
+          }
+          ++completed;
+          --in_flight;
+          condition.notify_all();
+        });
+    ASSERT_TRUE(outcome.IsSuccessful());
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock,
+                   [&] { return completed == parameter.requests_count; });
+  }
+  const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  const auto statistics = network->GetStatistics();
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, %s, requests %zu, in flight %zu, %lld ms, %.1f requests "
+      "per second, connections opened %llu, connections reused %llu, HTTP/2 "
+      "requests %llu, failed %zu",
+      parameter.configuration_name.c_str(), parameter.requests_count,
+      parameter.requests_in_flight, static_cast<long long>(duration.count()),
+      parameter.requests_count * 1000.0 /
+          std::max<long long>(1, duration.count()),
+      static_cast<unsigned long long>(statistics.connections_opened),
+      static_cast<unsigned long long>(statistics.connections_reused),
+      static_cast<unsigned long long>(statistics.http2_requests), failed);
+
+  EXPECT_EQ(failed, 0u);
+  EXPECT_EQ(statistics.requests_completed, parameter.requests_count);
+}
+
+std::vector<NetworkMultiplexingTestConfiguration> Configurations() {
+  std::vector<NetworkMultiplexingTestConfiguration> configurations;
+
+  NetworkMultiplexingTestConfiguration configuration;
+  configuration.configuration_name = "http1_1";
+  configuration.http2_multiplexing = false;
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "http1_1_4_connections";
+  configuration.max_connections_per_host = 4;
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "http2";
+  configuration.http2_multiplexing = true;
+  configuration.max_connections_per_host = 0;
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "http2_16_streams";
+  configuration.max_streams_per_connection = 16;
+  configurations.push_back(configuration);
+
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<NetworkMultiplexingTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(Http2, NetworkMultiplexingTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
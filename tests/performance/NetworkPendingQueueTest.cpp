@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/http/HttpStatusCode.h>
+#include <olp/core/http/Network.h>
+#include <olp/core/logging/Log.h>
+#include <olp/core/thread/Priority.h>
+#include <testutils/CustomParameters.hpp>
+
+namespace {
+struct NetworkPendingQueueTestConfiguration {
+  std::string configuration_name;
+  size_t max_requests_count = 16;
+  size_t max_pending_requests_count = 4096;
+  size_t requests_count = 4000;
+  // Every n-th request is sent with the high priority, zero for none.
+  size_t high_priority_interval = 0;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const NetworkPendingQueueTestConfiguration& config) {
+  return os << "NetworkPendingQueueTestConfiguration("
+            << ".configuration_name=" << config.configuration_name
+            << ", .max_requests_count=" << config.max_requests_count
+            << ", .max_pending_requests_count="
+            << config.max_pending_requests_count
+            << ", .requests_count=" << config.requests_count
+            << ", .high_priority_interval=" << config.high_priority_interval
+            << ")";
+}
+
+constexpr auto kLogTag = "NetworkPendingQueueTest";
+
+using Latencies = std::vector<std::chrono::microseconds>;
+
+long long Percentile(Latencies& latencies, double value) {
+  if (latencies.empty()) {
+    return 0;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  const auto index = static_cast<size_t>(value * (latencies.size() - 1));
+  return static_cast<long long>(latencies[index].count());
+}
+
+class NetworkPendingQueueTest
+    : public ::testing::TestWithParam<NetworkPendingQueueTestConfiguration> {
+ protected:
+  void SetUp() override;
+
+  std::string url_;
+};
+
+void NetworkPendingQueueTest::SetUp() {
+  // For example, the GET handler of tests/utils/mock_server/server.js.
+  url_ = CustomParameters::getArgument("http_server_url");
+  if (url_.empty()) {
+    GTEST_SKIP() << "http_server_url is not set";
+  }
+}
+
+/*
+ * Sends a burst of requests, many more than the handles pool can send in
+ * parallel, and measures how many are rejected, how long the queued requests
+ * wait for a free handle, and the latencies of the low and high priority
+ * requests.
+ */
+TEST_P(NetworkPendingQueueTest, Burst) {
+  const auto& parameter = GetParam();
+
+  olp::http::NetworkInitializationSettings settings;
+  settings.max_requests_count = parameter.max_requests_count;
+  settings.min_requests_count = parameter.max_requests_count / 4;
+  settings.max_pending_requests_count = parameter.max_pending_requests_count;
+  auto network = olp::http::CreateDefaultNetwork(settings);
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t in_flight = 0u;
+  size_t rejected = 0u;
+  size_t failed = 0u;
+  Latencies normal_latencies;
+  Latencies high_latencies;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < parameter.requests_count; ++i) {
+    const bool high_priority = parameter.high_priority_interval > 0 &&
+                               i % parameter.high_priority_interval == 0;
+    const auto send_time = std::chrono::steady_clock::now();
+    auto request =
+        olp::http::NetworkRequest(url_)
+            .WithVerb(olp::http::NetworkRequest::HttpVerb::GET)
+            .WithPriority(high_priority ? olp::thread::HIGH
+                                        : olp::thread::NORMAL);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto outcome = network->Send(
+        request, std::make_shared<std::stringstream>(),
+        [&, send_time, high_priority](olp::http::NetworkResponse response) {
+          const auto latency =
+              std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - send_time);
+          std::lock_guard<std::mutex> lock(mutex);
+          if (response.GetStatus() != olp::http::HttpStatusCode::OK) {
+            ++failed;
+          }
+          (high_priority ? high_latencies : normal_latencies)
+              .push_back(latency);
+          --in_flight;
+          condition.notify_all();
+        });
+    if (outcome.IsSuccessful()) {
+      ++in_flight;
+    } else {
+      ++rejected;
+    }
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&] { return in_flight == 0u; });
+  }
+  const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  const auto statistics = network->GetStatistics();
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, %s, requests %zu, %lld ms, rejected %zu, failed %zu, "
+      "queued %llu, peak queue depth %llu, queue wait avg %lld us, max %lld "
+      "us, normal priority latency p50 %lld us, p99 %lld us, high priority "
+      "latency p50 %lld us, p99 %lld us",
+      parameter.configuration_name.c_str(), parameter.requests_count,
+      static_cast<long long>(duration.count()), rejected, failed,
+      static_cast<unsigned long long>(statistics.requests_queued),
+      static_cast<unsigned long long>(statistics.peak_pending_requests),
+      static_cast<long long>(
+          statistics.total_queue_wait_time.count() /
+          std::max<std::uint64_t>(1u, statistics.requests_queued)),
+      static_cast<long long>(statistics.max_queue_wait_time.count()),
+      Percentile(normal_latencies, 0.5), Percentile(normal_latencies, 0.99),
+      Percentile(high_latencies, 0.5), Percentile(high_latencies, 0.99));
+
+  EXPECT_EQ(failed, 0u);
+  EXPECT_EQ(statistics.pending_requests, 0u);
+  if (parameter.max_pending_requests_count >= parameter.requests_count) {
+    EXPECT_EQ(rejected, 0u);
+  }
+}
+
+std::vector<NetworkPendingQueueTestConfiguration> Configurations() {
+  std::vector<NetworkPendingQueueTestConfiguration> configurations;
+
+  NetworkPendingQueueTestConfiguration configuration;
+  configuration.configuration_name = "no_queue";
+  configuration.max_pending_requests_count = 0;
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "queue";
+  configuration.max_pending_requests_count = 4096;
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "queue_with_priorities";
+  configuration.high_priority_interval = 10;
+  configurations.push_back(configuration);
+
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<NetworkPendingQueueTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(NetworkPendingQueue, NetworkPendingQueueTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
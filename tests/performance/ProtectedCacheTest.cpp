@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/cache/CacheSettings.h>
+#include <olp/core/cache/DefaultCache.h>
+#include <olp/core/cache/MappedCacheBuilder.h>
+#include <olp/core/logging/Log.h>
+#include "CacheTestCommon.h"
+
+namespace {
+struct ProtectedCacheTestConfiguration {
+  std::string configuration_name;
+  bool mapped = false;
+  size_t keys_count = 10000;
+  size_t value_size = 1024;
+  size_t lookups_count = 100000;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const ProtectedCacheTestConfiguration& config) {
+  return ConfigurationPrinter(os, "ProtectedCacheTestConfiguration",
+                              config.configuration_name)
+      .Field("mapped", config.mapped)
+      .Field("keys_count", config.keys_count)
+      .Field("value_size", config.value_size)
+      .Field("lookups_count", config.lookups_count)
+      .End();
+}
+
+constexpr auto kLogTag = "ProtectedCacheTest";
+
+class ProtectedCacheTest
+    : public DiskCacheTest<ProtectedCacheTestConfiguration> {
+ protected:
+  void SetUp() override;
+  void TearDown() override;
+
+  std::string mapped_cache_path_;
+};
+
+void ProtectedCacheTest::SetUp() {
+  DiskCacheTest::SetUp();
+  const auto& parameter = GetParam();
+  mapped_cache_path_ = disk_cache_path_ + ".mapped";
+
+  olp::cache::CacheSettings settings;
+  settings.disk_path_mutable = disk_cache_path_;
+  settings.max_disk_storage = std::uint64_t(-1);
+  settings.max_memory_cache_size = 0u;
+
+  olp::cache::DefaultCache cache(settings);
+  ASSERT_EQ(cache.Open(), olp::cache::DefaultCache::Success);
+  ASSERT_TRUE(cache.Clear());
+
+  const std::string value(parameter.value_size, 'x');
+  olp::cache::KeyValueCache::BatchItems items(parameter.keys_count);
+  for (size_t i = 0; i < parameter.keys_count; ++i) {
+    items[i].key = CreateKey(i);
+    items[i].value = value;
+    items[i].encoder = [&value]() { return value; };
+    items[i].expiry = kNoExpiry;
+  }
+  ASSERT_TRUE(cache.PutBatch(items));
+  cache.Close();
+
+  ASSERT_TRUE(olp::cache::MappedCacheBuilder::ConvertDiskCache(
+      disk_cache_path_, mapped_cache_path_));
+}
+
+void ProtectedCacheTest::TearDown() {
+  DiskCacheTest::TearDown();
+  std::remove(mapped_cache_path_.c_str());
+}
+
+/*
+ * Measures the latency of the lookups in the protected cache, when the cache
+ * is a LevelDB directory and when it is the memory-mapped file converted from
+ * the same directory. The in-memory cache is disabled, so every lookup reads
+ * the protected cache.
+ */
+TEST_P(ProtectedCacheTest, LookupLatency) {
+  const auto& parameter = GetParam();
+
+  olp::cache::CacheSettings settings;
+  settings.disk_path_protected =
+      parameter.mapped ? mapped_cache_path_ : disk_cache_path_;
+  settings.max_memory_cache_size = 0u;
+
+  olp::cache::DefaultCache cache(settings);
+  ASSERT_EQ(cache.Open(), olp::cache::DefaultCache::Success);
+
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<size_t> key_distribution(
+      0, parameter.keys_count - 1);
+
+  std::vector<std::chrono::nanoseconds> latencies;
+  latencies.reserve(parameter.lookups_count);
+  size_t hits = 0;
+  for (size_t i = 0; i < parameter.lookups_count; ++i) {
+    const auto key = CreateKey(key_distribution(generator));
+    const auto start = std::chrono::steady_clock::now();
+    auto value = cache.Get(key);
+    latencies.push_back(std::chrono::steady_clock::now() - start);
+    if (value) {
+      ++hits;
+    }
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  std::chrono::nanoseconds total(0);
+  for (const auto& latency : latencies) {
+    total += latency;
+  }
+
+  const auto percentile = [&](double value) {
+    const auto index = static_cast<size_t>(value * (latencies.size() - 1));
+    return static_cast<long long>(latencies[index].count());
+  };
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, %s, keys %zu, value size %zu, lookups %zu, hits %zu, "
+      "average %lld ns, p50 %lld ns, p99 %lld ns",
+      parameter.mapped ? "mapped" : "leveldb", parameter.keys_count,
+      parameter.value_size, parameter.lookups_count, hits,
+      static_cast<long long>(total.count() / latencies.size()),
+      percentile(0.5), percentile(0.99));
+
+  EXPECT_EQ(hits, parameter.lookups_count);
+}
+
+std::vector<ProtectedCacheTestConfiguration> Configurations() {
+  std::vector<ProtectedCacheTestConfiguration> configurations;
+  for (size_t value_size : {1024u, 16u * 1024u}) {
+    for (bool mapped : {false, true}) {
+      ProtectedCacheTestConfiguration configuration;
+      configuration.configuration_name =
+          std::string(mapped ? "mapped" : "leveldb") + "_" +
+          std::to_string(value_size) + "_bytes";
+      configuration.mapped = mapped;
+      configuration.value_size = value_size;
+      configurations.emplace_back(std::move(configuration));
+    }
+  }
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<ProtectedCacheTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(ProtectedCacheLatency, ProtectedCacheTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/client/OlpClient.h>
+#include <olp/core/client/OlpClientSettings.h>
+#include <olp/core/http/Network.h>
+#include <olp/core/logging/Log.h>
+#include <olp/core/thread/ThreadPoolTaskScheduler.h>
+
+namespace {
+struct RetryThroughputTestConfiguration {
+  std::string configuration_name;
+  size_t healthy_requests_count = 2000;
+  size_t retried_requests_count = 0;
+  int max_attempts = 3;
+  int initial_backdown_period = 200;
+  bool with_task_scheduler = true;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const RetryThroughputTestConfiguration& config) {
+  return os << "RetryThroughputTestConfiguration("
+            << ".configuration_name=" << config.configuration_name
+            << ", .healthy_requests_count=" << config.healthy_requests_count
+            << ", .retried_requests_count=" << config.retried_requests_count
+            << ", .max_attempts=" << config.max_attempts
+            << ", .initial_backdown_period=" << config.initial_backdown_period
+            << ", .with_task_scheduler=" << config.with_task_scheduler << ")";
+}
+
+constexpr auto kLogTag = "RetryThroughputTest";
+constexpr auto kUnhealthyPath = "/unhealthy";
+
+/*
+ * Completes the requests on one worker thread, the same way the network
+ * implementations call the callbacks. The requests to the unhealthy path
+ * fail with 503.
+ */
+class SingleThreadNetwork : public olp::http::Network {
+ public:
+  SingleThreadNetwork() : thread_(&SingleThreadNetwork::Run, this) {}
+
+  ~SingleThreadNetwork() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    condition_.notify_one();
+    thread_.join();
+  }
+
+  olp::http::SendOutcome Send(olp::http::NetworkRequest request,
+                              Payload payload, Callback callback,
+                              HeaderCallback header_callback = nullptr,
+                              DataCallback data_callback = nullptr) override {
+    const bool unhealthy =
+        request.GetUrl().find(kUnhealthyPath) != std::string::npos;
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto id = ++request_id_;
+    requests_.push_back({unhealthy, std::move(callback)});
+    condition_.notify_one();
+    return olp::http::SendOutcome(id);
+  }
+
+  void Cancel(olp::http::RequestId id) override {}
+
+ private:
+  struct Request {
+    bool unhealthy;
+    Callback callback;
+  };
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      condition_.wait(lock, [&]() { return stop_ || !requests_.empty(); });
+      if (stop_) {
+        return;
+      }
+
+      auto request = std::move(requests_.front());
+      requests_.pop_front();
+      lock.unlock();
+      request.callback(olp::http::NetworkResponse().WithStatus(
+          request.unhealthy ? 503 : 200));
+      lock.lock();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<Request> requests_;
+  olp::http::RequestId request_id_ = 0;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+class RetryThroughputTest
+    : public ::testing::TestWithParam<RetryThroughputTestConfiguration> {};
+
+/*
+ * Sends the requests that are retried with the backdown, then the healthy
+ * requests, and measures the throughput of the healthy requests. The backdown
+ * period should not stall the network thread, so the throughput should be
+ * the same as without the retried requests.
+ */
+TEST_P(RetryThroughputTest, HealthyThroughput) {
+  const auto& parameter = GetParam();
+
+  auto network = std::make_shared<SingleThreadNetwork>();
+  olp::client::OlpClientSettings settings;
+  settings.network_request_handler = network;
+  if (parameter.with_task_scheduler) {
+    settings.task_scheduler =
+        std::make_shared<olp::thread::ThreadPoolTaskScheduler>(4u);
+  }
+  settings.retry_settings.max_attempts = parameter.max_attempts;
+  settings.retry_settings.initial_backdown_period =
+      parameter.initial_backdown_period;
+  settings.retry_settings.retry_condition =
+      [](const olp::client::HttpResponse& response) {
+        return response.status == 503;
+      };
+
+  olp::client::OlpClient client;
+  client.SetBaseUrl("http://localhost");
+  client.SetSettings(settings);
+
+  const auto total_count =
+      parameter.retried_requests_count + parameter.healthy_requests_count;
+  std::atomic<size_t> retried_done{0u};
+  std::atomic<size_t> healthy_done{0u};
+  std::atomic<size_t> failed{0u};
+  std::promise<void> healthy_finished;
+  std::promise<void> all_finished;
+  std::atomic<size_t> done{0u};
+
+  auto on_done = [&]() {
+    if (++done == total_count) {
+      all_finished.set_value();
+    }
+  };
+
+  std::vector<olp::client::CancellationToken> tokens;
+  tokens.reserve(total_count);
+  for (size_t i = 0; i < parameter.retried_requests_count; ++i) {
+    tokens.push_back(client.CallApi(
+        kUnhealthyPath, "GET", {}, {}, {}, nullptr, {},
+        [&](olp::client::HttpResponse response) {
+          ++retried_done;
+          on_done();
+        }));
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point healthy_end;
+  for (size_t i = 0; i < parameter.healthy_requests_count; ++i) {
+    tokens.push_back(client.CallApi(
+        "/healthy", "GET", {}, {}, {}, nullptr, {},
+        [&](olp::client::HttpResponse response) {
+          if (response.status != 200) {
+            ++failed;
+          }
+          if (++healthy_done == parameter.healthy_requests_count) {
+            healthy_end = std::chrono::steady_clock::now();
+            healthy_finished.set_value();
+          }
+          on_done();
+        }));
+  }
+
+  healthy_finished.get_future().wait();
+  const auto retried_done_before = retried_done.load();
+  all_finished.get_future().wait();
+
+  const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      healthy_end - start);
+  const auto throughput =
+      parameter.healthy_requests_count * 1000.0 /
+      std::max<long long>(1, static_cast<long long>(duration.count()));
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, %s, %zu healthy requests in %lld ms, %.0f requests/s, "
+      "retried requests done before the healthy ones %zu/%zu",
+      parameter.configuration_name.c_str(), parameter.healthy_requests_count,
+      static_cast<long long>(duration.count()), throughput, retried_done_before,
+      parameter.retried_requests_count);
+
+  EXPECT_EQ(0u, failed.load());
+}
+
+std::vector<RetryThroughputTestConfiguration> Configurations() {
+  std::vector<RetryThroughputTestConfiguration> configurations;
+
+  RetryThroughputTestConfiguration configuration;
+  configuration.configuration_name = "healthy_only";
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "with_retries";
+  configuration.retried_requests_count = 500;
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "with_retries_no_task_scheduler";
+  configuration.with_task_scheduler = false;
+  configurations.push_back(configuration);
+
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<RetryThroughputTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(RetryThroughput, RetryThroughputTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
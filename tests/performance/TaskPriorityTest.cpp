@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/logging/Log.h>
+#include <olp/core/thread/ThreadPoolTaskScheduler.h>
+
+namespace {
+struct TaskPriorityTestConfiguration {
+  std::string configuration_name;
+  size_t thread_count = 4;
+  size_t background_tasks_count = 2000;
+  std::chrono::microseconds background_task_duration{1000};
+  size_t interactive_tasks_count = 20;
+  std::chrono::milliseconds interactive_tasks_interval{20};
+  std::uint32_t background_priority = olp::thread::NORMAL;
+  std::uint32_t interactive_priority = olp::thread::NORMAL;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const TaskPriorityTestConfiguration& config) {
+  return os << "TaskPriorityTestConfiguration("
+            << ".configuration_name=" << config.configuration_name
+            << ", .thread_count=" << config.thread_count
+            << ", .background_tasks_count=" << config.background_tasks_count
+            << ", .background_task_duration="
+            << config.background_task_duration.count()
+            << ", .interactive_tasks_count=" << config.interactive_tasks_count
+            << ", .interactive_tasks_interval="
+            << config.interactive_tasks_interval.count()
+            << ", .background_priority=" << config.background_priority
+            << ", .interactive_priority=" << config.interactive_priority
+            << ")";
+}
+
+constexpr auto kLogTag = "TaskPriorityTest";
+
+using Latencies = std::vector<std::chrono::microseconds>;
+
+long long Percentile(Latencies& latencies, double value) {
+  std::sort(latencies.begin(), latencies.end());
+  const auto index = static_cast<size_t>(value * (latencies.size() - 1));
+  return static_cast<long long>(latencies[index].count());
+}
+
+class TaskPriorityTest
+    : public ::testing::TestWithParam<TaskPriorityTestConfiguration> {};
+
+/*
+ * Floods the scheduler with background tasks, like a large prefetch does,
+ * then schedules interactive tasks, and measures how long the interactive
+ * tasks wait before they start.
+ */
+TEST_P(TaskPriorityTest, InteractiveLatency) {
+  const auto& parameter = GetParam();
+
+  olp::thread::ThreadPoolTaskScheduler scheduler(parameter.thread_count);
+
+  std::atomic<size_t> background_done{0u};
+  std::promise<void> background_finished;
+  for (size_t i = 0; i < parameter.background_tasks_count; ++i) {
+    scheduler.ScheduleTask(
+        [&]() {
+          std::this_thread::sleep_for(parameter.background_task_duration);
+          if (++background_done == parameter.background_tasks_count) {
+            background_finished.set_value();
+          }
+        },
+        parameter.background_priority);
+  }
+
+  std::mutex mutex;
+  Latencies latencies;
+  std::vector<std::future<void>> interactive_finished;
+  for (size_t i = 0; i < parameter.interactive_tasks_count; ++i) {
+    auto promise = std::make_shared<std::promise<void>>();
+    interactive_finished.push_back(promise->get_future());
+    const auto schedule_time = std::chrono::steady_clock::now();
+    scheduler.ScheduleTask(
+        [&, promise, schedule_time]() {
+          const auto latency =
+              std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - schedule_time);
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            latencies.push_back(latency);
+          }
+          promise->set_value();
+        },
+        parameter.interactive_priority);
+    std::this_thread::sleep_for(parameter.interactive_tasks_interval);
+  }
+
+  for (auto& future : interactive_finished) {
+    future.wait();
+  }
+  const auto interactive_done = background_done.load();
+  background_finished.get_future().wait();
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, %s, interactive latency p50 %lld us, p99 %lld us, max "
+      "%lld us, background tasks done before the last interactive %zu/%zu",
+      parameter.configuration_name.c_str(), Percentile(latencies, 0.5),
+      Percentile(latencies, 0.99), Percentile(latencies, 1.0),
+      interactive_done, parameter.background_tasks_count);
+}
+
+std::vector<TaskPriorityTestConfiguration> Configurations() {
+  std::vector<TaskPriorityTestConfiguration> configurations;
+
+  TaskPriorityTestConfiguration configuration;
+  configuration.configuration_name = "same_priority";
+  configurations.push_back(configuration);
+
+  configuration.configuration_name = "low_background_high_interactive";
+  configuration.background_priority = olp::thread::LOW;
+  configuration.interactive_priority = olp::thread::HIGH;
+  configurations.push_back(configuration);
+
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<TaskPriorityTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(TaskPriority, TaskPriorityTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
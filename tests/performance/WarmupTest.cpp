@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/cache/CacheSettings.h>
+#include <olp/core/cache/DefaultCache.h>
+#include <olp/core/logging/Log.h>
+#include <olp/core/thread/ThreadPoolTaskScheduler.h>
+#include <olp/core/utils/Dir.h>
+#include <testutils/CustomParameters.hpp>
+
+namespace {
+enum class WarmupMode { kCold, kHotKeys, kPrefixes };
+
+struct WarmupTestConfiguration {
+  std::string configuration_name;
+  WarmupMode mode = WarmupMode::kCold;
+  size_t keys_count = 20000;
+  size_t hot_keys_count = 2000;
+  size_t value_size = 4096;
+  size_t max_parallel_tasks = 4;
+  // The lookups between the hit rate checks.
+  size_t window_size = 500;
+  // The in-memory hit rate of a window that counts as the steady state.
+  double steady_hit_rate = 0.95;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const WarmupTestConfiguration& config) {
+  return os << "WarmupTestConfiguration("
+            << ".configuration_name=" << config.configuration_name
+            << ", .mode=" << static_cast<int>(config.mode)
+            << ", .keys_count=" << config.keys_count
+            << ", .hot_keys_count=" << config.hot_keys_count
+            << ", .value_size=" << config.value_size
+            << ", .max_parallel_tasks=" << config.max_parallel_tasks
+            << ", .window_size=" << config.window_size
+            << ", .steady_hit_rate=" << config.steady_hit_rate << ")";
+}
+
+constexpr auto kLogTag = "WarmupTest";
+constexpr auto kNoExpiry = olp::cache::KeyValueCache::kDefaultExpiry;
+constexpr auto kHotPrefix = "hrn:here:data::olp-here-test:testhrn::hot::";
+constexpr auto kColdPrefix = "hrn:here:data::olp-here-test:testhrn::cold::";
+
+std::string CreateKey(size_t index, size_t hot_keys_count) {
+  return (index < hot_keys_count ? kHotPrefix : kColdPrefix) +
+         std::to_string(index) + "::Data";
+}
+
+class WarmupTest : public ::testing::TestWithParam<WarmupTestConfiguration> {
+ protected:
+  void SetUp() override;
+  void TearDown() override;
+
+  olp::cache::CacheSettings CreateSettings() const;
+
+  std::string disk_cache_path_;
+  std::string hot_keys_path_;
+};
+
+olp::cache::CacheSettings WarmupTest::CreateSettings() const {
+  const auto& parameter = GetParam();
+
+  olp::cache::CacheSettings settings;
+  settings.disk_path_mutable = disk_cache_path_;
+  settings.max_disk_storage = std::uint64_t(-1);
+  // The hot keys fit into the memory with some room to spare.
+  settings.max_memory_cache_size =
+      parameter.hot_keys_count * parameter.value_size * 5u / 4u;
+  settings.enable_statistics = true;
+  settings.task_scheduler =
+      std::make_shared<olp::thread::ThreadPoolTaskScheduler>(
+          parameter.max_parallel_tasks);
+  return settings;
+}
+
+void WarmupTest::SetUp() {
+  const auto& parameter = GetParam();
+
+  auto location = CustomParameters::getArgument("cache_location");
+  if (location.empty()) {
+    location = olp::utils::Dir::TempDirectory() + "/performance_test_cache";
+  }
+  disk_cache_path_ = location;
+  hot_keys_path_ = location + ".hot_keys";
+
+  olp::cache::DefaultCache cache(CreateSettings());
+  ASSERT_EQ(cache.Open(), olp::cache::DefaultCache::Success);
+  ASSERT_TRUE(cache.Clear());
+
+  const auto value = std::make_shared<olp::cache::KeyValueCache::ValueType>(
+      parameter.value_size, 'x');
+  for (size_t i = 0; i < parameter.keys_count; ++i) {
+    ASSERT_TRUE(
+        cache.Put(CreateKey(i, parameter.hot_keys_count), value, kNoExpiry));
+  }
+
+  // The snapshot of the previous run, taken after the hot keys are read.
+  for (size_t i = 0; i < parameter.hot_keys_count; ++i) {
+    ASSERT_TRUE(cache.Get(CreateKey(i, parameter.hot_keys_count)));
+  }
+  ASSERT_TRUE(cache.DumpHotKeys(hot_keys_path_));
+}
+
+void WarmupTest::TearDown() {
+  olp::utils::Dir::remove(disk_cache_path_);
+  std::remove(hot_keys_path_.c_str());
+}
+
+/*
+ * Measures the time it takes a restarted cache to reach the steady in-memory
+ * hit rate, when the lookups go to the hot keys. The cold cache fills the
+ * memory by the lookups, the warmed one loads the hot keys snapshot or the hot
+ * keys prefix first. The reported time includes the warm-up.
+ */
+TEST_P(WarmupTest, TimeToSteadyState) {
+  const auto& parameter = GetParam();
+
+  olp::cache::DefaultCache cache(CreateSettings());
+  ASSERT_EQ(cache.Open(), olp::cache::DefaultCache::Success);
+
+  const auto start = std::chrono::steady_clock::now();
+  size_t loaded_count = 0u;
+  if (parameter.mode != WarmupMode::kCold) {
+    olp::cache::WarmupManifest manifest;
+    if (parameter.mode == WarmupMode::kHotKeys) {
+      manifest.hot_keys_path = hot_keys_path_;
+    } else {
+      manifest.key_prefixes = {kHotPrefix};
+    }
+    manifest.max_parallel_tasks = parameter.max_parallel_tasks;
+
+    std::promise<size_t> loaded;
+    ASSERT_TRUE(cache.Warmup(
+        manifest, [&](size_t count) { loaded.set_value(count); }));
+    loaded_count = loaded.get_future().get();
+  }
+  const auto warmup_time = std::chrono::steady_clock::now() - start;
+
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<size_t> key_distribution(
+      0, parameter.hot_keys_count - 1);
+
+  cache.ResetStatistics();
+  size_t lookups = 0u;
+  std::uint64_t memory_hits = 0u;
+  double hit_rate = 0.0;
+  while (hit_rate < parameter.steady_hit_rate &&
+         lookups < 100u * parameter.hot_keys_count) {
+    for (size_t i = 0; i < parameter.window_size; ++i) {
+      ASSERT_TRUE(cache.Get(
+          CreateKey(key_distribution(generator), parameter.hot_keys_count)));
+    }
+    lookups += parameter.window_size;
+
+    const auto hits = cache.GetStatistics().total.memory_hits;
+    hit_rate = static_cast<double>(hits - memory_hits) / parameter.window_size;
+    memory_hits = hits;
+  }
+  const auto total_time = std::chrono::steady_clock::now() - start;
+
+  const auto to_ms = [](std::chrono::steady_clock::duration duration) {
+    return static_cast<long long>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(duration)
+            .count());
+  };
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, %s, loaded %zu values in %lld ms, steady hit rate after "
+      "%zu lookups, time to steady state %lld ms",
+      parameter.configuration_name.c_str(), loaded_count, to_ms(warmup_time),
+      lookups, to_ms(total_time));
+
+  EXPECT_GE(hit_rate, parameter.steady_hit_rate);
+}
+
+std::vector<WarmupTestConfiguration> Configurations() {
+  std::vector<WarmupTestConfiguration> configurations;
+
+  WarmupTestConfiguration cold;
+  cold.configuration_name = "cold";
+  configurations.push_back(cold);
+
+  WarmupTestConfiguration hot_keys;
+  hot_keys.configuration_name = "hot_keys";
+  hot_keys.mode = WarmupMode::kHotKeys;
+  configurations.push_back(hot_keys);
+
+  WarmupTestConfiguration prefixes;
+  prefixes.configuration_name = "prefixes";
+  prefixes.mode = WarmupMode::kPrefixes;
+  configurations.push_back(prefixes);
+
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<WarmupTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(CacheWarmup, WarmupTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
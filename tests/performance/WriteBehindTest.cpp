@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <olp/core/cache/CacheSettings.h>
+#include <olp/core/cache/DefaultCache.h>
+#include <olp/core/logging/Log.h>
+#include "CacheTestCommon.h"
+
+namespace {
+struct WriteBehindTestConfiguration {
+  std::string configuration_name;
+  bool write_behind = false;
+  bool enforce_immediate_flush = true;
+  size_t keys_count = 10000;
+  size_t value_size = 4096;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const WriteBehindTestConfiguration& config) {
+  return ConfigurationPrinter(os, "WriteBehindTestConfiguration",
+                              config.configuration_name)
+      .Field("write_behind", config.write_behind)
+      .Field("enforce_immediate_flush", config.enforce_immediate_flush)
+      .Field("keys_count", config.keys_count)
+      .Field("value_size", config.value_size)
+      .End();
+}
+
+constexpr auto kLogTag = "WriteBehindTest";
+
+class WriteBehindTest : public DiskCacheTest<WriteBehindTestConfiguration> {};
+
+/*
+ * Measures the latency of the puts with the synchronous disk writes and with
+ * the write-behind mode. The total time includes the final flush, so it shows
+ * the throughput of the disk writes as well.
+ */
+TEST_P(WriteBehindTest, PutLatency) {
+  const auto& parameter = GetParam();
+
+  olp::cache::CacheSettings settings;
+  settings.disk_path_mutable = disk_cache_path_;
+  settings.max_disk_storage = std::uint64_t(-1);
+  settings.enforce_immediate_flush = parameter.enforce_immediate_flush;
+  settings.write_behind = parameter.write_behind;
+
+  olp::cache::DefaultCache cache(settings);
+  ASSERT_EQ(cache.Open(), olp::cache::DefaultCache::Success);
+
+  const auto value = std::make_shared<olp::cache::KeyValueCache::ValueType>(
+      parameter.value_size, 'x');
+  std::vector<std::chrono::nanoseconds> latencies;
+  latencies.reserve(parameter.keys_count);
+
+  const auto test_start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < parameter.keys_count; ++i) {
+    const auto key = CreateKey(i);
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(cache.Put(key, value, kNoExpiry));
+    latencies.push_back(std::chrono::steady_clock::now() - start);
+  }
+  ASSERT_TRUE(cache.Flush());
+  const auto total = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - test_start);
+
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&](double value) {
+    const auto index = static_cast<size_t>(value * (latencies.size() - 1));
+    return static_cast<long long>(latencies[index].count());
+  };
+
+  OLP_SDK_LOG_CRITICAL_INFO_F(
+      kLogTag,
+      "Test finished, %s, immediate flush %d, keys %zu, value size %zu, "
+      "total %lld ms, p50 %lld ns, p99 %lld ns",
+      parameter.write_behind ? "write-behind" : "synchronous",
+      parameter.enforce_immediate_flush ? 1 : 0, parameter.keys_count,
+      parameter.value_size, static_cast<long long>(total.count()),
+      percentile(0.5), percentile(0.99));
+
+  cache.Close();
+}
+
+std::vector<WriteBehindTestConfiguration> Configurations() {
+  std::vector<WriteBehindTestConfiguration> configurations;
+  for (bool enforce_immediate_flush : {true, false}) {
+    for (bool write_behind : {false, true}) {
+      WriteBehindTestConfiguration configuration;
+      configuration.configuration_name =
+          std::string(write_behind ? "write_behind" : "synchronous") +
+          (enforce_immediate_flush ? "_immediate_flush" : "");
+      configuration.write_behind = write_behind;
+      configuration.enforce_immediate_flush = enforce_immediate_flush;
+      configurations.emplace_back(std::move(configuration));
+    }
+  }
+  return configurations;
+}
+
+std::string TestName(
+    const testing::TestParamInfo<WriteBehindTestConfiguration>& info) {
+  return info.param.configuration_name;
+}
+
+INSTANTIATE_TEST_SUITE_P(WriteBehindLatency, WriteBehindTest,
+                         ::testing::ValuesIn(Configurations()), TestName);
+}  // namespace
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2019 HERE Europe B.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <iostream>
+#include <string>
+
+#include <olp/core/cache/MappedCacheBuilder.h>
+
+namespace {
+constexpr auto kUsage =
+    "usage is \n olp-cpp-sdk-protected-cache-builder <disk cache path> "
+    "<output file> \n Converts the disk cache, for example, the mutable cache "
+    "filled by the SDK, to the memory-mapped protected cache file. Set "
+    "CacheSettings::disk_path_protected to the output file to use it.";
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::cout << kUsage << std::endl;
+    return 1;
+  }
+
+  const std::string disk_cache_path = argv[1];
+  const std::string output_path = argv[2];
+  if (!olp::cache::MappedCacheBuilder::ConvertDiskCache(disk_cache_path,
+                                                        output_path)) {
+    std::cerr << "Failed to convert " << disk_cache_path << " to "
+              << output_path << std::endl;
+    return 1;
+  }
+
+  std::cout << "Converted " << disk_cache_path << " to " << output_path
+            << std::endl;
+  return 0;
+}